@@ -2,6 +2,9 @@
 #include <json.h>  // NOLINT(build/include)
 #include <logger.h>
 #include <fileutil.h>
+#include <mappedfile.h>
+#include <directorywatcher.h>
+#include <algorithm>
 #include <vector>
 #include <queue>
 #include <sstream>
@@ -14,11 +17,19 @@
 
 namespace glass3 {
 
+// constants
+const int fileInput::k_iLineBatchSize;
+const int fileInput::k_iMaxTimestampLength;
+const int fileInput::k_iWatchTimeoutMS;
+
 // ---------------------------------------------------------fileInput
 fileInput::fileInput()
 		: glass3::input::Input() {
 	glass3::util::Logger::log("debug", "fileInput::fileInput(): Construction.");
 
+	m_iLineBatchIndex = 0;
+	m_iDataCount = 0;
+
 	// init config to defaults and allocate
 	clear();
 }
@@ -28,6 +39,9 @@ fileInput::fileInput(const std::shared_ptr<const json::Object> &config)
 		: glass3::input::Input() {
 	glass3::util::Logger::log(
 			"debug", "fileInput::fileInput(): Advanced Construction.");
+	m_iLineBatchIndex = 0;
+	m_iDataCount = 0;
+
 	// do basic construction
 	clear();
 
@@ -164,124 +178,228 @@ void fileInput::clear() {
 	setShutdownWhenNoData(true);
 	setShutdownWait(60);
 
+	// watch the (new) input directory when we next need a file
+	m_DirectoryWatcher.stop();
+	m_bWatchDirectory = true;
+	m_bScanForFiles = true;
+
 	// finally do baseclass clear
 	glass3::input::Input::clear();
 }
 
 // ---------------------------------------------------------fetchRawData
 std::string fileInput::fetchRawData(std::string* pOutType) {
+	std::vector<std::string> messages;
+	if (fetchRawDataBatch(1, &messages, pOutType) > 0) {
+		return (messages[0]);
+	}
+
+	return ("");
+}
+
+// ---------------------------------------------------------fetchRawDataBatch
+int fileInput::fetchRawDataBatch(int maxCount,
+									std::vector<std::string> *pMessages,
+									std::string* pOutType) {
 	// our pOutType is our format (extension)
 	*pOutType = getFormat();
 
 	// check to see if we've got a file
-	if ((m_InputFile.good() == true) && (m_InputFile.eof() != true)) {
-		std::string line = "";
+	if (m_InputFile.isOpen() == true) {
+		// split off the next batch of lines when this batch is used up
+		if ((m_iLineBatchIndex < m_vLineBatch.size()) || (readLineBatch())) {
+			// hand off the lines
+			return (copyLineBatch(maxCount, pMessages));
+		}
+	}
 
-		// we're processing an input file, get the next line
-		std::getline(m_InputFile, line);
+	// need to get a new file
+	// make sure we close an old file
+	if (m_InputFile.isOpen()) {
+		// log some throughput statistics
+		std::chrono::high_resolution_clock::time_point tFileEndTime =
+				std::chrono::high_resolution_clock::now();
+		std::chrono::duration<double> tFileProcDuration =
+				std::chrono::duration_cast<std::chrono::duration<double>>(
+						tFileEndTime - m_tFileStartTime);
+		double tAverageTime = tFileProcDuration.count() / m_iDataCount;
+		double megabytesPerSecond = 0;
+		if (tFileProcDuration.count() > 0) {
+			megabytesPerSecond = m_InputFile.getSize()
+					/ tFileProcDuration.count() / (1024.0 * 1024.0);
+		}
 
-		// skip empty lines
-		while ((line.length() == 0) && (m_InputFile.eof() != true)) {
-			// get the next line
-			std::getline(m_InputFile, line);
+		glass3::util::Logger::log(
+				"info",
+				"fileInput::fetchRawDataBatch(): Processed "
+						+ std::to_string(m_iDataCount) + " data from file: "
+						+ m_sFileName + " in "
+						+ std::to_string(tFileProcDuration.count())
+						+ " seconds. (Average: "
+						+ std::to_string(tAverageTime) + " seconds, "
+						+ std::to_string(megabytesPerSecond) + " MB/s)");
+
+		m_InputFile.close();
+		m_vLineBatch.clear();
+		m_iLineBatchIndex = 0;
+
+		// cleanup
+		bool move = false;
+		if (getArchiveDir() != "") {
+			move = true;
 		}
+		// archive (or not) our fileInput
+		cleanupFile(m_sFileName, move, getArchiveDir());
+		m_sFileName = "";
+	}
 
-		// skip a timestamp line (gpick format)
-		// timestamp format: 1425340828\n
-		// so a line with less than or equal to 11 characters is a timestamp
-		// (with newline)
-		while ((line.length() <= 11) && (m_InputFile.eof() != true)) {
-			// get the next line
-			std::getline(m_InputFile, line);
+	// now look for a new file
+	if (getNextFileName(&m_sFileName) == true) {
+		// found one
+		// open the file
+		// next time we'll start reading from the file
+		if (m_InputFile.open(m_sFileName) == false) {
+			// try again next time
+			return (0);
 		}
 
-		// otherwise, return the line
-		m_iDataCount++;
-		return (line);
-	} else {
-		// need to get a new file
-		// make sure we close an old file
-		if (m_InputFile.is_open()) {
-			// log some throughput statistics
-			std::chrono::high_resolution_clock::time_point tFileEndTime =
-					std::chrono::high_resolution_clock::now();
-			std::chrono::duration<double> tFileProcDuration =
-					std::chrono::duration_cast<std::chrono::duration<double>>(
-							tFileEndTime - m_tFileStartTime);
-			double tAverageTime = tFileProcDuration.count() / m_iDataCount;
+		glass3::util::Logger::log(
+				"info",
+				"fileInput::fetchRawDataBatch(): Opened file: " + m_sFileName);
+
+		// reset performance counters
+		m_tFileStartTime = std::chrono::high_resolution_clock::now();
+		m_iDataCount = 0;
 
+		// start on the file right away
+		if (readLineBatch() == true) {
+			return (copyLineBatch(maxCount, pMessages));
+		}
+	} else {
+		// no file to process, check to see if we still have data in the
+		// queue and if we're supposed to autoshutdown
+		if ((getInputDataCount() <= 0)
+				&& (getShutdownWhenNoData() == true)) {
+			// we don't
 			glass3::util::Logger::log(
-					"info",
-					"fileInput::fetchRawData(): Processed "
-							+ std::to_string(m_iDataCount) + " data from file: "
-							+ m_sFileName + " in "
-							+ std::to_string(tFileProcDuration.count())
-							+ " seconds. (Average: "
-							+ std::to_string(tAverageTime) + " seconds)");
-
-			m_InputFile.close();
-
-			// cleanup
-			bool move = false;
-			if (getArchiveDir() != "") {
-				move = true;
+					"warning",
+					"fileInput::fetchRawDataBatch(): No more input files and/or "
+							"pending data in queue, shutting down in "
+							+ std::to_string(getShutdownWait())
+							+ " seconds.");
+
+			// wait for glass to finish processing
+			for (int i = 0; i < getShutdownWait(); i++) {
+				// signal that we're still running
+				setThreadHealth();
+
+				// sleep for one second
+				std::this_thread::sleep_for(
+						std::chrono::milliseconds(1000));
 			}
-			// archive (or not) our fileInput
-			cleanupFile(m_sFileName, move, getArchiveDir());
-			m_sFileName = "";
+
+			// times up
+			glass3::util::Logger::log(
+					"warning",
+					"fileInput::fetchRawDataBatch(): shutting down.");
+
+			// shut it down
+			setWorkThreadsState(glass3::util::ThreadState::Stopping);
 		}
+	}
 
-		// now look for a new file
-		if (glass3::util::getFirstFileNameByExtension(getInputDir(),
-														getFormat(),
-														m_sFileName) == true) {
-			// found one
-			// open the file
-			// next time we'll start reading from the file
-			m_InputFile.open(m_sFileName, std::ios::in);
+	// 'till next time
+	return (0);
+}
 
+// ---------------------------------------------------------getNextFileName
+bool fileInput::getNextFileName(std::string *fileName) {
+	std::string inputDir = getInputDir();
+
+	// (re)start watching the input directory when needed, anything already
+	// in the directory is found by scanning
+	if ((m_bWatchDirectory == true)
+			&& ((m_DirectoryWatcher.isWatching() == false)
+					|| (m_DirectoryWatcher.getPath() != inputDir))) {
+		if (m_DirectoryWatcher.watch(inputDir, getFormat()) == false) {
+			// fall back to scanning
 			glass3::util::Logger::log(
-					"info",
-					"fileInput::fetchRawData(): Opened file: " + m_sFileName);
-
-			// reset performance counters
-			m_tFileStartTime = std::chrono::high_resolution_clock::now();
-			m_iDataCount = 0;
-		} else {
-			// no file to process, check to see if we still have data in the
-			// queue and if we're supposed to autoshutdown
-			if ((getInputDataCount() <= 0)
-					&& (getShutdownWhenNoData() == true)) {
-				// we don't
-				glass3::util::Logger::log(
-						"warning",
-						"fileInput::fetchRawData(): No more input files and/or "
-								"pending data in queue, shutting down in "
-								+ std::to_string(getShutdownWait())
-								+ " seconds.");
-
-				// wait for glass to finish processing
-				for (int i = 0; i < getShutdownWait(); i++) {
-					// signal that we're still running
-					setThreadHealth();
-
-					// sleep for one second
-					std::this_thread::sleep_for(
-							std::chrono::milliseconds(1000));
-				}
-
-				// times up
-				glass3::util::Logger::log(
-						"warning", "fileInput::fetchRawData(): shutting down.");
-
-				// shut it down
-				setWorkThreadsState(glass3::util::ThreadState::Stopping);
+					"warning",
+					"fileInput::getNextFileName(): Unable to watch " + inputDir
+							+ ", scanning for files instead.");
+			m_bWatchDirectory = false;
+		}
+		m_bScanForFiles = true;
+	}
+
+	// the watch may have missed files
+	if (m_DirectoryWatcher.hasOverflowed() == true) {
+		m_bScanForFiles = true;
+	}
+
+	if ((m_bScanForFiles == true)
+			|| (m_DirectoryWatcher.isWatching() == false)) {
+		if (glass3::util::getFirstFileNameByExtension(inputDir, getFormat(),
+														*fileName) == true) {
+			return (true);
+		}
+
+		// nothing left from before, wait for the watch to report new files
+		m_bScanForFiles = false;
+		if (m_DirectoryWatcher.isWatching() == false) {
+			return (false);
+		}
+	}
+
+	return (m_DirectoryWatcher.getNextFileName(fileName, k_iWatchTimeoutMS));
+}
+
+// ---------------------------------------------------------readLineBatch
+bool fileInput::readLineBatch() {
+	m_vLineBatch.clear();
+	m_iLineBatchIndex = 0;
+
+	while (m_vLineBatch.size() == 0) {
+		// only complete lines, the end of the file may still be being written
+		if (m_InputFile.readLines(k_iLineBatchSize, &m_vLineBatch, false)
+				== 0) {
+			// pick up anything appended since the file was opened
+			if (m_InputFile.update() == true) {
+				continue;
+			}
+
+			// the file is done, take a last line without a newline
+			if (m_InputFile.readLines(1, &m_vLineBatch) == 0) {
+				break;
 			}
 		}
+
+		// skip empty and timestamp (gpick format) lines
+		m_vLineBatch.erase(
+				std::remove_if(
+						m_vLineBatch.begin(), m_vLineBatch.end(),
+						[](const glass3::util::MappedLine &line) {
+							return (line.iLength <= k_iMaxTimestampLength);
+						}),
+				m_vLineBatch.end());
 	}
 
-	// 'till next time
-	return ("");
+	return (m_vLineBatch.size() > 0);
+}
+
+// ---------------------------------------------------------copyLineBatch
+int fileInput::copyLineBatch(int maxCount,
+								std::vector<std::string> *pMessages) {
+	int count = 0;
+	while ((count < maxCount) && (m_iLineBatchIndex < m_vLineBatch.size())) {
+		const glass3::util::MappedLine &line =
+				m_vLineBatch[m_iLineBatchIndex++];
+		pMessages->push_back(std::string(line.pData, line.iLength));
+		count++;
+	}
+
+	m_iDataCount += count;
+	return (count);
 }
 
 // ---------------------------------------------------------cleanupFile
@@ -10,11 +10,14 @@
 #include <json.h>
 #include <threadbaseclass.h>
 #include <input.h>
+#include <mappedfile.h>
+#include <directorywatcher.h>
 
 #include <chrono>
 #include <mutex>
 #include <string>
 #include <memory>
+#include <vector>
 
 #define GPICK_EXTENSION "gpick"
 #define GPICKS_EXTENSION "gpicks"
@@ -180,6 +183,23 @@ class fileInput : public glass3::input::Input {
 	 */
 	std::string fetchRawData(std::string* pOutType) override;
 
+	/**
+	 * \brief get a batch of input data strings and their type
+	 *
+	 * A function (overridden from glass3::input) that retrieves up to
+	 * maxCount data lines from the current input file, so that a batch of
+	 * lines split from the file is handed off to parsing in one go
+	 * \param maxCount - An integer containing the maximum number of lines to
+	 * fetch
+	 * \param pMessages - A pointer to a std::vector of std::string to append
+	 * the lines to
+	 * \param pOutType - A pointer to a std::string used to pass out the type
+	 * of the data
+	 * \return returns the number of lines fetched
+	 */
+	int fetchRawDataBatch(int maxCount, std::vector<std::string> *pMessages,
+							std::string* pOutType) override;
+
 	/**
 	 * \brief cleanup file function
 	 *
@@ -225,9 +245,94 @@ class fileInput : public glass3::input::Input {
 	std::atomic<int> m_iShutdownWait;
 
 	/**
-	 * \brief the current input file handle
+	 * \brief get the next input file
+	 *
+	 * Gets the next input file to process. New files are found from the
+	 * input directory watch as soon as they are written, the input directory
+	 * is only scanned at startup, after the watch may have missed files, or
+	 * when the directory can not be watched.
+	 *
+	 * \param fileName - A pointer to a std::string to return the path and
+	 * name of the file in
+	 * \return Returns true if a file was found, false otherwise
+	 */
+	bool getNextFileName(std::string *fileName);
+
+	/**
+	 * \brief split the next batch of lines
+	 *
+	 * Splits the next batch of data lines off of the current input file into
+	 * m_vLineBatch, skipping empty and timestamp lines. Once the complete
+	 * lines are used up, picks up anything appended to the file since it was
+	 * opened before treating a last line without a newline as complete.
+	 *
+	 * \return Returns true if there are lines in the batch, false if the file
+	 * has been completely read
+	 */
+	bool readLineBatch();
+
+	/**
+	 * \brief copy lines from the current batch
+	 *
+	 * Copies up to maxCount lines from m_vLineBatch, starting at
+	 * m_iLineBatchIndex
+	 *
+	 * \param maxCount - An integer containing the maximum number of lines to
+	 * copy
+	 * \param pMessages - A pointer to a std::vector of std::string to append
+	 * the lines to
+	 * \return Returns the number of lines copied
+	 */
+	int copyLineBatch(int maxCount, std::vector<std::string> *pMessages);
+
+	/**
+	 * \brief the current input file, mapped into memory
+	 */
+	glass3::util::MappedFile m_InputFile;
+
+	/**
+	 * \brief the current batch of lines split from the input file
+	 */
+	std::vector<glass3::util::MappedLine> m_vLineBatch;
+
+	/**
+	 * \brief the index of the next line to return from m_vLineBatch
+	 */
+	int m_iLineBatchIndex;
+
+	/**
+	 * \brief the number of lines to split from the input file at a time
+	 */
+	static const int k_iLineBatchSize = 1000;
+
+	/**
+	 * \brief lines this short or shorter are gpick timestamps
+	 * (e.g. 1425340828) and are skipped
+	 */
+	static const int k_iMaxTimestampLength = 11;
+
+	/**
+	 * \brief the watch on the input directory
+	 */
+	glass3::util::DirectoryWatcher m_DirectoryWatcher;
+
+	/**
+	 * \brief a boolean flag indicating whether to watch the input directory,
+	 * cleared if the directory can not be watched
+	 */
+	bool m_bWatchDirectory;
+
+	/**
+	 * \brief a boolean flag indicating whether the input directory needs to be
+	 * scanned for files the watch has not reported
+	 */
+	bool m_bScanForFiles;
+
+	/**
+	 * \brief the time in milliseconds to wait for a new file to be written to
+	 * the watched input directory
 	 */
-	std::ifstream m_InputFile;
+	static const int k_iWatchTimeoutMS = 500;
 
 	/**
 	 * \brief the current input file name
@@ -14,6 +14,12 @@
 
 namespace glass3 {
 
+// constants
+const int fileOutput::k_iDefaultAppendLogMaxSizeMB;
+const int fileOutput::k_iDefaultAppendLogMaxAgeSeconds;
+const int fileOutput::k_iDefaultAppendLogFlushRecords;
+const int fileOutput::k_iDefaultAppendLogFlushIntervalMS;
+
 // ---------------------------------------------------------fileOutput
 fileOutput::fileOutput()
 		: glass3::output::output() {
@@ -42,6 +48,9 @@ fileOutput::fileOutput(const std::shared_ptr<const json::Object> &config)
 
 // ---------------------------------------------------------~fileOutput
 fileOutput::~fileOutput() {
+	// write out anything still buffered
+	m_DetectionLog.close();
+	m_RetractionLog.close();
 }
 
 // ---------------------------------------------------------setup
@@ -120,6 +129,81 @@ bool fileOutput::setup(std::shared_ptr<const json::Object> config) {
 						"is: " + std::to_string(m_bTimestampFileName) + ".");
 	}
 
+	// output mode
+	bool appendLog = false;
+	if ((config->HasKey("OutputMode"))
+			&& ((*config)["OutputMode"].GetType()
+					== json::ValueType::StringVal)) {
+		std::string outputMode = (*config)["OutputMode"].ToString();
+		if (outputMode == "AppendLog") {
+			appendLog = true;
+		} else if (outputMode != "File") {
+			glass3::util::Logger::log(
+					"warning",
+					"fileOutput::setup(): Unknown OutputMode: " + outputMode
+							+ ", defaulting to File.");
+		}
+	}
+
+	if (appendLog == true) {
+		int maxSizeMB = k_iDefaultAppendLogMaxSizeMB;
+		if ((config->HasKey("AppendLogMaxSizeMB"))
+				&& ((*config)["AppendLogMaxSizeMB"].GetType()
+						== json::ValueType::IntVal)) {
+			maxSizeMB = (*config)["AppendLogMaxSizeMB"].ToInt();
+		}
+
+		int maxAgeSeconds = k_iDefaultAppendLogMaxAgeSeconds;
+		if ((config->HasKey("AppendLogMaxAgeSeconds"))
+				&& ((*config)["AppendLogMaxAgeSeconds"].GetType()
+						== json::ValueType::IntVal)) {
+			maxAgeSeconds = (*config)["AppendLogMaxAgeSeconds"].ToInt();
+		}
+
+		int flushRecords = k_iDefaultAppendLogFlushRecords;
+		if ((config->HasKey("AppendLogFlushRecords"))
+				&& ((*config)["AppendLogFlushRecords"].GetType()
+						== json::ValueType::IntVal)) {
+			flushRecords = (*config)["AppendLogFlushRecords"].ToInt();
+		}
+
+		int flushIntervalMS = k_iDefaultAppendLogFlushIntervalMS;
+		if ((config->HasKey("AppendLogFlushIntervalMS"))
+				&& ((*config)["AppendLogFlushIntervalMS"].GetType()
+						== json::ValueType::IntVal)) {
+			flushIntervalMS = (*config)["AppendLogFlushIntervalMS"].ToInt();
+		}
+
+		int64_t maxSize = static_cast<int64_t>(maxSizeMB) * 1024 * 1024;
+		if ((m_DetectionLog.setup(m_sOutputDir, "detection",
+									std::string(DETECTIONEXTENSION), maxSize,
+									maxAgeSeconds, flushRecords,
+									flushIntervalMS) == true)
+				&& (m_RetractionLog.setup(m_sOutputDir, "retraction",
+									std::string(RETRACTEXTENSION), maxSize,
+									maxAgeSeconds, flushRecords,
+									flushIntervalMS) == true)) {
+			glass3::util::Logger::log(
+					"info",
+					"fileOutput::setup(): Using OutputMode: AppendLog, "
+							"AppendLogMaxSizeMB: " + std::to_string(maxSizeMB)
+							+ ", AppendLogMaxAgeSeconds: "
+							+ std::to_string(maxAgeSeconds)
+							+ ", AppendLogFlushRecords: "
+							+ std::to_string(flushRecords)
+							+ ", AppendLogFlushIntervalMS: "
+							+ std::to_string(flushIntervalMS) + ".");
+		} else {
+			glass3::util::Logger::log(
+					"error",
+					"fileOutput::setup(): Invalid append log configuration, "
+					"defaulting to OutputMode: File.");
+			appendLog = false;
+		}
+	}
+
+	m_bAppendLog = appendLog;
+
 	getMutex().unlock();
 
 	glass3::util::Logger::log("debug", "fileOutput::setup(): Done Setting Up.");
@@ -139,6 +223,11 @@ void fileOutput::clear() {
 	getMutex().unlock();
 
 	m_bTimestampFileName = true;
+	m_bAppendLog = false;
+
+	// write out anything still buffered
+	m_DetectionLog.close();
+	m_RetractionLog.close();
 
 	// finally do baseclass clear
 	glass3::output::output::clear();
@@ -192,6 +281,16 @@ void fileOutput::sendOutput(const std::string &type, const std::string &id,
 		return;
 	}
 
+	// append to the log for this type instead of writing a new file
+	if (getAppendLog() == true) {
+		if (type == "Detection") {
+			m_DetectionLog.append(OutputData);
+		} else {
+			m_RetractionLog.append(OutputData);
+		}
+		return;
+	}
+
 	// build time string if requested
 	std::string timestring = "";
 	if (timeStampName == true) {
@@ -266,6 +365,16 @@ void fileOutput::sendOutput(const std::string &type, const std::string &id,
 	return;
 }
 
+// ---------------------------------------------------------sendHeartbeat
+void fileOutput::sendHeartbeat() {
+	if (getAppendLog() == false) {
+		return;
+	}
+
+	m_DetectionLog.flushIfDue();
+	m_RetractionLog.flushIfDue();
+}
+
 // ---------------------------------------------------------getOutputDir
 const std::string fileOutput::getOutputDir() {
 	std::lock_guard<std::mutex> guard(getMutex());
@@ -283,6 +392,11 @@ bool fileOutput::getTimestampFileName() {
 	return (m_bTimestampFileName);
 }
 
+// ---------------------------------------------------------getAppendLog
+bool fileOutput::getAppendLog() {
+	return (m_bAppendLog);
+}
+
 // ---------------------------------------------------------getMutex
 std::mutex & fileOutput::getMutex() {
 	return (m_Mutex);
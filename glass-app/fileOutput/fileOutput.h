@@ -10,6 +10,7 @@
 #include <json.h>
 #include <threadbaseclass.h>
 #include <output.h>
+#include <appendlog.h>
 
 #include <thread>
 #include <mutex>
@@ -103,7 +104,20 @@ class fileOutput : public glass3::output::output {
 	 */
 	bool getTimestampFileName();
 
+	/**
+	 * \brief Get whether to write output to rolling append logs
+	 *
+	 * This function retrieves whether output is appended to rolling log files
+	 * rather than written one file per message
+	 * \return A boolean flag indicating whether to write append logs
+	 */
+	bool getAppendLog();
+
  protected:
+	// fileOutput doesn't route by location, but callers holding a fileOutput
+	// should still reach the routed overload
+	using glass3::output::output::sendOutput;
+
 	/**
 	 * \brief fileOutput file writing function
 	 *
@@ -116,6 +130,14 @@ class fileOutput : public glass3::output::output {
 	void sendOutput(const std::string &type, const std::string &id,
 					const std::string &message) override;
 
+	/**
+	 * \brief fileOutput heartbeat function
+	 *
+	 * Writes out any append log records that have been buffered for longer
+	 * than the flush interval, and completes append logs that are too old
+	 */
+	void sendHeartbeat() override;
+
  private:
 	/**
 	 * \brief the std::string configuration value defining the fileOutput
@@ -135,6 +157,44 @@ class fileOutput : public glass3::output::output {
 	 */
 	std::atomic<bool> m_bTimestampFileName;
 
+	/**
+	 * \brief the boolean configuration flag determining whether to write
+	 * output to rolling append logs instead of one file per message.
+	 */
+	std::atomic<bool> m_bAppendLog;
+
+	/**
+	 * \brief the rolling append log detection messages are written to
+	 */
+	glass3::util::AppendLog m_DetectionLog;
+
+	/**
+	 * \brief the rolling append log retraction messages are written to
+	 */
+	glass3::util::AppendLog m_RetractionLog;
+
+	/**
+	 * \brief the default size in megabytes at which to rotate append logs
+	 */
+	static const int k_iDefaultAppendLogMaxSizeMB = 64;
+
+	/**
+	 * \brief the default age in seconds at which to rotate append logs
+	 */
+	static const int k_iDefaultAppendLogMaxAgeSeconds = 3600;
+
+	/**
+	 * \brief the default number of buffered records at which to write to the
+	 * append logs
+	 */
+	static const int k_iDefaultAppendLogFlushRecords = 100;
+
+	/**
+	 * \brief the default maximum time in milliseconds to keep append log
+	 * records buffered
+	 */
+	static const int k_iDefaultAppendLogFlushIntervalMS = 1000;
+
 	/**
 	 * \brief Retrieves a reference to the class member containing the mutex
 	 * used to control access to class members
@@ -42,14 +42,29 @@
 #include <json.h>
 #include <logger.h>
 #include <config.h>
+#include <clock.h>
+#include <date.h>
 #include <fileInput.h>
 #include <fileOutput.h>
 #include <associator.h>
+#include <metricsregistry.h>
+#include <metricsserver.h>
+#include <instrumentedmutex.h>
+#include <latencytracer.h>
 
 #include <cstdio>
 #include <cstdlib>
 #include <string>
 #include <memory>
+#include <vector>
+#include <chrono>
+#include <thread>
+
+/**
+ * \brief The time in seconds to wait for timed input data to start the
+ * simulated clock, before falling back to the wall clock
+ */
+#define SIMULATEDSTARTTIMEOUT 60
 
 int main(int argc, char* argv[]) {
 	std::string configdir = "";
@@ -297,6 +312,68 @@ int main(int argc, char* argv[]) {
 		return (1);
 	}
 
+	// get whether to replay the input in simulated time
+	bool simulatedTime = false;
+	if (glassConfig.getJSON()->HasKey("SimulatedTime")
+			&& ((*glassConfig.getJSON())["SimulatedTime"].GetType()
+					== json::ValueType::BoolVal)) {
+		simulatedTime = (*glassConfig.getJSON())["SimulatedTime"].ToBool();
+	}
+
+	if (simulatedTime == true) {
+		glass3::util::Logger::log(
+				"info", "glass-app: Using simulated time driven by the input "
+				"data.");
+	}
+
+	// serve the metrics to local monitoring, if configured
+	glass3::util::MetricsServer MetricsThread;
+	if (glassConfig.getJSON()->HasKey("MetricsPort")
+			&& ((*glassConfig.getJSON())["MetricsPort"].GetType()
+					== json::ValueType::IntVal)) {
+		int metricsPort = (*glassConfig.getJSON())["MetricsPort"].ToInt();
+		if ((metricsPort > 0) && (MetricsThread.openPort(metricsPort) == true)) {
+			MetricsThread.start();
+		}
+	}
+
+	// periodically write the metrics to a file, if configured
+	if (glassConfig.getJSON()->HasKey("MetricsFile")
+			&& ((*glassConfig.getJSON())["MetricsFile"].GetType()
+					== json::ValueType::StringVal)) {
+		// default to once a minute
+		int metricsInterval = 60;
+		if (glassConfig.getJSON()->HasKey("MetricsIntervalSeconds")
+				&& ((*glassConfig.getJSON())["MetricsIntervalSeconds"].GetType()
+						== json::ValueType::IntVal)) {
+			metricsInterval =
+					(*glassConfig.getJSON())["MetricsIntervalSeconds"].ToInt();
+		}
+
+		glass3::util::MetricsRegistry::getInstance().startDump(
+				(*glassConfig.getJSON())["MetricsFile"].ToString(),
+				metricsInterval);
+	}
+
+	// profile the glasscore locks, if configured
+	if (glassConfig.getJSON()->HasKey("LockProfiling")
+			&& ((*glassConfig.getJSON())["LockProfiling"].GetType()
+					== json::ValueType::BoolVal)
+			&& ((*glassConfig.getJSON())["LockProfiling"].ToBool() == true)) {
+		glass3::util::LockProfile::setEnabled(true);
+		glass3::util::Logger::log("info", "glass-app: Profiling locks.");
+	}
+
+	// trace the pick latency through the pipeline, if configured
+	if (glassConfig.getJSON()->HasKey("PickLatencyTracing")
+			&& ((*glassConfig.getJSON())["PickLatencyTracing"].GetType()
+					== json::ValueType::BoolVal)
+			&& ((*glassConfig.getJSON())["PickLatencyTracing"].ToBool()
+					== true)) {
+		glass3::util::LatencyTracer::setEnabled(true);
+		glass3::util::Logger::log("info", "glass-app: Tracing pick latency.");
+	}
+
 	// create our objects
 	glass3::fileInput InputThread;
 	glass3::fileOutput OutputThread;
@@ -322,6 +399,55 @@ int main(int argc, char* argv[]) {
 	// information
 	OutputThread.setAssociator(&AssocThread);
 
+	// when replaying in simulated time, start the clock at the time of the
+	// first input data, before glass is configured, so that everything glass
+	// creates is stamped in data time
+	std::vector<std::shared_ptr<json::Object>> startupData;
+	if (simulatedTime == true) {
+		InputThread.start();
+
+		// the input may never provide timed data, so don't wait for it
+		// forever
+		std::chrono::steady_clock::time_point tWaitStart =
+				std::chrono::steady_clock::now();
+		double startTime = -1;
+		while (startTime < 0) {
+			std::shared_ptr<json::Object> data = InputThread.getInputData();
+			if (data == NULL) {
+				if (InputThread.healthCheck() == false) {
+					glass3::util::Logger::log(
+							"error", "glass-app: Input thread has exited!!");
+					return (1);
+				}
+				if ((std::chrono::steady_clock::now() - tWaitStart)
+						>= std::chrono::seconds(SIMULATEDSTARTTIMEOUT)) {
+					break;
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+				continue;
+			}
+
+			startupData.push_back(data);
+			startTime = glass3::process::Associator::getDataTime(data);
+		}
+
+		if (startTime < 0) {
+			glass3::util::Logger::log(
+					"warning",
+					"glass-app: No timed input data within "
+							+ std::to_string(SIMULATEDSTARTTIMEOUT)
+							+ " seconds, using the wall clock instead of "
+							"simulated time.");
+		} else {
+			glass3::util::Clock::setSimulatedTime(startTime);
+			glass3::util::Logger::log(
+					"info",
+					"glass-app: Starting simulated time at "
+							+ glass3::util::Date::convertEpochTimeToISO8601(
+									startTime));
+		}
+	}
+
 	// configure glass
 	// first send in initialize
 	AssocThread.setup(InitializeConfig.getJSON());
@@ -340,8 +466,16 @@ int main(int argc, char* argv[]) {
 		}
 	}
 
+	// pass any data read while starting the simulated clock to glass ahead
+	// of the rest of the input
+	for (auto data : startupData) {
+		AssocThread.setup(data);
+	}
+
 	// startup
-	InputThread.start();
+	if (simulatedTime == false) {
+		InputThread.start();
+	}
 	OutputThread.start();
 	AssocThread.start();
 
@@ -377,6 +511,11 @@ int main(int argc, char* argv[]) {
 	InputThread.stop();
 	OutputThread.stop();
 	AssocThread.stop();
+	MetricsThread.stop();
+	glass3::util::MetricsRegistry::getInstance().stopDump();
+	if (glass3::util::LockProfile::getEnabled() == true) {
+		glass3::util::LockProfile::report();
+	}
 
 	return (0);
 }
@@ -0,0 +1,561 @@
+/*****************************************
+ * This file is documented for Doxygen.
+ * If you modify this file please update
+ * the comments so that Doxygen will still
+ * be able to work.
+ ****************************************/
+/**
+ * \file
+ * \brief glass-bench.cpp
+ *
+ * glass-bench is an application that measures the throughput and latency of
+ * the glasscore libraries by replaying a recorded input dataset through
+ * glasscore in-process, as fast as glasscore will accept it.
+ *
+ * glass-bench uses the same configuration files as glass-app (see the
+ * examples directory), reading the glasscore initialize, station list, and
+ * grid configurations, and the default agency id and author from the input
+ * configuration. The input and output threads of glass-app are not used.
+ *
+ * glass-bench reads the input dataset from a single file containing one
+ * message per line, the file extension (i.e. gpick, jsonpick, dat, txt)
+ * defines the format of the messages, as with glass-app file input.
+ *
+ * glass-bench writes a json benchmark report containing the number of input
+ * messages, the input rate in messages per second, the total time spent in
+ * each stage of glasscore processing, the pick to first hypo latency
+ * percentiles, and the peak resident set size to the console, and optionally
+ * to a file.
+ *
+ * glass-bench uses the environment variable GLASS_LOG to define the location
+ * to write log files
+ *
+ * \par Usage
+ * \parblock
+ * <tt>glass-bench <configfile> <inputfile> [reportfile]</tt>
+ *
+ * \par Where
+ * \parblock
+ *    \b configfile is the required path to the glass-app configuration file
+ *
+ *    \b inputfile is the required path to the input dataset file to replay
+ *
+ *    \b reportfile is an optional path to a file to write the json benchmark
+ * report to
+ * \endparblock
+ * \endparblock
+ */
+#include <project_version.h>
+#include <json.h>
+#include <logger.h>
+#include <config.h>
+#include <gpickparser.h>
+#include <jsonparser.h>
+#include <ccparser.h>
+#include <simplepickparser.h>
+#include <Glass.h>
+#include <IGlassSend.h>
+#include <PickList.h>
+#include <HypoList.h>
+#include <Hypo.h>
+#include <Pick.h>
+#include <date.h>
+#include <sys/resource.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <memory>
+#include <map>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+#define GPICK_TYPE "gpick"
+#define JSON_TYPE "json"
+#define CC_TYPE "dat"
+#define SIMPLE_TYPE "txt"
+
+/**
+ * \brief The time in milliseconds between checks for glasscore being idle
+ */
+#define IDLE_CHECK_INTERVAL 100
+
+/**
+ * \brief The number of consecutive idle checks before glasscore is considered
+ * done processing the input dataset
+ */
+#define IDLE_CHECK_COUNT 20
+
+/**
+ * \brief glass-bench glasscore message receiver
+ *
+ * The BenchReceiver class receives the messages sent by glasscore, counting
+ * them by type and remembering the time the first Event message for each
+ * hypo was received, along with the ids of the picks the hypo contained at
+ * that moment.
+ */
+class BenchReceiver : public glasscore::IGlassSend {
+ public:
+	/**
+	 * \brief receive a message from glasscore
+	 * \param com - A pointer to a json::object containing the message
+	 */
+	void recieveGlassMessage(std::shared_ptr<json::Object> com) override {
+		if (com == NULL) {
+			return;
+		}
+
+		std::chrono::steady_clock::time_point tNow =
+				std::chrono::steady_clock::now();
+
+		std::string type = "unknown";
+		if (com->HasKey("Cmd")) {
+			type = (*com)["Cmd"].ToString();
+		} else if (com->HasKey("Type")) {
+			type = (*com)["Type"].ToString();
+		}
+
+		std::string id = "";
+		if (com->HasKey("ID")) {
+			id = (*com)["ID"].ToString();
+		} else if (com->HasKey("Pid")) {
+			id = (*com)["Pid"].ToString();
+		}
+
+		bool firstEvent = false;
+		m_Mutex.lock();
+		m_mMessageCounts[type]++;
+		if ((type == "Event") && (id != "")
+				&& (m_mFirstEventTimes.find(id) == m_mFirstEventTimes.end())) {
+			m_mFirstEventTimes[id] = tNow;
+			firstEvent = true;
+		}
+		m_Mutex.unlock();
+
+		// look up the reported pick set without holding our mutex, since
+		// glasscore sends some messages while holding its own locks
+		if (firstEvent == true) {
+			std::vector<std::string> pickIDs = getPickIDs(com, id);
+
+			std::lock_guard<std::mutex> guard(m_Mutex);
+			m_mFirstEventPicks[id] = pickIDs;
+		}
+	}
+
+	/**
+	 * \brief get the ids of the picks a reported hypo contains
+	 *
+	 * Event messages are sent from the hypo processing thread with no
+	 * glasscore locks held, and before the hypo is processed again, so the
+	 * pick set found here is the one that was reported.
+	 *
+	 * \param event - A pointer to a json::object containing the Event message
+	 * \param id - A std::string containing the id of the hypo
+	 * \return Returns a std::vector of the pick ids, empty if the hypo was
+	 * not found
+	 */
+	std::vector<std::string> getPickIDs(std::shared_ptr<json::Object> event,
+										const std::string &id) {
+		std::vector<std::string> pickIDs;
+		if ((!event->HasKey("Time"))
+				|| (glasscore::CGlass::getHypoList() == NULL)) {
+			return (pickIDs);
+		}
+
+		// find the hypo by its origin time
+		double originTime = glass3::util::Date::convertISO8601ToEpochTime(
+				(*event)["Time"].ToString());
+		std::vector<std::weak_ptr<glasscore::CHypo>> hypos =
+				glasscore::CGlass::getHypoList()->getHypos(originTime - 1.0,
+															originTime + 1.0);
+		for (auto weakHypo : hypos) {
+			std::shared_ptr<glasscore::CHypo> hypo = weakHypo.lock();
+			if ((hypo == NULL) || (hypo->getID() != id)) {
+				continue;
+			}
+
+			for (auto pick : hypo->getPickData()) {
+				pickIDs.push_back(pick->getID());
+			}
+			break;
+		}
+
+		return (pickIDs);
+	}
+
+	/**
+	 * \brief A std::map of message types to the number of messages of that
+	 * type received
+	 */
+	std::map<std::string, int> m_mMessageCounts;
+
+	/**
+	 * \brief A std::map of hypo ids to the time the first Event message for
+	 * that hypo was received
+	 */
+	std::map<std::string, std::chrono::steady_clock::time_point>
+		m_mFirstEventTimes;
+
+	/**
+	 * \brief A std::map of hypo ids to the ids of the picks that hypo
+	 * contained when its first Event message was sent
+	 */
+	std::map<std::string, std::vector<std::string>> m_mFirstEventPicks;
+
+	/**
+	 * \brief A mutex to control access to class members
+	 */
+	std::mutex m_Mutex;
+};
+
+/**
+ * \brief load a configuration file named in the glass-app configuration
+ * \param glassConfig - The glass-app configuration
+ * \param key - The key of the configuration file name
+ * \param configdir - The directory containing the configuration file
+ * \return Returns a shared_ptr to the loaded configuration, NULL on failure
+ */
+std::shared_ptr<json::Object> loadConfigFile(
+		std::shared_ptr<const json::Object> glassConfig, const std::string &key,
+		const std::string &configdir) {
+	if (!(glassConfig->HasKey(key)
+			&& ((*glassConfig)[key].GetType() == json::ValueType::StringVal))) {
+		glass3::util::Logger::log(
+				"critical", "Invalid configuration, missing <" + key + ">.");
+		return (NULL);
+	}
+
+	std::string filename = (*glassConfig)[key].ToString();
+	glass3::util::Config config;
+	try {
+		config.parseJSONFromFile(configdir, filename);
+	} catch (std::exception& e) {
+		glass3::util::Logger::log(
+				"criticalerror",
+				"Failed to load file: " + filename + "; "
+						+ std::string(e.what()));
+		return (NULL);
+	}
+
+	return (std::make_shared<json::Object>(*config.getJSON()));
+}
+
+/**
+ * \brief compute a percentile of a sorted vector of values
+ * \param values - A sorted std::vector of doubles
+ * \param percentile - The percentile to compute, 0 to 100
+ * \return Returns the nearest rank percentile, or 0 if there are no values
+ */
+double getPercentile(const std::vector<double> &values, double percentile) {
+	if (values.size() == 0) {
+		return (0);
+	}
+
+	int rank = static_cast<int>(std::ceil(percentile / 100.0 * values.size()));
+	rank = std::max(1, std::min(rank, static_cast<int>(values.size())));
+
+	return (values[rank - 1]);
+}
+
+int main(int argc, char* argv[]) {
+	// check our arguments
+	if ((argc < 3) || (argc > 4)) {
+		std::cout << "glass-bench version "
+					<< std::to_string(PROJECT_VERSION_MAJOR) << "."
+					<< std::to_string(PROJECT_VERSION_MINOR) << "."
+					<< std::to_string(PROJECT_VERSION_PATCH) << "; Usage: "
+					<< "glass-bench <configfile> <inputfile> [reportfile]"
+					<< std::endl;
+		return 1;
+	}
+
+	std::string inputFile = std::string(argv[2]);
+	std::string reportFile = "";
+	if (argc == 4) {
+		reportFile = std::string(argv[3]);
+	}
+
+	// Look up our log directory
+	std::string logpath;
+	char* pLogDir = getenv("GLASS_LOG");
+	if (pLogDir != NULL) {
+		logpath = pLogDir;
+	} else {
+		logpath = "./";
+	}
+
+	// log to file only, the console is used for the report
+	glass3::util::Logger::log_init("glass-bench", "info", logpath, false);
+
+	glass3::util::Logger::log(
+			"info",
+			"glass-bench: neic-glass3 Version "
+					+ std::to_string(PROJECT_VERSION_MAJOR) + "."
+					+ std::to_string(PROJECT_VERSION_MINOR) + "."
+					+ std::to_string(PROJECT_VERSION_PATCH) + " startup.");
+
+	// load our basic config from file
+	glass3::util::Config glassConfig;
+	try {
+		glassConfig.parseJSONFromFile("", std::string(argv[1]));
+	} catch (std::exception& e) {
+		std::cout << "Failed to load file: " << argv[1] << "; " << e.what()
+					<< std::endl;
+		return (1);
+	}
+
+	// get the directory where the rest of the glass configs are stored
+	std::string configdir = "./";
+	if (glassConfig.getJSON()->HasKey("ConfigDirectory")
+			&& ((*glassConfig.getJSON())["ConfigDirectory"].GetType()
+					== json::ValueType::StringVal)) {
+		configdir = (*glassConfig.getJSON())["ConfigDirectory"].ToString();
+	}
+
+	// set our proper loglevel
+	if (glassConfig.getJSON()->HasKey("LogLevel")
+			&& ((*glassConfig.getJSON())["LogLevel"].GetType()
+					== json::ValueType::StringVal)) {
+		glass3::util::Logger::log_update_level(
+				(*glassConfig.getJSON())["LogLevel"]);
+	}
+
+	std::shared_ptr<json::Object> initializeConfig = loadConfigFile(
+			glassConfig.getJSON(), "InitializeFile", configdir);
+	std::shared_ptr<json::Object> stationList = loadConfigFile(
+			glassConfig.getJSON(), "StationList", configdir);
+	std::shared_ptr<json::Object> inputConfig = loadConfigFile(
+			glassConfig.getJSON(), "InputConfig", configdir);
+	if ((initializeConfig == NULL) || (stationList == NULL)
+			|| (inputConfig == NULL)) {
+		std::cout << "Failed to load configuration, see log." << std::endl;
+		return (1);
+	}
+
+	// get detection grid file list
+	json::Array gridconfigfilelist;
+	if (glassConfig.getJSON()->HasKey("GridFiles")
+			&& ((*glassConfig.getJSON())["GridFiles"].GetType()
+					== json::ValueType::ArrayVal)) {
+		gridconfigfilelist = (*glassConfig.getJSON())["GridFiles"];
+	}
+	if (gridconfigfilelist.size() == 0) {
+		std::cout << "No <GridFiles> specified, exiting." << std::endl;
+		return (1);
+	}
+
+	// set up the parser for the input file type
+	std::string agencyID = "";
+	if (inputConfig->HasKey("DefaultAgencyID")) {
+		agencyID = (*inputConfig)["DefaultAgencyID"].ToString();
+	}
+	std::string author = "";
+	if (inputConfig->HasKey("DefaultAuthor")) {
+		author = (*inputConfig)["DefaultAuthor"].ToString();
+	}
+
+	std::string inputType = inputFile.substr(inputFile.find_last_of('.') + 1);
+	std::shared_ptr<glass3::parse::Parser> parser;
+	if (inputType.find(GPICK_TYPE) != std::string::npos) {
+		parser = std::make_shared<glass3::parse::GPickParser>(agencyID, author);
+	} else if (inputType.find(JSON_TYPE) != std::string::npos) {
+		parser = std::make_shared<glass3::parse::JSONParser>(agencyID, author);
+	} else if (inputType == CC_TYPE) {
+		parser = std::make_shared<glass3::parse::CCParser>(agencyID, author);
+	} else if (inputType == SIMPLE_TYPE) {
+		parser = std::make_shared<glass3::parse::SimplePickParser>(agencyID,
+																	author);
+	} else {
+		std::cout << "Unknown input file type: " << inputType << std::endl;
+		return (1);
+	}
+
+	// read and parse the input dataset up front, so that file reading and
+	// parsing are not part of the measurement
+	std::ifstream inputStream(inputFile);
+	if (!inputStream) {
+		std::cout << "Failed to open input file: " << inputFile << std::endl;
+		return (1);
+	}
+	std::vector<std::shared_ptr<json::Object>> inputData;
+	std::string line;
+	while (std::getline(inputStream, line)) {
+		if (line == "") {
+			continue;
+		}
+		std::shared_ptr<json::Object> data;
+		try {
+			data = parser->parse(line);
+		} catch (const std::exception &e) {
+			glass3::util::Logger::log(
+					"debug",
+					"glass-bench: Exception:" + std::string(e.what())
+							+ " parsing Input: " + line);
+		}
+		if (data != NULL) {
+			inputData.push_back(data);
+		}
+	}
+	inputStream.close();
+
+	// configure glass
+	BenchReceiver receiver;
+	glasscore::CGlass::setExternalInterface(&receiver);
+	glasscore::CGlass::clear();
+	glasscore::CGlass::receiveExternalMessage(initializeConfig);
+	glasscore::CGlass::receiveExternalMessage(stationList);
+	for (int i = 0; i < gridconfigfilelist.size(); i++) {
+		std::string gridconfigfile = gridconfigfilelist[i];
+		if (gridconfigfile != "") {
+			glass3::util::Config GridConfig(configdir, gridconfigfile);
+			glasscore::CGlass::receiveExternalMessage(
+					std::make_shared<json::Object>(*GridConfig.getJSON()));
+		}
+	}
+
+	if ((glasscore::CGlass::getPickList() == NULL)
+			|| (glasscore::CGlass::getHypoList() == NULL)) {
+		std::cout << "Failed to initialize glasscore, see log." << std::endl;
+		return (1);
+	}
+
+	glass3::util::Logger::log(
+			"info",
+			"glass-bench: replaying " + std::to_string(inputData.size())
+					+ " messages from " + inputFile);
+
+	// replay the input dataset, remembering when each pick was sent
+	std::map<std::string, std::chrono::steady_clock::time_point> sendTimes;
+	std::chrono::steady_clock::time_point tStartTime =
+			std::chrono::steady_clock::now();
+	for (auto data : inputData) {
+		std::string id = "";
+		if (data->HasKey("ID")) {
+			id = (*data)["ID"].ToString();
+		}
+		if (id != "") {
+			sendTimes[id] = std::chrono::steady_clock::now();
+		}
+
+		glasscore::CGlass::receiveExternalMessage(data);
+	}
+
+	// wait for glasscore to finish processing
+	std::chrono::steady_clock::time_point tEndTime =
+			std::chrono::steady_clock::now();
+	int idleCount = 0;
+	while (idleCount < IDLE_CHECK_COUNT) {
+		std::this_thread::sleep_for(
+				std::chrono::milliseconds(IDLE_CHECK_INTERVAL));
+
+		if ((glasscore::CGlass::getPickList()->getPickProcessingQueueLength()
+				== 0)
+				&& (glasscore::CGlass::getHypoList()
+						->getHypoProcessingQueueLength() == 0)) {
+			if (idleCount == 0) {
+				tEndTime = std::chrono::steady_clock::now();
+			}
+			idleCount++;
+		} else {
+			idleCount = 0;
+		}
+	}
+
+	double wallTime = std::chrono::duration_cast<
+			std::chrono::duration<double>>(tEndTime - tStartTime).count();
+
+	// compute the pick to first hypo latencies, the time from sending the
+	// last pick that the hypo contained when it was first reported to the
+	// first report
+	std::vector<double> latencies;
+	receiver.m_Mutex.lock();
+	for (auto event : receiver.m_mFirstEventTimes) {
+		bool found = false;
+		std::chrono::steady_clock::time_point tLastSend;
+		for (const auto &id : receiver.m_mFirstEventPicks[event.first]) {
+			auto sendTime = sendTimes.find(id);
+			if ((sendTime == sendTimes.end())
+					|| (sendTime->second > event.second)) {
+				continue;
+			}
+			if ((found == false) || (sendTime->second > tLastSend)) {
+				tLastSend = sendTime->second;
+				found = true;
+			}
+		}
+
+		if (found == true) {
+			latencies.push_back(
+					std::chrono::duration_cast<std::chrono::duration<double>>(
+							event.second - tLastSend).count());
+		}
+	}
+	std::map<std::string, int> messageCounts = receiver.m_mMessageCounts;
+	receiver.m_Mutex.unlock();
+	std::sort(latencies.begin(), latencies.end());
+
+	// peak resident set size
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+
+	// build the report
+	json::Object report;
+	report["Cmd"] = "GlassBenchmark";
+	report["Version"] = std::to_string(PROJECT_VERSION_MAJOR) + "."
+			+ std::to_string(PROJECT_VERSION_MINOR) + "."
+			+ std::to_string(PROJECT_VERSION_PATCH);
+	report["InputFile"] = inputFile;
+	report["InputCount"] = static_cast<int>(inputData.size());
+	report["WallTime"] = wallTime;
+	report["InputPerSecond"] =
+			(wallTime > 0) ? (static_cast<double>(inputData.size()) / wallTime) :
+					0.0;
+
+	json::Object stageTimes;
+	stageTimes["nucleate"] =
+			glasscore::CGlass::getPickList()->getTotalNucleationTime();
+	for (auto stage : glasscore::CGlass::getHypoList()
+			->getProcessingStageTimes()) {
+		stageTimes[stage.first] = stage.second;
+	}
+	report["StageTimes"] = stageTimes;
+
+	json::Object latency;
+	latency["Count"] = static_cast<int>(latencies.size());
+	latency["P50"] = getPercentile(latencies, 50);
+	latency["P90"] = getPercentile(latencies, 90);
+	latency["P99"] = getPercentile(latencies, 99);
+	latency["Max"] = getPercentile(latencies, 100);
+	report["FirstHypoLatency"] = latency;
+
+	json::Object messages;
+	for (auto count : messageCounts) {
+		messages[count.first] = count.second;
+	}
+	report["MessageCounts"] = messages;
+	report["PeakRSSKB"] = static_cast<int>(usage.ru_maxrss);
+
+	std::string reportString = json::Serialize(report);
+	std::cout << reportString << std::endl;
+
+	if (reportFile != "") {
+		std::ofstream reportStream(reportFile, std::ios::out);
+		reportStream << reportString << std::endl;
+		reportStream.close();
+	}
+
+	glass3::util::Logger::log("info",
+								"glass-bench: " + reportString);
+
+	// shutdown
+	glasscore::CGlass::getPickList()->stop();
+	glasscore::CGlass::getHypoList()->stop();
+
+	return (0);
+}
@@ -9,9 +9,15 @@
 #include <mutex>
 #include <string>
 #include <limits>
+#include <utility>
 
 namespace glass3 {
 
+// constants
+const int brokerInput::k_iPollTimeoutMS;
+const int brokerInput::k_iDefaultBatchSize;
+const int brokerInput::k_iDefaultBatchTimeMS;
+
 // ---------------------------------------------------------brokerInput
 brokerInput::brokerInput()
 		: glass3::input::Input() {
@@ -126,20 +132,10 @@ bool brokerInput::setup(std::shared_ptr<const json::Object> config) {
 		}
 	}
 
-	// set up consumer
-	if (m_Consumer != NULL) {
-		delete (m_Consumer);
-	}
-
-	// create new consumer
-	m_Consumer = new hazdevbroker::Consumer();
-
 	// optional directory to write heartbeat files to
 	std::string heartbeatDirectory = "";
 	if (config->HasKey("HeartbeatDirectory")) {
-		std::string heartbeatDirectory =
-			(*config)["HeartbeatDirectory"].ToString();
-		m_Consumer->setHeartbeatDirectory(heartbeatDirectory);
+		heartbeatDirectory = (*config)["HeartbeatDirectory"].ToString();
 		glass3::util::Logger::log(
 				"info",
 				"brokerInput::setup(): Using HeartbeatDirectory: "
@@ -156,15 +152,39 @@ bool brokerInput::setup(std::shared_ptr<const json::Object> config) {
 						+ std::to_string(m_iBrokerHeartbeatInterval) + ".");
 	}
 
-	// set up logging
-	m_Consumer->setLogCallback(
-			std::bind(&brokerInput::logConsumer, this, std::placeholders::_1));
+	// optional maximum number of messages to drain from the consumer at once
+	if ((config->HasKey("BatchSize"))
+			&& ((*config)["BatchSize"].GetType() == json::ValueType::IntVal)) {
+		m_iBatchSize = (*config)["BatchSize"].ToInt();
+		if (m_iBatchSize < 1) {
+			m_iBatchSize = 1;
+		}
+		glass3::util::Logger::log(
+				"info",
+				"brokerInput::setup(): Using BatchSize: "
+						+ std::to_string(m_iBatchSize) + ".");
+	}
 
-	// set up consumer, set up default topic config
-	m_Consumer->setup(consumerConfig, topicConfig);
+	// optional maximum time to spend draining messages from the consumer
+	if ((config->HasKey("BatchTimeMS"))
+			&& ((*config)["BatchTimeMS"].GetType() == json::ValueType::IntVal)) {
+		m_iBatchTimeMS = (*config)["BatchTimeMS"].ToInt();
+		if (m_iBatchTimeMS < 0) {
+			m_iBatchTimeMS = 0;
+		}
+		glass3::util::Logger::log(
+				"info",
+				"brokerInput::setup(): Using BatchTimeMS: "
+						+ std::to_string(m_iBatchTimeMS) + ".");
+	}
 
-	// subscribe to topics
-	m_Consumer->subscribe(topicList);
+	// set up consumer
+	if (setupConsumer(consumerConfig, topicConfig, topicList,
+						heartbeatDirectory) == false) {
+		glass3::util::Logger::log(
+				"error", "brokerInput::setup(): Unable to set up consumer.");
+		return (false);
+	}
 
 	glass3::util::Logger::log("debug",
 								"brokerInput::setup(): Done Setting Up.");
@@ -182,54 +202,169 @@ void brokerInput::clear() {
 	glass3::util::Logger::log(
 			"debug", "brokerInput::clear(): clearing configuration.");
 
+	m_iBatchSize = k_iDefaultBatchSize;
+	m_iBatchTimeMS = k_iDefaultBatchTimeMS;
+	std::queue<std::string>().swap(m_MessageBatch);
+
 	// finally do baseclass clear
 	glass3::input::Input::clear();
 }
 
 // ---------------------------------------------------------fetchRawData
 std::string brokerInput::fetchRawData(std::string* pOutType) {
+	std::vector<std::string> messages;
+	if (fetchRawDataBatch(1, &messages, pOutType) > 0) {
+		return (messages[0]);
+	}
+
+	return ("");
+}
+
+// ---------------------------------------------------------fetchRawDataBatch
+int brokerInput::fetchRawDataBatch(int maxCount,
+									std::vector<std::string> *pMessages,
+									std::string* pOutType) {
 	// we only expect json messages from the broker
 	*pOutType = std::string(JSON_TYPE);
 
+	checkHeartbeat();
+
+	// get more messages from the consumer once the batch is used up
+	if (m_MessageBatch.empty() == true) {
+		if (fillMessageBatch() == 0) {
+			// 'till next time
+			return (0);
+		}
+	}
+
+	// hand off as much of the batch as there is room for
+	int count = 0;
+	while ((count < maxCount) && (m_MessageBatch.empty() == false)) {
+		pMessages->push_back(std::move(m_MessageBatch.front()));
+		m_MessageBatch.pop();
+		count++;
+	}
+
+	return (count);
+}
+
+// ---------------------------------------------------------checkHeartbeat
+void brokerInput::checkHeartbeat() {
+	// if we are checking heartbeat times
+	if ((m_Consumer == NULL) || (m_iBrokerHeartbeatInterval < 0)) {
+		return;
+	}
+
+	// get current time in seconds
+	int64_t timeNow = std::time(NULL);
+
+	// get last heartbeat time
+	int64_t lastHB = m_Consumer->getLastHeartbeatTime();
+
+	// calculate elapsed time
+	int64_t elapsedTime = timeNow - lastHB;
+
+	// has it been too long since the last heartbeat?
+	if (elapsedTime > m_iBrokerHeartbeatInterval) {
+		glass3::util::Logger::log("error",
+			"brokerInput::checkHeartbeat: No Heartbeat Message seen from"
+			" topic(s) in " +
+			std::to_string(m_iBrokerHeartbeatInterval) + " seconds! (" +
+			std::to_string(elapsedTime) + ")");
+
+		// reset last heartbeat time so that we don't fill the log
+		m_Consumer->setLastHeartbeatTime(timeNow);
+	}
+}
+
+// ---------------------------------------------------------setupConsumer
+bool brokerInput::setupConsumer(const std::string &consumerConfig,
+								const std::string &topicConfig,
+								const std::vector<std::string> &topicList,
+								const std::string &heartbeatDirectory) {
+	if (m_Consumer != NULL) {
+		delete (m_Consumer);
+	}
+
+	// create new consumer
+	m_Consumer = new hazdevbroker::Consumer();
+
+	if (heartbeatDirectory != "") {
+		m_Consumer->setHeartbeatDirectory(heartbeatDirectory);
+	}
+
+	// set up logging
+	m_Consumer->setLogCallback(
+			std::bind(&brokerInput::logConsumer, this, std::placeholders::_1));
+
+	// set up consumer, set up default topic config
+	m_Consumer->setup(consumerConfig, topicConfig);
+
+	// subscribe to topics
+	m_Consumer->subscribe(topicList);
+
+	return (true);
+}
+
+// ---------------------------------------------------------pollConsumer
+std::string brokerInput::pollConsumer(int timeoutMS) {
 	// make sure we have a consumer
 	if (m_Consumer == NULL) {
 		return ("");
 	}
 
-	// if we are checking heartbeat times
-	if (m_iBrokerHeartbeatInterval >= 0) {
-		// get current time in seconds
-		int64_t timeNow = std::time(NULL);
-
-		// get last heartbeat time
-		int64_t lastHB = m_Consumer->getLastHeartbeatTime();
-
-		// calculate elapsed time
-		int64_t elapsedTime = timeNow - lastHB;
-
-		// has it been too long since the last heartbeat?
-		if (elapsedTime > m_iBrokerHeartbeatInterval) {
-			glass3::util::Logger::log("error",
-				"brokerInput::fetchRawData: No Heartbeat Message seen from"
-				" topic(s) in " +
-				std::to_string(m_iBrokerHeartbeatInterval) + " seconds! (" +
-				std::to_string(elapsedTime) + ")");
-
-			// reset last heartbeat time so that we don't fill the log
-			m_Consumer->setLastHeartbeatTime(timeNow);
-		}
+	return (m_Consumer->pollString(timeoutMS));
+}
+
+// ---------------------------------------------------------fillMessageBatch
+int brokerInput::fillMessageBatch() {
+	// wait for the first message
+	std::string message = pollConsumer(k_iPollTimeoutMS);
+	if (message == "") {
+		return (0);
 	}
 
-	// get message from the consumer
-	std::string message = m_Consumer->pollString(100);
+	std::chrono::steady_clock::time_point batchStart =
+			std::chrono::steady_clock::now();
+	m_MessageBatch.push(message);
+	int numMessages = 1;
+
+	// drain whatever else is already waiting, so catching up on a backlog
+	// doesn't cost a poll round trip per message
+	while (numMessages < m_iBatchSize) {
+		int elapsedMS = std::chrono::duration_cast<std::chrono::milliseconds>(
+				std::chrono::steady_clock::now() - batchStart).count();
+		if (elapsedMS >= m_iBatchTimeMS) {
+			break;
+		}
+
+		message = pollConsumer(0);
+		if (message == "") {
+			break;
+		}
 
-	// check for empty string
-	if (message != "") {
-		return (message);
+		m_MessageBatch.push(message);
+		numMessages++;
 	}
 
-	// 'till next time
-	return ("");
+	if (numMessages > 1) {
+		glass3::util::Logger::log(
+				"trace",
+				"brokerInput::fillMessageBatch(): Drained "
+						+ std::to_string(numMessages) + " messages.");
+	}
+
+	return (numMessages);
+}
+
+// ---------------------------------------------------------getBatchSize
+int brokerInput::getBatchSize() {
+	return (m_iBatchSize);
+}
+
+// ---------------------------------------------------------getBatchTimeMS
+int brokerInput::getBatchTimeMS() {
+	return (m_iBatchTimeMS);
 }
 
 // ---------------------------------------------------------logConsumer
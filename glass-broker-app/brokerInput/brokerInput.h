@@ -89,13 +89,100 @@ class brokerInput : public glass3::input::Input {
 	 */
 	std::string fetchRawData(std::string* pOutType) override;
 
+	/**
+	 * \brief get a batch of input data strings and their type
+	 *
+	 * A function (overridden from glass3::input) that retrieves up to
+	 * maxCount messages drained from the consumer, so that a batch drained
+	 * while catching up on a backlog is handed off to parsing in one go
+	 * \param maxCount - An integer containing the maximum number of messages
+	 * to fetch
+	 * \param pMessages - A pointer to a std::vector of std::string to append
+	 * the messages to
+	 * \param pOutType - A pointer to a std::string used to pass out the type
+	 * of the data
+	 * \return returns the number of messages fetched
+	 */
+	int fetchRawDataBatch(int maxCount, std::vector<std::string> *pMessages,
+							std::string* pOutType) override;
+
 	/**
 	 * \brief the function for consumer logging
 	 * \param message - A string containing the logging message
 	 */
 	void logConsumer(const std::string &message);
 
+	/**
+	 * \brief set up the consumer function
+	 *
+	 * Creates the hazdevbroker consumer and subscribes it to the topics. Tests
+	 * override this function, along with pollConsumer(), to stand in for
+	 * kafka with a local consumer.
+	 *
+	 * \param consumerConfig - A std::string containing the consumer
+	 * configuration
+	 * \param topicConfig - A std::string containing the default topic
+	 * configuration, empty to use the hazdevbroker default
+	 * \param topicList - A std::vector of std::string containing the topics
+	 * to subscribe to
+	 * \param heartbeatDirectory - A std::string containing the directory to
+	 * write heartbeat files to, empty to not write them
+	 * \return returns true if successful.
+	 */
+	virtual bool setupConsumer(const std::string &consumerConfig,
+								const std::string &topicConfig,
+								const std::vector<std::string> &topicList,
+								const std::string &heartbeatDirectory);
+
+	/**
+	 * \brief poll the consumer function
+	 *
+	 * Polls the hazdevbroker consumer for the next message. Tests override
+	 * this function to stand in for kafka with a local consumer.
+	 *
+	 * \param timeoutMS - An integer containing the maximum time to wait for a
+	 * message in milliseconds, 0 to not wait
+	 * \return returns a std::string containing the message, or an empty
+	 * string if no message was available
+	 */
+	virtual std::string pollConsumer(int timeoutMS);
+
+	/**
+	 * \brief fill the message batch function
+	 *
+	 * Waits for a message from the consumer, then drains any further messages
+	 * that are immediately available, up to the batch size or batch time,
+	 * into the message batch.
+	 *
+	 * \return returns the number of messages added to the batch
+	 */
+	int fillMessageBatch();
+
+	/**
+	 * \brief Function to retrieve the batch size
+	 *
+	 * \return Returns an integer containing the maximum number of messages
+	 * drained from the consumer at once
+	 */
+	int getBatchSize();
+
+	/**
+	 * \brief Function to retrieve the batch time
+	 *
+	 * \return Returns an integer containing the maximum time in milliseconds
+	 * spent draining messages from the consumer at once
+	 */
+	int getBatchTimeMS();
+
  private:
+	/**
+	 * \brief check the broker heartbeat function
+	 *
+	 * Logs an error if no heartbeat has been seen from the topics within the
+	 * configured heartbeat interval
+	 */
+	void checkHeartbeat();
+
 	/**
 	 * \brief the hazdevbroker consumer object to get messages from kafka
 	 */
@@ -105,6 +192,39 @@ class brokerInput : public glass3::input::Input {
 	 * \brief the interval in seconds to expect hazdevbroker heartbeats.
 	 */
 	int m_iBrokerHeartbeatInterval;
+
+	/**
+	 * \brief the maximum number of messages to drain from the consumer at once
+	 */
+	int m_iBatchSize;
+
+	/**
+	 * \brief the maximum time in milliseconds to spend draining messages from
+	 * the consumer at once
+	 */
+	int m_iBatchTimeMS;
+
+	/**
+	 * \brief the messages drained from the consumer that have not yet been
+	 * fetched
+	 */
+	std::queue<std::string> m_MessageBatch;
+
+	/**
+	 * \brief the time in milliseconds to wait for the first message of a
+	 * batch
+	 */
+	static const int k_iPollTimeoutMS = 100;
+
+	/**
+	 * \brief the default batch size, one message at a time
+	 */
+	static const int k_iDefaultBatchSize = 1;
+
+	/**
+	 * \brief the default batch time in milliseconds
+	 */
+	static const int k_iDefaultBatchTimeMS = 100;
 };
 }  // namespace glass3
 #endif  // BROKERINPUT_H
@@ -15,11 +15,16 @@
 #include <iostream>
 #include <fstream>
 #include <limits>
+#include <cmath>
+#include <algorithm>
 
 #include "outputTopic.h"
 
 namespace glass3 {
 
+// constants
+constexpr double brokerOutput::k_dTopicIndexCellSize;
+
 // ---------------------------------------------------------brokerOutput
 brokerOutput::brokerOutput()
 		: glass3::output::output() {
@@ -55,12 +60,14 @@ brokerOutput::brokerOutput(const std::shared_ptr<json::Object> &config)
 // ---------------------------------------------------------~brokerOutput
 brokerOutput::~brokerOutput() {
 	// cleanup
+	std::lock_guard<std::mutex> topicGuard(m_TopicMutex);
 	for (auto aTopic : m_vOutputTopics) {
 		if (aTopic != NULL) {
 			delete (aTopic);
 		}
 	}
 	m_vOutputTopics.clear();
+	m_vOutputTopicIndex.clear();
 
 	if(m_StationRequestProducer != NULL) {
 		delete(m_StationRequestProducer);
@@ -167,12 +174,14 @@ bool brokerOutput::setup(std::shared_ptr<const json::Object> config) {
 	}
 
 	// clear out any old topics
+	std::unique_lock<std::mutex> topicLock(m_TopicMutex);
 	for (auto aTopic : m_vOutputTopics) {
 		if (aTopic != NULL) {
 			delete (aTopic);
 		}
 	}
 	m_vOutputTopics.clear();
+	m_vOutputTopicIndex.clear();
 
 	// load the topics from config
 	if ((config->HasKey("OutputTopics"))
@@ -189,15 +198,9 @@ bool brokerOutput::setup(std::shared_ptr<const json::Object> config) {
 
 		// parse topics
 		for (auto aTopicConfig : topics) {
-			// create producer for the topic
-			hazdevbroker::Producer * topicProducer = new hazdevbroker::Producer();
-			topicProducer->setHeartbeatInterval(brokerHeartbeatInterval);
-			topicProducer->setLogCallback(
-					std::bind(&brokerOutput::logProducer, this, std::placeholders::_1));
-			topicProducer->setup(producerConfig, topicConfig);
-
-			// create output topic using the producer
-			outputTopic* newTopic = new outputTopic(topicProducer);
+			// create output topic and its producer
+			outputTopic* newTopic = createOutputTopic(
+					producerConfig, topicConfig, brokerHeartbeatInterval);
 
 			// setup output topic
 			if (newTopic->setup(aTopicConfig) == true) {
@@ -222,6 +225,10 @@ bool brokerOutput::setup(std::shared_ptr<const json::Object> config) {
 		return (false);
 	}
 
+	// index the topics by their bounds
+	indexOutputTopics();
+	topicLock.unlock();
+
 	// optional station lookup
 	std::string stationRequestTopic = "";
 	if (!(config->HasKey("StationRequestTopic"))) {
@@ -294,6 +301,15 @@ void brokerOutput::clear() {
 // ---------------------------------------------------------sendOutput
 void brokerOutput::sendOutput(const std::string &type, const std::string &id,
 								const std::string &message) {
+	// no routing location provided
+	sendOutput(type, id, std::numeric_limits<double>::quiet_NaN(),
+				std::numeric_limits<double>::quiet_NaN(), message);
+}
+
+// ---------------------------------------------------------sendOutput
+void brokerOutput::sendOutput(const std::string &type, const std::string &id,
+								double latitude, double longitude,
+								const std::string &message) {
 	if (type == "") {
 		glass3::util::Logger::log(
 				"error", "fileOutput::sendOutput(): empty type passed in.");
@@ -359,109 +375,51 @@ void brokerOutput::sendOutput(const std::string &type, const std::string &id,
 		}
 	} else {
 		// send everything else out via the output topics
-		sendToOutputTopics(message);
+		sendToOutputTopics(type, id, latitude, longitude, message);
 	}
 }
 
 // ---------------------------------------------------------sendToOutputTopics
-void brokerOutput::sendToOutputTopics(const std::string &message) {
+void brokerOutput::sendToOutputTopics(const std::string &type,
+										const std::string &id, double latitude,
+										double longitude,
+										const std::string &message) {
 	// nullchecks
 	if (message == "") {
 		return;
 	}
 
-	// we need to check the message for it's type (and it's lat/lon if it's
-	// a detection
-	// deserialize the string into JSON
-	json::Value deserializedJSON = json::Deserialize(message);
-
-	// make sure we got valid json
-	if (deserializedJSON.GetType() == json::ValueType::NULLVal) {
-		return;
-	}
-
-	// convert to json object
-	json::Object messageObject = deserializedJSON.ToObject();
-
-	// check type
-	std::string type = "";
-	if (messageObject.HasKey("Type")
-			&& ((messageObject)["Type"].GetType() == json::ValueType::StringVal)) {
-		type = (messageObject)["Type"].ToString();
-	} else {
-		glass3::util::Logger::log(
-				"error",
-				"brokerOutput::sendToOutputTopics: Message missing type.");
-		return;
-	}
-	
-	std::string id = "";
-	if (messageObject.HasKey("ID")
-			&& ((messageObject)["ID"].GetType() == json::ValueType::StringVal)) {
-		id = (messageObject)["ID"].ToString();
-	}
+	std::lock_guard<std::mutex> topicGuard(m_TopicMutex);
 
 	// handle based on type
 	if (type == "Detection") {
 		// detections have a lat/lon to filter which topic to send to
-		// get the hypocenter from the message
-		if ((messageObject.HasKey("Hypocenter"))
-				&& ((messageObject)["Hypocenter"].GetType()
-						== json::ValueType::ObjectVal)) {
-			// get the hypocenter object
-			json::Object hypocenter = (messageObject)["Hypocenter"].ToObject();
-
-			// get latitude from hypocenter
-			double lat = 0;
-			if (hypocenter.HasKey("Latitude")
-					&& (hypocenter["Latitude"].GetType()
-							== json::ValueType::DoubleVal)) {
-				lat = hypocenter["Latitude"].ToDouble();
-			} else {
-				glass3::util::Logger::log(
-						"error",
-						"brokerOutput::sendToOutputTopics: Detection Message "
-						"Hypocenter Latitude");
-
-				return;
-			}
-
-			// get longitude from hypocenter
-			double lon = 0;
-			if (hypocenter.HasKey("Longitude")
-					&& (hypocenter["Longitude"].GetType()
-							== json::ValueType::DoubleVal)) {
-				lon = hypocenter["Longitude"].ToDouble();
-			} else {
-				glass3::util::Logger::log(
-						"error",
-						"brokerOutput::sendToOutputTopics: Detection Message "
-						"Hypocenter Longitude");
-
-				return;
-			}
+		if ((std::isnan(latitude) == true) || (std::isnan(longitude) == true)) {
+			glass3::util::Logger::log(
+					"error",
+					"brokerOutput::sendToOutputTopics: Detection Message "
+					+ id + " missing Hypocenter Latitude or Longitude");
+			return;
+		}
 
-			// for each output topic we have
-			for (auto aTopic : m_vOutputTopics) {
+		// only the topics that overlap the detection's index cell can want
+		// this detection
+		int cell = getTopicIndexCell(latitude, longitude);
+		if (cell < m_vOutputTopicIndex.size()) {
+			for (auto aTopic : m_vOutputTopicIndex[cell]) {
 				// does this topic want this detection
-				if (aTopic->isInBounds(lat, lon) == true) {
+				if (aTopic->isInBounds(latitude, longitude) == true) {
 					// yes, send it
 					aTopic->send(message);
 				}
 			}
-			glass3::util::Logger::log(
-					"debug",
-					"brokerOutput::sendToOutputTopics: Detection Message "
-					+ id +
-					"written to topics");
-		} else {
-			glass3::util::Logger::log(
-					"error",
-					"brokerOutput::sendToOutputTopics: Detection Message missing "
-					"Hypocenter");
-			return;
 		}
-	} else if (type == "Retract") {
+		glass3::util::Logger::log(
+				"debug",
+				"brokerOutput::sendToOutputTopics: Detection Message "
+				+ id +
+				" written to topics");
+	} else if (type == "Retraction") {
 		// retractions don't have a lat/lon, so just send to all topics?
 		// for each topic
 		for (auto aTopic : m_vOutputTopics) {
@@ -473,12 +431,74 @@ void brokerOutput::sendToOutputTopics(const std::string &message) {
 					"debug",
 					"brokerOutput::sendToOutputTopics: Retraction Message "
 					+ id +
-					"written to topics");
+					" written to topics");
 	}
 }
 
+// ---------------------------------------------------------createOutputTopic
+glass3::outputTopic * brokerOutput::createOutputTopic(
+		const std::string &producerConfig, const std::string &topicConfig,
+		int heartbeatInterval) {
+	// create producer for the topic
+	hazdevbroker::Producer * topicProducer = new hazdevbroker::Producer();
+	topicProducer->setHeartbeatInterval(heartbeatInterval);
+	topicProducer->setLogCallback(
+			std::bind(&brokerOutput::logProducer, this, std::placeholders::_1));
+	topicProducer->setup(producerConfig, topicConfig);
+
+	// create output topic using the producer
+	return (new outputTopic(topicProducer));
+}
+
+// ---------------------------------------------------------indexOutputTopics
+void brokerOutput::indexOutputTopics() {
+	int numRows = static_cast<int>(std::ceil(180.0 / k_dTopicIndexCellSize));
+	int numCols = static_cast<int>(std::ceil(360.0 / k_dTopicIndexCellSize));
+
+	m_vOutputTopicIndex.clear();
+	m_vOutputTopicIndex.resize(numRows * numCols);
+
+	for (auto aTopic : m_vOutputTopics) {
+		if (aTopic == NULL) {
+			continue;
+		}
+
+		// the corner cells of the topic bounds, cells are clamped to the
+		// index so that out of range bounds and locations land on the edges
+		int bottomLeft = getTopicIndexCell(aTopic->getBottomLatitude(),
+											aTopic->getLeftLongitude());
+		int topRight = getTopicIndexCell(aTopic->getTopLatitude(),
+											aTopic->getRightLongitude());
+
+		// add the topic to every cell it overlaps
+		for (int row = bottomLeft / numCols; row <= topRight / numCols; row++) {
+			for (int col = bottomLeft % numCols; col <= topRight % numCols;
+					col++) {
+				m_vOutputTopicIndex[row * numCols + col].push_back(aTopic);
+			}
+		}
+	}
+}
+
+// ---------------------------------------------------------getTopicIndexCell
+int brokerOutput::getTopicIndexCell(double lat, double lon) {
+	int numRows = static_cast<int>(std::ceil(180.0 / k_dTopicIndexCellSize));
+	int numCols = static_cast<int>(std::ceil(360.0 / k_dTopicIndexCellSize));
+
+	int row = static_cast<int>(std::floor((lat + 90.0) / k_dTopicIndexCellSize));
+	int col = static_cast<int>(std::floor(
+			(lon + 180.0) / k_dTopicIndexCellSize));
+
+	row = std::max(0, std::min(row, numRows - 1));
+	col = std::max(0, std::min(col, numCols - 1));
+
+	return (row * numCols + col);
+}
+
 // ---------------------------------------------------------sendHeartbeat
 void brokerOutput::sendHeartbeat() {
+	std::lock_guard<std::mutex> topicGuard(m_TopicMutex);
+
 	// send heartbeats to each topic
 	// for each topic
 	for (auto aTopic : m_vOutputTopics) {
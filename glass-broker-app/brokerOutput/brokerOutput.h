@@ -113,10 +113,41 @@ class brokerOutput : public glass3::output::output {
 					const std::string &message) override;
 
 	/**
-	 * \brief Sends the provided message to each of the output topics
+	 * \brief output sending function with routing information
+	 *
+	 * The function used output detection data, using the provided type and
+	 * location to route the message without parsing it
+	 *
+	 * \param type - A std::string containing the type of the data message
+	 * \param id - A std::string containing the id of the data message
+	 * \param latitude - A double containing the latitude of the data message
+	 * in degrees, or NaN if the message does not have a location
+	 * \param longitude - A double containing the longitude of the data
+	 * message in degrees, or NaN if the message does not have a location
+	 * \param message - A std::string containing the data message
+	 */
+	void sendOutput(const std::string &type, const std::string &id,
+					double latitude, double longitude,
+					const std::string &message) override;
+
+	/**
+	 * \brief Sends the provided message to the output topics
+	 *
+	 * Detections are sent to the output topics whose bounds contain the
+	 * provided location, found using the output topic index, retractions are
+	 * sent to all output topics.
+	 *
+	 * \param type - A std::string containing the type of the message
+	 * \param id - A std::string containing the id of the message
+	 * \param latitude - A double containing the latitude of the message in
+	 * degrees
+	 * \param longitude - A double containing the longitude of the message in
+	 * degrees
 	 * \param message - A string containing the message
 	 */
-	void sendToOutputTopics(const std::string &message);
+	void sendToOutputTopics(const std::string &type, const std::string &id,
+							double latitude, double longitude,
+							const std::string &message);
 
 	/**
 	 * \brief Send heartbeats
@@ -126,12 +157,68 @@ class brokerOutput : public glass3::output::output {
 	 */
 	void sendHeartbeat() override;
 
+	/**
+	 * \brief Create an output topic
+	 *
+	 * Creates a hazdevbroker::Producer with the provided configuration, and
+	 * an unconfigured output topic that uses it.
+	 *
+	 * \param producerConfig - A std::string containing the producer
+	 * configuration
+	 * \param topicConfig - A std::string containing the topic configuration
+	 * \param heartbeatInterval - An integer containing the producer heartbeat
+	 * interval, -1 for none
+	 * \return Returns a pointer to the new output topic, owned by the caller
+	 */
+	virtual glass3::outputTopic * createOutputTopic(
+			const std::string &producerConfig, const std::string &topicConfig,
+			int heartbeatInterval);
+
+	/**
+	 * \brief Get the output topic index cell containing a location
+	 *
+	 * Locations outside the valid latitude and longitude range are clamped
+	 * to the cells on the edges of the index.
+	 *
+	 * \param lat - A double containing the latitude in degrees
+	 * \param lon - A double containing the longitude in degrees
+	 * \return Returns an integer containing the index cell
+	 */
+	static int getTopicIndexCell(double lat, double lon);
+
+	// constants
+	/**
+	 * \brief The size in degrees of the cells of the output topic index
+	 */
+	static constexpr double k_dTopicIndexCellSize = 10.0;
+
  private:
+	/**
+	 * \brief Build the output topic index
+	 *
+	 * Build the geographic index of the output topics, listing for each cell
+	 * the output topics whose bounds overlap that cell. The topic mutex must
+	 * be held.
+	 */
+	void indexOutputTopics();
+
 	/**
 	 * \brief A vector containing the output topics
 	 */
 	std::vector<glass3::outputTopic*> m_vOutputTopics;
 
+	/**
+	 * \brief A mutex to control access to the output topics and their index,
+	 * which are used by the output thread pool and the work thread
+	 */
+	std::mutex m_TopicMutex;
+
+	/**
+	 * \brief A vector containing, for each cell of the geographic output topic
+	 * index, a vector of the output topics whose bounds overlap that cell
+	 */
+	std::vector<std::vector<glass3::outputTopic*>> m_vOutputTopicIndex;
+
 	/**
 	 * \brief The optional hazdevbroker producer used to send station requests
 	 * to kafka
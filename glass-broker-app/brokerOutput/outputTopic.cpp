@@ -48,20 +48,8 @@ bool outputTopic::setup(const json::Value &config) {
 		return (false);
 	}
 
-	// check producer
-	if (m_OutputProducer == NULL) {
-		glass3::util::Logger::log(
-				"error",
-				"outputTopic::setup(): invalid producer " + m_sTopicName);
-		return (false);
-	}
-
 	// create topic
-	m_OutputTopic = m_OutputProducer->createTopic(m_sTopicName);
-	if (m_OutputTopic == NULL) {
-		glass3::util::Logger::log(
-				"error",
-				"outputTopic::setup(): failed to create topic " + m_sTopicName);
+	if (createTopic() == false) {
 		return (false);
 	}
 
@@ -147,6 +135,28 @@ bool outputTopic::setup(const json::Value &config) {
 	return (true);
 }
 
+// ---------------------------------------------------------createTopic
+bool outputTopic::createTopic() {
+	// check producer
+	if (m_OutputProducer == NULL) {
+		glass3::util::Logger::log(
+				"error",
+				"outputTopic::setup(): invalid producer " + m_sTopicName);
+		return (false);
+	}
+
+	// create topic
+	m_OutputTopic = m_OutputProducer->createTopic(m_sTopicName);
+	if (m_OutputTopic == NULL) {
+		glass3::util::Logger::log(
+				"error",
+				"outputTopic::setup(): failed to create topic " + m_sTopicName);
+		return (false);
+	}
+
+	return (true);
+}
+
 // ---------------------------------------------------------clear
 void outputTopic::clear() {
 	m_dTopLatitude = glass3::util::Geo::k_MaximumLatitude;
@@ -176,6 +186,26 @@ bool outputTopic::isInBounds(double lat, double lon) {
 	return (false);
 }
 
+// ---------------------------------------------------------getTopLatitude
+double outputTopic::getTopLatitude() const {
+	return (m_dTopLatitude);
+}
+
+// ---------------------------------------------------------getBottomLatitude
+double outputTopic::getBottomLatitude() const {
+	return (m_dBottomLatitude);
+}
+
+// ---------------------------------------------------------getLeftLongitude
+double outputTopic::getLeftLongitude() const {
+	return (m_dLeftLongitude);
+}
+
+// ---------------------------------------------------------getRightLongitude
+double outputTopic::getRightLongitude() const {
+	return (m_dRightLongitude);
+}
+
 // ---------------------------------------------------------send
 void outputTopic::send(const std::string &message) {
 	// nullchecks
@@ -38,7 +38,7 @@ class outputTopic {
 	 *
 	 * The destructor for the outputTopic class.
 	 */
-	~outputTopic();
+	virtual ~outputTopic();
 
 	/**
 	 * \brief outputTopic configuration function
@@ -71,13 +71,41 @@ class outputTopic {
 	 */
 	bool isInBounds(double lat, double lon);
 
+	/**
+	 * \brief Gets the top of the bounds rectangle
+	 * \return Returns a double containing the top of the bounds rectangle in
+	 * degrees of latitude
+	 */
+	double getTopLatitude() const;
+
+	/**
+	 * \brief Gets the bottom of the bounds rectangle
+	 * \return Returns a double containing the bottom of the bounds rectangle
+	 * in degrees of latitude
+	 */
+	double getBottomLatitude() const;
+
+	/**
+	 * \brief Gets the left side of the bounds rectangle
+	 * \return Returns a double containing the left side of the bounds
+	 * rectangle in degrees of longitude
+	 */
+	double getLeftLongitude() const;
+
+	/**
+	 * \brief Gets the right side of the bounds rectangle
+	 * \return Returns a double containing the right side of the bounds
+	 * rectangle in degrees of longitude
+	 */
+	double getRightLongitude() const;
+
 	/**
 	 * \brief outputTopic send function
 	 * The function sends the provided message using the producer pointer and
 	 * the configured topic.
 	 * \param message - A string containing the message
 	 */
-	void send(const std::string &message);
+	virtual void send(const std::string &message);
 
 	/**
 	 * \brief outputTopic heartbeat function
@@ -85,9 +113,18 @@ class outputTopic {
 	 * the configured topic. Note that the producer takes care of deciding 
 	 * whether it has been long enough to generate a heartbeat
 	 */
-	void heartbeat();
+	virtual void heartbeat();
 
  protected:
+	/**
+	 * \brief outputTopic topic creation function
+	 *
+	 * The function creates the configured topic using the producer pointer.
+	 * Called by setup() once the topic name is known.
+	 * \return returns true if successful.
+	 */
+	virtual bool createTopic();
+
 	/**
 	 * \brief the top of the bounds rectangle in degrees of latitude.
 	 */
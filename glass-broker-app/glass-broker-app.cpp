@@ -47,6 +47,10 @@
 #include <brokerInput.h>
 #include <brokerOutput.h>
 #include <associator.h>
+#include <metricsregistry.h>
+#include <metricsserver.h>
+#include <instrumentedmutex.h>
+#include <latencytracer.h>
 
 #include <cstdio>
 #include <cstdlib>
@@ -300,6 +304,55 @@ int main(int argc, char* argv[]) {
 		return (1);
 	}
 
+	// serve the metrics to local monitoring, if configured
+	glass3::util::MetricsServer MetricsThread;
+	if (glassConfig.getJSON()->HasKey("MetricsPort")
+			&& ((*glassConfig.getJSON())["MetricsPort"].GetType()
+					== json::ValueType::IntVal)) {
+		int metricsPort = (*glassConfig.getJSON())["MetricsPort"].ToInt();
+		if ((metricsPort > 0) && (MetricsThread.openPort(metricsPort) == true)) {
+			MetricsThread.start();
+		}
+	}
+
+	// periodically write the metrics to a file, if configured
+	if (glassConfig.getJSON()->HasKey("MetricsFile")
+			&& ((*glassConfig.getJSON())["MetricsFile"].GetType()
+					== json::ValueType::StringVal)) {
+		// default to once a minute
+		int metricsInterval = 60;
+		if (glassConfig.getJSON()->HasKey("MetricsIntervalSeconds")
+				&& ((*glassConfig.getJSON())["MetricsIntervalSeconds"].GetType()
+						== json::ValueType::IntVal)) {
+			metricsInterval =
+					(*glassConfig.getJSON())["MetricsIntervalSeconds"].ToInt();
+		}
+
+		glass3::util::MetricsRegistry::getInstance().startDump(
+				(*glassConfig.getJSON())["MetricsFile"].ToString(),
+				metricsInterval);
+	}
+
+	// profile the glasscore locks, if configured
+	if (glassConfig.getJSON()->HasKey("LockProfiling")
+			&& ((*glassConfig.getJSON())["LockProfiling"].GetType()
+					== json::ValueType::BoolVal)
+			&& ((*glassConfig.getJSON())["LockProfiling"].ToBool() == true)) {
+		glass3::util::LockProfile::setEnabled(true);
+		glass3::util::Logger::log("info", "glass-broker-app: Profiling locks.");
+	}
+
+	// trace the pick latency through the pipeline, if configured
+	if (glassConfig.getJSON()->HasKey("PickLatencyTracing")
+			&& ((*glassConfig.getJSON())["PickLatencyTracing"].GetType()
+					== json::ValueType::BoolVal)
+			&& ((*glassConfig.getJSON())["PickLatencyTracing"].ToBool()
+					== true)) {
+		glass3::util::LatencyTracer::setEnabled(true);
+		glass3::util::Logger::log("info",
+									"glass-broker-app: Tracing pick latency.");
+	}
+
 	// create our objects
 	glass3::brokerInput InputThread;
 	glass3::brokerOutput OutputThread;
@@ -382,6 +435,11 @@ int main(int argc, char* argv[]) {
 	InputThread.stop();
 	OutputThread.stop();
 	AssocThread.stop();
+	MetricsThread.stop();
+	glass3::util::MetricsRegistry::getInstance().stopDump();
+	if (glass3::util::LockProfile::getEnabled() == true) {
+		glass3::util::LockProfile::report();
+	}
 
 	return (0);
 }
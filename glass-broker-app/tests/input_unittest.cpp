@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include <brokerInput.h>
+#include <config.h>
+#include <logger.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define CONFIGFILENAME "inputtest.d"
+#define TESTPATH "testdata"
+#define TESTTOPIC "Test-Picks"
+#define BATCHSIZE 50
+#define DATACOUNT 120
+
+// a pick message with the given id
+std::string makePick(int id) {
+	return ("{\"ID\":\"" + std::to_string(id) + "\",\"Phase\":\"P\","
+			"\"Picker\":\"raypicker\",\"Site\":{\"Channel\":\"HHZ\","
+			"\"Location\":\"--\",\"Network\":\"NC\",\"Station\":\"MDPB\"},"
+			"\"Source\":{\"AgencyID\":\"US\",\"Author\":\"glasstest\"},"
+			"\"Time\":\"2014-12-23T00:00:51.854Z\",\"Type\":\"Pick\"}");
+}
+
+// glass3::brokerInput with a local consumer standing in for kafka
+class brokerInputStub : public glass3::brokerInput {
+ public:
+	brokerInputStub()
+			: glass3::brokerInput() {
+		m_iConsumerSetups = 0;
+	}
+
+	~brokerInputStub() {
+	}
+
+	using glass3::brokerInput::getBatchSize;
+	using glass3::brokerInput::getBatchTimeMS;
+
+	// add a message to the local consumer
+	void addMessage(const std::string &message) {
+		std::lock_guard<std::mutex> guard(m_ConsumerMutex);
+		m_ConsumerMessages.push(message);
+	}
+
+	// fetch a batch the way the work thread does
+	int fetchBatch(int maxCount, std::vector<std::string> *messages) {
+		std::string type;
+		return (fetchRawDataBatch(maxCount, messages, &type));
+	}
+
+	int m_iConsumerSetups;
+	std::vector<std::string> m_vTopics;
+
+ protected:
+	bool setupConsumer(const std::string &consumerConfig,
+						const std::string &topicConfig,
+						const std::vector<std::string> &topicList,
+						const std::string &heartbeatDirectory) override {
+		m_iConsumerSetups++;
+		m_vTopics = topicList;
+		return (true);
+	}
+
+	std::string pollConsumer(int timeoutMS) override {
+		{
+			std::lock_guard<std::mutex> guard(m_ConsumerMutex);
+			if (m_ConsumerMessages.empty() == false) {
+				std::string message = m_ConsumerMessages.front();
+				m_ConsumerMessages.pop();
+				return (message);
+			}
+		}
+
+		// nothing waiting, like kafka wait out the timeout
+		std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMS));
+		return ("");
+	}
+
+ private:
+	std::mutex m_ConsumerMutex;
+	std::queue<std::string> m_ConsumerMessages;
+};
+
+// loads the test configuration
+std::shared_ptr<const json::Object> loadConfig() {
+	glass3::util::Config InputConfig(std::string(TESTPATH),
+										std::string(CONFIGFILENAME));
+	return (InputConfig.getJSON());
+}
+
+// tests to see if broker input can be configured
+TEST(BrokerInputTest, Configuration) {
+	glass3::util::Logger::disable();
+
+	brokerInputStub TestInput;
+
+	// one message at a time by default
+	ASSERT_EQ(1, TestInput.getBatchSize())<< "default batch size";
+
+	ASSERT_TRUE(TestInput.setup(loadConfig()))<< "setup";
+	ASSERT_EQ(1, TestInput.m_iConsumerSetups)<< "consumer set up";
+	ASSERT_EQ(1, TestInput.m_vTopics.size())<< "topic count";
+	ASSERT_STREQ(TESTTOPIC, TestInput.m_vTopics[0].c_str())<< "topic";
+	ASSERT_EQ(BATCHSIZE, TestInput.getBatchSize())<< "batch size";
+	ASSERT_EQ(100, TestInput.getBatchTimeMS())<< "batch time";
+	ASSERT_EQ(1000, TestInput.getInputDataMaxSize())<< "queue max size";
+}
+
+// tests that drained messages are handed off as batches
+TEST(BrokerInputTest, Batch) {
+	glass3::util::Logger::disable();
+
+	brokerInputStub TestInput;
+	ASSERT_TRUE(TestInput.setup(loadConfig()))<< "setup";
+
+	for (int i = 0; i < DATACOUNT; i++) {
+		TestInput.addMessage(makePick(i));
+	}
+
+	// only as much of a drained batch as there is room for
+	std::vector<std::string> messages;
+	ASSERT_EQ(20, TestInput.fetchBatch(20, &messages))<< "limited batch";
+
+	// the rest of the batch is handed off without draining more
+	ASSERT_EQ(BATCHSIZE - 20, TestInput.fetchBatch(1000, &messages))
+	<< "rest of batch";
+
+	// a whole drained batch at once
+	ASSERT_EQ(BATCHSIZE, TestInput.fetchBatch(1000, &messages))
+	<< "second batch";
+	ASSERT_EQ(DATACOUNT - (2 * BATCHSIZE),
+				TestInput.fetchBatch(1000, &messages))<< "last batch";
+	ASSERT_EQ(0, TestInput.fetchBatch(1000, &messages))<< "no more";
+
+	// in consumer order
+	ASSERT_EQ(DATACOUNT, messages.size())<< "message count";
+	for (int i = 0; i < DATACOUNT; i++) {
+		ASSERT_STREQ(makePick(i).c_str(), messages[i].c_str())<< "order";
+	}
+}
+
+// tests that the work thread parses drained messages in order
+TEST(BrokerInputTest, Run) {
+	glass3::util::Logger::disable();
+
+	brokerInputStub TestInput;
+	ASSERT_TRUE(TestInput.setup(loadConfig()))<< "setup";
+
+	for (int i = 0; i < DATACOUNT; i++) {
+		TestInput.addMessage(makePick(i));
+	}
+
+	TestInput.start();
+
+	// wait a bit for the messages to process
+	std::this_thread::sleep_for(std::chrono::seconds(1));
+
+	ASSERT_EQ(DATACOUNT, TestInput.getInputDataCount())<< "queue size";
+	for (int i = 0; i < DATACOUNT; i++) {
+		std::shared_ptr<json::Object> data = TestInput.getInputData();
+		ASSERT_TRUE(data != NULL)<< "data";
+		ASSERT_STREQ(std::to_string(i).c_str(),
+						(*data)["ID"].ToString().c_str())<< "order";
+	}
+
+	TestInput.stop();
+}
@@ -0,0 +1,243 @@
+#include <gtest/gtest.h>
+#include <brokerOutput.h>
+#include <outputTopic.h>
+#include <config.h>
+#include <logger.h>
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define CONFIGFILENAME "outputtest.d"
+#define TESTPATH "testdata"
+#define NUMTOPICS 4
+#define WORLDTOPIC 0
+#define SPANTOPIC 1
+#define NORTHEASTTOPIC 2
+#define SOUTHWESTTOPIC 3
+#define DETECTIONID "DB277841F26BB84089FE877BAAB85084"
+#define DETECTIONMESSAGE "{\"Type\":\"Detection\"}"
+#define RETRACTIONMESSAGE "{\"Type\":\"Retract\"}"
+
+// glass3::outputTopic that keeps what it is sent instead of producing it
+class outputTopicStub : public glass3::outputTopic {
+ public:
+	outputTopicStub()
+			: glass3::outputTopic(NULL) {
+		m_iHeartbeats = 0;
+	}
+
+	~outputTopicStub() {
+	}
+
+	void send(const std::string &message) override {
+		m_vMessages.push_back(message);
+	}
+
+	void heartbeat() override {
+		m_iHeartbeats++;
+	}
+
+	std::string getName() const {
+		return (m_sTopicName);
+	}
+
+	std::vector<std::string> m_vMessages;
+	int m_iHeartbeats;
+
+ protected:
+	bool createTopic() override {
+		return (true);
+	}
+};
+
+// glass3::brokerOutput with local topics standing in for kafka
+class brokerOutputStub : public glass3::brokerOutput {
+ public:
+	brokerOutputStub()
+			: glass3::brokerOutput() {
+	}
+
+	~brokerOutputStub() {
+	}
+
+	using glass3::brokerOutput::sendOutput;
+	using glass3::brokerOutput::sendHeartbeat;
+	using glass3::brokerOutput::getTopicIndexCell;
+	using glass3::brokerOutput::k_dTopicIndexCellSize;
+
+	// how many messages each topic was sent
+	std::vector<int> getMessageCounts() {
+		std::vector<int> counts;
+		for (auto aTopic : m_vTopics) {
+			counts.push_back(aTopic->m_vMessages.size());
+		}
+		return (counts);
+	}
+
+	// the topics, owned by the brokerOutput
+	std::vector<outputTopicStub*> m_vTopics;
+
+ protected:
+	glass3::outputTopic * createOutputTopic(const std::string &producerConfig,
+											const std::string &topicConfig,
+											int heartbeatInterval) override {
+		outputTopicStub * newTopic = new outputTopicStub();
+		m_vTopics.push_back(newTopic);
+		return (newTopic);
+	}
+};
+
+// loads the test configuration
+std::shared_ptr<const json::Object> loadOutputConfig() {
+	glass3::util::Config OutputConfig(std::string(TESTPATH),
+										std::string(CONFIGFILENAME));
+	return (OutputConfig.getJSON());
+}
+
+// sends a detection and returns how many messages each topic was sent
+std::vector<int> sendDetection(brokerOutputStub *output, double latitude,
+								double longitude) {
+	std::vector<int> before = output->getMessageCounts();
+	output->sendOutput("Detection", DETECTIONID, latitude, longitude,
+						DETECTIONMESSAGE);
+	std::vector<int> after = output->getMessageCounts();
+
+	std::vector<int> sent;
+	for (int i = 0; i < after.size(); i++) {
+		sent.push_back(after[i] - before[i]);
+	}
+	return (sent);
+}
+
+// tests to see if broker output can be configured
+TEST(BrokerOutputTest, Configuration) {
+	glass3::util::Logger::disable();
+
+	brokerOutputStub TestOutput;
+	ASSERT_TRUE(TestOutput.setup(loadOutputConfig()))<< "setup";
+
+	ASSERT_EQ(NUMTOPICS, TestOutput.m_vTopics.size())<< "topic count";
+	ASSERT_STREQ("World", TestOutput.m_vTopics[WORLDTOPIC]->getName().c_str())
+	<< "world topic";
+	ASSERT_EQ(25.0, TestOutput.m_vTopics[SPANTOPIC]->getTopLatitude())
+	<< "span top";
+	ASSERT_EQ(-125.0, TestOutput.m_vTopics[SPANTOPIC]->getLeftLongitude())
+	<< "span left";
+	ASSERT_EQ(5.0, TestOutput.m_vTopics[SPANTOPIC]->getBottomLatitude())
+	<< "span bottom";
+	ASSERT_EQ(-95.0, TestOutput.m_vTopics[SPANTOPIC]->getRightLongitude())
+	<< "span right";
+}
+
+// tests the output topic index cells
+TEST(BrokerOutputTest, IndexCells) {
+	glass3::util::Logger::disable();
+
+	int numCols = 360.0 / brokerOutputStub::k_dTopicIndexCellSize;
+	int numCells = numCols * (180.0 / brokerOutputStub::k_dTopicIndexCellSize);
+
+	// the corners
+	ASSERT_EQ(0, brokerOutputStub::getTopicIndexCell(-90.0, -180.0))
+	<< "bottom left";
+	ASSERT_EQ(numCols - 1, brokerOutputStub::getTopicIndexCell(-90.0, 180.0))
+	<< "bottom right";
+	ASSERT_EQ(numCells - numCols,
+				brokerOutputStub::getTopicIndexCell(90.0, -180.0))
+	<< "top left";
+	ASSERT_EQ(numCells - 1, brokerOutputStub::getTopicIndexCell(90.0, 180.0))
+	<< "top right";
+
+	// cells are half open, the next cell starts on the boundary
+	ASSERT_EQ(numCols * 9 + 18, brokerOutputStub::getTopicIndexCell(0.0, 0.0))
+	<< "origin";
+	ASSERT_EQ(numCols * 8 + 17,
+				brokerOutputStub::getTopicIndexCell(-0.001, -0.001))
+	<< "below origin";
+
+	// out of range locations land on the edges
+	ASSERT_EQ(numCells - 1, brokerOutputStub::getTopicIndexCell(95.0, 200.0))
+	<< "above range";
+	ASSERT_EQ(0, brokerOutputStub::getTopicIndexCell(-95.0, -200.0))
+	<< "below range";
+}
+
+// tests that detections are routed to the topics that want them
+TEST(BrokerOutputTest, DetectionRouting) {
+	glass3::util::Logger::disable();
+
+	brokerOutputStub TestOutput;
+	ASSERT_TRUE(TestOutput.setup(loadOutputConfig()))<< "setup";
+
+	// in the middle of a topic that spans several cells
+	std::vector<int> sent = sendDetection(&TestOutput, 15.0, -110.0);
+	ASSERT_EQ(1, sent[WORLDTOPIC])<< "middle world";
+	ASSERT_EQ(1, sent[SPANTOPIC])<< "middle span";
+	ASSERT_EQ(0, sent[NORTHEASTTOPIC])<< "middle northeast";
+	ASSERT_EQ(0, sent[SOUTHWESTTOPIC])<< "middle southwest";
+
+	// in the opposite corner cells of the spanning topic
+	sent = sendDetection(&TestOutput, 5.0, -125.0);
+	ASSERT_EQ(1, sent[SPANTOPIC])<< "span bottom left";
+	sent = sendDetection(&TestOutput, 25.0, -95.0);
+	ASSERT_EQ(1, sent[SPANTOPIC])<< "span top right";
+
+	// in a cell of the spanning topic, but outside its bounds
+	sent = sendDetection(&TestOutput, 27.0, -110.0);
+	ASSERT_EQ(1, sent[WORLDTOPIC])<< "outside world";
+	ASSERT_EQ(0, sent[SPANTOPIC])<< "outside span";
+
+	// on the edges of the world
+	sent = sendDetection(&TestOutput, 90.0, 180.0);
+	ASSERT_EQ(1, sent[WORLDTOPIC])<< "top right world";
+	ASSERT_EQ(1, sent[NORTHEASTTOPIC])<< "top right northeast";
+	ASSERT_EQ(0, sent[SOUTHWESTTOPIC])<< "top right southwest";
+
+	sent = sendDetection(&TestOutput, -90.0, -180.0);
+	ASSERT_EQ(1, sent[WORLDTOPIC])<< "bottom left world";
+	ASSERT_EQ(0, sent[NORTHEASTTOPIC])<< "bottom left northeast";
+	ASSERT_EQ(1, sent[SOUTHWESTTOPIC])<< "bottom left southwest";
+
+	sent = sendDetection(&TestOutput, 85.0, -180.0);
+	ASSERT_EQ(1, sent[WORLDTOPIC])<< "top left world";
+	ASSERT_EQ(0, sent[NORTHEASTTOPIC])<< "top left northeast";
+	ASSERT_EQ(0, sent[SOUTHWESTTOPIC])<< "top left southwest";
+
+	// detections without a location aren't sent anywhere
+	double nan = std::numeric_limits<double>::quiet_NaN();
+	sent = sendDetection(&TestOutput, nan, -110.0);
+	for (int i = 0; i < NUMTOPICS; i++) {
+		ASSERT_EQ(0, sent[i])<< "nan latitude";
+	}
+	sent = sendDetection(&TestOutput, 15.0, nan);
+	for (int i = 0; i < NUMTOPICS; i++) {
+		ASSERT_EQ(0, sent[i])<< "nan longitude";
+	}
+	std::vector<int> before = TestOutput.getMessageCounts();
+	TestOutput.sendOutput("Detection", DETECTIONID, DETECTIONMESSAGE);
+	ASSERT_TRUE(before == TestOutput.getMessageCounts())<< "no location";
+
+	ASSERT_STREQ(DETECTIONMESSAGE,
+					TestOutput.m_vTopics[WORLDTOPIC]->m_vMessages[0].c_str())
+	<< "message";
+}
+
+// tests that retractions and heartbeats go to every topic
+TEST(BrokerOutputTest, Broadcast) {
+	glass3::util::Logger::disable();
+
+	brokerOutputStub TestOutput;
+	ASSERT_TRUE(TestOutput.setup(loadOutputConfig()))<< "setup";
+
+	TestOutput.sendOutput("Retraction", DETECTIONID, RETRACTIONMESSAGE);
+	TestOutput.sendHeartbeat();
+	for (int i = 0; i < NUMTOPICS; i++) {
+		ASSERT_EQ(1, TestOutput.m_vTopics[i]->m_vMessages.size())
+		<< "retraction";
+		ASSERT_STREQ(RETRACTIONMESSAGE,
+						TestOutput.m_vTopics[i]->m_vMessages[0].c_str())
+		<< "retraction message";
+		ASSERT_EQ(1, TestOutput.m_vTopics[i]->m_iHeartbeats)<< "heartbeat";
+	}
+}
@@ -8,6 +8,7 @@
 #define GLASS_H
 
 #include <json.h>
+#include <instrumentedmutex.h>
 #include <TTT.h>
 #include <TravelTime.h>
 #include <string>
@@ -285,6 +286,37 @@ class CGlass {
 	 */
 	static void setMinimizeTTLocator(bool use);
 
+	/**
+	 * \brief Gets the maximum number of gradient refinement iterations run
+	 * after a shortened anneal when locating a hypo, 0 indicates refinement is
+	 * disabled
+	 * \return Returns an integer containing the number of refinement
+	 * iterations
+	 */
+	static int getLocatorRefinementIterations();
+
+	/**
+	 * \brief Sets the maximum number of gradient refinement iterations run
+	 * after a shortened anneal when locating a hypo, 0 disables refinement
+	 * \param iterations - An integer containing the number of refinement
+	 * iterations
+	 */
+	static void setLocatorRefinementIterations(int iterations);
+
+	/**
+	 * \brief Gets the seed used to make hypo locations reproducible
+	 * \return Returns an integer containing the locator random seed, a
+	 * negative value means the locator is randomly seeded
+	 */
+	static int getLocatorRandomSeed();
+
+	/**
+	 * \brief Sets the seed used to make hypo locations reproducible
+	 * \param seed - An integer containing the locator random seed, a negative
+	 * value to randomly seed the locator
+	 */
+	static void setLocatorRandomSeed(int seed);
+
 	/**
 	 * \brief Get the maximum number of sites link to a node
 	 * \return Returns an integer containing the maximum number of sites link to
@@ -428,6 +460,22 @@ class CGlass {
 	 */
 	static bool getAllowPickUpdates();
 
+	/**
+	 * \brief Gets a boolean flag indicating whether nodes nucleate from
+	 * incrementally maintained pick stacks rather than by scanning the picks
+	 * at each linked site
+	 */
+	static bool getIncrementalNucleation();
+
+	/**
+	 * \brief Sets a boolean flag indicating whether nodes nucleate from
+	 * incrementally maintained pick stacks rather than by scanning the picks
+	 * at each linked site
+	 * \param incremental - A boolean flag indicating whether to use
+	 * incremental nucleation
+	 */
+	static void setIncrementalNucleation(bool incremental);
+
 	/**
 	 * \brief Gets the optional threshold used for accepting the classification
 	 * of a pick as noise by an external algorithm. -1 indicates this feature is 
@@ -735,6 +783,18 @@ class CGlass {
 	 */
 	static std::atomic<bool> m_bMinimizeTTLocator;
 
+	/**
+	 * \brief The maximum number of gradient refinement iterations run after a
+	 * shortened anneal when locating a hypo, 0 to disable
+	 */
+	static std::atomic<int> m_iLocatorRefinementIterations;
+
+	/**
+	 * \brief The seed combined with each hypo's starting location to seed
+	 * its annealing locator, negative for a random seed
+	 */
+	static std::atomic<int> m_iLocatorRandomSeed;
+
 	/**
 	 * \brief number of data required for reporting a hypo
 	 */
@@ -764,6 +824,12 @@ class CGlass {
 	 */
 	static std::atomic<bool> m_bAllowPickUpdates;
 
+	/**
+	 * \brief The boolean flag indicating whether nodes nucleate from
+	 * incrementally maintained pick stacks
+	 */
+	static std::atomic<bool> m_bIncrementalNucleation;
+
 	/**
 	 * \brief The probability threshold for accepting the pick noise 
 	 * classification, phases that meet this threshold will be rejected
@@ -869,9 +935,11 @@ class CGlass {
 	static std::shared_ptr<traveltime::CTTT> m_pAssociationTravelTimes;
 
 	/**
-	 * \brief the std::mutex for traveltimes
+	 * \brief the mutex for traveltimes
+	 * Instrumented so that its contention can be profiled, see
+	 * glass3::util::LockProfile.
 	 */
-	static std::mutex m_TTTMutex;
+	static glass3::util::InstrumentedMutex m_TTTMutex;
 
 	// constants
 	/**
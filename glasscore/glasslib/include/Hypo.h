@@ -9,11 +9,14 @@
 
 #include <json.h>
 #include <geo.h>
+#include <randomstream.h>
+#include <instrumentedmutex.h>
 #include <memory>
 #include <string>
 #include <vector>
 #include <mutex>
 #include <atomic>
+#include <unordered_map>
 #include "TTT.h"
 
 namespace glasscore {
@@ -22,6 +25,7 @@ namespace glasscore {
 class CPick;
 class CCorrelation;
 class CTrigger;
+class CSite;
 class CSiteList;
 class CHypoList;
 
@@ -48,6 +52,23 @@ typedef struct _HypoAuditingPerformanceStruct {
 	double dDepthPrev;
 } HypoAuditingPerformanceStruct;
 
+/**
+ * \brief glasscore hypo site cache structure
+ *
+ * The HypoSiteCacheStruct struct is used to hold the geometry and association
+ * travel times between a hypo's current location and a site, so that
+ * evaluating many picks from the same site does not repeat them
+ */
+typedef struct _HypoSiteCacheStruct {
+	std::weak_ptr<CSite> wpSite;
+	double dSiteLatitude;
+	double dSiteLongitude;
+	double dDistance;
+	double dAzimuth;
+	double dSiteAzimuth;
+	double adTravelTimes[traveltime::CTTT::k_iMaximumNumberOfTravelTimes];
+} HypoSiteCacheStruct;
+
 /**
  * \brief glasscore hypocenter class
  *
@@ -66,9 +87,9 @@ typedef struct _HypoAuditingPerformanceStruct {
  * calculations.
  *
  * The glasscore location algorithm consists of the CHypo anneal(), localize(),
- * annealingLocateBayes(), annealingLocateResidual(), calculateBayes(), and
- * calculateAbsResidualSum() functions, along with the various statistical
- * calculations.
+ * annealingLocateBayes(), annealingLocateResidual(), refineLocation(),
+ * calculateBayes(), and calculateAbsResidualSum() functions, along with the
+ * various statistical calculations.
  *
  * CHypo uses smart pointers (std::shared_ptr).
  */
@@ -436,6 +457,17 @@ class CHypo {
 	 */
 	double calculateDistanceToPick(std::shared_ptr<CPick> pick);
 
+	/**
+	 * \brief Get the number of sites in the site cache
+	 *
+	 * Gets the number of sites whose geometry and travel times are cached for
+	 * the current hypo location, used by canAssociate(), calculateResidual(),
+	 * calculateDistanceToPick(), and getTravelTimeForPhase().
+	 *
+	 * \return Returns an integer containing the number of cached sites
+	 */
+	int getSiteCacheSize() const;
+
 	/**
 	 * \brief Calculates the residual of a pick to this hypo
 	 *
@@ -572,7 +604,8 @@ class CHypo {
 	 * This function calculates the current location of this hypo given the
 	 * supporting data using either a maximum baysian fit (annealingLocateBayes)
 	 * or minimum residual (annealingLocateResidual) depending on the
-	 * configuration
+	 * configuration. If refinement iterations are configured, the anneal is
+	 * shortened and followed by gradient refinement (refineLocation)
 	 *
 	 * Also computes supporting data statistics by calling calculateStatistics()
 	 *
@@ -620,6 +653,22 @@ class CHypo {
 									double tStart, double tStop, bool nucleate =
 											false);
 
+	/**
+	 * \brief Gradient location refinement algorithm
+	 *
+	 * Locator which refines the current location using damped least squares
+	 * (Levenberg-Marquardt) steps built from the travel time derivatives of
+	 * the supporting data. A step is only kept if it improves the bayesian
+	 * fit (or the sum of absolute residuals if the minimizing travel time
+	 * locator is configured), so refinement never makes a location worse.
+	 * Intended to be run after a (shortened) anneal has found the right basin.
+	 *
+	 * \param nIter - An integer value containing the maximum number of
+	 * iterations
+	 * \return Returns the number of iterations that improved the location
+	 */
+	int refineLocation(int nIter);
+
 	/**
 	 * \brief Calculate gap
 	 *
@@ -874,6 +923,15 @@ class CHypo {
 	 */
 	double getAssociationDistanceCutoff() const;
 
+	/**
+	 * \brief Sets the hypo list this hypo is in, which is told whenever the
+	 * association distance cutoff changes so that it can keep the largest
+	 * cutoff of its hypos without scanning them for every pick
+	 * \param hypoList - A pointer to the CHypoList containing this hypo,
+	 * NULL if it is not in a list
+	 */
+	void setHypoList(CHypoList * hypoList);
+
 	/**
 	 * \brief Gets the distance cutoff factor used in calculating the
 	 * Association Distance Cutoff
@@ -1254,6 +1312,48 @@ class CHypo {
 	 */
 	static const int k_iLocationNumIterationsLarge = 10000;
 
+	/**
+	 * \brief The factor the number of location iterations is divided by when
+	 * the anneal is followed by gradient refinement
+	 */
+	static const int k_iLocationRefinementAnnealReduction = 10;
+
+	/**
+	 * \brief The minimum number of usable picks needed for gradient refinement,
+	 * one per unknown (latitude, longitude, depth, and origin time)
+	 */
+	static const int k_iLocationRefinementMinimumPicks = 4;
+
+	/**
+	 * \brief The initial Levenberg-Marquardt damping used in gradient
+	 * refinement
+	 */
+	static constexpr double k_dLocationRefinementInitialDamping = 0.01;
+
+	/**
+	 * \brief The Levenberg-Marquardt damping above which gradient refinement
+	 * gives up
+	 */
+	static constexpr double k_dLocationRefinementMaximumDamping = 1.0e6;
+
+	/**
+	 * \brief The factor the Levenberg-Marquardt damping is changed by after
+	 * each gradient refinement step
+	 */
+	static constexpr double k_dLocationRefinementDampingFactor = 10.0;
+
+	/**
+	 * \brief The step size in km below which gradient refinement has
+	 * converged
+	 */
+	static constexpr double k_dLocationRefinementMinimumStepKM = 0.01;
+
+	/**
+	 * \brief The number of sigmas beyond which a residual is excluded from
+	 * gradient refinement
+	 */
+	static constexpr double k_dLocationRefinementResidualCutoff = 3.0;
+
 	/**
 	 * \brief The factor for dividing the web resolution when computing the
 	 * location search radius
@@ -1272,6 +1372,14 @@ class CHypo {
 	static constexpr double k_dSearchRadiusFactor = 0.5;
 
  private:
+	/**
+	 * \brief Set the association distance cutoff, telling the hypo list if
+	 * it changed
+	 * \param cutoff - A double containing the new association distance cutoff
+	 * in degrees
+	 */
+	void setAssociationDistanceCutoff(double cutoff);
+
 	/**
 	 * \brief  A std::string with the name of the web used during the nucleation
 	 * process
@@ -1389,6 +1497,12 @@ class CHypo {
 	 */
 	std::atomic<double> m_dAssociationDistanceCutoff;
 
+	/**
+	 * \brief A pointer to the CHypoList containing this hypo, NULL if it is
+	 * not in a list, told when m_dAssociationDistanceCutoff changes
+	 */
+	std::atomic<CHypoList *> m_pHypoList;
+
 	/**
 	 * \brief A std::string containing this hypo's unique identifier
 	 */
@@ -1485,8 +1599,10 @@ class CHypo {
 	 * see: http://www.codingstandard.com/rule/18-3-3-do-not-use-stdrecursive_mutex/
 	 * However a recursive_mutex allows us to maintain the original class
 	 * design as delivered by the contractor.
+	 * Instrumented so that its contention can be profiled, see
+	 * glass3::util::LockProfile.
 	 */
-	mutable std::recursive_mutex m_HypoMutex;
+	mutable glass3::util::InstrumentedRecursiveMutex m_HypoMutex;
 
 	/**
 	 * \brief A mutex to control processing access to CHypo.
@@ -1497,6 +1613,56 @@ class CHypo {
 	 * \brief The auditing structure for this hypo
 	 */
 	HypoAuditingPerformanceStruct m_hapsAudit;
+
+	/**
+	 * \brief Get the cached geometry and travel times for a site
+	 *
+	 * Gets the cache entry for the given site at the current hypo location,
+	 * computing it if needed. The cache is cleared whenever the hypo location
+	 * has changed since it was filled.
+	 *
+	 * \param site - A shared_ptr to the site to get the cache entry for
+	 * \return Returns a pointer to the cache entry, or NULL if the hypo has no
+	 * travel time tables; only valid until the hypo moves
+	 */
+	const HypoSiteCacheStruct * getSiteCache(std::shared_ptr<CSite> site);
+
+	/**
+	 * \brief A std::unordered_map of the cached geometry and travel times for
+	 * the sites evaluated at the current location, keyed by site
+	 */
+	std::unordered_map<CSite *, HypoSiteCacheStruct> m_mSiteCache;
+
+	/**
+	 * \brief A double containing the latitude the site cache was filled at
+	 */
+	double m_dSiteCacheLatitude;
+
+	/**
+	 * \brief A double containing the longitude the site cache was filled at
+	 */
+	double m_dSiteCacheLongitude;
+
+	/**
+	 * \brief A double containing the depth the site cache was filled at
+	 */
+	double m_dSiteCacheDepth;
+
+	/**
+	 * \brief Seed the annealing random stream
+	 *
+	 * When CGlass::getLocatorRandomSeed() is not negative, seeds
+	 * m_RandomStream from the locator seed and the current hypo location,
+	 * origin time, and pick count, so that an anneal from the same state
+	 * always takes the same steps. Otherwise the stream is left as is.
+	 */
+	void seedRandomStream();
+
+	/**
+	 * \brief The random stream used for the annealing locator steps, owned by
+	 * the hypo so that it is not shared between threads
+	 */
+	glass3::util::RandomStream m_RandomStream;
 };
 }  // namespace glasscore
 #endif  // HYPO_H
@@ -66,6 +66,22 @@ struct HypoCompare {
  */
 class CHypoList : public glass3::util::ThreadBaseClass {
  public:
+	/**
+	 * \brief The timed stages of processHypo(), see getProcessingStageTimes()
+	 */
+	enum ProcessingStage {
+		Localize = 0, /**< Locating the hypo */
+		Merge = 1, /**< Merging the hypo with nearby hypos */
+		Scavenge = 2, /**< Scavenging picks and correlations */
+		Prune = 3, /**< Pruning picks and correlations */
+		Resolve = 4, /**< Resolving picks shared with other hypos */
+		Cancel = 5, /**< Checking whether to cancel the hypo */
+		Remove = 6, /**< Removing a canceled hypo */
+		Report = 7, /**< Checking whether to report the hypo */
+		Trap = 8, /**< Checking for a trapped hypo */
+		Evolve = 9 /**< The whole of processHypo() */
+	};
+
 	/**
 	 * \brief CHypoList constructor
 	 *
@@ -188,6 +204,36 @@ class CHypoList : public glass3::util::ThreadBaseClass {
 	 */
 	int getHypoProcessingQueueLength();
 
+	/**
+	 * \brief Mark the largest association distance cutoff of the hypos in
+	 * the list as out of date, so it is recomputed the next time data is
+	 * associated. Called by hypos in the list when their cutoff changes.
+	 */
+	void invalidateMaxAssociationDistanceCutoff();
+
+	/**
+	 * \brief Get the total time spent in each stage of hypocenter processing
+	 *
+	 * Get the total time spent by all of this list's threads in each stage
+	 * of processHypo(), keyed by stage name (localize, merge, scavenge,
+	 * prune, resolve, cancel, remove, report, trap, and evolve for the
+	 * whole of processHypo())
+	 *
+	 * \return Returns a std::map of stage names to doubles containing the
+	 * total time spent in that stage in seconds
+	 */
+	std::map<std::string, double> getProcessingStageTimes();
+
+	/**
+	 * \brief Get the name of a processHypo() stage
+	 *
+	 * \param stage - The stage to get the name of
+	 * \return Returns a std::string containing the name of the stage, used to
+	 * key getProcessingStageTimes() and to name the stage's
+	 * "hypolist.<name>_us" histogram
+	 */
+	static const std::string & getProcessingStageName(ProcessingStage stage);
+
 	/**
 	 * \brief Get list of CHypos in given time range
 	 *
@@ -200,6 +246,30 @@ class CHypoList : public glass3::util::ThreadBaseClass {
 	 */
 	std::vector<std::weak_ptr<CHypo>> getHypos(double t1, double t2);
 
+	/**
+	 * \brief Get list of CHypos in given time range and distance
+	 *
+	 * Get a list of hypocenters with origin time within given range and
+	 * epicenter within the given distance of the given location. Only the
+	 * cells of the space-time hypo index that can contain such hypos are
+	 * searched.
+	 *
+	 * \param t1 - Starting time of selection range
+	 * \param t2 - Ending time of selection range
+	 * \param lat - A double containing the latitude of the selection center
+	 * in degrees
+	 * \param lon - A double containing the longitude of the selection center
+	 * in degrees
+	 * \param maxDistance - A double containing the maximum distance from the
+	 * selection center in degrees, values less than zero or greater than or
+	 * equal to 180 select all hypos in the time range
+	 * \return A vector of std::weak_ptr to CHypos withing range,
+	 * or empty list if none fit in the time range and distance.
+	 */
+	std::vector<std::weak_ptr<CHypo>> getHypos(double t1, double t2,
+												double lat, double lon,
+												double maxDistance);
+
 	/**
 	 * \brief Gets the maximum number of hypocenters this list will hold
 	 * \return Returns an integer containing the maximum number of hypocenters
@@ -331,6 +401,11 @@ class CHypoList : public glass3::util::ThreadBaseClass {
 	 */
 	static constexpr double k_nHypoSearchPastDurationForPick = 3600;
 
+	/**
+	 * \brief The number of timed processHypo() stages
+	 */
+	static const int k_iNumProcessingStages = 10;
+
  private:
 	/**
 	 * \brief A HypoList function that updates the position of the given hypo
@@ -345,6 +420,48 @@ class CHypoList : public glass3::util::ThreadBaseClass {
 	 */
 	void eraseFromMultiset(std::shared_ptr<CHypo> hyp);
 
+	/**
+	 * \brief A HypoList function that adds the given hypo to the space-time
+	 * hypo index using its current location and tSort
+	 * \param hyp - A shared_ptr to the hypo to be indexed
+	 */
+	void addToIndex(std::shared_ptr<CHypo> hyp);
+
+	/**
+	 * \brief A HypoList function that removes the given hypo from the
+	 * space-time hypo index
+	 * \param hyp - A shared_ptr to the hypo to be removed
+	 */
+	void eraseFromIndex(std::shared_ptr<CHypo> hyp);
+
+	/**
+	 * \brief A HypoList function that gets the largest current association
+	 * distance cutoff of all hypos in the list, used to bound the space-time
+	 * hypo index search when associating data
+	 *
+	 * The largest cutoff is cached, and only recomputed after a hypo was
+	 * added or removed, or a hypo's cutoff changed.
+	 * \return Returns a double containing the largest association distance
+	 * cutoff in degrees
+	 */
+	double getMaxAssociationDistanceCutoff();
+
+	/**
+	 * \brief Add to the total time spent in a stage of hypocenter processing
+	 * \param stage - The stage
+	 * \param seconds - A double containing the time spent in the stage in
+	 * seconds
+	 */
+	void addProcessingStageTime(ProcessingStage stage, double seconds);
+
+	/**
+	 * \brief Compute the space-time hypo index cell containing a location
+	 * \param lat - A double containing the latitude in degrees
+	 * \param lon - A double containing the longitude in degrees
+	 * \return Returns an integer containing the index cell
+	 */
+	static int getIndexCell(double lat, double lon);
+
 	/**
 	 * \brief An integer containing the maximum number of hypocenters stored by
 	 * CHypoList
@@ -369,6 +486,17 @@ class CHypoList : public glass3::util::ThreadBaseClass {
 	 */
 	std::mutex m_HypoProcessingQueueMutex;
 
+	/**
+	 * \brief A std::map containing the total time in seconds spent in each
+	 * stage of processHypo(), keyed by stage name
+	 */
+	std::map<std::string, double> m_mProcessingStageTimes;
+
+	/**
+	 * \brief the std::mutex for m_mProcessingStageTimes
+	 */
+	std::mutex m_ProcessingStageTimesMutex;
+
 	/**
 	 * \brief A std::multiset containing each hypo in the list in sequential
 	 * time order from oldest to youngest.
@@ -381,6 +509,34 @@ class CHypoList : public glass3::util::ThreadBaseClass {
 	 */
 	std::map<std::string, std::shared_ptr<CHypo>> m_mHypo;
 
+	/**
+	 * \brief The space-time hypo index, a std::map of std::multisets
+	 * containing each hypo in the list in sequential time order, indexed by
+	 * the integer latitude/longitude cell containing the hypo's epicenter
+	 * when it was last positioned.
+	 */
+	std::map<int, std::multiset<std::shared_ptr<CHypo>, HypoCompare>>
+		m_mHypoIndex;
+
+	/**
+	 * \brief A std::map containing the space-time hypo index cell of each
+	 * hypocenter in CHypoList indexed by the std::string hypo id.
+	 */
+	std::map<std::string, int> m_mHypoIndexCell;
+
+	/**
+	 * \brief A double containing the cached largest association distance
+	 * cutoff of the hypos in the list, valid when
+	 * m_bMaxAssociationDistanceCutoffValid is true
+	 */
+	double m_dMaxAssociationDistanceCutoff;
+
+	/**
+	 * \brief A boolean flag indicating whether
+	 * m_dMaxAssociationDistanceCutoff is up to date
+	 */
+	std::atomic<bool> m_bMaxAssociationDistanceCutoffValid;
+
 	/**
 	 * \brief A recursive_mutex to control threading access to CHypoList.
 	 * NOTE: recursive mutexes are frowned upon, so maybe redesign around it
@@ -426,6 +582,19 @@ class CHypoList : public glass3::util::ThreadBaseClass {
 	 * \brief The tolerance in degrees used to reject adding a new close hypo
 	 */
 	static constexpr double k_dExistingDistanceTolerance = 0.5;
+
+	/**
+	 * \brief The size in degrees of a space-time hypo index cell. Index
+	 * searches are padded by one cell to allow for hypos that have moved
+	 * since they were last positioned.
+	 */
+	static constexpr double k_dIndexCellSize = 15.0;
+
+	/**
+	 * \brief The maximum seismic velocity in km/s along any ray path, used
+	 * to compute the minimum possible travel time to a station.
+	 */
+	static constexpr double k_dMaximumSeismicVelocity = 14.0;
 };
 }  // namespace glasscore
 #endif  // HYPOLIST_H
@@ -8,6 +8,7 @@
 #define NODE_H
 
 #include <geo.h>
+#include <instrumentedmutex.h>
 #include <vector>
 #include <memory>
 #include <string>
@@ -16,6 +17,8 @@
 #include <tuple>
 #include <atomic>
 #include <set>
+#include <map>
+#include <cstdint>
 #include "Link.h"
 
 namespace glasscore {
@@ -169,6 +172,11 @@ class CNode {
 	 * sources are not nuclated. Picks without authors or sources are always
 	 * nuclated.
 	 *
+	 * When incremental nucleation is enabled (see
+	 * CGlass::getIncrementalNucleation()), the candidate picks are read from
+	 * this node's pick stack instead of scanning the picks at every linked
+	 * site.
+	 *
 	 * \param tOrigin - A double value containing the proposed origin time
 	 * to use in Gregorian seconds
 	 * \param parentThread - A pointer to the parent CPickList thread to allow 
@@ -178,6 +186,58 @@ class CNode {
 	 */
 	std::shared_ptr<CTrigger> nucleate(double tOrigin, CPickList* parentThread);
 
+	/**
+	 * \brief Add a pick to this node's pick stack
+	 *
+	 * Stack the provided pick at the origin time implied by each of the
+	 * travel times from the pick's site to this node, replacing any previous
+	 * stacking of the pick. The pick's window and nucleation checks, and the
+	 * residual allowances of its significances, are worked out once here.
+	 * Called by the pick's site when the pick is added, so that nucleation
+	 * can read the candidate picks for an origin time from the stack rather
+	 * than scanning every linked site. A pick that can't nucleate at this
+	 * node is not stacked.
+	 *
+	 * \param pick - A shared_ptr to the CPick to stack
+	 * \param distDeg - A double value containing the distance in degrees
+	 * between the node and the pick's site.
+	 * \param travelTime1 - A double value containing the first travel time
+	 * from the node to the pick's site
+	 * \param phase1 - A std::string containing the first travel time phase code
+	 * \param travelTime2 - A double value containing the second travel time
+	 * from the node to the pick's site, -1 if none
+	 * \param phase2 - A std::string containing the second travel time phase
+	 * code
+	 */
+	void addPickToStack(std::shared_ptr<CPick> pick, double distDeg,
+						double travelTime1, std::string phase1,
+						double travelTime2, std::string phase2);
+
+	/**
+	 * \brief Remove a pick from this node's pick stack
+	 *
+	 * \param pick - A shared_ptr to the CPick to remove
+	 */
+	void removePickFromStack(std::shared_ptr<CPick> pick);
+
+	/**
+	 * \brief Remove all the picks from a site from this node's pick stack
+	 *
+	 * \param site - A shared_ptr to the CSite to remove the picks of
+	 */
+	void removeSiteFromStack(std::shared_ptr<CSite> site);
+
+	/**
+	 * \brief Remove all picks from this node's pick stack
+	 */
+	void clearPickStack();
+
+	/**
+	 * \brief Gets the number of picks in this node's pick stack
+	 * \return Returns an integer containing the number of stacked picks
+	 */
+	int getPickStackCount() const;
+
 	/**
 	 * \brief CNode significance function
 	 *
@@ -196,6 +256,20 @@ class CNode {
 	double getSignificance(double tObservedTT, double travelTime,
 							double distDeg);
 
+	/**
+	 * \brief CNode residual allowance function
+	 *
+	 * Compute the travel time residual allowed before the significance of a
+	 * pick starts to drop, allowing for picks to still be significant even if
+	 * an event is not directly on the node.
+	 *
+	 * \param travelTime - A double value containing the calculated travel time
+	 * \param distDeg - A double value containing the distance between the
+	 * station and the node in degrees
+	 * \return Returns the residual allowance in seconds
+	 */
+	double getResidualAllowance(double travelTime, double distDeg);
+
 	/**
 	 * \brief CNode site used function
 	 *
@@ -314,6 +388,38 @@ class CNode {
 	 */
 	void setWeb(CWeb* web);
 
+	/**
+	 * \brief Gets a flag indicating that the node is part of the coarse level
+	 * of a hierarchical web
+	 *
+	 * Coarse nodes are nucleated against relaxed thresholds, and only to
+	 * decide whether the fine nodes under them are worth nucleating. They
+	 * don't keep a pick stack, they always scan their sites' picks.
+	 * \return Returns a boolean flag, true if the node is coarse, false
+	 * otherwise
+	 */
+	bool getCoarse() const;
+
+	/**
+	 * \brief Sets a flag indicating that the node is part of the coarse level
+	 * of a hierarchical web
+	 * \param coarse - A boolean flag, true if the node is coarse
+	 */
+	void setCoarse(bool coarse);
+
+	/**
+	 * \brief Gets the coarse node this node is under in a hierarchical web
+	 * \return Returns a shared_ptr to the coarse parent node, NULL if this
+	 * node has none
+	 */
+	std::shared_ptr<CNode> getParentNode() const;
+
+	/**
+	 * \brief Sets the coarse node this node is under in a hierarchical web
+	 * \param parent - A shared_ptr to the coarse parent node
+	 */
+	void setParentNode(std::shared_ptr<CNode> parent);
+
 	/**
 	 * \brief Get the maximum site distance for this node
 	 * \return Returns a double containing the maximum site distance for this node
@@ -342,7 +448,171 @@ class CNode {
 	 */
 	void addSource(std::string source);
 
+	/**
+	 * \brief Note that a site linked to this node now has picks
+	 *
+	 * Called by the site when its first pick is added, or when it is linked
+	 * to this node while it has picks.
+	 * \param travelTime1 - A double value containing the first travel time
+	 * from this node to the site
+	 * \param travelTime2 - A double value containing the second travel time
+	 * from this node to the site
+	 */
+	void addActiveSite(double travelTime1, double travelTime2);
+
+	/**
+	 * \brief Note that a site linked to this node no longer has picks
+	 *
+	 * Called by the site when its last pick is removed, or when it is
+	 * unlinked from this node while it has picks.
+	 * \param travelTime1 - A double value containing the first travel time
+	 * from this node to the site
+	 * \param travelTime2 - A double value containing the second travel time
+	 * from this node to the site
+	 */
+	void removeActiveSite(double travelTime1, double travelTime2);
+
+	/**
+	 * \brief Get the number of sites linked to this node that have picks
+	 * \return Returns an integer containing the number of active sites
+	 */
+	int getActiveSiteCount() const;
+
+	/**
+	 * \brief Get the most picks the sites linked to this node that have picks
+	 * could add to a nucleation stack
+	 * \return Returns an integer containing the active pick limit
+	 */
+	int getActivePickLimit() const;
+
+	/**
+	 * \brief Get the most significant picks a site link can add to the stack,
+	 * one per valid travel time
+	 *
+	 * \param travelTime1 - A double value containing the first travel time
+	 * \param travelTime2 - A double value containing the second travel time
+	 * \return Returns an integer containing the maximum number of picks, each
+	 * of which adds a significance of at most 1.0
+	 */
+	static int getMaximumLinkContribution(double travelTime1,
+											double travelTime2);
+
  private:
+	/**
+	 * \brief Stack the best pick at each linked site by scanning the picks at
+	 * each site
+	 *
+	 * Each site's picks are locked once, while they are scanned, and scanning
+	 * stops as soon as the sites left to scan can no longer bring the stack up
+	 * to the thresholds.
+	 *
+	 * \param tOrigin - A double value containing the proposed origin time
+	 * to use in Gregorian seconds
+	 * \param parentThread - A pointer to the parent CPickList thread
+	 * \param countThreshold - An integer containing the count of significant
+	 * picks needed to nucleate
+	 * \param sumThreshold - A double containing the significance sum needed
+	 * to nucleate
+	 * \param sum - A pointer to a double to add the significances to
+	 * \param count - A pointer to an integer to add the count of significant
+	 * picks to
+	 * \param picks - A pointer to a std::vector to add the significant picks
+	 * to
+	 * \param exitedEarly - A pointer to a boolean set to true if stacking
+	 * stopped early because the thresholds could no longer be reached
+	 * \return Returns false if nucleation was halted or stopped early, true
+	 * otherwise
+	 */
+	bool scanSitePicks(double tOrigin, CPickList* parentThread,
+						int countThreshold, double sumThreshold, double *sum,
+						int *count, std::vector<std::shared_ptr<CPick>> *picks,
+						bool *exitedEarly);
+
+	/**
+	 * \brief Stack the best pick at each linked site by reading the picks
+	 * stacked in this node's pick stack for the origin time
+	 *
+	 * \param tOrigin - A double value containing the proposed origin time
+	 * to use in Gregorian seconds
+	 * \param parentThread - A pointer to the parent CPickList thread
+	 * \param countThreshold - An integer containing the count of significant
+	 * picks needed to nucleate
+	 * \param sumThreshold - A double containing the significance sum needed
+	 * to nucleate
+	 * \param sum - A pointer to a double to add the significances to
+	 * \param count - A pointer to an integer to add the count of significant
+	 * picks to
+	 * \param picks - A pointer to a std::vector to add the significant picks
+	 * to
+	 * \param exitedEarly - A pointer to a boolean set to true if stacking
+	 * stopped early because the thresholds could no longer be reached
+	 * \return Returns false if nucleation was halted or stopped early, true
+	 * otherwise
+	 */
+	bool readPickStack(double tOrigin, CPickList* parentThread,
+						int countThreshold, double sumThreshold, double *sum,
+						int *count, std::vector<std::shared_ptr<CPick>> *picks,
+						bool *exitedEarly);
+
+	/**
+	 * \brief Compute the window of pick times to nucleate with for an origin
+	 * time and the travel times to a site
+	 *
+	 * \param tOrigin - A double value containing the proposed origin time
+	 * \param travelTime1 - A double value containing the first travel time
+	 * \param travelTime2 - A double value containing the second travel time
+	 * \param min - A pointer to a double to hold the window start
+	 * \param max - A pointer to a double to hold the window end
+	 * \param excludeBegin - A pointer to a double to hold the start of the
+	 * window between the travel times to exclude, 0 if none
+	 * \param excludeEnd - A pointer to a double to hold the end of the
+	 * window between the travel times to exclude
+	 * \return Returns false if there are no valid travel times, true otherwise
+	 */
+	bool getPickWindow(double tOrigin, double travelTime1, double travelTime2,
+						double *min, double *max, double *excludeBegin,
+						double *excludeEnd);
+
+	/**
+	 * \brief Check whether a pick's source, beam, and classifications allow
+	 * it to nucleate at this node
+	 *
+	 * \param pick - A shared_ptr to the CPick to check
+	 * \param phase1 - A std::string containing the first travel time phase
+	 * \param phase2 - A std::string containing the second travel time phase
+	 * \param phase1set - A pointer to a boolean set to true if the pick is
+	 * classified as phase1
+	 * \param phase2set - A pointer to a boolean set to true if the pick is
+	 * classified as phase2
+	 * \return Returns true if the pick can nucleate, false otherwise
+	 */
+	bool checkPickForNucleation(std::shared_ptr<CPick> pick,
+								const std::string &phase1,
+								const std::string &phase2, bool *phase1set,
+								bool *phase2set);
+
+	/**
+	 * \brief Remove a pick from the pick stack, the caller must hold
+	 * m_PickStackMutex
+	 *
+	 * \param pick - A pointer to the CPick to remove
+	 */
+	void eraseFromPickStack(const CPick * pick);
+
+	/**
+	 * \brief Compute a significance given an already computed residual
+	 * allowance, see getSignificance()
+	 *
+	 * \param tObservedTT - A double value containing the observed travel time
+	 * \param travelTime - A double value containing the calculated travel time
+	 * \param residualAllowance - A double value containing the residual
+	 * allowance for the travel time
+	 * \return Returns the significance
+	 */
+	static double getSignificanceWithAllowance(double tObservedTT,
+												double travelTime,
+												double residualAllowance);
+
 	/**
 	 * \brief A pointer to the parent CWeb class, used get configuration,
 	 * values
@@ -395,6 +665,19 @@ class CNode {
 	 */
 	std::atomic<double> m_dResolution;
 
+	/**
+	 * \brief A boolean flag indicating whether this node is part of the
+	 * coarse level of a hierarchical web
+	 */
+	std::atomic<bool> m_bCoarse;
+
+	/**
+	 * \brief A std::weak_ptr to the coarse node this node is under in a
+	 * hierarchical web, a weak_ptr is used so that the fine nodes don't keep
+	 * a removed coarse node alive
+	 */
+	std::weak_ptr<CNode> m_wpParentNode;
+
 	/**
 	 * \brief A boolean flag indicating whether this node is enabled for
 	 * nucleation. Nodes are disabled when they are being reconfigured.
@@ -424,8 +707,125 @@ class CNode {
 	 * see: http://www.codingstandard.com/rule/18-3-3-do-not-use-stdrecursive_mutex/
 	 * However a recursive_mutex allows us to maintain the original class
 	 * design as delivered by the contractor.
+	 * Instrumented so that its contention can be profiled, see
+	 * glass3::util::LockProfile.
+	 */
+	mutable glass3::util::InstrumentedRecursiveMutex m_NodeMutex;
+
+	/**
+	 * \brief A pick in the pick stack, along with what nucleation needs to
+	 * know about it at this node
+	 */
+	typedef struct _PickStackEntry {
+		/**
+		 * \brief A shared_ptr to the stacked pick
+		 */
+		std::shared_ptr<CPick> pPick;
+
+		/**
+		 * \brief The link from this node to the pick's site
+		 */
+		SiteLink siteLink;
+
+		/**
+		 * \brief The pick time
+		 */
+		double dPickTime;
+
+		/**
+		 * \brief The residual allowance of the first travel time
+		 */
+		double dResidualAllowance1;
+
+		/**
+		 * \brief The residual allowance of the second travel time
+		 */
+		double dResidualAllowance2;
+
+		/**
+		 * \brief Whether the pick is classified as the first phase
+		 */
+		bool bPhase1Set;
+
+		/**
+		 * \brief Whether the pick is classified as the second phase
+		 */
+		bool bPhase2Set;
+
+		/**
+		 * \brief The earliest origin time with the pick in its pick window
+		 */
+		double dWindowStart;
+
+		/**
+		 * \brief The latest origin time with the pick in its pick window
+		 */
+		double dWindowEnd;
+
+		/**
+		 * \brief Whether some origin times exclude the pick for falling
+		 * between the travel times
+		 */
+		bool bExclude;
+
+		/**
+		 * \brief The earliest origin time excluding the pick
+		 */
+		double dExcludeStart;
+
+		/**
+		 * \brief The origin time after the last one excluding the pick
+		 */
+		double dExcludeEnd;
+
+		/**
+		 * \brief The positions of the pick in m_mmPickStack
+		 */
+		std::vector<std::multimap<double,
+				const struct _PickStackEntry *>::iterator> vStackPositions;
+	} PickStackEntry;
+
+	/**
+	 * \brief A std::multimap of the stacked picks, keyed by the origin time
+	 * implied by each of the travel times to the pick's site. Maintained
+	 * incrementally as picks are added to and removed from the linked sites.
+	 */
+	std::multimap<double, const PickStackEntry *> m_mmPickStack;
+
+	/**
+	 * \brief A std::map of the stacked picks, keyed by pick
+	 */
+	std::map<const CPick *, PickStackEntry> m_mPickStackEntries;
+
+	/**
+	 * \brief A std::map of the stacked picks from each site, keyed by site,
+	 * used to remove a site's picks from the stack
+	 */
+	std::map<const CSite *, std::set<const CPick *>> m_mPickStackSites;
+
+	/**
+	 * \brief The largest distance in seconds between an origin time and a
+	 * stacked pick's implied origin time at which the pick can still be
+	 * significant
+	 */
+	double m_dPickStackRadius;
+
+	/**
+	 * \brief A mutex to control threading access to the pick stack.
 	 */
-	mutable std::recursive_mutex m_NodeMutex;
+	mutable std::mutex m_PickStackMutex;
+
+	/**
+	 * \brief An integer containing the number of sites linked to this node
+	 * that currently have picks, maintained by the sites
+	 */
+	std::atomic<int> m_iActiveSiteCount;
+
+	/**
+	 * \brief An integer containing the most picks the active sites could add
+	 * to a nucleation stack, one per valid travel time to each active site
+	 */
+	std::atomic<int> m_iActivePickLimit;
 
 	// constants
 	/**
@@ -457,6 +857,19 @@ class CNode {
 	 * kitty corner node in a cubiod plus halfway to the next.
 	 */
 	static constexpr double k_residualDistanceAllowanceFactor = 2.;
+
+	/**
+	 * \brief The minimum significance of the best pick at a site for the
+	 * site to count towards nucleation
+	 */
+	static constexpr double k_dSiteSignificanceThreshold = 0.1;
+
+	/**
+	 * \brief The number of sigmas beyond the residual allowance at which a
+	 * pick's significance drops below k_dSiteSignificanceThreshold,
+	 * sqrt(-2 ln(0.1)) rounded up
+	 */
+	static constexpr double k_dPickStackSigmaRange = 2.15;
 };
 }  // namespace glasscore
 #endif  // NODE_H
@@ -21,6 +21,7 @@ class CSite;
 class CHypo;
 class CSiteList;
 class CPickList;
+class CTrigger;
 
 /**
  * \brief glasscore pick class
@@ -232,8 +233,11 @@ class CPick {
 	 *
 	 * Attempt to nucleate a new hypo based on the addition of this pick. By
 	 * scanning all nodes linked to this pick's site, producing a list of
-	 * triggers. Then, for the best trigger for each web, try to generate a new
-	 * hypo, performing a fast location/prune using hypo->anneal
+	 * triggers. The triggers are grouped into clusters of nearby triggers
+	 * (see clusterTriggers), and for the best trigger in each cluster, try to
+	 * generate a new hypo, performing a fast location/prune using
+	 * hypo->anneal. The next best trigger in a cluster is only tried if the
+	 * hypo from the previous one was abandoned.
 	 * \param parentThread - A pointer to the parent CPickList thread to allow 
 	 * nucleate to call the CPickList thread status update function, the owner
 	 * of this pointer is the CPickList object
@@ -241,6 +245,23 @@ class CPick {
 	 */
 	bool nucleate(CPickList* parentThread);
 
+	/**
+	 * \brief Group triggers into clusters of nearby triggers
+	 *
+	 * Triggers are taken in order of decreasing stack value, each trigger
+	 * starts a new cluster unless it is within the web resolution (in
+	 * distance, including depth) and the corresponding origin time tolerance
+	 * of the first, best, trigger of an existing cluster. Such triggers would
+	 * anneal to the same hypo and be merged later anyway.
+	 * \param triggers - A std::vector of the shared_ptrs to the triggers to
+	 * cluster
+	 * \return Returns a std::vector of clusters, in order of decreasing stack
+	 * value, each a std::vector of the shared_ptrs to the triggers in the
+	 * cluster in order of decreasing stack value
+	 */
+	static std::vector<std::vector<std::shared_ptr<CTrigger>>> clusterTriggers(
+			const std::vector<std::shared_ptr<CTrigger>> &triggers);
+
 	/**
 	 * \brief Get the optional back azimuth related to this pick
 	 * \return Returns a double value containing the optional back azimuth, or
@@ -431,6 +452,19 @@ class CPick {
 	void setTNucleation();
 
  private:
+	/**
+	 * \brief Attempt to nucleate a new hypo from a single trigger
+	 *
+	 * Generate a new hypo from the trigger, performing a fast location/prune
+	 * using hypo->anneal, and add it to the hypo list if it survives.
+	 * \param trigger - A shared_ptr to the trigger to nucleate from
+	 * \param parentThread - A pointer to the parent CPickList thread
+	 * \return Returns true if a hypo was added, false if the trigger was
+	 * skipped or the hypo abandoned
+	 */
+	bool nucleateTrigger(std::shared_ptr<CTrigger> trigger,
+							CPickList* parentThread);
+
 	/**
 	 * \brief A std::weak_ptr to a CSite object
 	 * representing the link between this pick and the site it was
@@ -8,6 +8,7 @@
 #define PICKLIST_H
 
 #include <threadbaseclass.h>
+#include <instrumentedmutex.h>
 
 #include <json.h>
 #include <set>
@@ -20,6 +21,7 @@
 #include <queue>
 #include <random>
 #include <atomic>
+#include <chrono>
 
 #include "Glass.h"
 #include "Pick.h"
@@ -200,6 +202,20 @@ class CPickList : public glass3::util::ThreadBaseClass {
 	 */
 	int length() const;
 
+	/**
+	 * \brief Get the current number of picks waiting to be processed
+	 * \return Return an integer containing the current number of picks
+	 * waiting to be processed by this list
+	 */
+	int getPickProcessingQueueLength();
+
+	/**
+	 * \brief Get the total time spent nucleating picks
+	 * \return Return a double containing the total time in seconds spent by
+	 * all of this list's threads nucleating picks
+	 */
+	double getTotalNucleationTime() const;
+
 	/**
 	 * \brief Get a vector of picks that fall within a time window
 	 *
@@ -239,6 +255,15 @@ class CPickList : public glass3::util::ThreadBaseClass {
 	void eraseFromMultiset(std::shared_ptr<CPick> pick);
 
  private:
+	/**
+	 * \brief A PickList function that adds, associates and nucleates a pick
+	 * taken from the processing queue
+	 * \param jsonPick - A shared_ptr to the json::Object containing the pick
+	 * \param tDequeue - The time the pick was taken from the queue
+	 */
+	void processPick(std::shared_ptr<json::Object> jsonPick,
+						std::chrono::steady_clock::time_point tDequeue);
+
 	/**
 	 * \brief A pointer to a CSiteList object containing all the sites for
 	 * lookups
@@ -258,6 +283,12 @@ class CPickList : public glass3::util::ThreadBaseClass {
 	 */
 	int m_iCountOfTotalPicksProcessed;
 
+	/**
+	 * \brief An integer containing the total time in microseconds spent by
+	 * all of this list's threads nucleating picks
+	 */
+	std::atomic<int64_t> m_iTotalNucleationMicroseconds;
+
 	/**
 	 * \brief A std::multiset containing each pick in the list in sequential
 	 * time order from oldest to youngest.
@@ -281,8 +312,10 @@ class CPickList : public glass3::util::ThreadBaseClass {
 	 * see: http://www.codingstandard.com/rule/18-3-3-do-not-use-stdrecursive_mutex/
 	 * However a recursive_mutex allows us to maintain the original class
 	 * design as delivered by the contractor.
+	 * Instrumented so that its contention can be profiled, see
+	 * glass3::util::LockProfile.
 	 */
-	mutable std::recursive_mutex m_PickListMutex;
+	mutable glass3::util::InstrumentedRecursiveMutex m_PickListMutex;
 
 	/**
 	 * \brief A shared_ptr to a pick used to represent the lower value in
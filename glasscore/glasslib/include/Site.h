@@ -195,7 +195,8 @@ class CSite {
 	/**
 	 * \brief Add pick to this site
 	 * This function adds the given pick to the list of picks made at this
-	 * site
+	 * site, and to the pick stacks of the linked nodes if incremental
+	 * nucleation is enabled
 	 *
 	 * \param pck - A shared_ptr to a CPick object containing the pick to add
 	 */
@@ -204,7 +205,8 @@ class CSite {
 	/**
 	 * \brief Remove pick from this site
 	 * This function removes the given pick from the list of picks made at this
-	 * site
+	 * site, and from the pick stacks of the linked nodes if incremental
+	 * nucleation is enabled
 	 *
 	 * \param pck - A shared_ptr to a CPick object containing the pick to remove
 	 */
@@ -228,7 +230,8 @@ class CSite {
 	/**
 	 * \brief Add node to this site
 	 * This function adds the given pick to the list of nodes serviced by this
-	 * site
+	 * site, and when using incremental nucleation stacks the picks this site
+	 * already has at the node
 	 *
 	 * \param node - A shared_ptr to a CNode object containing the node to add
 	 * \param distDeg - A double value containing the distance between the node
@@ -260,6 +263,13 @@ class CSite {
 	 *
 	 * The function uses addTrigger to keep track of triggering nodes
 	 *
+	 * In a hierarchical web, each fine node is skipped unless its coarse node
+	 * came close to triggering, whether or not the coarse node is linked to
+	 * this site. This trades some recall for speed: a fine node can only
+	 * trigger if its coarse node reaches the thresholds scaled by the web's
+	 * coarse threshold factor, which is the margin allowed for the coarse
+	 * node seeing the picks with a poorer fit, or at fewer sites.
+	 *
 	 * \param tpick - A double value containing the pick time to nucleate with
 	 * in Gregorian seconds
 	 * \param parentThread - A pointer to the parent CPickList thread to allow 
@@ -498,6 +508,42 @@ class CSite {
 	 */
 	void eraseFromMultiset(std::shared_ptr<CPick> pick);
 
+	/**
+	 * \brief Add the given pick to the pick stack of each node linked to
+	 * this site, used when incremental nucleation is enabled
+	 * \param pick - A shared_ptr to the pick to be stacked
+	 */
+	void addPickToNodeStacks(std::shared_ptr<CPick> pick);
+
+	/**
+	 * \brief Try to nucleate a new event at a node linked to this site, using
+	 * the first travel time to the node and then, if that does not trigger,
+	 * the second
+	 * \param link - The NodeLink to the node
+	 * \param node - A shared_ptr to the linked node
+	 * \param tPick - A double value containing the pick time to nucleate with
+	 * \param parentThread - A pointer to the parent CPickList thread
+	 * \return Returns a shared_ptr to the CTrigger generated by the node, NULL
+	 * if the node did not trigger
+	 */
+	std::shared_ptr<CTrigger> nucleateNode(const NodeLink &link,
+											std::shared_ptr<CNode> node,
+											double tPick,
+											CPickList* parentThread);
+
+	/**
+	 * \brief Update the active site counts of the nodes linked to this site
+	 * after the site gained its first pick or lost its last one
+	 */
+	void updateNodeActivity();
+
+	/**
+	 * \brief Remove the given pick from the pick stack of each node linked to
+	 * this site, used when incremental nucleation is enabled
+	 * \param pick - A shared_ptr to the pick to be removed
+	 */
+	void removePickFromNodeStacks(std::shared_ptr<CPick> pick);
+
 	/**
 	 * \brief A mutex to control threading access to vPick.
 	 */
@@ -604,6 +650,12 @@ class CSite {
 	 */
 	std::vector<NodeLink> m_vNode;
 
+	/**
+	 * \brief A boolean flag indicating whether the nodes linked to this site
+	 * are counting it as having picks, protected by m_vNodeMutex
+	 */
+	bool m_bHasPicks;
+
 	/**
 	 * \brief A recursive_mutex to control threading access to CSite.
 	 * NOTE: recursive mutexes are frowned upon, so maybe redesign around it
@@ -8,6 +8,8 @@
 #define SITELIST_H
 
 #include <threadbaseclass.h>
+#include <timerservice.h>
+#include <instrumentedmutex.h>
 
 #include <json.h>
 #include <string>
@@ -35,6 +37,11 @@ class CSite;
  * CSiteList contains functions to support new data input and
  * clearing the list
  *
+ * CSiteList checks its sites every hour (of glass3::util::Clock time). A timer
+ * on the shared glass3::util::TimerService flags when the check is due, and
+ * the CSiteList work thread then runs it, keeping the check off the shared
+ * timer thread.
+ *
  * CSiteList uses smart pointers (std::shared_ptr).
  */
 class CSiteList : public glass3::util::ThreadBaseClass {
@@ -231,13 +238,22 @@ class CSiteList : public glass3::util::ThreadBaseClass {
 	/**
 	 * \brief SiteList work function
 	 *
-	 * checks sites
+	 * checks sites once the hourly site check timer has flagged the check as
+	 * due
 	 * \return returns glass3::util::WorkState::OK if work was successful,
 	 * glass3::util::WorkState::Error if not.
 	 */
 	glass3::util::WorkState work() override;
 
  private:
+	/**
+	 * \brief Mark the site check as due
+	 *
+	 * The hourly site check timer callback. The shared timer thread must not
+	 * block, so it only flags the check, which the work thread then runs.
+	 */
+	void checkDue();
+
 	/**
 	 * \brief A std::vector of all the sites in CSiteList.
 	 */
@@ -261,8 +277,10 @@ class CSiteList : public glass3::util::ThreadBaseClass {
 	 * see: http://www.codingstandard.com/rule/18-3-3-do-not-use-stdrecursive_mutex/
 	 * However a recursive_mutex allows us to maintain the original class
 	 * design as delivered by the contractor.
+	 * Instrumented so that its contention can be profiled, see
+	 * glass3::util::LockProfile.
 	 */
-	mutable std::recursive_mutex m_SiteListMutex;
+	mutable glass3::util::InstrumentedRecursiveMutex m_SiteListMutex;
 
 	/**
 	 * \brief A double value containing the last time the site list was checked
@@ -270,6 +288,17 @@ class CSiteList : public glass3::util::ThreadBaseClass {
 	 */
 	std::atomic<double> m_tLastChecked;
 
+	/**
+	 * \brief The id of the hourly site check timer, -1 if there is none
+	 */
+	int64_t m_iCheckTimerID;
+
+	/**
+	 * \brief a boolean flag indicating that the hourly site check timer has
+	 * fired and the work thread should check the sites
+	 */
+	std::atomic<bool> m_bCheckDue;
+
 	/**
 	 * \brief An integer containing the maximum hours between requesting site
 	 * information from outside glasscore, a -1 disables this process
@@ -8,6 +8,7 @@
 #define WEB_H
 
 #include <threadbaseclass.h>
+#include <instrumentedmutex.h>
 
 #include <json.h>
 #include <utility>
@@ -20,6 +21,7 @@
 #include <queue>
 #include <map>
 #include <atomic>
+#include <cstdint>
 
 #include "TravelTime.h"
 #include "ZoneStats.h"
@@ -306,10 +308,12 @@ class CWeb : public glass3::util::ThreadBaseClass {
 	 * \param lon - A double variable containing the longitude to use
 	 * \param z - A double variable containing the depth to use
 	 * \param resol - A double variable containing the spatial resolution to use
+	 * \param coarse - A boolean flag indicating whether the node is part of
+	 * the coarse level of a hierarchical web, defaults to false
 	 * \return Returns a std::shared_ptr to the newly created node.
 	 */
 	std::shared_ptr<CNode> generateNode(double lat, double lon, double z,
-										double resol);
+										double resol, bool coarse = false);
 
 	/**
 	 * \brief Add node to list
@@ -553,6 +557,61 @@ class CWeb : public glass3::util::ThreadBaseClass {
 	 */
 	int getASeismicNucleationDataCountThreshold() const;
 
+	/**
+	 * \brief Gets the resolution of the coarse level of this web
+	 * \return Returns a double value containing the coarse node resolution in
+	 * kilometers, 0 if this web is not hierarchical
+	 */
+	double getCoarseResolution() const;
+
+	/**
+	 * \brief Gets the factor applied to the nucleation thresholds of the
+	 * coarse nodes of this web
+	 * \return Returns a double value containing the coarse threshold factor
+	 */
+	double getCoarseThresholdFactor() const;
+
+	/**
+	 * \brief Gets the number of coarse nodes in this web
+	 * \return Returns an integer value containing the number of coarse nodes
+	 */
+	int getCoarseNodeCount() const;
+
+	/**
+	 * \brief Count a nucleation attempt by a node in this web
+	 * \param exitedEarly - A boolean flag indicating whether the node stopped
+	 * stacking early because the thresholds could no longer be reached
+	 */
+	void countNucleation(bool exitedEarly);
+
+	/**
+	 * \brief Gets the number of nucleation attempts by nodes in this web
+	 * \return Returns an integer containing the number of nucleation attempts
+	 */
+	int64_t getNucleationCount() const;
+
+	/**
+	 * \brief Gets the number of nucleation attempts by nodes in this web that
+	 * stopped stacking early because the thresholds could no longer be reached
+	 * \return Returns an integer containing the number of early exits
+	 */
+	int64_t getNucleationEarlyExitCount() const;
+
+	/**
+	 * \brief Count a nucleation attempt by a node in this web that was
+	 * skipped without stacking, because too few of the node's linked sites
+	 * have picks, or because its coarse node did not come close enough to
+	 * triggering
+	 */
+	void countNucleationSkip();
+
+	/**
+	 * \brief Gets the number of nucleation attempts by nodes in this web that
+	 * were skipped without stacking
+	 * \return Returns an integer containing the number of skips
+	 */
+	int64_t getNucleationSkipCount() const;
+
 	/**
 	 * \brief is coordinate within web function
 	 *
@@ -565,6 +624,29 @@ class CWeb : public glass3::util::ThreadBaseClass {
 	double isWithin(double dLat, double dLon);
 
  private:
+	/**
+	 * \brief Generate the vertices of a global grid
+	 *
+	 * Generates equally spaced (more or less) vertices over the globe at the
+	 * given resolution, following (Gonzalez, 2010) Measurement of Areas on a
+	 * Sphere Using Fibonacci and Latitude Longitude Lattices
+	 * \param resolution - A double value containing the desired inter-node
+	 * resolution in kilometers
+	 * \return Returns a std::vector of latitude, longitude pairs
+	 */
+	static std::vector<std::pair<double, double>> generateGlobalVertices(
+			double resolution);
+
+	/**
+	 * \brief Link each fine node of a hierarchical web to the closest coarse
+	 * node at the same depth
+	 * \param fineNodes - A std::vector of shared_ptrs to the fine nodes
+	 * \param coarseNodes - A std::vector of shared_ptrs to the coarse nodes
+	 */
+	void assignCoarseParents(
+			const std::vector<std::shared_ptr<CNode>> &fineNodes,
+			const std::vector<std::shared_ptr<CNode>> &coarseNodes);
+
 	/**
 	 * \brief A pointer to the CSiteList class, used get sites (stations)
 	 */
@@ -773,8 +855,10 @@ class CWeb : public glass3::util::ThreadBaseClass {
 	 * see: http://www.codingstandard.com/rule/18-3-3-do-not-use-stdrecursive_mutex/
 	 * However a recursive_mutex allows us to maintain the original class
 	 * design as delivered by the contractor.
+	 * Instrumented so that its contention can be profiled, see
+	 * glass3::util::LockProfile.
 	 */
-	mutable std::recursive_mutex m_WebMutex;
+	mutable glass3::util::InstrumentedRecursiveMutex m_WebMutex;
 
 	/**
 	 * \brief An integer containing the epoch time that the web site list was last 
@@ -782,6 +866,42 @@ class CWeb : public glass3::util::ThreadBaseClass {
 	 */
 	std::atomic<int> m_tLastUpdated;
 
+	/**
+	 * \brief A double value containing the resolution of the coarse level of
+	 * this web in kilometers, 0 if this web is not hierarchical
+	 */
+	std::atomic<double> m_dCoarseResolution;
+
+	/**
+	 * \brief A double value containing the factor applied to the nucleation
+	 * thresholds of the coarse nodes, so that coarse nodes near threshold
+	 * still open up the fine nodes under them
+	 */
+	std::atomic<double> m_dCoarseThresholdFactor;
+
+	/**
+	 * \brief An integer containing the number of coarse nodes in this web
+	 */
+	std::atomic<int> m_iCoarseNodeCount;
+
+	/**
+	 * \brief An integer containing the number of nucleation attempts by nodes
+	 * in this web
+	 */
+	std::atomic<int64_t> m_iNucleationCount;
+
+	/**
+	 * \brief An integer containing the number of nucleation attempts by nodes
+	 * in this web that stopped early
+	 */
+	std::atomic<int64_t> m_iNucleationEarlyExitCount;
+
+	/**
+	 * \brief An integer containing the number of nucleation attempts by nodes
+	 * in this web that were skipped without stacking
+	 */
+	std::atomic<int64_t> m_iNucleationSkipCount;
+
 	/**
 	 * \brief default azimuth taper
 	 */
@@ -819,6 +939,12 @@ class CWeb : public glass3::util::ThreadBaseClass {
 	 * based on zonestats).
 	 */
 	static constexpr double k_dMinimumMaxNodeDepth = 50.0;
+
+	/**
+	 * \brief the default factor applied to the nucleation thresholds of
+	 * coarse nodes
+	 */
+	static constexpr double k_dCoarseThresholdFactorDefault = 0.75;
 };
 }  // namespace glasscore
 #endif  // WEB_H
@@ -87,7 +87,7 @@ CCorrelation::CCorrelation(std::shared_ptr<json::Object> correlation,
 			&& ((*correlation)["Site"].GetType() == json::ValueType::ObjectVal)) {
 		// site is an object, create scnl string from it
 		// get object
-		json::Object siteobj = (*correlation)["Site"].ToObject();
+		const json::Object &siteobj = (*correlation)["Site"].AsObject();
 
 		// site
 		if (siteobj.HasKey("Station")
@@ -201,7 +201,7 @@ CCorrelation::CCorrelation(std::shared_ptr<json::Object> correlation,
 					== json::ValueType::ObjectVal)) {
 		// site is an object, create scnl string from it
 		// get object
-		json::Object hypoobj = (*correlation)["Hypocenter"].ToObject();
+		const json::Object &hypoobj = (*correlation)["Hypocenter"].AsObject();
 
 		// latitude
 		if (hypoobj.HasKey("Latitude")
@@ -72,7 +72,7 @@ bool CDetection::processDetectionMessage(std::shared_ptr<json::Object> com) {
 	// Get information from hypocenter
 	if (com->HasKey("Hypocenter")
 			&& ((*com)["Hypocenter"].GetType() == json::ValueType::ObjectVal)) {
-		json::Object hypocenter = (*com)["Hypocenter"].ToObject();
+		const json::Object &hypocenter = (*com)["Hypocenter"].AsObject();
 
 		// get time from hypocenter
 		if (hypocenter.HasKey("Time")
@@ -56,6 +56,8 @@ std::string CGlass::m_sGraphicsOutFolder;  // NOLINT
 std::atomic<double> CGlass::m_dGraphicsStepKM;
 std::atomic<int> CGlass::m_iGraphicsSteps;
 std::atomic<bool> CGlass::m_bMinimizeTTLocator;
+std::atomic<int> CGlass::m_iLocatorRefinementIterations;
+std::atomic<int> CGlass::m_iLocatorRandomSeed;
 std::atomic<double> CGlass::m_dPickDuplicateTimeWindow;
 std::atomic<double> CGlass::m_dCorrelationMatchingTimeWindow;
 std::atomic<double> CGlass::m_dCorrelationMatchingDistanceWindow;
@@ -69,6 +71,7 @@ std::atomic<double> CGlass::m_dHypoMergingDistanceWindow;
 std::atomic<double> CGlass::m_dEventFragmentDepthThreshold;
 std::atomic<double> CGlass::m_dEventFragmentAzimuthThreshold;
 std::atomic<bool> CGlass::m_bAllowPickUpdates;
+std::atomic<bool> CGlass::m_bIncrementalNucleation;
 std::atomic<double> CGlass::m_dPickNoiseClassificationThreshold;
 std::atomic<double> CGlass::m_dPickPhaseClassificationThreshold;
 std::atomic<double> CGlass::m_dPickAzimuthClassificationThreshold;
@@ -79,7 +82,7 @@ std::vector<double> CGlass::m_dPickDistClassificationClassesUpperBound;
 std::vector<double> CGlass::m_dPickDistClassificationClassesLowerBound;
 
 
-std::mutex CGlass::m_TTTMutex;
+glass3::util::InstrumentedMutex CGlass::m_TTTMutex("CGlass::m_TTTMutex");
 
 // constants
 // Related to Taper Range array
@@ -243,6 +246,8 @@ void CGlass::clear() {
 	m_dGraphicsStepKM = 1.0;
 	m_iGraphicsSteps = 100;
 	m_bMinimizeTTLocator = false;
+	m_iLocatorRefinementIterations = 0;
+	m_iLocatorRandomSeed = -1;
 	m_dPickDuplicateTimeWindow = 2.5;
 	m_dCorrelationMatchingTimeWindow = 2.5;
 	m_dCorrelationMatchingDistanceWindow = 0.5;
@@ -256,6 +261,7 @@ void CGlass::clear() {
 	m_dEventFragmentDepthThreshold = 550.0;
 	m_dEventFragmentAzimuthThreshold = 270.0;
 	m_bAllowPickUpdates = false;
+	m_bIncrementalNucleation = false;
 	m_dPickNoiseClassificationThreshold = -1;
 	m_dPickPhaseClassificationThreshold = -1;
 	m_dPickDistanceClassificationThreshold = -1;
@@ -300,7 +306,7 @@ bool CGlass::initialize(std::shared_ptr<json::Object> com) {
 	if ((com->HasKey("DefaultNucleationPhase"))
 			&& ((*com)["DefaultNucleationPhase"].GetType()
 					== json::ValueType::ObjectVal)) {
-		std::lock_guard < std::mutex > ttGuard(m_TTTMutex);
+		std::lock_guard<glass3::util::InstrumentedMutex> ttGuard(m_TTTMutex);
 		// get the phase object
 		json::Object phsObj = (*com)["DefaultNucleationPhase"].ToObject();
 
@@ -349,7 +355,7 @@ bool CGlass::initialize(std::shared_ptr<json::Object> com) {
 			m_pDefaultNucleationTravelTime->writeToFile(debugFile, debugDepth);
 		}
 	} else {
-		std::lock_guard < std::mutex > ttGuard(m_TTTMutex);
+		std::lock_guard<glass3::util::InstrumentedMutex> ttGuard(m_TTTMutex);
 		// if no first phase, default to P
 		// clean out old phase if any
 		m_pDefaultNucleationTravelTime.reset();
@@ -370,7 +376,7 @@ bool CGlass::initialize(std::shared_ptr<json::Object> com) {
 	if ((com->HasKey("AssociationPhases"))
 			&& ((*com)["AssociationPhases"].GetType()
 					== json::ValueType::ArrayVal)) {
-		std::lock_guard < std::mutex > ttGuard(m_TTTMutex);
+		std::lock_guard<glass3::util::InstrumentedMutex> ttGuard(m_TTTMutex);
 		// get the array of phase entries
 		json::Array phases = (*com)["AssociationPhases"].ToArray();
 
@@ -556,6 +562,31 @@ bool CGlass::initialize(std::shared_ptr<json::Object> com) {
 		m_bMinimizeTTLocator = (*com)["UseL1ResidualLocator"].ToBool();
 	}
 
+	// optional gradient refinement after a shortened anneal
+	if ((com->HasKey("LocatorRefinementIterations"))
+			&& ((*com)["LocatorRefinementIterations"].GetType()
+					== json::ValueType::IntVal)) {
+		m_iLocatorRefinementIterations =
+				(*com)["LocatorRefinementIterations"].ToInt();
+
+		glass3::util::Logger::log(
+				"info",
+				"CGlass::initialize: Using LocatorRefinementIterations: "
+						+ std::to_string(m_iLocatorRefinementIterations));
+	}
+
+	// optional fixed locator seed, for reproducible locations
+	if ((com->HasKey("LocatorRandomSeed"))
+			&& ((*com)["LocatorRandomSeed"].GetType()
+					== json::ValueType::IntVal)) {
+		m_iLocatorRandomSeed = (*com)["LocatorRandomSeed"].ToInt();
+
+		glass3::util::Logger::log(
+				"info",
+				"CGlass::initialize: Using LocatorRandomSeed: "
+						+ std::to_string(m_iLocatorRandomSeed));
+	}
+
 	// Collect info for files to plot output
 	if ((com->HasKey("PlottingInfo"))
 			&& ((*com)["PlottingInfo"].GetType() == json::ValueType::ObjectVal)) {
@@ -599,7 +630,8 @@ bool CGlass::initialize(std::shared_ptr<json::Object> com) {
 		if ((paramsPlot.HasKey("graphicsOutFolder"))
 				&& (paramsPlot["graphicsOutFolder"].GetType()
 						== json::ValueType::StringVal)) {
-			std::lock_guard < std::mutex > ttGuard(m_TTTMutex);
+			std::lock_guard<glass3::util::InstrumentedMutex> ttGuard(
+					m_TTTMutex);
 			m_sGraphicsOutFolder = paramsPlot["graphicsOutFolder"].ToString();
 			glass3::util::Logger::log(
 					"info",
@@ -1232,6 +1264,18 @@ bool CGlass::initialize(std::shared_ptr<json::Object> com) {
 						+ std::to_string(m_bAllowPickUpdates));
 	}
 
+	// set whether to nucleate from incrementally maintained pick stacks
+	if ((com->HasKey("IncrementalNucleation"))
+			&& ((*com)["IncrementalNucleation"].GetType()
+					== json::ValueType::BoolVal)) {
+		m_bIncrementalNucleation = (*com)["IncrementalNucleation"].ToBool();
+
+		glass3::util::Logger::log(
+				"info",
+				"CGlass::initialize: Using IncrementalNucleation: "
+						+ std::to_string(m_bIncrementalNucleation));
+	}
+
 	// pick classification
 	if ((com->HasKey("PickClassification"))
 			&& ((*com)["PickClassification"].GetType()
@@ -1595,7 +1639,7 @@ bool CGlass::getGraphicsOut() {
 
 // ------------------------------------------------getGraphicsOutFolder
 const std::string& CGlass::getGraphicsOutFolder() {
-	std::lock_guard < std::mutex > ttGuard(m_TTTMutex);
+	std::lock_guard<glass3::util::InstrumentedMutex> ttGuard(m_TTTMutex);
 	return (m_sGraphicsOutFolder);
 }
 
@@ -1711,13 +1755,13 @@ CSiteList* CGlass::getSiteList() {
 
 // -----------------------------------------------getDefaultNucleationTravelTime
 std::shared_ptr<traveltime::CTravelTime>& CGlass::getDefaultNucleationTravelTime() {  // NOLINT
-	std::lock_guard < std::mutex > ttGuard(m_TTTMutex);
+	std::lock_guard<glass3::util::InstrumentedMutex> ttGuard(m_TTTMutex);
 	return (m_pDefaultNucleationTravelTime);
 }
 
 // ------------------------------------------------getAssociationTravelTimes
 std::shared_ptr<traveltime::CTTT>& CGlass::getAssociationTravelTimes() {
-	std::lock_guard < std::mutex > ttGuard(m_TTTMutex);
+	std::lock_guard<glass3::util::InstrumentedMutex> ttGuard(m_TTTMutex);
 	return (m_pAssociationTravelTimes);
 }
 
@@ -1766,6 +1810,36 @@ bool CGlass::getAllowPickUpdates() {
 	return (m_bAllowPickUpdates);
 }
 
+// ------------------------------------------getLocatorRefinementIterations
+int CGlass::getLocatorRefinementIterations() {
+	return (m_iLocatorRefinementIterations);
+}
+
+// ------------------------------------------setLocatorRefinementIterations
+void CGlass::setLocatorRefinementIterations(int iterations) {
+	m_iLocatorRefinementIterations = iterations;
+}
+
+// ------------------------------------------------getLocatorRandomSeed
+int CGlass::getLocatorRandomSeed() {
+	return (m_iLocatorRandomSeed);
+}
+
+// ------------------------------------------------setLocatorRandomSeed
+void CGlass::setLocatorRandomSeed(int seed) {
+	m_iLocatorRandomSeed = seed;
+}
+
+// ------------------------------------------------getIncrementalNucleation
+bool CGlass::getIncrementalNucleation() {
+	return (m_bIncrementalNucleation);
+}
+
+// ------------------------------------------------setIncrementalNucleation
+void CGlass::setIncrementalNucleation(bool incremental) {
+	m_bIncrementalNucleation = incremental;
+}
+
 // ------------------------------------------getPickNoiseClassificationThreshold
 double CGlass::getPickNoiseClassificationThreshold() {
 	return (m_dPickNoiseClassificationThreshold);
@@ -5,6 +5,7 @@
 #include <taper.h>
 #include <glassid.h>
 #include <glassmath.h>
+#include <randomstream.h>
 #include <geo.h>
 #include <cmath>
 #include <string>
@@ -54,12 +55,21 @@ const int CHypo::k_iLocationNPickThresholdLarge;
 const int CHypo::k_iLocationNumIterationsSmall;
 const int CHypo::k_iLocationNumIterationsMedium;
 const int CHypo::k_iLocationNumIterationsLarge;
+const int CHypo::k_iLocationRefinementAnnealReduction;
+const int CHypo::k_iLocationRefinementMinimumPicks;
+constexpr double CHypo::k_dLocationRefinementInitialDamping;
+constexpr double CHypo::k_dLocationRefinementMaximumDamping;
+constexpr double CHypo::k_dLocationRefinementDampingFactor;
+constexpr double CHypo::k_dLocationRefinementMinimumStepKM;
+constexpr double CHypo::k_dLocationRefinementResidualCutoff;
 constexpr double CHypo::k_dSearchRadiusResolutionFactor;
 constexpr double CHypo::k_dSearchRadiusTaperFactor;
 constexpr double CHypo::k_dSearchRadiusFactor;
 
 // ---------------------------------------------------------CHypo
 CHypo::CHypo() {
+	m_HypoMutex.setName("CHypo::m_HypoMutex");
+	m_pHypoList = NULL;
 	clear();
 }
 
@@ -70,6 +80,8 @@ CHypo::CHypo(double lat, double lon, double z, double time, std::string pid,
 				std::shared_ptr<traveltime::CTravelTime> secondTrav,
 				std::shared_ptr<traveltime::CTTT> ttt, double resolution,
 				double aziTap, double maxDep) {
+	m_HypoMutex.setName("CHypo::m_HypoMutex");
+	m_pHypoList = NULL;
 	if (!initialize(lat, lon, z, time, pid, web, bayes, thresh, cut, firstTrav,
 					secondTrav, ttt, resolution, aziTap, maxDep)) {
 		clear();
@@ -82,6 +94,8 @@ CHypo::CHypo(std::shared_ptr<json::Object> detection, double thresh, int cut,
 				std::shared_ptr<traveltime::CTravelTime> secondTrav,
 				std::shared_ptr<traveltime::CTTT> ttt, double resolution,
 				double aziTap, double maxDep, CSiteList *pSiteList) {
+	m_HypoMutex.setName("CHypo::m_HypoMutex");
+	m_pHypoList = NULL;
 	// null check json
 	if (detection == NULL) {
 		glass3::util::Logger::log("error",
@@ -250,6 +264,8 @@ CHypo::CHypo(std::shared_ptr<json::Object> detection, double thresh, int cut,
 // ---------------------------------------------------------CHypo
 CHypo::CHypo(std::shared_ptr<CTrigger> trigger,
 				std::shared_ptr<traveltime::CTTT> ttt) {
+	m_HypoMutex.setName("CHypo::m_HypoMutex");
+	m_pHypoList = NULL;
 	// null checks
 	if (trigger == NULL) {
 		glass3::util::Logger::log("error", "CHypo::CHypo: NULL node.");
@@ -286,6 +302,8 @@ CHypo::CHypo(std::shared_ptr<CCorrelation> corr,
 				std::shared_ptr<traveltime::CTravelTime> firstTrav,
 				std::shared_ptr<traveltime::CTravelTime> secondTrav,
 				std::shared_ptr<traveltime::CTTT> ttt) {
+	m_HypoMutex.setName("CHypo::m_HypoMutex");
+	m_pHypoList = NULL;
 	m_pTravelTimeTables = NULL;
 	m_pNucleationTravelTime1 = NULL;
 	m_pNucleationTravelTime2 = NULL;
@@ -320,7 +338,8 @@ void CHypo::addCorrelationReference(std::shared_ptr<CCorrelation> corr) {
 	}
 
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	// for each correlation in the vector
 	for (auto q : m_vCorrelationData) {
@@ -353,7 +372,8 @@ bool CHypo::addPickReference(std::shared_ptr<CPick> pck) {
 	}
 
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	// for each pick in the vector
 	for (auto aPick : m_vPickData) {
@@ -377,7 +397,8 @@ double CHypo::calculateAffinity(std::shared_ptr<CPick> pck) {
 	}
 
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	// get the site from the pick
 	std::shared_ptr<CSite> site = pck->getSite();
@@ -431,7 +452,8 @@ double CHypo::calculateAffinity(std::shared_ptr<CPick> pck) {
 // ---------------------------------------------------------calculateAffinity
 double CHypo::calculateAffinity(std::shared_ptr<CCorrelation> corr) {
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	// NOTE: I'm just combining time/distance into a made up affinity
 	// wiser heads than mine may come up with a more robust approach JMP
@@ -483,7 +505,8 @@ double CHypo::calculateAffinity(std::shared_ptr<CCorrelation> corr) {
 double CHypo::anneal(int nIter, double dStart, double dStop, double tStart,
 						double tStop) {
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	// This is essentially a faster algorithmic implementation of iterate
 	// *** First, locate ***
@@ -584,7 +607,11 @@ void CHypo::annealingLocateBayes(int nIter, double dStart, double dStop,
 									double tStart, double tStop,
 									bool nucleate) {
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
+
+	// seed the steps when reproducible locations are requested
+	seedRandomStream();
 
 	// don't locate if the location is fixed
 	if (m_bFixed) {
@@ -650,12 +677,12 @@ void CHypo::annealingLocateBayes(int nIter, double dStart, double dStop,
 		// init x, y, and z gaussian step distances
 		// the km for dx and dy is double so the epicentral search space is
 		// larger than the depth search space, because we live on a sphere
-		double dx = glass3::util::GlassMath::gauss(
+		double dx = m_RandomStream.gauss(
 				0.0, dkm * k_dVerticalToHorizontalDistanceCorrectionFactor);
-		double dy = glass3::util::GlassMath::gauss(
+		double dy = m_RandomStream.gauss(
 				0.0, dkm * k_dVerticalToHorizontalDistanceCorrectionFactor);
-		double dz = glass3::util::GlassMath::gauss(0.0, dkm);
-		double dt = glass3::util::GlassMath::gauss(0.0, dOt);
+		double dz = m_RandomStream.gauss(0.0, dkm);
+		double dt = m_RandomStream.gauss(0.0, dOt);
 
 		// compute current location using the hypo location and the x and y
 		// Gaussian step distances
@@ -787,7 +814,11 @@ void CHypo::annealingLocateResidual(int nIter, double dStart, double dStop,
 									double tStart, double tStop,
 									bool nucleate) {
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
+
+	// seed the steps when reproducible locations are requested
+	seedRandomStream();
 
 	if (m_pTravelTimeTables == NULL) {
 		glass3::util::Logger::log(
@@ -846,12 +877,12 @@ void CHypo::annealingLocateResidual(int nIter, double dStart, double dStop,
 				+ tStop;
 
 		// init x, y, and z gaussian step distances
-		double dx = glass3::util::GlassMath::gauss(
+		double dx = m_RandomStream.gauss(
 				0.0, dkm * k_dVerticalToHorizontalDistanceCorrectionFactor);
-		double dy = glass3::util::GlassMath::gauss(
+		double dy = m_RandomStream.gauss(
 				0.0, dkm * k_dVerticalToHorizontalDistanceCorrectionFactor);
-		double dz = glass3::util::GlassMath::gauss(0.0, dkm);
-		double dt = glass3::util::GlassMath::gauss(0.0, dOt);
+		double dz = m_RandomStream.gauss(0.0, dkm);
+		double dt = m_RandomStream.gauss(0.0, dOt);
 
 		// compute current location using the hypo location and the x and y
 		// Gaussian step distances
@@ -955,11 +986,229 @@ void CHypo::annealingLocateResidual(int nIter, double dStart, double dStop,
 	return;
 }
 
+// ---------------------------------------------------------refineLocation
+int CHypo::refineLocation(int nIter) {
+	// lock mutex for this scope
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
+
+	// don't locate if the location is fixed
+	if (m_bFixed) {
+		return (0);
+	}
+
+	if (m_pTravelTimeTables == NULL) {
+		glass3::util::Logger::log("error",
+									"CHypo::refineLocation: NULL pTTT.");
+		return (0);
+	}
+
+	bool minimizeTT = CGlass::getMinimizeTTLocator();
+
+	// taper to lower calculateValue if large azimuthal gap, as in
+	// annealingLocateBayes
+	glass3::util::Taper taperGap;
+	taperGap = glass3::util::Taper(0.0, 0.0, m_dAzimuthTaper,
+									k_dGapTaperDownEnd);
+
+	// define a taper for sigma, as in calculateBayes
+	glass3::util::Taper tap;
+	tap = glass3::util::Taper(-0.0001, 2.0, 999.0, 999.0);
+
+	// the value to improve at the current location, larger is better
+	double valBest = 0;
+	if (minimizeTT == false) {
+		valBest = calculateBayes(m_dLatitude, m_dLongitude, m_dDepth, m_tOrigin,
+									false)
+				* taperGap.calculateValue(
+						calculateGap(m_dLatitude, m_dLongitude, m_dDepth));
+	} else {
+		valBest = -calculateAbsResidualSum(m_dLatitude, m_dLongitude, m_dDepth,
+											m_tOrigin, false);
+	}
+
+	double lambda = k_dLocationRefinementInitialDamping;
+	int nImproved = 0;
+
+	for (int iter = 0; iter < nIter; iter++) {
+		// build the normal equations for the unknowns east (km), north (km),
+		// depth (km), and origin time (s) at the current location
+		double normal[16] = { 0 };
+		double gradient[4] = { 0 };
+		int nUsed = 0;
+
+		glass3::util::Geo hypoGeo;
+		hypoGeo.setGeographic(m_dLatitude, m_dLongitude,
+								glass3::util::Geo::k_EarthRadiusKm - m_dDepth);
+		m_pTravelTimeTables->setTTOrigin(hypoGeo);
+
+		for (auto pick : m_vPickData) {
+			std::shared_ptr<CSite> site = pick->getSite();
+			glass3::util::Geo siteGeo = site->getGeo();
+
+			// best fitting phase, as in calculateBayes
+			double tObs = pick->getTPick() - m_tOrigin;
+			double tCal = m_pTravelTimeTables->T(&siteGeo, tObs);
+			if ((tCal < 0)
+					|| (m_pTravelTimeTables->m_bUseForLocations == false)) {
+				continue;
+			}
+			std::string phase = m_pTravelTimeTables->m_sPhase;
+
+			// weight by the same sigma as calculateBayes, scaling the residual
+			// by the phase weighting is the same as dividing sigma by it
+			double delta = glass3::util::GlassMath::k_RadiansToDegrees
+					* hypoGeo.delta(&siteGeo);
+			double sigma = ((tap.calculateValue(delta) * 2.25) + 0.75)
+					/ std::abs(calculateWeightedResidual(phase, 1.0, 0.0));
+			double residual = tObs - tCal;
+
+			// ignore outliers, they hardly contribute to the bayesian fit
+			if (std::abs(residual)
+					> sigma * k_dLocationRefinementResidualCutoff) {
+				continue;
+			}
+
+			double dTdDelta = 0;
+			double dTdDepth = 0;
+			if (m_pTravelTimeTables->calculateDerivatives(delta, phase, m_dDepth,
+					&dTdDelta, &dTdDepth) == false) {
+				continue;
+			}
+
+			// partial derivatives of the predicted arrival time, moving the
+			// hypo towards the site shortens the distance
+			double azimuth = hypoGeo.azimuth(&siteGeo);
+			double row[4];
+			row[0] = -dTdDelta * sin(azimuth) / glass3::util::Geo::k_DegreesToKm;
+			row[1] = -dTdDelta * cos(azimuth) / glass3::util::Geo::k_DegreesToKm;
+			row[2] = dTdDepth;
+			row[3] = 1.0;
+
+			double weight = 1.0 / (sigma * sigma);
+			for (int i = 0; i < 4; i++) {
+				gradient[i] += weight * row[i] * residual;
+				for (int j = 0; j < 4; j++) {
+					normal[i * 4 + j] += weight * row[i] * row[j];
+				}
+			}
+			nUsed++;
+		}
+
+		// need at least as many picks as unknowns
+		if (nUsed < k_iLocationRefinementMinimumPicks) {
+			break;
+		}
+
+		// try damped steps until one improves or the damping gets too large
+		bool improved = false;
+		double stepKM = 0;
+		while (lambda < k_dLocationRefinementMaximumDamping) {
+			double damped[16];
+			double step[4];
+			for (int i = 0; i < 16; i++) {
+				damped[i] = normal[i];
+			}
+			for (int i = 0; i < 4; i++) {
+				damped[i * 4 + i] += lambda * normal[i * 4 + i];
+				step[i] = gradient[i];
+			}
+
+			if (glass3::util::GlassMath::solveLinearSystem(4, damped, step)
+					== false) {
+				lambda *= k_dLocationRefinementDampingFactor;
+				continue;
+			}
+
+			// don't take steps beyond the web resolution, that's the anneal's
+			// job
+			stepKM = sqrt(step[0] * step[0] + step[1] * step[1]
+							+ step[2] * step[2]);
+			if ((m_dWebResolution > 0) && (stepKM > m_dWebResolution)) {
+				double scale = m_dWebResolution / stepKM;
+				for (int i = 0; i < 4; i++) {
+					step[i] *= scale;
+				}
+				stepKM = m_dWebResolution;
+			}
+
+			// compute the trial location
+			double xlat = m_dLatitude
+					+ step[1] / glass3::util::Geo::k_DegreesToKm;
+			double xlon = m_dLongitude
+					+ step[0] / (glass3::util::Geo::k_DegreesToKm
+							* cos(glass3::util::GlassMath::k_DegreesToRadians
+									* m_dLatitude));
+			double xz = m_dDepth + step[2];
+			double oT = m_tOrigin + step[3];
+
+			// don't let depth go below 1 km or exceed maximum
+			if (xz < 1.0) {
+				xz = 1.0;
+			}
+			if (xz > m_dMaxDepth) {
+				xz = m_dMaxDepth;
+			}
+
+			double value = 0;
+			if (minimizeTT == false) {
+				value = calculateBayes(xlat, xlon, xz, oT, false)
+						* taperGap.calculateValue(calculateGap(xlat, xlon, xz));
+			} else {
+				value = -calculateAbsResidualSum(xlat, xlon, xz, oT, false);
+			}
+
+			if (value > valBest) {
+				// keep the step and trust the gradient more next time
+				valBest = value;
+				setLatitude(xlat);
+				setLongitude(xlon);
+				setDepth(xz);
+				setTOrigin(oT);
+				lambda /= k_dLocationRefinementDampingFactor;
+				improved = true;
+				break;
+			}
+
+			// reject the step and damp harder
+			lambda *= k_dLocationRefinementDampingFactor;
+		}
+
+		if (improved == false) {
+			break;
+		}
+		nImproved++;
+
+		// converged
+		if (stepKM < k_dLocationRefinementMinimumStepKM) {
+			break;
+		}
+	}
+
+	// set dBayes to current value
+	if (minimizeTT == false) {
+		m_dBayesValue = valBest;
+	} else {
+		m_dBayesValue = calculateBayes(m_dLatitude, m_dLongitude, m_dDepth,
+										m_tOrigin, false);
+	}
+
+	glass3::util::Logger::log(
+			"debug",
+			"CHypo::refineLocation: " + m_sID + " improved "
+					+ std::to_string(nImproved) + " of "
+					+ std::to_string(nIter) + " iterations, bayes: "
+					+ std::to_string(m_dBayesValue));
+
+	return (nImproved);
+}
+
 // ---------------------------------------------------------canAssociate
 bool CHypo::canAssociate(std::shared_ptr<CPick> pick, double sigma,
 							double sdassoc, bool p_only, bool debug) {
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	// check to see if this is a valid hypo, a hypo must always have an id
 	if (m_sID == "") {
@@ -983,15 +1232,16 @@ bool CHypo::canAssociate(std::shared_ptr<CPick> pick, double sigma,
 	// get site
 	std::shared_ptr<CSite> site = pick->getSite();
 
-	// set up a geographic object for this hypo
-	glass3::util::Geo hypoGeo;
-	hypoGeo.setGeographic(m_dLatitude, m_dLongitude,
-							glass3::util::Geo::k_EarthRadiusKm - m_dDepth);
+	// get the cached geometry between this hypo and the site
+	const HypoSiteCacheStruct * siteCache = getSiteCache(site);
+	if (siteCache == NULL) {
+		return (false);
+	}
 
 	// check backazimuth if present
 	if (pick->getBackAzimuth() != std::numeric_limits<double>::quiet_NaN()) {
-		// compute azimuth from the site to the node
-		double siteAzimuth = site->getGeo().azimuth(&hypoGeo);
+		// azimuth from the site to the node
+		double siteAzimuth = siteCache->dSiteAzimuth;
 
 		// check to see if pick's backazimuth is within the
 		// valid range
@@ -1020,8 +1270,8 @@ bool CHypo::canAssociate(std::shared_ptr<CPick> pick, double sigma,
 		if ((std::isnan(pick->getClassifiedAzimuthProbability()) != true)
 				&& (pick->getClassifiedAzimuthProbability()
 						> CGlass::getPickAzimuthClassificationThreshold())) {
-			// set up a geo for azimuth calculations
-			double siteAzimuth = hypoGeo.azimuth(&(site->getGeo()))
+			// azimuth from the hypo to the site
+			double siteAzimuth = siteCache->dAzimuth
 					* glass3::util::GlassMath::k_RadiansToDegrees;
 			// check to see if pick's azimuth is within the
 			// valid range
@@ -1239,7 +1489,8 @@ bool CHypo::canAssociate(std::shared_ptr<CPick> pick, double sigma,
 bool CHypo::canAssociate(std::shared_ptr<CCorrelation> corr, double tWindow,
 							double xWindow) {
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	// check to see if this is a valid hypo, a hypo must always have an id
 	if (m_sID == "") {
@@ -1323,7 +1574,8 @@ bool CHypo::canAssociate(std::shared_ptr<CCorrelation> corr, double tWindow,
 // -------------------------------------------------------generateCancelMessage
 std::shared_ptr<json::Object> CHypo::generateCancelMessage() {
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	std::shared_ptr<json::Object> cancel = std::make_shared < json::Object
 			> (json::Object());
@@ -1343,7 +1595,8 @@ std::shared_ptr<json::Object> CHypo::generateCancelMessage() {
 // ---------------------------------------------------------cancelCheck
 bool CHypo::cancelCheck() {
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	// can't cancel fixed hypos
 	// NOTE: What implication does this have for "seed hypos" like twitter
@@ -1472,7 +1725,8 @@ bool CHypo::cancelCheck() {
 // ---------------------------------------------------------clear
 void CHypo::clear() {
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	setLatitude(0.0);
 	setLongitude(0.0);
@@ -1493,6 +1747,8 @@ void CHypo::clear() {
 	m_dDistanceSD = 0;
 	m_dWebResolution = 0;
 
+	// a cleared hypo is no longer in a list
+	m_pHypoList = NULL;
 	m_dAssociationDistanceCutoff = 0;
 
 	m_bFixed = false;
@@ -1510,12 +1766,20 @@ void CHypo::clear() {
 
 	m_iTotalProcessCount = 0;
 	m_iReportCount = 0;
+
+	m_mSiteCache.clear();
+	m_dSiteCacheLatitude = std::numeric_limits<double>::quiet_NaN();
+	m_dSiteCacheLongitude = std::numeric_limits<double>::quiet_NaN();
+	m_dSiteCacheDepth = std::numeric_limits<double>::quiet_NaN();
+
+	m_RandomStream.seed(glass3::util::RandomStream::getThreadStream().next());
 }
 
 // ---------------------------------------------------clearCorrelationReferences
 void CHypo::clearCorrelationReferences() {
 	// lock the hypo since we're iterating through it's lists
-	std::lock_guard < std::recursive_mutex > hypoGuard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> hypoGuard(
+			m_HypoMutex);
 
 	// go through all the corrs linked to this hypo
 	for (auto corr : m_vCorrelationData) {
@@ -1536,7 +1800,8 @@ void CHypo::clearCorrelationReferences() {
 // ---------------------------------------------------------clearPickReferences
 void CHypo::clearPickReferences() {
 	// lock the hypo since we're iterating through it's lists
-	std::lock_guard < std::recursive_mutex > hypoGuard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> hypoGuard(
+			m_HypoMutex);
 
 	// go through all the picks linked to this hypo
 	for (auto pck : m_vPickData) {
@@ -1557,7 +1822,8 @@ void CHypo::clearPickReferences() {
 // ---------------------------------------------------------generateEventMessage
 std::shared_ptr<json::Object> CHypo::generateEventMessage() {
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	if (m_bEventGenerated == false) {
 		m_hapsAudit.dtFirstEventMessage = glass3::util::Date::now();
@@ -1618,7 +1884,8 @@ std::shared_ptr<json::Object> CHypo::generateExpireMessage() {
 // ---------------------------------------------------------calculateGap
 double CHypo::calculateGap(double lat, double lon, double z) {
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	// set up a geographic object for this hypo
 	glass3::util::Geo geo;
@@ -1676,26 +1943,105 @@ double CHypo::getTravelTimeForPhase(std::shared_ptr<CPick> pick,
 	}
 
 	// lock mutex for this scope
-	std::lock_guard <std::recursive_mutex> guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
-	// setup traveltime interface for this hypo
-	m_pTravelTimeTables->setTTOrigin(m_dLatitude, m_dLongitude, m_dDepth);
+	// get the cached travel times between this hypo and the site
+	const HypoSiteCacheStruct * siteCache = getSiteCache(pick->getSite());
+	if (siteCache == NULL) {
+		return(traveltime::CTravelTime::k_dTravelTimeInvalid);
+	}
+
+	// get the traveltime for this phase depth and distance
+	double tCal = m_pTravelTimeTables->selectTravelTime(
+			siteCache->adTravelTimes, siteCache->dDistance, phaseName);
+
+	return (tCal);
+}
+
+// ---------------------------------------------seedRandomStream
+void CHypo::seedRandomStream() {
+	int seed = CGlass::getLocatorRandomSeed();
+	if (seed < 0) {
+		return;
+	}
+
+	// lock mutex for this scope
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
+
+	// derive the stream seed from the state the anneal starts from
+	uint64_t streamSeed = static_cast<uint64_t>(seed);
+	streamSeed = glass3::util::RandomStream::combineSeed(streamSeed,
+															m_dLatitude);
+	streamSeed = glass3::util::RandomStream::combineSeed(streamSeed,
+															m_dLongitude);
+	streamSeed = glass3::util::RandomStream::combineSeed(streamSeed, m_dDepth);
+	streamSeed = glass3::util::RandomStream::combineSeed(streamSeed,
+															m_tOrigin);
+	streamSeed = glass3::util::RandomStream::combineSeed(
+			streamSeed, static_cast<double>(m_vPickData.size()));
+
+	m_RandomStream.seed(streamSeed);
+}
+
+// ---------------------------------------------getSiteCache
+const HypoSiteCacheStruct * CHypo::getSiteCache(std::shared_ptr<CSite> site) {
+	if ((site == NULL) || (m_pTravelTimeTables == NULL)) {
+		return (NULL);
+	}
+
+	// lock mutex for this scope
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
+
+	// the cache is only valid at the location it was filled at
+	if ((m_dSiteCacheLatitude != m_dLatitude)
+			|| (m_dSiteCacheLongitude != m_dLongitude)
+			|| (m_dSiteCacheDepth != m_dDepth)) {
+		m_mSiteCache.clear();
+		m_dSiteCacheLatitude = m_dLatitude;
+		m_dSiteCacheLongitude = m_dLongitude;
+		m_dSiteCacheDepth = m_dDepth;
+	}
+
+	glass3::util::Geo &siteGeo = site->getGeo();
+
+	// use the existing entry if it is for this site at its current location
+	auto found = m_mSiteCache.find(site.get());
+	if ((found != m_mSiteCache.end())
+			&& (found->second.wpSite.lock() == site)
+			&& (found->second.dSiteLatitude == siteGeo.m_dGeocentricLatitude)
+			&& (found->second.dSiteLongitude
+					== siteGeo.m_dGeocentricLongitude)) {
+		return (&found->second);
+	}
 
 	// set up a geographic object for this hypo
 	glass3::util::Geo hypoGeo;
 	hypoGeo.setGeographic(m_dLatitude, m_dLongitude,
 							glass3::util::Geo::k_EarthRadiusKm - m_dDepth);
 
-	// get site
-	std::shared_ptr<CSite> site = pick->getSite();
+	HypoSiteCacheStruct &entry = m_mSiteCache[site.get()];
+	entry.wpSite = site;
+	entry.dSiteLatitude = siteGeo.m_dGeocentricLatitude;
+	entry.dSiteLongitude = siteGeo.m_dGeocentricLongitude;
+	entry.dAzimuth = hypoGeo.azimuth(&siteGeo);
+	entry.dSiteAzimuth = siteGeo.azimuth(&hypoGeo);
 
-	// compute site distance in degrees
-	double siteDistance = calculateDistanceToPick(pick);
+	// compute the distance and the travel time for every phase at once
+	m_pTravelTimeTables->setTTOrigin(m_dLatitude, m_dLongitude, m_dDepth);
+	entry.dDistance = m_pTravelTimeTables->calculateTravelTimes(
+			&siteGeo, entry.adTravelTimes);
 
-	// get the traveltime for this phase depth and distance
-	double tCal = m_pTravelTimeTables->Td(siteDistance, phaseName, m_dDepth);
+	return (&entry);
+}
 
-	return (tCal);
+// ---------------------------------------------getSiteCacheSize
+int CHypo::getSiteCacheSize() const {
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
+	return (m_mSiteCache.size());
 }
 
 // ---------------------------------------------calculateDistanceToPick
@@ -1705,21 +2051,22 @@ double CHypo::calculateDistanceToPick(std::shared_ptr<CPick> pick) {
 	}
 
 	// lock mutex for this scope
-	std::lock_guard <std::recursive_mutex> guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
-	// set up a geographic object for this hypo
-	glass3::util::Geo hypoGeo;
-	hypoGeo.setGeographic(m_dLatitude, m_dLongitude,
-							glass3::util::Geo::k_EarthRadiusKm - m_dDepth);
+	// get the cached site distance in degrees
+	const HypoSiteCacheStruct * siteCache = getSiteCache(pick->getSite());
+	if (siteCache == NULL) {
+		// no travel time tables to cache with, compute it directly
+		glass3::util::Geo hypoGeo;
+		hypoGeo.setGeographic(m_dLatitude, m_dLongitude,
+								glass3::util::Geo::k_EarthRadiusKm - m_dDepth);
 
-	// get site
-	std::shared_ptr<CSite> site = pick->getSite();
-
-	// compute site distance in degrees
-	double siteDistance = glass3::util::GlassMath::k_RadiansToDegrees
-				* hypoGeo.delta(&site->getGeo());
+		return(glass3::util::GlassMath::k_RadiansToDegrees
+				* hypoGeo.delta(&pick->getSite()->getGeo()));
+	}
 
-	return(siteDistance);
+	return(siteCache->dDistance);
 }
 
 // --------------------------------------------------------calculateResidual
@@ -1730,13 +2077,17 @@ double CHypo::calculateResidual(std::shared_ptr<CPick> pick,
 	}
 
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
-
-	// setup traveltime interface for this hypo
-	m_pTravelTimeTables->setTTOrigin(m_dLatitude, m_dLongitude, m_dDepth);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
-	// get site
-	std::shared_ptr<CSite> site = pick->getSite();
+	// get the cached travel times between this hypo and the site
+	const HypoSiteCacheStruct * siteCache = getSiteCache(pick->getSite());
+	if (siteCache == NULL) {
+		if (useForLocations != NULL) {
+			*useForLocations = false;
+		}
+		return (std::numeric_limits<double>::quiet_NaN());
+	}
 
 	// compute observed traveltime
 	double tObs = pick->getTPick() - m_tOrigin;
@@ -1759,18 +2110,21 @@ double CHypo::calculateResidual(std::shared_ptr<CPick> pick,
 			// valid phase classification,
 			// compute expected travel time based on the pick site location and
 			// the classified pick phase
-			tCal = m_pTravelTimeTables->T(&site->getGeo(),
-											pick->getClassifiedPhase());
+			tCal = m_pTravelTimeTables->selectTravelTime(
+					siteCache->adTravelTimes, siteCache->dDistance,
+					pick->getClassifiedPhase());
 			phase = pick->getClassifiedPhase();
 		} else {
 			// no valid phase classification,
 			// compute expected travel time based on the pick site location and
 			// the observed travel time
 			if (p_only == false) {
-				tCal = m_pTravelTimeTables->T(&site->getGeo(), tObs);
+				tCal = m_pTravelTimeTables->selectBestTravelTime(
+						siteCache->adTravelTimes, siteCache->dDistance, tObs);
 				phase = m_pTravelTimeTables->m_sPhase;
 			} else {
-				tCal = m_pTravelTimeTables->T(&site->getGeo(), "P");
+				tCal = m_pTravelTimeTables->selectTravelTime(
+						siteCache->adTravelTimes, siteCache->dDistance, "P");
 				phase = "P";
 			}
 		}
@@ -1779,10 +2133,12 @@ double CHypo::calculateResidual(std::shared_ptr<CPick> pick,
 		// compute expected travel time based on the pick site location and
 		// the observed travel time
 		if (p_only == false) {
-			tCal = m_pTravelTimeTables->T(&site->getGeo(), tObs);
+			tCal = m_pTravelTimeTables->selectBestTravelTime(
+					siteCache->adTravelTimes, siteCache->dDistance, tObs);
 			phase = m_pTravelTimeTables->m_sPhase;
 		} else {
-			tCal = m_pTravelTimeTables->T(&site->getGeo(), "P");
+			tCal = m_pTravelTimeTables->selectTravelTime(
+					siteCache->adTravelTimes, siteCache->dDistance, "P");
 			phase = "P";
 		}
 	}
@@ -1859,7 +2215,8 @@ double CHypo::calculateBayes(double xlat, double xlon, double xZ, double oT,
 	}
 
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	if ((!m_pNucleationTravelTime1) && (!m_pNucleationTravelTime2)) {
 		glass3::util::Logger::log(
@@ -2001,6 +2358,24 @@ double CHypo::getAssociationDistanceCutoff() const {
 	return (m_dAssociationDistanceCutoff);
 }
 
+// ------------------------------------------------setAssociationDistanceCutoff
+void CHypo::setAssociationDistanceCutoff(double cutoff) {
+	if (m_dAssociationDistanceCutoff.exchange(cutoff) == cutoff) {
+		return;
+	}
+
+	// let our list know that its largest cutoff may have changed
+	CHypoList * hypoList = m_pHypoList;
+	if (hypoList != NULL) {
+		hypoList->invalidateMaxAssociationDistanceCutoff();
+	}
+}
+
+// ---------------------------------------------------------setHypoList
+void CHypo::setHypoList(CHypoList * hypoList) {
+	m_pHypoList = hypoList;
+}
+
 // ------------------------------------------------------------getProcessCount
 int CHypo::getProcessCount() const {
 	return (m_iProcessCount);
@@ -2033,7 +2408,8 @@ int CHypo::getTeleseismicPhaseCount() const {
 
 // ------------------------------------------------------------getGeo
 glass3::util::Geo CHypo::getGeo() const {
-	std::lock_guard < std::recursive_mutex > hypoGuard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> hypoGuard(
+			m_HypoMutex);
 	glass3::util::Geo geoHypo;
 	geoHypo.setGeographic(m_dLatitude, m_dLongitude,
 							glass3::util::Geo::k_EarthRadiusKm - m_dDepth);
@@ -2102,37 +2478,43 @@ double CHypo::getNucleationStackThreshold() const {
 
 // --------------------------------------------------getNucleationTravelTime1
 std::shared_ptr<traveltime::CTravelTime> CHypo::getNucleationTravelTime1() const {  // NOLINT
-	std::lock_guard < std::recursive_mutex > hypoGuard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> hypoGuard(
+			m_HypoMutex);
 	return (m_pNucleationTravelTime1);
 }
 
 // --------------------------------------------------getNucleationTravelTime2
 std::shared_ptr<traveltime::CTravelTime> CHypo::getNucleationTravelTime2() const {  // NOLINT
-	std::lock_guard < std::recursive_mutex > hypoGuard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> hypoGuard(
+			m_HypoMutex);
 	return (m_pNucleationTravelTime2);
 }
 
 // --------------------------------------------------getTravelTimeTables
 std::shared_ptr<traveltime::CTTT> CHypo::getTravelTimeTables() const {
-	std::lock_guard < std::recursive_mutex > hypoGuard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> hypoGuard(
+			m_HypoMutex);
 	return (m_pTravelTimeTables);
 }
 
 // --------------------------------------------------getPickDataSize
 int CHypo::getPickDataSize() const {
-	std::lock_guard < std::recursive_mutex > hypoGuard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> hypoGuard(
+			m_HypoMutex);
 	return (m_vPickData.size());
 }
 
 // --------------------------------------------------getPickData
 std::vector<std::shared_ptr<CPick>> CHypo::getPickData() const {
-	std::lock_guard < std::recursive_mutex > hypoGuard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> hypoGuard(
+			m_HypoMutex);
 	return (m_vPickData);
 }
 
 // --------------------------------------------------getCorrelationDataSize
 int CHypo::getCorrelationDataSize() const {
-	std::lock_guard < std::recursive_mutex > hypoGuard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> hypoGuard(
+			m_HypoMutex);
 	return (m_vCorrelationData.size());
 }
 
@@ -2151,7 +2533,8 @@ double CHypo::calculateAbsResidualSum(double xlat, double xlon, double xZ,
 	}
 
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	double sigma;
 	double value = 0.;
@@ -2254,7 +2637,8 @@ void CHypo::graphicsOutput() {
 		return;
 	}
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	// create and open file
 	std::ofstream outfile;
@@ -2336,7 +2720,8 @@ bool CHypo::hasCorrelationReference(std::shared_ptr<CCorrelation> corr) {
 	}
 
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	// for each corr in the vector
 	for (const auto &q : m_vCorrelationData) {
@@ -2358,7 +2743,8 @@ bool CHypo::hasPickReference(std::shared_ptr<CPick> pck) {
 	}
 
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	// for each pick in the vector
 	for (const auto &q : m_vPickData) {
@@ -2410,7 +2796,8 @@ std::shared_ptr<json::Object> CHypo::generateHypoMessage() {
 					+ m_sID + " sWebName:" + m_sWebName);
 
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	// NOTE: Need to think about this format, currently it *almost*
 	// creates a detection formats json, but doesn't use the library
@@ -2651,7 +3038,8 @@ bool CHypo::initialize(double lat, double lon, double z, double time,
 						std::shared_ptr<traveltime::CTTT> ttt,
 						double resolution, double aziTap, double maxDep) {
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	clear();
 
@@ -2715,7 +3103,8 @@ bool CHypo::isLockedForProcessing() {
 // ---------------------------------------------------------localize
 double CHypo::localize() {
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	// check to see if this is a valid hypo, a hypo must always have an id
 	if (m_sID == "") {
@@ -2758,67 +3147,64 @@ double CHypo::localize() {
 			+ taper.calculateValue(npick) * k_dSearchRadiusTaperFactor
 					* m_dWebResolution) / k_dSearchRadiusFactor;
 
+	// choose the number of anneal iterations based on the number of picks,
+	// 0 to skip this localize
+	int nIter = 0;
+
 	// This should be the default
 	if (CGlass::getMinimizeTTLocator() == false) {
 		if (npick < k_iLocationNPickThresholdMedium) {
-			annealingLocateBayes(k_iLocationNumIterationsLarge, searchR,
-									k_dLocationMinDistanceStepSize,
-									searchR / k_dLocationSearchRadiusToTime,
-									k_dLocationMinTimeStepSize);
+			nIter = k_iLocationNumIterationsLarge;
 		} else if (npick < k_iLocationNPickThresholdLarge
 				&& (npick % k_iLocationNPicksToSkipMedium) == 0) {
-			annealingLocateBayes(k_iLocationNumIterationsMedium, searchR,
-									k_dLocationMinDistanceStepSize,
-									searchR / k_dLocationSearchRadiusToTime,
-									k_dLocationMinTimeStepSize);
+			nIter = k_iLocationNumIterationsMedium;
 		} else if ((npick % k_iLocationNPicksToSkipLarge) == 0) {
-			annealingLocateBayes(k_iLocationNumIterationsSmall, searchR,
-									k_dLocationMinDistanceStepSize,
-									searchR / k_dLocationSearchRadiusToTime,
-									k_dLocationMinTimeStepSize);
-		} else {
-			// calculate bayes for resolve even if we didn't localize
-			m_dBayesValue = calculateBayes(m_dLatitude, m_dLongitude, m_dDepth,
-											m_tOrigin, false);
-
-			snprintf(sLog, sizeof(sLog),
-						"CHypo::localize: Skipping localize with %d picks",
-						npick);
-			glass3::util::Logger::log(sLog);
+			nIter = k_iLocationNumIterationsSmall;
 		}
 	} else {
 		if (npick < k_iLocationNPickThresholdSmall) {
-			annealingLocateResidual(k_iLocationNumIterationsLarge, searchR,
-									k_dLocationMinDistanceStepSize,
-									searchR / k_dLocationSearchRadiusToTime,
-									k_dLocationMinTimeStepSize);
+			nIter = k_iLocationNumIterationsLarge;
 		} else if (npick < k_iLocationNPickThresholdMedium
 				&& (npick % k_iLocationNPicksToSkipSmall) == 0) {
-			annealingLocateResidual(k_iLocationNumIterationsMedium, searchR,
-									k_dLocationMinDistanceStepSize,
-									searchR / k_dLocationSearchRadiusToTime,
-									k_dLocationMinTimeStepSize);
+			nIter = k_iLocationNumIterationsMedium;
 		} else if (npick < k_iLocationNPickThresholdLarge
 				&& (npick % k_iLocationNPicksToSkipMedium) == 0) {
-			annealingLocateResidual(k_iLocationNumIterationsMedium, searchR,
-									k_dLocationMinDistanceStepSize,
+			nIter = k_iLocationNumIterationsMedium;
+		} else if ((npick % k_iLocationNPicksToSkipLarge) == 0) {
+			nIter = k_iLocationNumIterationsSmall;
+		}
+	}
+
+	if (nIter > 0) {
+		// when refining, a short anneal finds the basin and the gradient
+		// refinement converges within it
+		int nRefine = CGlass::getLocatorRefinementIterations();
+		if (nRefine > 0) {
+			nIter /= k_iLocationRefinementAnnealReduction;
+		}
+
+		if (CGlass::getMinimizeTTLocator() == false) {
+			annealingLocateBayes(nIter, searchR, k_dLocationMinDistanceStepSize,
 									searchR / k_dLocationSearchRadiusToTime,
 									k_dLocationMinTimeStepSize);
-		} else if ((npick % k_iLocationNPicksToSkipLarge) == 0) {
-			annealingLocateResidual(k_iLocationNumIterationsSmall, searchR,
+		} else {
+			annealingLocateResidual(nIter, searchR,
 									k_dLocationMinDistanceStepSize,
 									searchR / k_dLocationSearchRadiusToTime,
 									k_dLocationMinTimeStepSize);
-		} else {
-			// calculate bayes for resolve even if we didn't localize
-			m_dBayesValue = calculateBayes(m_dLatitude, m_dLongitude, m_dDepth,
-											m_tOrigin, false);
+		}
 
-			snprintf(sLog, sizeof(sLog),
-						"CHypo::localize: Skipping localize with %d picks",
-						npick);
-			glass3::util::Logger::log(sLog);
+		if (nRefine > 0) {
+			refineLocation(nRefine);
 		}
+	} else {
+		// calculate bayes for resolve even if we didn't localize
+		m_dBayesValue = calculateBayes(m_dLatitude, m_dLongitude, m_dDepth,
+										m_tOrigin, false);
+
+		snprintf(sLog, sizeof(sLog),
+					"CHypo::localize: Skipping localize with %d picks", npick);
+		glass3::util::Logger::log(sLog);
 	}
 
 	// log
@@ -2839,7 +3225,8 @@ double CHypo::localize() {
 // ---------------------------------------------------------pruneData
 bool CHypo::pruneData(CHypoList* parentThread) {
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	// check to see if this is a valid hypo, a hypo must always have an id
 	if (m_sID == "") {
@@ -2973,7 +3360,8 @@ void CHypo::removeCorrelationReference(std::shared_ptr<CCorrelation> corr) {
 	}
 
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	// get the correlation id
 	std::string pid = corr->getID();
@@ -3001,7 +3389,8 @@ void CHypo::removePickReference(std::shared_ptr<CPick> pck) {
 	}
 
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	// get the pick id
 	std::string pid = pck->getID();
@@ -3024,7 +3413,8 @@ void CHypo::removePickReference(std::shared_ptr<CPick> pck) {
 // ---------------------------------------------------------reportCheck
 bool CHypo::reportCheck() {
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	// check to see if this is a valid hypo, a hypo must always have an id
 	if (m_sID == "") {
@@ -3081,7 +3471,8 @@ bool CHypo::reportCheck() {
 bool CHypo::resolveData(std::shared_ptr<CHypo> hyp, bool allowStealing,
 		CHypoList* parentThread) {
 	// lock the hypo since we're iterating through it's lists
-	std::lock_guard < std::recursive_mutex > hypoGuard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> hypoGuard(
+			m_HypoMutex);
 
 	// nullchecks
 	if (CGlass::getHypoList() == NULL) {
@@ -3274,7 +3665,8 @@ bool CHypo::resolveData(std::shared_ptr<CHypo> hyp, bool allowStealing,
 // ---------------------------------------------------------calculateStatistics
 void CHypo::calculateStatistics() {
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	// Calculate the statistical distribution of distance
 	// histogram for culling purposes. The actual values are
@@ -3286,7 +3678,7 @@ void CHypo::calculateStatistics() {
 		m_dDistanceSD = 0.0;
 		m_dMedianDistance = 0.0;
 		m_dMinDistance = 0.0;
-		m_dAssociationDistanceCutoff = 0.0;
+		setAssociationDistanceCutoff(0.0);
 		m_iTeleseismicPhaseCount = 0;
 		m_dGap = 360.0;
 		return;
@@ -3355,13 +3747,13 @@ void CHypo::calculateStatistics() {
 	// In the long term, he wants to replace this with a more statistics
 	// based algorithm
 	int icut = static_cast<int>((CGlass::getDistanceCutoffRatio() * ndis));
-	m_dAssociationDistanceCutoff = CGlass::getDistanceCutoffFactor()
-			* dis[icut];
+	double cutoff = CGlass::getDistanceCutoffFactor() * dis[icut];
 
 	// make sure our calculated dCut is not below the minimum allowed
-	if (m_dAssociationDistanceCutoff < CGlass::getMinDistanceCutoff()) {
-		m_dAssociationDistanceCutoff = CGlass::getMinDistanceCutoff();
+	if (cutoff < CGlass::getMinDistanceCutoff()) {
+		cutoff = CGlass::getMinDistanceCutoff();
 	}
+	setAssociationDistanceCutoff(cutoff);
 
 	// sort the azimuths
 	sort(azm.begin(), azm.end());
@@ -3388,7 +3780,8 @@ void CHypo::calculateStatistics() {
 // ---------------------------------------------------------trap
 void CHypo::trap() {
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	char sLog[glass3::util::Logger::k_nMaxLogEntrySize];
 
@@ -3494,7 +3887,8 @@ void CHypo::setNucleationStackThreshold(double thresh) {
 void CHypo::setNucleationAuditingInfo(double tNucleation,
 										double tNucleationKeyPickInsertion) {
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	if (!m_hapsAudit.dtNucleated) {
 		m_hapsAudit.dtNucleated = tNucleation;
@@ -3505,7 +3899,8 @@ void CHypo::setNucleationAuditingInfo(double tNucleation,
 // ----------------------------------------------getHypoAuditingPerformanceInfo
 const HypoAuditingPerformanceStruct * CHypo::getHypoAuditingPerformanceInfo() {
 	// lock mutex for this scope
-	std::lock_guard < std::recursive_mutex > guard(m_HypoMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_HypoMutex);
 
 	return (&m_hapsAudit);
 }
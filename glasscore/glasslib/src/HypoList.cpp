@@ -1,9 +1,12 @@
 #include "HypoList.h"
 #include <logger.h>
+#include <metricsregistry.h>
 #include <stringutil.h>
 #include <geo.h>
 #include <date.h>
 #include <json.h>
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <utility>
@@ -13,6 +16,7 @@
 #include <map>
 #include <set>
 #include <ctime>
+#include <cmath>
 #include <thread>
 #include <chrono>
 #include <mutex>
@@ -30,6 +34,7 @@ namespace glasscore {
 
 // constants
 constexpr double CHypoList::k_nHypoSearchPastDurationForPick;
+const int CHypoList::k_iNumProcessingStages;
 const int CHypoList::k_nMaxAllowableHypoCountDefault;
 const unsigned int CHypoList::k_nNumberOfMergeAnnealIterations;
 constexpr double CHypoList::k_dFinalMergeAnnealTimeStepSize;
@@ -37,6 +42,8 @@ constexpr double CHypoList::k_dMergeStackImprovementRatio;
 constexpr double CHypoList::k_dMinimumRoundingProtectionRatio;
 constexpr double CHypoList::k_dExistingTimeTolerance;
 constexpr double CHypoList::k_dExistingDistanceTolerance;
+constexpr double CHypoList::k_dIndexCellSize;
+constexpr double CHypoList::k_dMaximumSeismicVelocity;
 // ---------------------------------------------------------CHypoList
 CHypoList::CHypoList(int numThreads, int sleepTime, int checkInterval)
 		: glass3::util::ThreadBaseClass("HypoList", sleepTime, numThreads,
@@ -49,6 +56,11 @@ CHypoList::CHypoList(int numThreads, int sleepTime, int checkInterval)
 
 // ---------------------------------------------------------~CHypoList
 CHypoList::~CHypoList() {
+	// the hypos may outlive us
+	std::lock_guard<std::recursive_mutex> listGuard(m_HypoListMutex);
+	for (auto &hypo : m_mHypo) {
+		hypo.second->setHypoList(NULL);
+	}
 }
 
 // ---------------------------------------------------------addHypo
@@ -274,6 +286,13 @@ bool CHypoList::addHypo(std::shared_ptr<CHypo> hypo, bool scheduleProcessing,
 	// add to hypo map
 	m_mHypo[hypo->getID()] = hypo;
 
+	// add to the space-time index
+	addToIndex(hypo);
+
+	// the hypo tells us when its association distance cutoff changes
+	hypo->setHypoList(this);
+	invalidateMaxAssociationDistanceCutoff();
+
 	// Schedule this hypo for refinement. Note that this
 	// hypo will be the first one in the queue, and will be the
 	// first one processed.
@@ -296,14 +315,19 @@ bool CHypoList::associateData(std::shared_ptr<CPick> pk) {
 	}
 
 	std::vector<std::shared_ptr<CHypo>> assocHypoList;
+	glass3::util::Geo &siteGeo = pk->getSite()->getGeo();
+	double siteLat, siteLon, siteRadius;
+	siteGeo.getGeographic(&siteLat, &siteLon, &siteRadius);
 
 	// compute the list of hypos to associate with
-	// (a potential hypo must be before the pick we're associating)
+	// (a potential hypo must be before the pick we're associating, and
+	// within the largest association distance of the pick's station)
 	// use the pick time minus 3600 seconds to compute the starting index
 	// NOTE: Hard coded time delta
 	std::vector<std::weak_ptr<CHypo>> hypoList = getHypos(
 			pk->getTPick() - k_nHypoSearchPastDurationForPick,
-			pk->getTPick() + 10.0);
+			pk->getTPick() + 10.0, siteLat, siteLon,
+			getMaxAssociationDistanceCutoff());
 
 	// make sure we got any hypos
 	if (hypoList.size() == 0) {
@@ -316,6 +340,11 @@ bool CHypoList::associateData(std::shared_ptr<CPick> pk) {
 
 	double sdassoc = CGlass::getAssociationSDCutoff();
 
+	// the widest residual window canAssociate could allow for an early
+	// arrival
+	double earlyTolerance = CGlass::k_dAssociationSecondsPerSigma * sdassoc
+			* std::max(1.0, CGlass::getNonLocatingPhaseCutoffFactor());
+
 	// for each hypo in the list within the time range
 	for (int i = 0; i < hypoList.size(); i++) {
 		// make sure hypo is still valid before associating
@@ -324,6 +353,27 @@ bool CHypoList::associateData(std::shared_ptr<CPick> pk) {
 			double bayesValue = hyp->getBayesValue();
 			double nucleationThreshold = hyp->getNucleationStackThreshold();
 
+			// cheaply reject hypos that are beyond their association distance
+			// from this station, or that this pick arrives too early for
+			// any phase to reach this station from, before doing the
+			// expensive association check
+			glass3::util::Geo hypoGeo;
+			hypoGeo.setGeographic(hyp->getLatitude(), hyp->getLongitude(),
+									glass3::util::Geo::k_EarthRadiusKm);
+			double siteDelta = hypoGeo.delta(&siteGeo);
+			if ((siteDelta * glass3::util::GlassMath::k_RadiansToDegrees)
+					> hyp->getAssociationDistanceCutoff()) {
+				continue;
+			}
+			double chordKm = 2.0 * glass3::util::Geo::k_EarthRadiusKm
+					* std::sin(siteDelta / 2.0);
+			double minTravelTime = (chordKm - hyp->getDepth())
+					/ k_dMaximumSeismicVelocity;
+			if ((pk->getTPick() - hyp->getTOrigin())
+					< (minTravelTime - earlyTolerance)) {
+				continue;
+			}
+
 			// move on if it cannot associate
 			if (hyp->canAssociate(pk, CGlass::k_dAssociationSecondsPerSigma,
 									sdassoc, false, true) == false) {
@@ -390,14 +440,18 @@ bool CHypoList::fitData(std::shared_ptr<CPick> pk) {
 	}
 	bool debug = true;
 	std::vector<std::shared_ptr<CHypo>> assocHypoList;
+	double siteLat, siteLon, siteRadius;
+	pk->getSite()->getGeo().getGeographic(&siteLat, &siteLon, &siteRadius);
 
 	// compute the list of hypos to associate with
-	// (a potential hypo must be before the pick we're associating)
+	// (a potential hypo must be before the pick we're associating, and
+	// within the fit distance limit of the pick's station)
 	// use the pick time minus 3600 seconds to compute the starting index
 	// NOTE: Hard coded time delta
 	std::vector<std::weak_ptr<CHypo>> hypoList = getHypos(
 			pk->getTPick() - k_nHypoSearchPastDurationForPick,
-			pk->getTPick() + 10.0);
+			pk->getTPick() + 10.0, siteLat, siteLon,
+			std::min(17.5, getMaxAssociationDistanceCutoff()));
 
 	// make sure we got any hypos
 	if (hypoList.size() == 0) {
@@ -583,8 +637,19 @@ void CHypoList::clear() {
 	m_lHypoProcessingQueue.clear();
 
 	std::lock_guard<std::recursive_mutex> listGuard(m_HypoListMutex);
+	for (auto &hypo : m_mHypo) {
+		hypo.second->setHypoList(NULL);
+	}
 	m_msHypoList.clear();
 	m_mHypo.clear();
+	m_mHypoIndex.clear();
+	m_mHypoIndexCell.clear();
+	m_dMaxAssociationDistanceCutoff = 0.0;
+	m_bMaxAssociationDistanceCutoffValid = true;
+
+	m_ProcessingStageTimesMutex.lock();
+	m_mProcessingStageTimes.clear();
+	m_ProcessingStageTimesMutex.unlock();
 
 	// reset
 	m_iCountOfTotalHyposProcessed = 0;
@@ -761,6 +826,11 @@ bool CHypoList::processHypo(std::shared_ptr<CHypo> hyp) {
 	hyp->incrementTotalProcessCount();
 	hyp->setProcessCount(hyp->getProcessCount() + 1);
 
+	static std::atomic<int64_t> &processCounter =
+			glass3::util::MetricsRegistry::getInstance().getCounter(
+					"hypolist.processed");
+	processCounter++;
+
 	// initialize breport, gets set to true later if event isn't cancelled.
 	// otherwise, in some cases events will not be reported.
 	bool breport = false;
@@ -782,6 +852,7 @@ bool CHypoList::processHypo(std::shared_ptr<CHypo> hyp) {
 	double localizeTime = std::chrono::duration_cast<
 			std::chrono::duration<double>>(tLocalizeEndTime - tEvolveStartTime)
 			.count();
+	addProcessingStageTime(Localize, localizeTime);
 
 	// now that we've got a location, see if we can merge any proximal events
 	// note that if successful findAndMergeMatchingHypos does a localize
@@ -816,6 +887,7 @@ bool CHypoList::processHypo(std::shared_ptr<CHypo> hyp) {
 	double mergeTime =
 			std::chrono::duration_cast<std::chrono::duration<double>>(
 					tMergeEndTime - tLocalizeEndTime).count();
+	addProcessingStageTime(Merge, mergeTime);
 
 	// Search for any associable picks that match hypo in the pick list
 	// NOTE: This uses the hard coded 3600 second scavenge duration default
@@ -845,6 +917,7 @@ bool CHypoList::processHypo(std::shared_ptr<CHypo> hyp) {
 	double scavengeTime = std::chrono::duration_cast<
 			std::chrono::duration<double>>(tScavengeEndTime - tMergeEndTime)
 			.count();
+	addProcessingStageTime(Scavenge, scavengeTime);
 
 	// Remove data that no longer fit hypo's association criteria
 	if (hyp->pruneData(this)) {
@@ -871,6 +944,7 @@ bool CHypoList::processHypo(std::shared_ptr<CHypo> hyp) {
 	double pruneTime =
 			std::chrono::duration_cast<std::chrono::duration<double>>(
 					tPruneEndTime - tScavengeEndTime).count();
+	addProcessingStageTime(Prune, pruneTime);
 
 	// Ensure all remaining data belong to hypo
 	if (resolveData(hyp)) {
@@ -890,6 +964,7 @@ bool CHypoList::processHypo(std::shared_ptr<CHypo> hyp) {
 	double resolveTime = std::chrono::duration_cast<
 			std::chrono::duration<double>>(tResolveEndTime - tPruneEndTime)
 			.count();
+	addProcessingStageTime(Resolve, resolveTime);
 
 	// check to see if this hypo is viable.
 	if (hyp->cancelCheck()) {
@@ -911,6 +986,10 @@ bool CHypoList::processHypo(std::shared_ptr<CHypo> hyp) {
 				std::chrono::duration<double>>(
 				tRemoveEndTime - tEvolveStartTime).count();
 
+		addProcessingStageTime(Cancel, cancelTime);
+		addProcessingStageTime(Remove, removeTime);
+		addProcessingStageTime(Evolve, evolveTime);
+
 		glass3::util::Logger::log(
 				"debug",
 				"CHypoList::processHypo: Canceled sPid:" + pid + " cycle:"
@@ -935,6 +1014,7 @@ bool CHypoList::processHypo(std::shared_ptr<CHypo> hyp) {
 	double cancelTime =
 			std::chrono::duration_cast<std::chrono::duration<double>>(
 					tCancelEndTime - tResolveEndTime).count();
+	addProcessingStageTime(Cancel, cancelTime);
 
 	// announce if a correlation has been added to an existing event
 	// NOTE: Is there a better way to do this?
@@ -1001,6 +1081,13 @@ bool CHypoList::processHypo(std::shared_ptr<CHypo> hyp) {
 			std::chrono::duration_cast<std::chrono::duration<double>>(
 					tTrapEndTime - tEvolveStartTime).count();
 
+	addProcessingStageTime(
+			Report,
+			std::chrono::duration_cast<std::chrono::duration<double>>(
+					tReportEndTime - tCancelEndTime).count());
+	addProcessingStageTime(Trap, trapTime);
+	addProcessingStageTime(Evolve, evolveTime);
+
 	glass3::util::Logger::log(
 			"debug",
 			"CHypoList::processHypo: Finished sPid:" + pid + " cycle:"
@@ -1041,6 +1128,55 @@ int CHypoList::getHypoProcessingQueueLength() {
 	return (size);
 }
 
+// -----------------------------------------------getProcessingStageTimes
+std::map<std::string, double> CHypoList::getProcessingStageTimes() {
+	std::lock_guard<std::mutex> timesGuard(m_ProcessingStageTimesMutex);
+	return (m_mProcessingStageTimes);
+}
+
+// ------------------------------------------------getProcessingStageName
+const std::string & CHypoList::getProcessingStageName(
+		ProcessingStage stage) {
+	static const std::string stageNames[k_iNumProcessingStages] = {
+			"localize", "merge", "scavenge", "prune", "resolve", "cancel",
+			"remove", "report", "trap", "evolve" };
+	static const std::string unknownName = "unknown";
+
+	if ((stage < 0) || (stage >= k_iNumProcessingStages)) {
+		return (unknownName);
+	}
+	return (stageNames[stage]);
+}
+
+// ------------------------------------------------addProcessingStageTime
+void CHypoList::addProcessingStageTime(ProcessingStage stage,
+										double seconds) {
+	if ((stage < 0) || (stage >= k_iNumProcessingStages)) {
+		return;
+	}
+
+	// look up the histograms of the stages once, rather than on every call
+	static const std::vector<glass3::util::LatencyHistogram *>
+		stageHistograms = []() {
+			glass3::util::MetricsRegistry &registry =
+					glass3::util::MetricsRegistry::getInstance();
+			std::vector<glass3::util::LatencyHistogram *> histograms;
+			for (int i = 0; i < k_iNumProcessingStages; i++) {
+				histograms.push_back(&registry.getHistogram(
+						"hypolist."
+								+ getProcessingStageName(
+										static_cast<ProcessingStage>(i))
+								+ "_us"));
+			}
+			return (histograms);
+		}();
+
+	stageHistograms[stage]->record(static_cast<int64_t>(seconds * 1000000.0));
+
+	std::lock_guard<std::mutex> timesGuard(m_ProcessingStageTimesMutex);
+	m_mProcessingStageTimes[getProcessingStageName(stage)] += seconds;
+}
+
 // ---------------------------------------------------------getHypos
 std::vector<std::weak_ptr<CHypo>> CHypoList::getHypos(double t1, double t2) {
 	std::vector<std::weak_ptr<CHypo>> hypos;
@@ -1122,6 +1258,141 @@ std::vector<std::weak_ptr<CHypo>> CHypoList::getHypos(double t1, double t2) {
 	return (hypos);
 }
 
+// ---------------------------------------------------------getHypos
+std::vector<std::weak_ptr<CHypo>> CHypoList::getHypos(double t1, double t2,
+														double lat, double lon,
+														double maxDistance) {
+	// no useful distance restriction, just use the time window
+	if ((maxDistance < 0) || (maxDistance >= 180.0)) {
+		return (getHypos(t1, t2));
+	}
+
+	std::vector<std::weak_ptr<CHypo>> hypos;
+
+	if (t1 == t2) {
+		return (hypos);
+	}
+	// swap t1 and t2 if necessary so that t1 <= t2
+	if (t1 > t2) {
+		double temp = t2;
+		t2 = t1;
+		t1 = temp;
+	}
+
+	std::shared_ptr<traveltime::CTravelTime> nullTrav;
+	std::shared_ptr<traveltime::CTTT> nullTTT;
+
+	// construct the lower and upper bound values. std::multiset requires
+	// that these be in the form of a std::shared_ptr<CHypo>
+	std::shared_ptr<CHypo> lowerValue = std::make_shared<CHypo>(0, 0, 0, t1, "",
+																"", 0, 0, 0,
+																nullTrav,
+																nullTrav,
+																nullTTT);
+	std::shared_ptr<CHypo> upperValue = std::make_shared<CHypo>(0, 0, 0, t2, "",
+																"", 0, 0, 0,
+																nullTrav,
+																nullTrav,
+																nullTTT);
+
+	// compute the range of index cells to search, padded by one cell to
+	// allow for hypos that have moved since they were indexed
+	int numRows = static_cast<int>(std::ceil(180.0 / k_dIndexCellSize));
+	int numCols = static_cast<int>(std::ceil(360.0 / k_dIndexCellSize));
+	double searchDistance = maxDistance + k_dIndexCellSize;
+	double minLat = lat - searchDistance;
+	double maxLat = lat + searchDistance;
+	int minRow = std::max(0, static_cast<int>(
+			std::floor((minLat + 90.0) / k_dIndexCellSize)));
+	int maxRow = std::min(numRows - 1, static_cast<int>(
+			std::floor((maxLat + 90.0) / k_dIndexCellSize)));
+
+	// search all longitudes if the search area contains a pole or is
+	// too wide, otherwise search the longitudes spanned at the highest
+	// latitude of the search area
+	int minCol = 0;
+	int maxCol = numCols - 1;
+	if ((minLat > -90.0) && (maxLat < 90.0)) {
+		double highLat = std::max(std::abs(minLat), std::abs(maxLat));
+		double lonDistance = searchDistance
+				/ std::cos(highLat * glass3::util::GlassMath::k_DegreesToRadians);
+
+		if (lonDistance < 180.0) {
+			int lonCol = getIndexCell(0.0, lon) % numCols;
+			int colSpan = static_cast<int>(
+					std::ceil(lonDistance / k_dIndexCellSize));
+			minCol = lonCol - colSpan;
+			maxCol = lonCol + colSpan;
+		}
+	}
+	if ((maxCol - minCol) >= numCols) {
+		minCol = 0;
+		maxCol = numCols - 1;
+	}
+
+	glass3::util::Geo centerGeo;
+	centerGeo.setGeographic(lat, lon, glass3::util::Geo::k_EarthRadiusKm);
+
+	std::vector<std::shared_ptr<CHypo>> found;
+
+	std::lock_guard<std::recursive_mutex> listGuard(m_HypoListMutex);
+
+	// don't bother if the list is empty
+	if (m_msHypoList.size() == 0) {
+		return (hypos);
+	}
+
+	// for each index cell in the search area
+	for (int row = minRow; row <= maxRow; row++) {
+		for (int col = minCol; col <= maxCol; col++) {
+			int cell = (row * numCols) + (((col % numCols) + numCols) % numCols);
+
+			auto cellIt = m_mHypoIndex.find(cell);
+			if (cellIt == m_mHypoIndex.end()) {
+				continue;
+			}
+
+			// get the hypos in the time window for this cell
+			std::multiset<std::shared_ptr<CHypo>, HypoCompare> &cellList =
+					cellIt->second;
+			std::multiset<std::shared_ptr<CHypo>, HypoCompare>::iterator lower =
+					cellList.lower_bound(lowerValue);
+			std::multiset<std::shared_ptr<CHypo>, HypoCompare>::iterator upper =
+					cellList.upper_bound(upperValue);
+
+			for (std::multiset<std::shared_ptr<CHypo>, HypoCompare>::iterator it =
+					lower; ((it != upper) && (it != cellList.end())); ++it) {
+				std::shared_ptr<CHypo> aHypo = *it;
+
+				if (aHypo == NULL) {
+					continue;
+				}
+
+				// check the hypo's current distance from the search center
+				glass3::util::Geo hypoGeo;
+				hypoGeo.setGeographic(aHypo->getLatitude(), aHypo->getLongitude(),
+										glass3::util::Geo::k_EarthRadiusKm);
+				double distance = centerGeo.delta(&hypoGeo)
+						* glass3::util::GlassMath::k_RadiansToDegrees;
+
+				if (distance <= maxDistance) {
+					found.push_back(aHypo);
+				}
+			}
+		}
+	}
+
+	// return the hypos in time order, as the time only query does
+	std::stable_sort(found.begin(), found.end(), HypoCompare());
+
+	for (auto aHypo : found) {
+		hypos.push_back(std::weak_ptr<CHypo>(aHypo));
+	}
+
+	// return the list of hypos we found
+	return (hypos);
+}
+
 // ---------------------------------------------------------getHypoMax
 int CHypoList::getMaxAllowableHypoCount() const {
 	return (m_iMaxAllowableHypoCount);
@@ -1157,9 +1428,10 @@ bool CHypoList::findAndMergeMatchingHypos(std::shared_ptr<CHypo> hypo) {
 	bool merged = false;
 
 	// Get the list of hypos to try merging with with
-	// (a potential hypo must be within time cut to consider)
+	// (a potential hypo must be within time cut and distance cut to consider)
 	std::vector<std::weak_ptr<CHypo>> mergeList = getHypos(
-			hypo->getTOrigin() - timeCut, hypo->getTOrigin() + timeCut);
+			hypo->getTOrigin() - timeCut, hypo->getTOrigin() + timeCut,
+			hypo->getLatitude(), hypo->getLongitude(), distanceCut);
 
 	setThreadHealth();
 
@@ -1488,6 +1760,9 @@ bool CHypoList::findAndMergeMatchingHypos(std::shared_ptr<CHypo> hypo) {
 			// fromHypo, since it was successfully merged
 			removeHypo(fromHypo);
 
+			// intoHypo may have moved, so update its position
+			updatePosition(intoHypo);
+
 			// we've merged a hypo, move on to the next candidate
 			merged = true;
 		} else if (newBayes
@@ -1745,6 +2020,11 @@ void CHypoList::removeHypo(std::shared_ptr<CHypo> hypo, bool reportCancel) {
 	// remove from from multiset
 	eraseFromMultiset(hypo);
 
+	// remove from the space-time index
+	eraseFromIndex(hypo);
+	hypo->setHypoList(NULL);
+	invalidateMaxAssociationDistanceCutoff();
+
 	// erase this hypo from the map
 	m_HypoListMutex.lock();
 	m_mHypo.erase(hypo->getID());
@@ -1880,6 +2160,8 @@ void CHypoList::updatePosition(std::shared_ptr<CHypo> hyp) {
 	// erase
 	eraseFromMultiset(hyp);
 
+	eraseFromIndex(hyp);
+
 	// update tSort
 	hyp->setTSort(hyp->getTOrigin());
 
@@ -1887,6 +2169,7 @@ void CHypoList::updatePosition(std::shared_ptr<CHypo> hyp) {
 
 	// insert
 	m_msHypoList.insert(hyp);
+	addToIndex(hyp);
 }
 
 // ---------------------------------------------------------updatePosition
@@ -1956,4 +2239,122 @@ void CHypoList::eraseFromMultiset(std::shared_ptr<CHypo> hyp) {
 			"CHypoList::eraseFromMultiset: did not delete hypo " + hyp->getID()
 					+ " in multiset, id not found.");
 }
+
+// ---------------------------------------------------------addToIndex
+void CHypoList::addToIndex(std::shared_ptr<CHypo> hyp) {
+	// nullchecks
+	if (hyp == NULL) {
+		return;
+	}
+	if (hyp->getID() == "") {
+		return;
+	}
+
+	std::lock_guard<std::recursive_mutex> listGuard(m_HypoListMutex);
+
+	int cell = getIndexCell(hyp->getLatitude(), hyp->getLongitude());
+
+	m_mHypoIndex[cell].insert(hyp);
+	m_mHypoIndexCell[hyp->getID()] = cell;
+}
+
+// ---------------------------------------------------------eraseFromIndex
+void CHypoList::eraseFromIndex(std::shared_ptr<CHypo> hyp) {
+	// nullchecks
+	if (hyp == NULL) {
+		return;
+	}
+	if (hyp->getID() == "") {
+		return;
+	}
+
+	std::lock_guard<std::recursive_mutex> listGuard(m_HypoListMutex);
+
+	// find the cell this hypo was indexed in
+	auto cellIt = m_mHypoIndexCell.find(hyp->getID());
+	if (cellIt == m_mHypoIndexCell.end()) {
+		return;
+	}
+	int cell = cellIt->second;
+	m_mHypoIndexCell.erase(cellIt);
+
+	auto listIt = m_mHypoIndex.find(cell);
+	if (listIt == m_mHypoIndex.end()) {
+		return;
+	}
+	std::multiset<std::shared_ptr<CHypo>, HypoCompare> &cellList =
+			listIt->second;
+
+	// like eraseFromMultiset, multiple hypos can have the same tSort, so
+	// confirm the id, falling back to searching the whole cell in case the
+	// tSort has changed since the hypo was indexed
+	std::multiset<std::shared_ptr<CHypo>, HypoCompare>::iterator it;
+	bool erased = false;
+	for (it = cellList.lower_bound(hyp);
+			((it != cellList.upper_bound(hyp)) && (it != cellList.end()));
+			++it) {
+		if ((*it)->getID() == hyp->getID()) {
+			cellList.erase(it);
+			erased = true;
+			break;
+		}
+	}
+	if (erased == false) {
+		for (it = cellList.begin(); it != cellList.end(); ++it) {
+			if ((*it)->getID() == hyp->getID()) {
+				cellList.erase(it);
+				break;
+			}
+		}
+	}
+
+	// don't keep empty cells around
+	if (cellList.size() == 0) {
+		m_mHypoIndex.erase(listIt);
+	}
+}
+
+// ----------------------------------------------getMaxAssociationDistanceCutoff
+double CHypoList::getMaxAssociationDistanceCutoff() {
+	std::lock_guard<std::recursive_mutex> listGuard(m_HypoListMutex);
+
+	// only rescan the hypos if something changed since the last time, a
+	// cutoff changing during the scan marks the cache out of date again
+	if (m_bMaxAssociationDistanceCutoffValid.exchange(true) == false) {
+		double maxCutoff = 0.0;
+		for (auto aHypo : m_msHypoList) {
+			if (aHypo->getAssociationDistanceCutoff() > maxCutoff) {
+				maxCutoff = aHypo->getAssociationDistanceCutoff();
+			}
+		}
+		m_dMaxAssociationDistanceCutoff = maxCutoff;
+	}
+
+	return (m_dMaxAssociationDistanceCutoff);
+}
+
+// ---------------------------------------invalidateMaxAssociationDistanceCutoff
+void CHypoList::invalidateMaxAssociationDistanceCutoff() {
+	m_bMaxAssociationDistanceCutoffValid = false;
+}
+
+// ---------------------------------------------------------getIndexCell
+int CHypoList::getIndexCell(double lat, double lon) {
+	int numRows = static_cast<int>(std::ceil(180.0 / k_dIndexCellSize));
+	int numCols = static_cast<int>(std::ceil(360.0 / k_dIndexCellSize));
+
+	// normalize longitude to [-180, 180)
+	lon = std::fmod(lon + 180.0, 360.0);
+	if (lon < 0) {
+		lon += 360.0;
+	}
+
+	int row = static_cast<int>(std::floor((lat + 90.0) / k_dIndexCellSize));
+	int col = static_cast<int>(std::floor(lon / k_dIndexCellSize));
+
+	row = std::min(std::max(row, 0), numRows - 1);
+	col = std::min(std::max(col, 0), numCols - 1);
+
+	return ((row * numCols) + col);
+}
 }  // namespace glasscore
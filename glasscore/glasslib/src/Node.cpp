@@ -13,6 +13,8 @@
 #include <vector>
 #include <cmath>
 #include <set>
+#include <map>
+#include <cstdint>
 #include "Glass.h"
 #include "Web.h"
 #include "Trigger.h"
@@ -27,6 +29,8 @@ constexpr double CNode::k_dTravelTimePickSelectionWindow;
 constexpr double CNode::k_dDepthShellResolutionKm;
 constexpr double CNode::k_dGridPointVsResolutionRatio;
 constexpr double CNode::k_residualDistanceAllowanceFactor;
+constexpr double CNode::k_dSiteSignificanceThreshold;
+constexpr double CNode::k_dPickStackSigmaRange;
 
 // site Link sorting function
 // Compares site links using travel times
@@ -52,12 +56,14 @@ bool sortSiteLink(const SiteLink &lhs, const SiteLink &rhs) {
 
 // ---------------------------------------------------------CNode
 CNode::CNode() {
+	m_NodeMutex.setName("CNode::m_NodeMutex");
 	clear();
 }
 
 // ---------------------------------------------------------CNode
 CNode::CNode(std::string name, double lat, double lon, double z,
 				double resolution, double maxDepth, bool aseismic) {
+	m_NodeMutex.setName("CNode::m_NodeMutex");
 	if (!initialize(name, lat, lon, z, resolution, maxDepth, aseismic)) {
 		clear();
 	}
@@ -69,7 +75,8 @@ CNode::~CNode() {
 
 // ---------------------------------------------------------clear
 void CNode::clear() {
-	std::lock_guard < std::recursive_mutex > nodeGuard(m_NodeMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> nodeGuard(
+			m_NodeMutex);
 
 	clearSiteLinks();
 
@@ -82,6 +89,8 @@ void CNode::clear() {
 	m_dMaxDepth = 0;
 	m_bEnabled = false;
 	m_bAseismic = false;
+	m_bCoarse = false;
+	m_wpParentNode.reset();
 	m_SourceSet.clear();
 }
 
@@ -92,10 +101,6 @@ void CNode::clearSiteLinks() {
 
 	m_dMaxSiteDistance = 0;
 
-	if (m_vSiteLinkList.size() == 0) {
-		return;
-	}
-
 	// remove any links that sites have TO this node
 	for (auto &link : m_vSiteLinkList) {
 		std::shared_ptr<CSite> aSite = std::get < LINK_PTR > (link);
@@ -104,12 +109,18 @@ void CNode::clearSiteLinks() {
 
 	// remove all the links from this node to sites
 	m_vSiteLinkList.clear();
+	m_iActiveSiteCount = 0;
+	m_iActivePickLimit = 0;
+
+	// without sites, there are no picks to stack
+	clearPickStack();
 }
 
 // ---------------------------------------------------------initialize
 bool CNode::initialize(std::string name, double lat, double lon, double z,
 						double resolution, double maxDepth, bool aseismic) {
-	std::lock_guard < std::recursive_mutex > nodeGuard(m_NodeMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> nodeGuard(
+			m_NodeMutex);
 
 	clear();
 
@@ -152,7 +163,8 @@ bool CNode::linkSite(std::shared_ptr<CSite> site, std::shared_ptr<CNode> node,
 									phase2, distDeg);
 	m_vSiteLinkList.push_back(link);
 
-	// link site to node, again using the traveltime
+	// link site to node, again using the traveltime, the site stacks the
+	// picks it already has with this node
 	// NOTE: this used to be site->addNode(shared_ptr<CNode>(this), tt);
 	// but that caused problems when deleting site-node links.
 	site->addNode(node, distDeg, travelTime1, phase1, travelTime2, phase2);
@@ -225,6 +237,9 @@ bool CNode::unlinkSite(std::shared_ptr<CSite> site) {
 			// done after unlock to avoid node-site deadlocks
 			foundSite->removeNode(getID());
 
+			// remove the site's picks from the stack
+			removeSiteFromStack(foundSite);
+
 			return (true);
 		}
 	}
@@ -254,6 +269,9 @@ bool CNode::unlinkLastSite() {
 	// unlink last site from node
 	m_vSiteLinkList.pop_back();
 
+	// remove the site's picks from the stack
+	removeSiteFromStack(lastSite);
+
 	// recompute furthest site distance
 	m_dMaxSiteDistance = 0;
 	for (const auto &link : m_vSiteLinkList) {
@@ -271,7 +289,8 @@ bool CNode::unlinkLastSite() {
 // ---------------------------------------------------------nucleate
 std::shared_ptr<CTrigger> CNode::nucleate(double tOrigin,
 		CPickList* parentThread) {
-	std::lock_guard < std::recursive_mutex > nodeGuard(m_NodeMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> nodeGuard(
+			m_NodeMutex);
 	// don't nucleate if this node is disabled
 	if (m_bEnabled == false) {
 		return (NULL);
@@ -296,10 +315,20 @@ std::shared_ptr<CTrigger> CNode::nucleate(double tOrigin,
 		dThresh = m_pWeb->getASeismicNucleationStackThreshold();
 	}
 
-	double dAzimuthRange = CGlass::getBeamMatchingAzimuthWindow();
-	// commented out because slowness matching of beams is not yet implemented
-	// but is scheduled to be soon
-	// double dDistanceRange = CGlass::getBeamMatchingDistanceWindow();
+	// a coarse node only has to come close to the thresholds to open up
+	// the fine nodes under it
+	if (m_bCoarse == true) {
+		double factor = m_pWeb->getCoarseThresholdFactor();
+		nCut = std::max(1, static_cast<int>(std::floor(nCut * factor)));
+		dThresh *= factor;
+	}
+
+	// skip the node if too few of its sites have picks to reach the count
+	// threshold, without looking at any of them
+	if (m_iActivePickLimit < nCut) {
+		m_pWeb->countNucleationSkip();
+		return (NULL);
+	}
 
 	// init overall significance sum and node site count
 	// to 0
@@ -308,10 +337,90 @@ std::shared_ptr<CTrigger> CNode::nucleate(double tOrigin,
 
 	std::vector < std::shared_ptr < CPick >> vPick;
 
+	// stack the best pick at each site linked to this node, either from the
+	// incrementally maintained pick stack, or by scanning each site's picks
+	// either engine stops early once the thresholds can no longer be reached
+	bool haltNucleation = false;
+	bool exitedEarly = false;
+	// coarse nodes don't keep a pick stack, see CSite::addPickToNodeStacks
+	if ((CGlass::getIncrementalNucleation() == true) && (m_bCoarse == false)) {
+		haltNucleation = !readPickStack(tOrigin, parentThread, nCut, dThresh,
+										&dSum, &nCount, &vPick, &exitedEarly);
+	} else {
+		haltNucleation = !scanSitePicks(tOrigin, parentThread, nCut, dThresh,
+										&dSum, &nCount, &vPick, &exitedEarly);
+	}
+
+	// keep track of how often nucleation is cut short
+	m_pWeb->countNucleation(exitedEarly);
+
+	// signal that we're still here
+	if (parentThread != NULL) {
+		parentThread->setThreadHealth();
+	}
+
+	// if we were halted, the node did not nucleate an event, return null
+	if (haltNucleation == true) {
+		return (NULL);
+	}
+
+	// make sure the number of significant picks
+	// exceeds the nucleation threshold
+	if (nCount < nCut) {
+		// the node did not nucleate an event
+		return (NULL);
+	}
+
+	// make sure the total node significance exceeds the
+	// significance threshold
+	if (dSum < dThresh) {
+		// the node did not nucleate an event
+		return (NULL);
+	}
+
+	// create trigger
+	std::shared_ptr<CTrigger> trigger(
+			new CTrigger(m_dLatitude, m_dLongitude, m_dDepth, tOrigin,
+							m_dResolution, m_dMaxDepth, dSum, nCount,
+							m_bAseismic, vPick, m_pWeb));
+
+	// the node nucleated an event
+	return (trigger);
+}
+
+// ---------------------------------------------------------scanSitePicks
+bool CNode::scanSitePicks(double tOrigin, CPickList* parentThread,
+							int countThreshold, double sumThreshold,
+							double *sum, int *count,
+							std::vector<std::shared_ptr<CPick>> *picks,
+							bool *exitedEarly) {
 	// lock mutex for this scope (iterating through the site links)
 	std::lock_guard < std::mutex > guard(m_SiteLinkListMutex);
 
 	bool haltNucleation = false;
+	*exitedEarly = false;
+
+	// each usable site can add at most one pick with a significance of at
+	// most 1.0 per valid travel time, which bounds what the sites not yet
+	// searched can add. This only reads the links, the site picks are only
+	// locked once, while searching them
+	int maxRemaining = 0;
+	for (const auto &link : m_vSiteLinkList) {
+		std::shared_ptr<CSite> site = std::get < LINK_PTR > (link);
+		if ((site->getUse() == false) || (site->getEnable() == false)) {
+			continue;
+		}
+
+		maxRemaining += getMaximumLinkContribution(
+				std::get < LINK_TT1 > (link), std::get < LINK_TT2 > (link));
+	}
+
+	// give up if the usable sites can't reach the thresholds
+	if ((maxRemaining < countThreshold)
+			|| (static_cast<double>(maxRemaining) < sumThreshold)) {
+		*exitedEarly = true;
+		return (false);
+	}
 
 	// search through each site linked to this node
 	for (const auto &link : m_vSiteLinkList) {
@@ -351,44 +460,14 @@ std::shared_ptr<CTrigger> CNode::nucleate(double tOrigin,
 		std::string phase2 = std::get < LINK_PHS2 > (link);
 		double distDeg = std::get < LINK_DIST > (link);
 
-		// the minimum and maximum time windows for picks
+		// the minimum and maximum time windows for picks, and the exclusion
+		// window within min and max that we don't want picks from
 		double min = 0.0;
 		double max = 0.0;
-
-		// the exclusion window within min and max that we don't want
-		// picks from
 		double dtExcludeBegin = 0.0;
 		double dtExcludeEnd = 0.0;
-
-		// use traveltimes to compute min and max
-		if ((travelTime1 >= 0) && (travelTime2 >= 0)) {
-			// both travel times are valid
-			if (travelTime1 <= travelTime2) {
-				// TT1 smaller/shorter/faster
-				min = tOrigin + travelTime1
-						- (k_dTravelTimePickSelectionWindow / 2);
-				max = tOrigin + travelTime2
-						+ (k_dTravelTimePickSelectionWindow / 2);
-			} else {
-				// TT2 smaller/shorter/faster
-				min = tOrigin + travelTime2
-						- (k_dTravelTimePickSelectionWindow / 2);
-				max = tOrigin + travelTime1
-						+ (k_dTravelTimePickSelectionWindow / 2);
-			}
-		} else if (travelTime1 >= 0) {
-			// Only TT1 valid
-			min = tOrigin + travelTime1
-					- (k_dTravelTimePickSelectionWindow / 2);
-			max = tOrigin + travelTime1
-					+ (k_dTravelTimePickSelectionWindow / 2);
-		} else if (travelTime2 >= 0) {
-			// Only TT2 valid
-			min = tOrigin + travelTime2
-					- (k_dTravelTimePickSelectionWindow / 2);
-			max = tOrigin + travelTime2
-					+ (k_dTravelTimePickSelectionWindow / 2);
-		} else {
+		if (getPickWindow(tOrigin, travelTime1, travelTime2, &min, &max,
+							&dtExcludeBegin, &dtExcludeEnd) == false) {
 			// no valid TTs
 			glass3::util::Logger::log(
 					"error", "CNode::nucleate: Bad Node Traveltimes while generating pick"
@@ -396,19 +475,6 @@ std::shared_ptr<CTrigger> CNode::nucleate(double tOrigin,
 			continue;
 		}
 
-		// use min and max to compute exclusion window
-		if ((max - min) > k_dTravelTimePickSelectionWindow) {
-			// we have two different TTs and there's a window of picks
-			// in between the two TTs we don't want
-			dtExcludeBegin = min + (k_dTravelTimePickSelectionWindow / 2) * 2.0;
-			dtExcludeEnd = max - (k_dTravelTimePickSelectionWindow / 2) * 2.0;
-			if (dtExcludeEnd < dtExcludeBegin) {
-				// we effectively don't have a window because our two windows
-				// overlap.
-				dtExcludeBegin = 0.0;
-			}
-		}
-
 		// lock site pick list while we're extracting our picks
 		site->getPickMutex().lock();
 
@@ -431,18 +497,6 @@ std::shared_ptr<CTrigger> CNode::nucleate(double tOrigin,
 				continue;
 			}
 
-			// skip this pick if it's not in the set of allowed sources
-			std::string pickSource = pick->getSource();
-			if ((m_SourceSet.empty() == false) &&
-				(pickSource != "") &&
-				(m_SourceSet.find(pickSource) == m_SourceSet.end())) {
-				// we have a set of allowed sources
-				// and we have a valid pick source
-				// and the source is NOT found in allowed sources
-				// so skip this pick
-				continue;
-			}
-
 			/*
 			// check to see if the pick is currently associated to a hypo
 			std::shared_ptr<CHypo> pHypo = pick->getHypoReference();
@@ -477,136 +531,16 @@ std::shared_ptr<CTrigger> CNode::nucleate(double tOrigin,
 				continue;
 			}
 
-			// get the picks back azimuth
-			double backAzimuth = pick->getBackAzimuth();
+			// check the pick's source, beam, and classifications
+			if (checkPickForNucleation(pick, phase1, phase2, &phase1set,
+										&phase2set) == false) {
+				continue;
+			}
 
 			// compute observed travel time from the pick time and
 			// the provided origin time
 			double tObs = tPick - tOrigin;
 
-			// check backazimuth if present
-			if (backAzimuth > 0) {
-				// set up a geo for distance calculations
-				glass3::util::Geo nodeGeo;
-				nodeGeo.setGeographic(
-						m_dLatitude, m_dLongitude,
-						glass3::util::Geo::k_EarthRadiusKm - m_dDepth);
-
-				// compute azimuth from the site to the node
-				double siteAzimuth = pick->getSite()->getGeo().azimuth(
-						&nodeGeo);
-
-				// check to see if pick's backazimuth is within the
-				// valid range
-				if (glass3::util::GlassMath::angleDifference(backAzimuth,
-																siteAzimuth)
-						> dAzimuthRange) {
-					// it is not, do not nucleate
-					continue;
-				}
-			}
-
-			// check slowness if present
-			// Need modify travel time libraries to support getting distance
-			// from slowness, and it's of limited value compared to the back
-			// azimuth check
-			/*if (pick->dSlowness > 0) {
-			 // compute distance from the site to the node
-			 double siteDistance = pick->pSite->getGeo().delta(&nodeGeo);
-			 // compute observed distance from slowness (1/velocity)
-			 // and tObs (distance = velocity * time)
-			 double obsDistance = (1 / pick->dSlowness) * tObs;
-			 // check to see if the observed distance is within the
-			 // valid range
-			 if ((obsDistance < (siteDistance - dDistanceRange))
-			 || (obsDistance > (siteDistance + dDistanceRange))) {
-			 // it is not, do not nucleate
-			 continue;
-			 }
-			 }
-			 */
-
-			// check pick classification
-			// are we configured to check pick phase classification
-			if (CGlass::getPickPhaseClassificationThreshold() > 0) {
-				// check to see if the phase classification is valid and above
-				// our threshold
-				if ((std::isnan(pick->getClassifiedPhaseProbability()) != true)
-						&& (pick->getClassifiedPhaseProbability()
-								> CGlass::getPickPhaseClassificationThreshold())) {
-					// check to see if the phase is classified as one of our
-					// nucleation phases
-					if (pick->getClassifiedPhase() == phase1) {
-						// match, we only consider traveltime1, disable
-						// traveltime2
-						phase1set = true;
-					} else if (pick->getClassifiedPhase() == phase2) {
-						// match, we only consider traveltime2, disable
-						// traveltime1
-						phase2set = true;
-					}
-					// otherwise there is no match and it's business as usual
-				}
-			}
-
-			// check azimuth classification
-			if (CGlass::getPickAzimuthClassificationThreshold() > 0) {
-				if ((std::isnan(pick->getClassifiedAzimuthProbability()) != true)
-						&& (pick->getClassifiedAzimuthProbability()
-								> CGlass::getPickAzimuthClassificationThreshold())) {
-					// set up a geo for azimuth calculations
-					glass3::util::Geo nodeGeo;
-					nodeGeo.setGeographic(
-							m_dLatitude, m_dLongitude,
-							glass3::util::Geo::k_EarthRadiusKm - m_dDepth);
-
-					// compute azimuth from the azimuth node to site
-					double siteAzimuth = nodeGeo.azimuth(
-							&(pick->getSite()->getGeo()))
-							* glass3::util::GlassMath::k_RadiansToDegrees;
-
-					// check to see if pick's backazimuth is within the
-					// valid range
-					if (glass3::util::GlassMath::angleDifference(
-							pick->getClassifiedAzimuth(), siteAzimuth)
-							> CGlass::getPickAzimuthClassificationUncertainty()) {
-						// it is not, do not nucleate
-						continue;
-					}
-				}
-			}
-
-			// check distance classification
-			if (CGlass::getPickDistanceClassificationThreshold() > 0) {
-				if ((std::isnan(pick->getClassifiedDistanceProbability())
-						!= true)
-						&& (pick->getClassifiedDistanceProbability()
-								> CGlass::getPickDistanceClassificationThreshold())) {
-					// set up a geo for distance calculations
-					glass3::util::Geo nodeGeo;
-					nodeGeo.setGeographic(
-							m_dLatitude, m_dLongitude,
-							glass3::util::Geo::k_EarthRadiusKm - m_dDepth);
-
-					// compute distance from the site to the node
-					double siteDistance = pick->getSite()->getGeo().delta(
-							&nodeGeo)
-							* glass3::util::GlassMath::k_RadiansToDegrees;
-
-					// check to see if pick's distance is within the
-					// valid range
-					if (siteDistance
-							< CGlass::getDistanceClassLowerBound(
-									pick->getClassifiedDistance())
-							|| siteDistance
-									> CGlass::getDistanceClassUpperBound(
-											pick->getClassifiedDistance())) {
-						// it is not, do not nucleate
-						continue;
-					}
-				}
-			}
-
 			// get the best significance from the observed time and link
 			double dSig1 = getSignificance(tObs, travelTime1, distDeg);
 			double dSig2 = getSignificance(tObs, travelTime2, distDeg);
@@ -641,67 +575,624 @@ std::shared_ptr<CTrigger> CNode::nucleate(double tOrigin,
 
 		// check to see if the pick with the highest significance at this site
 		// should be added to the overall sum from this site
-		// NOTE: This significance threshold is hard coded.
-		if ((dSigBest_phase1 >= 0.1) && (pickBest_phase1 != NULL)) {
+		if ((dSigBest_phase1 >= k_dSiteSignificanceThreshold)
+				&& (pickBest_phase1 != NULL)) {
 			// count this site
-			nCount++;
+			(*count)++;
 
 			// add the best pick significance to the node
 			// significance sum
-			dSum += dSigBest_phase1;
+			(*sum) += dSigBest_phase1;
 
 			// add the pick to the pick vector
-			vPick.push_back(pickBest_phase1);
+			picks->push_back(pickBest_phase1);
 		}
-		if ((dSigBest_phase2 >= 0.1) && (pickBest_phase2 != NULL)) {
+		if ((dSigBest_phase2 >= k_dSiteSignificanceThreshold)
+				&& (pickBest_phase2 != NULL)) {
 			// count this site
-			nCount++;
+			(*count)++;
 			// add the best pick significance to the node
 			// significance sum
-			dSum += dSigBest_phase2;
+			(*sum) += dSigBest_phase2;
 
 			// add the pick to the pick vector
-			vPick.push_back(pickBest_phase2);
+			picks->push_back(pickBest_phase2);
+		}
+
+		// give up once the rest of the active sites can't make up the
+		// difference to the thresholds
+		maxRemaining -= getMaximumLinkContribution(travelTime1, travelTime2);
+		if (((*count) + maxRemaining < countThreshold)
+				|| ((*sum) + maxRemaining < sumThreshold)) {
+			*exitedEarly = true;
+			return (false);
 		}
 	}  // ---- end search through each site this node is linked to ----
 
+	return (!haltNucleation);
+}
+
+// ---------------------------------------------------------readPickStack
+bool CNode::readPickStack(double tOrigin, CPickList* parentThread,
+							int countThreshold, double sumThreshold,
+							double *sum, int *count,
+							std::vector<std::shared_ptr<CPick>> *picks,
+							bool *exitedEarly) {
+	*exitedEarly = false;
+
+	// the best nucleating pick and its significance at each site
+	std::map<const CSite *, std::pair<double, const PickStackEntry *>> mBest_phase1;  // NOLINT
+	std::map<const CSite *, std::pair<double, const PickStackEntry *>> mBest_phase2;  // NOLINT
+
+	std::lock_guard < std::mutex > guard(m_PickStackMutex);
+
+	// only the picks stacked within the stack radius of the origin time can
+	// be significant at it
+	auto last = m_mmPickStack.upper_bound(tOrigin + m_dPickStackRadius);
+	for (auto position = m_mmPickStack.lower_bound(
+			tOrigin - m_dPickStackRadius); position != last; ++position) {
+		const PickStackEntry *entry = position->second;
+
+		// apply the same pick window as scanning the site would
+		if ((tOrigin < entry->dWindowStart) || (tOrigin > entry->dWindowEnd)) {
+			continue;
+		}
+		if ((entry->bExclude == true) && (tOrigin >= entry->dExcludeStart)
+				&& (tOrigin < entry->dExcludeEnd)) {
+			continue;
+		}
+
+		const SiteLink &link = entry->siteLink;
+		const std::shared_ptr<CSite> &site = std::get < LINK_PTR > (link);
+
+		// Ignore if station out of service
+		if (!site->getUse()) {
+			continue;
+		}
+		if (!site->getEnable()) {
+			continue;
+		}
+
+		// compute observed travel time from the pick time and
+		// the provided origin time
+		double tObs = entry->dPickTime - tOrigin;
+
+		// get the best significance from the observed time and link
+		double dSig1 = getSignificanceWithAllowance(
+				tObs, std::get < LINK_TT1 > (link), entry->dResidualAllowance1);
+		double dSig2 = getSignificanceWithAllowance(
+				tObs, std::get < LINK_TT2 > (link), entry->dResidualAllowance2);
+
+		if (entry->bPhase1Set) {
+			dSig2 = -1.;
+		}
+		if (entry->bPhase2Set) {
+			dSig1 = -1.;
+		}
+
+		// keep the best pick at this site, the earlier pick on a tie, like
+		// scanning the site's picks in time order
+		if (dSig1 >= dSig2) {
+			auto best = mBest_phase1.find(site.get());
+			if ((best == mBest_phase1.end()) || (dSig1 > best->second.first)
+					|| ((dSig1 == best->second.first)
+							&& (entry->dPickTime
+									< best->second.second->dPickTime))) {
+				mBest_phase1[site.get()] = std::make_pair(dSig1, entry);
+			}
+		}
+		if (dSig2 > dSig1) {
+			auto best = mBest_phase2.find(site.get());
+			if ((best == mBest_phase2.end()) || (dSig2 > best->second.first)
+					|| ((dSig2 == best->second.first)
+							&& (entry->dPickTime
+									< best->second.second->dPickTime))) {
+				mBest_phase2[site.get()] = std::make_pair(dSig2, entry);
+			}
+		}
+	}
+
+	// halt nucleation if the node has been disabled
+	if (m_bEnabled == false) {
+		return (false);
+	}
+
 	// signal that we're still here
 	if (parentThread != NULL) {
 		parentThread->setThreadHealth();
 	}
 
-	// if we were halted, the node did not nucleate an event, return null
-	if (haltNucleation == true) {
-		return (NULL);
+	// the links to the sites with a significant pick, give up if the
+	// significant picks can't reach the thresholds
+	std::map<const CSite *, const SiteLink *> mSiteLinks;
+	int significantCount = 0;
+	double significantSum = 0.0;
+	for (const auto &best : mBest_phase1) {
+		if (best.second.first >= k_dSiteSignificanceThreshold) {
+			mSiteLinks[best.first] = &(best.second.second->siteLink);
+			significantCount++;
+			significantSum += best.second.first;
+		}
+	}
+	for (const auto &best : mBest_phase2) {
+		if (best.second.first >= k_dSiteSignificanceThreshold) {
+			mSiteLinks[best.first] = &(best.second.second->siteLink);
+			significantCount++;
+			significantSum += best.second.first;
+		}
+	}
+	if ((significantCount < countThreshold)
+			|| (significantSum < sumThreshold)) {
+		*exitedEarly = true;
+		return (false);
 	}
 
-	// make sure the number of significant picks
-	// exceeds the nucleation threshold
-	if (nCount < nCut) {
-		// the node did not nucleate an event
-		return (NULL);
+	// add the best picks to the overall sum in site link order
+	std::vector<const SiteLink *> vLinks;
+	for (const auto &siteLink : mSiteLinks) {
+		vLinks.push_back(siteLink.second);
 	}
+	std::sort(vLinks.begin(), vLinks.end(),
+				[](const SiteLink *lhs, const SiteLink *rhs) {
+					return (sortSiteLink(*lhs, *rhs));
+				});
+
+	for (const auto &link : vLinks) {
+		const CSite *site = std::get < LINK_PTR > (*link).get();
+
+		auto best1 = mBest_phase1.find(site);
+		if ((best1 != mBest_phase1.end())
+				&& (best1->second.first >= k_dSiteSignificanceThreshold)) {
+			(*count)++;
+			(*sum) += best1->second.first;
+			picks->push_back(best1->second.second->pPick);
+		}
 
-	// make sure the total node significance exceeds the
-	// significance threshold
-	if (dSum < dThresh) {
-		// the node did not nucleate an event
-		return (NULL);
+		auto best2 = mBest_phase2.find(site);
+		if ((best2 != mBest_phase2.end())
+				&& (best2->second.first >= k_dSiteSignificanceThreshold)) {
+			(*count)++;
+			(*sum) += best2->second.first;
+			picks->push_back(best2->second.second->pPick);
+		}
 	}
 
-	// create trigger
-	std::shared_ptr<CTrigger> trigger(
-			new CTrigger(m_dLatitude, m_dLongitude, m_dDepth, tOrigin,
-							m_dResolution, m_dMaxDepth, dSum, nCount,
-							m_bAseismic, vPick, m_pWeb));
+	return (true);
+}
 
-	// the node nucleated an event
-	return (trigger);
+// ---------------------------------------------------------addActiveSite
+void CNode::addActiveSite(double travelTime1, double travelTime2) {
+	m_iActiveSiteCount++;
+	m_iActivePickLimit += getMaximumLinkContribution(travelTime1, travelTime2);
+}
+
+// ---------------------------------------------------------removeActiveSite
+void CNode::removeActiveSite(double travelTime1, double travelTime2) {
+	m_iActiveSiteCount--;
+	m_iActivePickLimit -= getMaximumLinkContribution(travelTime1, travelTime2);
+}
+
+// ---------------------------------------------------------getActiveSiteCount
+int CNode::getActiveSiteCount() const {
+	return (m_iActiveSiteCount);
+}
+
+// ---------------------------------------------------------getActivePickLimit
+int CNode::getActivePickLimit() const {
+	return (m_iActivePickLimit);
+}
+
+// ---------------------------------------------------------getMaximumLinkContribution
+int CNode::getMaximumLinkContribution(double travelTime1,
+										double travelTime2) {
+	int contribution = 0;
+	if (travelTime1 >= 0) {
+		contribution++;
+	}
+	if (travelTime2 >= 0) {
+		contribution++;
+	}
+
+	return (contribution);
+}
+
+// ---------------------------------------------------------getPickWindow
+bool CNode::getPickWindow(double tOrigin, double travelTime1,
+							double travelTime2, double *min, double *max,
+							double *excludeBegin, double *excludeEnd) {
+	*excludeBegin = 0.0;
+	*excludeEnd = 0.0;
+
+	// use traveltimes to compute min and max
+	if ((travelTime1 >= 0) && (travelTime2 >= 0)) {
+		// both travel times are valid
+		if (travelTime1 <= travelTime2) {
+			// TT1 smaller/shorter/faster
+			*min = tOrigin + travelTime1
+					- (k_dTravelTimePickSelectionWindow / 2);
+			*max = tOrigin + travelTime2
+					+ (k_dTravelTimePickSelectionWindow / 2);
+		} else {
+			// TT2 smaller/shorter/faster
+			*min = tOrigin + travelTime2
+					- (k_dTravelTimePickSelectionWindow / 2);
+			*max = tOrigin + travelTime1
+					+ (k_dTravelTimePickSelectionWindow / 2);
+		}
+	} else if (travelTime1 >= 0) {
+		// Only TT1 valid
+		*min = tOrigin + travelTime1 - (k_dTravelTimePickSelectionWindow / 2);
+		*max = tOrigin + travelTime1 + (k_dTravelTimePickSelectionWindow / 2);
+	} else if (travelTime2 >= 0) {
+		// Only TT2 valid
+		*min = tOrigin + travelTime2 - (k_dTravelTimePickSelectionWindow / 2);
+		*max = tOrigin + travelTime2 + (k_dTravelTimePickSelectionWindow / 2);
+	} else {
+		// no valid TTs
+		return (false);
+	}
+
+	// use min and max to compute exclusion window
+	if ((*max - *min) > k_dTravelTimePickSelectionWindow) {
+		// we have two different TTs and there's a window of picks
+		// in between the two TTs we don't want
+		*excludeBegin = *min + (k_dTravelTimePickSelectionWindow / 2) * 2.0;
+		*excludeEnd = *max - (k_dTravelTimePickSelectionWindow / 2) * 2.0;
+		if (*excludeEnd < *excludeBegin) {
+			// we effectively don't have a window because our two windows
+			// overlap.
+			*excludeBegin = 0.0;
+		}
+	}
+
+	return (true);
+}
+
+// ---------------------------------------------------------checkPickForNucleation
+bool CNode::checkPickForNucleation(std::shared_ptr<CPick> pick,
+									const std::string &phase1,
+									const std::string &phase2, bool *phase1set,
+									bool *phase2set) {
+	*phase1set = false;
+	*phase2set = false;
+
+	// skip this pick if it's not in the set of allowed sources
+	std::string pickSource = pick->getSource();
+	if ((m_SourceSet.empty() == false) &&
+		(pickSource != "") &&
+		(m_SourceSet.find(pickSource) == m_SourceSet.end())) {
+		// we have a set of allowed sources
+		// and we have a valid pick source
+		// and the source is NOT found in allowed sources
+		// so skip this pick
+		return (false);
+	}
+
+	// get the picks back azimuth
+	double backAzimuth = pick->getBackAzimuth();
+
+	// check backazimuth if present
+	if (backAzimuth > 0) {
+		// set up a geo for distance calculations
+		glass3::util::Geo nodeGeo;
+		nodeGeo.setGeographic(
+				m_dLatitude, m_dLongitude,
+				glass3::util::Geo::k_EarthRadiusKm - m_dDepth);
+
+		// compute azimuth from the site to the node
+		double siteAzimuth = pick->getSite()->getGeo().azimuth(
+				&nodeGeo);
+
+		// check to see if pick's backazimuth is within the
+		// valid range
+		if (glass3::util::GlassMath::angleDifference(backAzimuth,
+														siteAzimuth)
+				> CGlass::getBeamMatchingAzimuthWindow()) {
+			// it is not, do not nucleate
+			return (false);
+		}
+	}
+
+	// check slowness if present
+	// Need modify travel time libraries to support getting distance
+	// from slowness, and it's of limited value compared to the back
+	// azimuth check
+	/*if (pick->dSlowness > 0) {
+	 // compute distance from the site to the node
+	 double siteDistance = pick->pSite->getGeo().delta(&nodeGeo);
+	 // compute observed distance from slowness (1/velocity)
+	 // and tObs (distance = velocity * time)
+	 double obsDistance = (1 / pick->dSlowness) * tObs;
+	 // check to see if the observed distance is within the
+	 // valid range
+	 if ((obsDistance < (siteDistance - dDistanceRange))
+	 || (obsDistance > (siteDistance + dDistanceRange))) {
+	 // it is not, do not nucleate
+	 continue;
+	 }
+	 }
+	 */
+
+	// check pick classification
+	// are we configured to check pick phase classification
+	if (CGlass::getPickPhaseClassificationThreshold() > 0) {
+		// check to see if the phase classification is valid and above
+		// our threshold
+		if ((std::isnan(pick->getClassifiedPhaseProbability()) != true)
+				&& (pick->getClassifiedPhaseProbability()
+						> CGlass::getPickPhaseClassificationThreshold())) {
+			// check to see if the phase is classified as one of our
+			// nucleation phases
+			if (pick->getClassifiedPhase() == phase1) {
+				// match, we only consider traveltime1, disable
+				// traveltime2
+				*phase1set = true;
+			} else if (pick->getClassifiedPhase() == phase2) {
+				// match, we only consider traveltime2, disable
+				// traveltime1
+				*phase2set = true;
+			}
+			// otherwise there is no match and it's business as usual
+		}
+	}
+
+	// check azimuth classification
+	if (CGlass::getPickAzimuthClassificationThreshold() > 0) {
+		if ((std::isnan(pick->getClassifiedAzimuthProbability()) != true)
+				&& (pick->getClassifiedAzimuthProbability()
+						> CGlass::getPickAzimuthClassificationThreshold())) {
+			// set up a geo for azimuth calculations
+			glass3::util::Geo nodeGeo;
+			nodeGeo.setGeographic(
+					m_dLatitude, m_dLongitude,
+					glass3::util::Geo::k_EarthRadiusKm - m_dDepth);
+
+			// compute azimuth from the azimuth node to site
+			double siteAzimuth = nodeGeo.azimuth(
+					&(pick->getSite()->getGeo()))
+					* glass3::util::GlassMath::k_RadiansToDegrees;
+
+			// check to see if pick's backazimuth is within the
+			// valid range
+			if (glass3::util::GlassMath::angleDifference(
+					pick->getClassifiedAzimuth(), siteAzimuth)
+					> CGlass::getPickAzimuthClassificationUncertainty()) {
+				// it is not, do not nucleate
+				return (false);
+			}
+		}
+	}
+
+	// check distance classification
+	if (CGlass::getPickDistanceClassificationThreshold() > 0) {
+		if ((std::isnan(pick->getClassifiedDistanceProbability())
+				!= true)
+				&& (pick->getClassifiedDistanceProbability()
+						> CGlass::getPickDistanceClassificationThreshold())) {
+			// set up a geo for distance calculations
+			glass3::util::Geo nodeGeo;
+			nodeGeo.setGeographic(
+					m_dLatitude, m_dLongitude,
+					glass3::util::Geo::k_EarthRadiusKm - m_dDepth);
+
+			// compute distance from the site to the node
+			double siteDistance = pick->getSite()->getGeo().delta(
+					&nodeGeo)
+					* glass3::util::GlassMath::k_RadiansToDegrees;
+
+			// check to see if pick's distance is within the
+			// valid range
+			if (siteDistance
+					< CGlass::getDistanceClassLowerBound(
+							pick->getClassifiedDistance())
+					|| siteDistance
+							> CGlass::getDistanceClassUpperBound(
+									pick->getClassifiedDistance())) {
+				// it is not, do not nucleate
+				return (false);
+			}
+		}
+	}
+
+	return (true);
+}
+
+// ---------------------------------------------------------addPickToStack
+void CNode::addPickToStack(std::shared_ptr<CPick> pick, double distDeg,
+							double travelTime1, std::string phase1,
+							double travelTime2, std::string phase2) {
+	if (pick == NULL) {
+		return;
+	}
+	std::shared_ptr<CSite> site = pick->getSite();
+	if (site == NULL) {
+		return;
+	}
+
+	// check the pick's source, beam, and classifications once, they don't
+	// depend on the origin time
+	bool phase1set = false;
+	bool phase2set = false;
+	bool nucleates = checkPickForNucleation(pick, phase1, phase2, &phase1set,
+											&phase2set);
+
+	std::lock_guard < std::mutex > guard(m_PickStackMutex);
+
+	// replace any previous stacking of this pick
+	eraseFromPickStack(pick.get());
+
+	if (nucleates == false) {
+		return;
+	}
+
+	// the pick window in terms of origin times, see getPickWindow
+	double shortTravelTime = 0.0;
+	double longTravelTime = 0.0;
+	if ((travelTime1 >= 0) && (travelTime2 >= 0)) {
+		shortTravelTime = std::min(travelTime1, travelTime2);
+		longTravelTime = std::max(travelTime1, travelTime2);
+	} else if (travelTime1 >= 0) {
+		shortTravelTime = travelTime1;
+		longTravelTime = travelTime1;
+	} else if (travelTime2 >= 0) {
+		shortTravelTime = travelTime2;
+		longTravelTime = travelTime2;
+	} else {
+		// no valid TTs
+		return;
+	}
+
+	double tPick = pick->getTPick();
+	PickStackEntry &entry = m_mPickStackEntries[pick.get()];
+	entry.pPick = pick;
+	entry.siteLink = std::make_tuple(site, travelTime1, phase1, travelTime2,
+										phase2, distDeg);
+	entry.dPickTime = tPick;
+	entry.dResidualAllowance1 = 0.0;
+	entry.dResidualAllowance2 = 0.0;
+	entry.bPhase1Set = phase1set;
+	entry.bPhase2Set = phase2set;
+	entry.dWindowStart = tPick - longTravelTime
+			- (k_dTravelTimePickSelectionWindow / 2);
+	entry.dWindowEnd = tPick - shortTravelTime
+			+ (k_dTravelTimePickSelectionWindow / 2);
+
+	// origin times whose two travel time windows don't overlap exclude the
+	// pick if it falls between them
+	entry.bExclude = ((longTravelTime - shortTravelTime)
+			>= k_dTravelTimePickSelectionWindow);
+	entry.dExcludeStart = tPick - longTravelTime
+			+ (k_dTravelTimePickSelectionWindow / 2);
+	entry.dExcludeEnd = tPick - shortTravelTime
+			- (k_dTravelTimePickSelectionWindow / 2);
+	entry.vStackPositions.clear();
+
+	// stack the pick at the origin time implied by each travel time, the
+	// pick is significant for origin times within a radius of it
+	if (travelTime1 > 0) {
+		entry.dResidualAllowance1 = getResidualAllowance(travelTime1, distDeg);
+		m_dPickStackRadius = std::max(
+				m_dPickStackRadius,
+				entry.dResidualAllowance1
+						+ k_dPickStackSigmaRange
+								* CGlass::k_dNucleationSecondsPerSigma);
+		entry.vStackPositions.push_back(
+				m_mmPickStack.insert(std::make_pair(tPick - travelTime1,
+													&entry)));
+	}
+	if (travelTime2 > 0) {
+		entry.dResidualAllowance2 = getResidualAllowance(travelTime2, distDeg);
+		m_dPickStackRadius = std::max(
+				m_dPickStackRadius,
+				entry.dResidualAllowance2
+						+ k_dPickStackSigmaRange
+								* CGlass::k_dNucleationSecondsPerSigma);
+		entry.vStackPositions.push_back(
+				m_mmPickStack.insert(std::make_pair(tPick - travelTime2,
+													&entry)));
+	}
+
+	if (entry.vStackPositions.size() == 0) {
+		m_mPickStackEntries.erase(pick.get());
+		return;
+	}
+
+	m_mPickStackSites[site.get()].insert(pick.get());
+}
+
+// ---------------------------------------------------------removePickFromStack
+void CNode::removePickFromStack(std::shared_ptr<CPick> pick) {
+	if (pick == NULL) {
+		return;
+	}
+
+	std::lock_guard < std::mutex > guard(m_PickStackMutex);
+	eraseFromPickStack(pick.get());
+}
+
+// ---------------------------------------------------------removeSiteFromStack
+void CNode::removeSiteFromStack(std::shared_ptr<CSite> site) {
+	if (site == NULL) {
+		return;
+	}
+
+	std::lock_guard < std::mutex > guard(m_PickStackMutex);
+
+	auto sitePicks = m_mPickStackSites.find(site.get());
+	if (sitePicks == m_mPickStackSites.end()) {
+		return;
+	}
+
+	// copy the site's picks, erasing the last one erases the set
+	std::set<const CPick *> stackedPicks = sitePicks->second;
+	for (const auto &pick : stackedPicks) {
+		eraseFromPickStack(pick);
+	}
+}
+
+// ---------------------------------------------------------clearPickStack
+void CNode::clearPickStack() {
+	std::lock_guard < std::mutex > guard(m_PickStackMutex);
+	m_mmPickStack.clear();
+	m_mPickStackEntries.clear();
+	m_mPickStackSites.clear();
+	m_dPickStackRadius = 0.0;
+}
+
+// ---------------------------------------------------------getPickStackCount
+int CNode::getPickStackCount() const {
+	std::lock_guard < std::mutex > guard(m_PickStackMutex);
+	return (m_mPickStackEntries.size());
+}
+
+// ---------------------------------------------------------eraseFromPickStack
+void CNode::eraseFromPickStack(const CPick * pick) {
+	auto entry = m_mPickStackEntries.find(pick);
+	if (entry == m_mPickStackEntries.end()) {
+		return;
+	}
+
+	for (auto position : entry->second.vStackPositions) {
+		m_mmPickStack.erase(position);
+	}
+
+	const CSite *site = std::get < LINK_PTR > (entry->second.siteLink).get();
+	auto sitePicks = m_mPickStackSites.find(site);
+	if (sitePicks != m_mPickStackSites.end()) {
+		sitePicks->second.erase(pick);
+		if (sitePicks->second.empty() == true) {
+			m_mPickStackSites.erase(sitePicks);
+		}
+	}
+
+	m_mPickStackEntries.erase(entry);
+}
+
+// ---------------------------------------------------------getResidualAllowance
+double CNode::getResidualAllowance(double travelTime, double distDeg) {
+	// The residual allowance calculates the maximum off grid distance assuming
+	// the nodes form a cuboid and multiply but compute slowness at that
+	// region, then multiplies by a factor (2) for slop.
+	return ((travelTime / distDeg)
+			* (std::sqrt(
+					3. * (m_dResolution * m_dResolution)
+							+ (k_dDepthShellResolutionKm
+									* k_dDepthShellResolutionKm)) * .5)
+			* glass3::util::Geo::k_KmToDegrees
+			* k_residualDistanceAllowanceFactor);
 }
 
 // ---------------------------------------------------------getSignificance
 double CNode::getSignificance(double tObservedTT, double travelTime,
 								double distDeg) {
+	return (getSignificanceWithAllowance(
+			tObservedTT, travelTime, getResidualAllowance(travelTime, distDeg)));
+}
+
+// ---------------------------------------getSignificanceWithAllowance
+double CNode::getSignificanceWithAllowance(double tObservedTT,
+											double travelTime,
+											double residualAllowance) {
 	// use observed travel time, travel times to site
 	double tRes = -1;
 	if (travelTime > 0) {
@@ -714,27 +1205,12 @@ double CNode::getSignificance(double tObservedTT, double travelTime,
 	//
 	// The significance is defined in a way that allows for picks to still be
 	// significant even if an event is not directly on a node. This is done in
-	// the form of a residual allowance which calculates the maximum off grid
-	// distance assuming the nodes form a cuboid and multiply but compute
-	// slowness at that region, then multiplies by a factor (2) for slop.
+	// the form of a residual allowance (see getResidualAllowance).
 	double dSig = 0;
 	if (tRes > 0) {
-		dSig =
-				glass3::util::GlassMath::sig(
-						std::max(
-								0.0,
-								(tRes
-										- (travelTime / distDeg)
-												* (std::sqrt(
-														3.
-																* (m_dResolution
-																		* m_dResolution)
-																+ (k_dDepthShellResolutionKm
-																		* k_dDepthShellResolutionKm))
-														* .5)
-												* glass3::util::Geo::k_KmToDegrees
-												* k_residualDistanceAllowanceFactor)),
-						CGlass::k_dNucleationSecondsPerSigma);
+		dSig = glass3::util::GlassMath::sig(
+				std::max(0.0, (tRes - residualAllowance)),
+				CGlass::k_dNucleationSecondsPerSigma);
 	}
 
 	return (dSig);
@@ -870,16 +1346,42 @@ glass3::util::Geo CNode::getGeo() const {
 
 // ---------------------------------------------------------getWeb
 CWeb * CNode::getWeb() const {
-	std::lock_guard < std::recursive_mutex > nodeGuard(m_NodeMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> nodeGuard(
+			m_NodeMutex);
 	return (m_pWeb);
 }
 
 // ---------------------------------------------------------setWeb
 void CNode::setWeb(CWeb* web) {
-	std::lock_guard < std::recursive_mutex > nodeGuard(m_NodeMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> nodeGuard(
+			m_NodeMutex);
 	m_pWeb = web;
 }
 
+// ---------------------------------------------------------getCoarse
+bool CNode::getCoarse() const {
+	return (m_bCoarse);
+}
+
+// ---------------------------------------------------------setCoarse
+void CNode::setCoarse(bool coarse) {
+	m_bCoarse = coarse;
+}
+
+// ---------------------------------------------------------getParentNode
+std::shared_ptr<CNode> CNode::getParentNode() const {
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> nodeGuard(
+			m_NodeMutex);
+	return (m_wpParentNode.lock());
+}
+
+// ---------------------------------------------------------setParentNode
+void CNode::setParentNode(std::shared_ptr<CNode> parent) {
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> nodeGuard(
+			m_NodeMutex);
+	m_wpParentNode = parent;
+}
+
 // ---------------------------------------------------------getName
 const std::string& CNode::getName() const {
 	return (m_sName);
@@ -901,7 +1403,8 @@ double CNode::getMaxSiteDistance() const {
 
 // -------------------------------------------------------addSource
 void CNode::addSource(std::string source) {
-	std::lock_guard < std::recursive_mutex > nodeGuard(m_NodeMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> nodeGuard(
+			m_NodeMutex);
 	m_SourceSet.insert(source);
 }
 }  // namespace glasscore
@@ -3,11 +3,13 @@
 #include <json.h>
 #include <date.h>
 #include <logger.h>
+#include <latencytracer.h>
 #include <memory>
 #include <string>
 #include <vector>
 #include <limits>
 #include <algorithm>
+#include <cmath>
 #include "Web.h"
 #include "Trigger.h"
 #include "Node.h"
@@ -71,10 +73,14 @@ CPick::CPick(std::shared_ptr<json::Object> pick, CSiteList *pSiteList) {
 		return;
 	}
 
+	// read the message through a const reference, each key is looked up
+	// once, a missing key gives a NULL value
+	const json::Object &pickobj = *pick;
+
 	// check type
-	if (pick->HasKey("Type")
-			&& ((*pick)["Type"].GetType() == json::ValueType::StringVal)) {
-		std::string type = (*pick)["Type"].ToString();
+	const json::Value &typeValue = pickobj["Type"];
+	if (typeValue.GetType() == json::ValueType::StringVal) {
+		std::string type = typeValue.AsString();
 
 		if (type != "Pick") {
 			glass3::util::Logger::log(
@@ -115,18 +121,18 @@ CPick::CPick(std::shared_ptr<json::Object> pick, CSiteList *pSiteList) {
 	std::string source = "";
 
 	// site
-	if (pick->HasKey("Site")
-			&& ((*pick)["Site"].GetType() == json::ValueType::ObjectVal)) {
+	const json::Value &siteValue = pickobj["Site"];
+	if (siteValue.GetType() == json::ValueType::ObjectVal) {
 		// site is an object, create scnl std::string from it
 		// get object
-		json::Object siteobj = (*pick)["Site"].ToObject();
+		const json::Object &siteobj = siteValue.AsObject();
 
 		// scnl varibles
 
 		// site
-		if (siteobj.HasKey("Station")
-				&& (siteobj["Station"].GetType() == json::ValueType::StringVal)) {
-			sta = siteobj["Station"].ToString();
+		const json::Value &stationValue = siteobj["Station"];
+		if (stationValue.GetType() == json::ValueType::StringVal) {
+			sta = stationValue.AsString();
 		} else {
 			glass3::util::Logger::log(
 					"error",
@@ -137,17 +143,17 @@ CPick::CPick(std::shared_ptr<json::Object> pick, CSiteList *pSiteList) {
 		}
 
 		// comp (optional)
-		if (siteobj.HasKey("Channel")
-				&& (siteobj["Channel"].GetType() == json::ValueType::StringVal)) {
-			comp = siteobj["Channel"].ToString();
+		const json::Value &channelValue = siteobj["Channel"];
+		if (channelValue.GetType() == json::ValueType::StringVal) {
+			comp = channelValue.AsString();
 		} else {
 			comp = "";
 		}
 
 		// net
-		if (siteobj.HasKey("Network")
-				&& (siteobj["Network"].GetType() == json::ValueType::StringVal)) {
-			net = siteobj["Network"].ToString();
+		const json::Value &networkValue = siteobj["Network"];
+		if (networkValue.GetType() == json::ValueType::StringVal) {
+			net = networkValue.AsString();
 		} else {
 			glass3::util::Logger::log(
 					"error",
@@ -158,9 +164,9 @@ CPick::CPick(std::shared_ptr<json::Object> pick, CSiteList *pSiteList) {
 		}
 
 		// loc (optional)
-		if (siteobj.HasKey("Location")
-				&& (siteobj["Location"].GetType() == json::ValueType::StringVal)) {
-			loc = siteobj["Location"].ToString();
+		const json::Value &locationValue = siteobj["Location"];
+		if (locationValue.GetType() == json::ValueType::StringVal) {
+			loc = locationValue.AsString();
 		} else {
 			loc = "";
 		}
@@ -195,10 +201,10 @@ CPick::CPick(std::shared_ptr<json::Object> pick, CSiteList *pSiteList) {
 
 	// time
 	// get the pick time based on which key we find
-	if (pick->HasKey("Time")
-			&& ((*pick)["Time"].GetType() == json::ValueType::StringVal)) {
+	const json::Value &timeValue = pickobj["Time"];
+	if (timeValue.GetType() == json::ValueType::StringVal) {
 		// Time is formatted in iso8601, convert to Gregorian seconds
-		ttt = (*pick)["Time"].ToString();
+		ttt = timeValue.AsString();
 		glass3::util::Date dt = glass3::util::Date();
 		tPick = dt.decodeISO8601Time(ttt);
 	} else {
@@ -212,9 +218,9 @@ CPick::CPick(std::shared_ptr<json::Object> pick, CSiteList *pSiteList) {
 
 	// pid
 	// get the pick id based on which key we find
-	if (pick->HasKey("ID")
-			&& ((*pick)["ID"].GetType() == json::ValueType::StringVal)) {
-		pid = (*pick)["ID"].ToString();
+	const json::Value &idValue = pickobj["ID"];
+	if (idValue.GetType() == json::ValueType::StringVal) {
+		pid = idValue.AsString();
 	} else {
 		glass3::util::Logger::log(
 				"warning",
@@ -225,16 +231,15 @@ CPick::CPick(std::shared_ptr<json::Object> pick, CSiteList *pSiteList) {
 	}
 
 	// beam
-	if (pick->HasKey("Beam")
-			&& ((*pick)["Beam"].GetType() == json::ValueType::ObjectVal)) {
+	const json::Value &beamValue = pickobj["Beam"];
+	if (beamValue.GetType() == json::ValueType::ObjectVal) {
 		// beam is an object
-		json::Object beamobj = (*pick)["Beam"].ToObject();
+		const json::Object &beamobj = beamValue.AsObject();
 
 		// backAzimuth
-		if (beamobj.HasKey("BackAzimuth")
-				&& (beamobj["BackAzimuth"].GetType()
-						== json::ValueType::DoubleVal)) {
-			backAzimuth = beamobj["BackAzimuth"].ToDouble();
+		const json::Value &backAzimuthValue = beamobj["BackAzimuth"];
+		if (backAzimuthValue.GetType() == json::ValueType::DoubleVal) {
+			backAzimuth = backAzimuthValue.ToDouble();
 		} else {
 			glass3::util::Logger::log(
 					"warning",
@@ -244,9 +249,9 @@ CPick::CPick(std::shared_ptr<json::Object> pick, CSiteList *pSiteList) {
 		}
 
 		// slowness
-		if (beamobj.HasKey("Slowness")
-				&& (beamobj["Slowness"].GetType() == json::ValueType::DoubleVal)) {
-			slowness = beamobj["Slowness"].ToDouble();
+		const json::Value &slownessValue = beamobj["Slowness"];
+		if (slownessValue.GetType() == json::ValueType::DoubleVal) {
+			slowness = slownessValue.ToDouble();
 		} else {
 			glass3::util::Logger::log(
 					"warning",
@@ -260,97 +265,92 @@ CPick::CPick(std::shared_ptr<json::Object> pick, CSiteList *pSiteList) {
 	}
 
 	// classification
-	if (pick->HasKey("ClassificationInfo")
-			&& ((*pick)["ClassificationInfo"].GetType()
-					== json::ValueType::ObjectVal)) {
+	const json::Value &classificationInfoValue = pickobj["ClassificationInfo"];
+	if (classificationInfoValue.GetType() == json::ValueType::ObjectVal) {
 		// classification is an object
-		json::Object classobj = (*pick)["ClassificationInfo"].ToObject();
+		const json::Object &classobj = classificationInfoValue.AsObject();
 
 		// classifiedPhase
-		if (classobj.HasKey("Phase")
-				&& (classobj["Phase"].GetType() == json::ValueType::StringVal)) {
-			classifiedPhase = classobj["Phase"].ToString();
+		const json::Value &phaseValue = classobj["Phase"];
+		if (phaseValue.GetType() == json::ValueType::StringVal) {
+			classifiedPhase = phaseValue.AsString();
 		} else {
 			classifiedPhase = "";
 		}
 
 		// classifiedPhaseProb
-		if (classobj.HasKey("PhaseProbability")
-				&& (classobj["PhaseProbability"].GetType()
-						== json::ValueType::DoubleVal)) {
-			classifiedPhaseProb = classobj["PhaseProbability"].ToDouble();
+		const json::Value &phaseProbabilityValue = classobj["PhaseProbability"];
+		if (phaseProbabilityValue.GetType() == json::ValueType::DoubleVal) {
+			classifiedPhaseProb = phaseProbabilityValue.ToDouble();
 		} else {
 			classifiedPhaseProb = std::numeric_limits<double>::quiet_NaN();
 		}
 
 
-		if (classobj.HasKey("Distance")
-				&& (classobj["Distance"].GetType() == json::ValueType::DoubleVal)) {
-			classifiedDist = classobj["Distance"].ToDouble();
-		} else if (classobj.HasKey("Distance")
-				&& (classobj["Distance"].GetType() == json::ValueType::IntVal)) {
-			classifiedDist = static_cast<double>(classobj["Distance"].ToInt());
+		const json::Value &distanceValue = classobj["Distance"];
+		if (distanceValue.GetType() == json::ValueType::DoubleVal) {
+			classifiedDist = distanceValue.ToDouble();
+		} else if (distanceValue.GetType() == json::ValueType::IntVal) {
+			classifiedDist = static_cast<double>(distanceValue.ToInt());
 		} else {
 			classifiedDist = std::numeric_limits<double>::quiet_NaN();
 		}
 
 		// classifiedDistProb
-		if (classobj.HasKey("DistanceProbability")
-				&& (classobj["DistanceProbability"].GetType()
-						== json::ValueType::DoubleVal)) {
-			classifiedDistProb = classobj["DistanceProbability"].ToDouble();
+		const json::Value &distanceProbabilityValue =
+				classobj["DistanceProbability"];
+		if (distanceProbabilityValue.GetType() == json::ValueType::DoubleVal) {
+			classifiedDistProb = distanceProbabilityValue.ToDouble();
 		} else {
 			classifiedDistProb = std::numeric_limits<double>::quiet_NaN();
 		}
 
 		// classifiedAzm
-		if (classobj.HasKey("Azimuth")
-				&& (classobj["Azimuth"].GetType() == json::ValueType::DoubleVal)) {
-			classifiedAzm = classobj["Azimuth"].ToDouble();
+		const json::Value &azimuthValue = classobj["Azimuth"];
+		if (azimuthValue.GetType() == json::ValueType::DoubleVal) {
+			classifiedAzm = azimuthValue.ToDouble();
 		} else {
 			classifiedAzm = std::numeric_limits<double>::quiet_NaN();
 		}
 
 		// classifiedAzmProb
-		if (classobj.HasKey("AzimuthProbability")
-				&& (classobj["AzimuthProbability"].GetType()
-						== json::ValueType::DoubleVal)) {
-			classifiedAzmProb = classobj["AzimuthProbability"].ToDouble();
+		const json::Value &azimuthProbabilityValue =
+				classobj["AzimuthProbability"];
+		if (azimuthProbabilityValue.GetType() == json::ValueType::DoubleVal) {
+			classifiedAzmProb = azimuthProbabilityValue.ToDouble();
 		} else {
 			classifiedAzmProb = std::numeric_limits<double>::quiet_NaN();
 		}
 
 		// classifiedDepth
-		if (classobj.HasKey("Depth")
-				&& (classobj["Depth"].GetType() == json::ValueType::DoubleVal)) {
-			classifiedDepth = classobj["Depth"].ToDouble();
+		const json::Value &depthValue = classobj["Depth"];
+		if (depthValue.GetType() == json::ValueType::DoubleVal) {
+			classifiedDepth = depthValue.ToDouble();
 		} else {
 			classifiedDepth = std::numeric_limits<double>::quiet_NaN();
 		}
 
 		// classifiedDepthProb
-		if (classobj.HasKey("DepthProbability")
-				&& (classobj["DepthProbability"].GetType()
-						== json::ValueType::DoubleVal)) {
-			classifiedDepthProb = classobj["DepthProbability"].ToDouble();
+		const json::Value &depthProbabilityValue = classobj["DepthProbability"];
+		if (depthProbabilityValue.GetType() == json::ValueType::DoubleVal) {
+			classifiedDepthProb = depthProbabilityValue.ToDouble();
 		} else {
 			classifiedDepthProb = std::numeric_limits<double>::quiet_NaN();
 		}
 
 		// classifiedMag
-		if (classobj.HasKey("Magnitude")
-				&& (classobj["Magnitude"].GetType()
-						== json::ValueType::DoubleVal)) {
-			classifiedMag = classobj["Magnitude"].ToDouble();
+		const json::Value &magnitudeValue = classobj["Magnitude"];
+		if (magnitudeValue.GetType() == json::ValueType::DoubleVal) {
+			classifiedMag = magnitudeValue.ToDouble();
 		} else {
 			classifiedMag = std::numeric_limits<double>::quiet_NaN();
 		}
 
 		// classifiedMagProb
-		if (classobj.HasKey("MagnitudeProbability")
-				&& (classobj["MagnitudeProbability"].GetType()
-						== json::ValueType::DoubleVal)) {
-			classifiedMagProb = classobj["MagnitudeProbability"].ToDouble();
+		const json::Value &magnitudeProbabilityValue =
+				classobj["MagnitudeProbability"];
+		if (magnitudeProbabilityValue.GetType() == json::ValueType::DoubleVal) {
+			classifiedMagProb = magnitudeProbabilityValue.ToDouble();
 		} else {
 			classifiedMagProb = std::numeric_limits<double>::quiet_NaN();
 		}
@@ -368,16 +368,15 @@ CPick::CPick(std::shared_ptr<json::Object> pick, CSiteList *pSiteList) {
 	}
 
 	// source
-	if (pick->HasKey("Source")
-			&& ((*pick)["Source"].GetType()
-					== json::ValueType::ObjectVal)) {
+	const json::Value &sourceValue = pickobj["Source"];
+	if (sourceValue.GetType() == json::ValueType::ObjectVal) {
 		// classification is an object
-		json::Object sourceobj = (*pick)["Source"].ToObject();
+		const json::Object &sourceobj = sourceValue.AsObject();
 
 		// author
-		if (sourceobj.HasKey("Author")
-				&& (sourceobj["Author"].GetType() == json::ValueType::StringVal)) {
-			source = sourceobj["Author"].ToString();
+		const json::Value &authorValue = sourceobj["Author"];
+		if (authorValue.GetType() == json::ValueType::StringVal) {
+			source = authorValue.AsString();
 		} else {
 			source = "";
 		}
@@ -498,6 +497,8 @@ void CPick::addHypoReference(std::shared_ptr<CHypo> hyp, bool force) {
 
 	if (getTFirstAssociation() == 0.0) {
 		setTFirstAssociation();
+		glass3::util::LatencyTracer::getInstance().mark(
+				m_sID, glass3::util::LatencyTracer::Associate);
 	}
 }
 
@@ -540,9 +541,10 @@ bool CPick::nucleate(CPickList* parentThread) {
 	// get the site shared_ptr
 	std::shared_ptr<CSite> pickSite = m_wpSite.lock();
 	std::string pt = glass3::util::Date::encodeDateTime(m_tPick);
-	char sLog[glass3::util::Logger::k_nMaxLogEntrySize];
 
 	setTNucleation();
+	glass3::util::LatencyTracer::getInstance().mark(
+			m_sID, glass3::util::LatencyTracer::Nucleate);
 
 	// Use site nucleate to scan all nodes
 	// linked to this pick's site and calculate
@@ -562,271 +564,364 @@ bool CPick::nucleate(CPickList* parentThread) {
 		return (false);
 	}
 
-	for (const auto &trigger : vTrigger) {
-		if (parentThread != NULL) {
-			parentThread->setThreadHealth();
-		}
+	// group nearby triggers, so that only one hypo is built for each group
+	std::vector<std::vector<std::shared_ptr<CTrigger>>> vCluster =
+			clusterTriggers(vTrigger);
+	if (vCluster.size() < vTrigger.size()) {
+		glass3::util::Logger::log(
+				"debug",
+				"CPick::nucleate: clustered " + std::to_string(vTrigger.size())
+						+ " triggers into " + std::to_string(vCluster.size())
+						+ " clusters; sID:" + m_sID);
+	}
 
-		if (trigger->getWeb() == NULL) {
-			continue;
+	for (const auto &cluster : vCluster) {
+		// try the triggers in the cluster, best first, until one of them
+		// produces a hypo
+		for (const auto &trigger : cluster) {
+			if (nucleateTrigger(trigger, parentThread) == true) {
+				break;
+			}
 		}
+	}
 
-		// check to see if the pick is currently associated to a hypo
-		if (m_wpHypo.expired() == false) {
-			// get the hypo and compute distance between it and the
-			// current trigger
-			std::shared_ptr<CHypo> pHypo = m_wpHypo.lock();
-			if (pHypo != NULL) {
-				glass3::util::Geo geoHypo = pHypo->getGeo();
+	// done
+	return (true);
+}
 
-				glass3::util::Geo trigHypo = trigger->getGeo();
+// ---------------------------------------------------------clusterTriggers
+std::vector<std::vector<std::shared_ptr<CTrigger>>> CPick::clusterTriggers(
+		const std::vector<std::shared_ptr<CTrigger>> &triggers) {
+	std::vector<std::vector<std::shared_ptr<CTrigger>>> clusters;
 
-				double dist = (geoHypo.delta(&trigHypo)
-						/ glass3::util::GlassMath::k_DegreesToRadians)
-						* glass3::util::Geo::k_DegreesToKm;
+	// best triggers first, so each cluster is represented by its best trigger
+	std::vector<std::shared_ptr<CTrigger>> sortedTriggers;
+	for (const auto &trigger : triggers) {
+		if (trigger != NULL) {
+			sortedTriggers.push_back(trigger);
+		}
+	}
+	std::stable_sort(
+			sortedTriggers.begin(), sortedTriggers.end(),
+			[](const std::shared_ptr<CTrigger> &lhs,
+				const std::shared_ptr<CTrigger> &rhs) {
+				return (lhs->getBayesValue() > rhs->getBayesValue());
+			});
+
+	for (const auto &trigger : sortedTriggers) {
+		glass3::util::Geo geoTrigger = trigger->getGeo();
+
+		bool clustered = false;
+		for (auto &cluster : clusters) {
+			std::shared_ptr<CTrigger> best = cluster.front();
+
+			// use the coarser of the two resolutions, and the same origin time
+			// tolerance as the first nucleation anneal
+			double resolution = std::max(best->getWebResolution(),
+											trigger->getWebResolution());
+			double timeTolerance = std::max(
+					resolution / CHypo::k_dTimeToDistanceCorrectionFactor,
+					k_dNucleateInitialAnnealTimeStepSize);
+
+			if (std::abs(best->getTOrigin() - trigger->getTOrigin())
+					> timeTolerance) {
+				continue;
+			}
 
-				// is the associated hypo close enough to this trigger to skip
-				// close enough means within the resolution of the trigger
-				if (dist < trigger->getWebResolution()) {
-					glass3::util::Logger::log(
-							"debug",
-							"CPick::nucleate: SKIPTRG because pick proximal hypo ("
-									+ std::to_string(dist) + " < "
-									+ std::to_string(
-											trigger->getWebResolution()) + ")");
-					continue;
-				}
+			glass3::util::Geo geoBest = best->getGeo();
+			double distKm = (geoBest.delta(&geoTrigger)
+					/ glass3::util::GlassMath::k_DegreesToRadians)
+					* glass3::util::Geo::k_DegreesToKm;
+			double depthKm = best->getDepth() - trigger->getDepth();
+			if (std::sqrt(distKm * distKm + depthKm * depthKm) > resolution) {
+				continue;
 			}
+
+			cluster.push_back(trigger);
+			clustered = true;
+			break;
 		}
 
-		// create the hypo using the node
-		std::shared_ptr<CHypo> hypo = std::make_shared < CHypo
-				> (trigger, CGlass::getAssociationTravelTimes());
+		if (clustered == false) {
+			clusters.push_back(std::vector<std::shared_ptr<CTrigger>>(
+					1, trigger));
+		}
+	}
+
+	return (clusters);
+}
+
+// ---------------------------------------------------------nucleateTrigger
+bool CPick::nucleateTrigger(std::shared_ptr<CTrigger> trigger,
+							CPickList* parentThread) {
+	// get the site shared_ptr
+	std::shared_ptr<CSite> pickSite = m_wpSite.lock();
+	std::string pt = glass3::util::Date::encodeDateTime(m_tPick);
+	char sLog[glass3::util::Logger::k_nMaxLogEntrySize];
 
-		// set nuclation auditing info
-		hypo->setNucleationAuditingInfo(glass3::util::Date::now(),
-										this->getTInsertion());
+	if (parentThread != NULL) {
+		parentThread->setThreadHealth();
+	}
 
-		// add links to all the picks that support the hypo
-		std::vector < std::shared_ptr < CPick >> vTriggerPicks = trigger
-				->getVPick();
+	if (trigger->getWeb() == NULL) {
+		return (false);
+	}
 
-		for (auto pick : vTriggerPicks) {
-			// they're not associated yet, just potentially
-			hypo->addPickReference(pick);
+	// check to see if the pick is currently associated to a hypo
+	if (m_wpHypo.expired() == false) {
+		// get the hypo and compute distance between it and the
+		// current trigger
+		std::shared_ptr<CHypo> pHypo = m_wpHypo.lock();
+		if (pHypo != NULL) {
+			glass3::util::Geo geoHypo = pHypo->getGeo();
+
+			glass3::util::Geo trigHypo = trigger->getGeo();
+
+			double dist = (geoHypo.delta(&trigHypo)
+					/ glass3::util::GlassMath::k_DegreesToRadians)
+					* glass3::util::Geo::k_DegreesToKm;
+
+			// is the associated hypo close enough to this trigger to skip
+			// close enough means within the resolution of the trigger
+			if (dist < trigger->getWebResolution()) {
+				glass3::util::Logger::log(
+						"debug",
+						"CPick::nucleate: SKIPTRG because pick proximal hypo ("
+								+ std::to_string(dist) + " < "
+								+ std::to_string(
+										trigger->getWebResolution()) + ")");
+				return (false);
+			}
 		}
+	}
 
-		int ncut;
-		double thresh;
-		std::string triggeringWeb = hypo->getWebName();
-		std::string controllingWeb = "";
-		bool isAseismic = trigger->getNodeAseismic();
-		bool bad = false;
+	// create the hypo using the node
+	std::shared_ptr<CHypo> hypo = std::make_shared < CHypo
+			> (trigger, CGlass::getAssociationTravelTimes());
+
+	// set nuclation auditing info
+	hypo->setNucleationAuditingInfo(glass3::util::Date::now(),
+									this->getTInsertion());
+
+	// add links to all the picks that support the hypo
+	std::vector < std::shared_ptr < CPick >> vTriggerPicks = trigger
+			->getVPick();
+
+	for (auto pick : vTriggerPicks) {
+		// they're not associated yet, just potentially
+		hypo->addPickReference(pick);
+	}
 
+	int ncut;
+	double thresh;
+	std::string triggeringWeb = hypo->getWebName();
+	std::string controllingWeb = "";
+	bool isAseismic = trigger->getNodeAseismic();
+	bool bad = false;
+
+	if (parentThread != NULL) {
+		parentThread->setThreadHealth();
+	}
+
+	// First localization attempt after nucleation
+	// make 3 passes
+	for (int ipass = 0; ipass < k_nNucleateAnnealPasses; ipass++) {
 		if (parentThread != NULL) {
 			parentThread->setThreadHealth();
 		}
 
-		// First localization attempt after nucleation
-		// make 3 passes
-		for (int ipass = 0; ipass < k_nNucleateAnnealPasses; ipass++) {
-			if (parentThread != NULL) {
-				parentThread->setThreadHealth();
-			}
+		// get an initial location via synthetic annealing,
+		// which also prunes out any poorly fitting picks
+		// the search is based on the grid resolution, and how
+		// far out the ot can change without losing the initial pick
+		// this all assumes that the closest grid triggers
+		// values derived from testing global event association
+		double bayes = hypo->anneal(
+				k_nNucleateNumberOfAnnealIterations,
+				trigger->getWebResolution()
+						/ CHypo::k_dInitialAnnealStepReducationFactor,  // NOLINT
+				trigger->getWebResolution()
+						/ CHypo::k_dFinalAnnealStepReducationFactor,
+				std::max(
+						trigger->getWebResolution()
+								/ CHypo::k_dTimeToDistanceCorrectionFactor,  // NOLINT
+						k_dNucleateInitialAnnealTimeStepSize),  // NOLINT
+				k_dNucleateFinalAnnealTimeStepSize);
+
+		// get the number of picks we have now
+		int npick = hypo->getPickDataSize();
+		double depth = hypo->getDepth();
+
+		// build trigger string
+		std::string triggerString = "lat:"
+					+ glass3::util::to_string_with_precision(hypo->getLatitude())
+					+ "; lon:"
+					+ glass3::util::to_string_with_precision(hypo->getLongitude())
+					+ "; z:"
+					+ glass3::util::to_string_with_precision(hypo->getDepth())
+					+ ", ot:"
+					+ glass3::util::Date::encodeDateTime(hypo->getTOrigin());
 
-			// get an initial location via synthetic annealing,
-			// which also prunes out any poorly fitting picks
-			// the search is based on the grid resolution, and how
-			// far out the ot can change without losing the initial pick
-			// this all assumes that the closest grid triggers
-			// values derived from testing global event association
-			double bayes = hypo->anneal(
-					k_nNucleateNumberOfAnnealIterations,
-					trigger->getWebResolution()
-							/ CHypo::k_dInitialAnnealStepReducationFactor,  // NOLINT
-					trigger->getWebResolution()
-							/ CHypo::k_dFinalAnnealStepReducationFactor,
-					std::max(
-							trigger->getWebResolution()
-									/ CHypo::k_dTimeToDistanceCorrectionFactor,  // NOLINT
-							k_dNucleateInitialAnnealTimeStepSize),  // NOLINT
-					k_dNucleateFinalAnnealTimeStepSize);
-
-			// get the number of picks we have now
-			int npick = hypo->getPickDataSize();
-			double depth = hypo->getDepth();
-
-			// build trigger string
-			std::string triggerString = "lat:"
-						+ glass3::util::to_string_with_precision(hypo->getLatitude())
-						+ "; lon:"
-						+ glass3::util::to_string_with_precision(hypo->getLongitude())
-						+ "; z:"
-						+ glass3::util::to_string_with_precision(hypo->getDepth())
-						+ ", ot:"
-						+ glass3::util::Date::encodeDateTime(hypo->getTOrigin());
-
-			/*
-			 snprintf(sLog, sizeof(sLog), "CPick::nucleate: -- Pass:%d; nPick:%d"
-			 "/nCut:%d; bayes:%f/thresh:%f; %s",
-			 ipass, npick, ncut, bayes, thresh,
-			 hypo->getID().c_str());
-			 glass3::util::Logger::log(sLog);
-			 */
-
-			// look up which web controls this area
-			std::shared_ptr<CWeb> theWeb = NULL;
-			std::string aSeismic = "";
-
-			// if we allow using controlling webs
-			if (trigger->getWeb()->getAllowControllingWebs() == true) {
-				// get the controlling web
-				theWeb = CGlass::getWebList()->getControllingWeb(
-					hypo->getLatitude(), hypo->getLongitude());
-			}
-
-			// function returns null if there is a tie (most likely two global
-			// grids), if we don't allow contorlling webs, or if something else
-			// went wrong if this happens, just use the triggering web thresholds
-			if (theWeb != NULL) {
-				// isAseismic defines whether to use stricter thresholds
-				if (isAseismic == true) {
-					ncut = theWeb->getASeismicNucleationDataCountThreshold();
-					thresh = theWeb->getASeismicNucleationStackThreshold();
-					aSeismic = " aSeismic ";
-				} else {
-					ncut = theWeb->getNucleationDataCountThreshold();
-					thresh = theWeb->getNucleationStackThreshold();
-					aSeismic = "";
-				}
-				controllingWeb = theWeb->getName();
-			} else {
-				// isAseismic defines whether to use stricter thresholds
-				if (isAseismic == true) {
-					ncut = trigger->getWeb()->getASeismicNucleationDataCountThreshold();
-					thresh = trigger->getWeb()->getASeismicNucleationStackThreshold();
-					aSeismic = " aSeismic ";
-				} else {
-					ncut = trigger->getWeb()->getNucleationDataCountThreshold();
-					thresh = trigger->getWeb()->getNucleationStackThreshold();
-					aSeismic = "";
-				}
-				controllingWeb = "N/A";
-			}
+		/*
+		 snprintf(sLog, sizeof(sLog), "CPick::nucleate: -- Pass:%d; nPick:%d"
+		 "/nCut:%d; bayes:%f/thresh:%f; %s",
+		 ipass, npick, ncut, bayes, thresh,
+		 hypo->getID().c_str());
+		 glass3::util::Logger::log(sLog);
+		 */
 
-			// check to see if we still have enough picks for this hypo to
-			// survive.
-			// NOTE, in Node, ncut is used as a threshold for the number of
-			// *stations* here it's used for the number of *picks*, which only
-			// since we only nucleate on a single phase.
-			if (npick < ncut) {
-				// we don't
-				snprintf(sLog, sizeof(sLog),
-							"CPick::nucleate: -- Abandoning trigger %s "
-							"because the number of picks is below the cutoff "
-							"(npick:%d, ncut:%d, triggeringWeb:%s, "
-							"controllingWeb:%s) %s--",
-							triggerString.c_str(), npick, ncut,
-							triggeringWeb.c_str(), controllingWeb.c_str(),
-							aSeismic.c_str());
-				glass3::util::Logger::log(sLog);
-
-				// don't bother making additional passes
-				bad = true;
-				break;
-			}
+		// look up which web controls this area
+		std::shared_ptr<CWeb> theWeb = NULL;
+		std::string aSeismic = "";
 
-			// check to see if we still have a high enough bayes value for this
-			// hypo to survive.
-			if (bayes < thresh) {
-				// it isn't
-				snprintf(sLog, sizeof(sLog),
-							"CPick::nucleate: -- Abandoning trigger %s "
-							"because the bayes value is below the threshold "
-							"(bayes:%f, thresh:%f, triggeringWeb:%s, "
-							"controllingWeb:%s) %s--",
-							triggerString.c_str(), bayes, thresh,
-							triggeringWeb.c_str(), controllingWeb.c_str(),
-							aSeismic.c_str());
-				glass3::util::Logger::log(sLog);
-
-				// don't bother making additional passes
-				bad = true;
-				break;
-			}
+		// if we allow using controlling webs
+		if (trigger->getWeb()->getAllowControllingWebs() == true) {
+			// get the controlling web
+			theWeb = CGlass::getWebList()->getControllingWeb(
+				hypo->getLatitude(), hypo->getLongitude());
+		}
 
-			// check to see if we are not below the maximum allowed depth for
-			// the web
-			double maxDepth = CGlass::k_dMaximumDepth;
-			if (theWeb != NULL) {
-				maxDepth = theWeb->getMaxDepth();
+		// function returns null if there is a tie (most likely two global
+		// grids), if we don't allow contorlling webs, or if something else
+		// went wrong if this happens, just use the triggering web thresholds
+		if (theWeb != NULL) {
+			// isAseismic defines whether to use stricter thresholds
+			if (isAseismic == true) {
+				ncut = theWeb->getASeismicNucleationDataCountThreshold();
+				thresh = theWeb->getASeismicNucleationStackThreshold();
+				aSeismic = " aSeismic ";
 			} else {
-				maxDepth = trigger->getWeb()->getMaxDepth();
+				ncut = theWeb->getNucleationDataCountThreshold();
+				thresh = theWeb->getNucleationStackThreshold();
+				aSeismic = "";
 			}
-
-			if (depth > maxDepth) {
-				// it isn't
-				snprintf(sLog, sizeof(sLog),
-							"CPick::nucleate: -- Abandoning trigger %s "
-							"because the depth is greater than the max depth "
-							"(depth:%f, maxDepth:%f, triggeringWeb:%s, "
-							"controllingWeb:%s) %s--",
-							triggerString.c_str(), depth, maxDepth,
-							triggeringWeb.c_str(), controllingWeb.c_str(),
-							aSeismic.c_str());
-				glass3::util::Logger::log(sLog);
-
-				// don't bother making additional passes
-				bad = true;
-				break;
+			controllingWeb = theWeb->getName();
+		} else {
+			// isAseismic defines whether to use stricter thresholds
+			if (isAseismic == true) {
+				ncut = trigger->getWeb()->getASeismicNucleationDataCountThreshold();
+				thresh = trigger->getWeb()->getASeismicNucleationStackThreshold();
+				aSeismic = " aSeismic ";
+			} else {
+				ncut = trigger->getWeb()->getNucleationDataCountThreshold();
+				thresh = trigger->getWeb()->getNucleationStackThreshold();
+				aSeismic = "";
 			}
+			controllingWeb = "N/A";
+		}
 
-			// update the hypo thresholds
-			hypo->setNucleationDataThreshold(ncut);
-			hypo->setNucleationStackThreshold(thresh);
+		// check to see if we still have enough picks for this hypo to
+		// survive.
+		// NOTE, in Node, ncut is used as a threshold for the number of
+		// *stations* here it's used for the number of *picks*, which only
+		// since we only nucleate on a single phase.
+		if (npick < ncut) {
+			// we don't
+			snprintf(sLog, sizeof(sLog),
+						"CPick::nucleate: -- Abandoning trigger %s "
+						"because the number of picks is below the cutoff "
+						"(npick:%d, ncut:%d, triggeringWeb:%s, "
+						"controllingWeb:%s) %s--",
+						triggerString.c_str(), npick, ncut,
+						triggeringWeb.c_str(), controllingWeb.c_str(),
+						aSeismic.c_str());
+			glass3::util::Logger::log(sLog);
+
+			// don't bother making additional passes
+			bad = true;
+			break;
+		}
 
-			if (parentThread != NULL) {
-				parentThread->setThreadHealth();
-			}
-		}  // end for each anneal pass
+		// check to see if we still have a high enough bayes value for this
+		// hypo to survive.
+		if (bayes < thresh) {
+			// it isn't
+			snprintf(sLog, sizeof(sLog),
+						"CPick::nucleate: -- Abandoning trigger %s "
+						"because the bayes value is below the threshold "
+						"(bayes:%f, thresh:%f, triggeringWeb:%s, "
+						"controllingWeb:%s) %s--",
+						triggerString.c_str(), bayes, thresh,
+						triggeringWeb.c_str(), controllingWeb.c_str(),
+						aSeismic.c_str());
+			glass3::util::Logger::log(sLog);
+
+			// don't bother making additional passes
+			bad = true;
+			break;
+		}
 
-		if (parentThread != NULL) {
-			parentThread->setThreadHealth();
+		// check to see if we are not below the maximum allowed depth for
+		// the web
+		double maxDepth = CGlass::k_dMaximumDepth;
+		if (theWeb != NULL) {
+			maxDepth = theWeb->getMaxDepth();
+		} else {
+			maxDepth = trigger->getWeb()->getMaxDepth();
 		}
 
-		// we've abandoned the potential hypo at this node
-		if (bad) {
-			// move on to the next triggering node
-			continue;
+		if (depth > maxDepth) {
+			// it isn't
+			snprintf(sLog, sizeof(sLog),
+						"CPick::nucleate: -- Abandoning trigger %s "
+						"because the depth is greater than the max depth "
+						"(depth:%f, maxDepth:%f, triggeringWeb:%s, "
+						"controllingWeb:%s) %s--",
+						triggerString.c_str(), depth, maxDepth,
+						triggeringWeb.c_str(), controllingWeb.c_str(),
+						aSeismic.c_str());
+			glass3::util::Logger::log(sLog);
+
+			// don't bother making additional passes
+			bad = true;
+			break;
 		}
 
-		// log the hypo
-		std::string st = glass3::util::Date::encodeDateTime(hypo->getTOrigin());
-		glass3::util::Logger::log(
-				"debug",
-				"CPick::nucleate: TRG site:" + pickSite->getSCNL() + "; tPick:"
-						+ pt + "; sID:" + m_sID + " => web:"
-						+ triggeringWeb + "; hyp: " + hypo->getID()
-						+ "; lat:"
-						+ glass3::util::to_string_with_precision(hypo->getLatitude(), 3)
-						+ "; lon:"
-						+ glass3::util::to_string_with_precision(hypo->getLongitude(), 3)
-						+ "; z:"
-						+ glass3::util::to_string_with_precision(hypo->getDepth())
-						+ "; bayes:"
-						+ glass3::util::to_string_with_precision(hypo->getBayesValue())
-						+ "; tOrg:" + st);
-
-		// if we got this far, the hypo has enough supporting data to
-		// merit adding it to the hypo list
-		CGlass::getHypoList()->addHypo(hypo, true, parentThread);
+		// update the hypo thresholds
+		hypo->setNucleationDataThreshold(ncut);
+		hypo->setNucleationStackThreshold(thresh);
 
 		if (parentThread != NULL) {
 			parentThread->setThreadHealth();
 		}
+	}  // end for each anneal pass
+
+	if (parentThread != NULL) {
+		parentThread->setThreadHealth();
 	}
 
-	// done
+	// we've abandoned the potential hypo at this node
+	if (bad) {
+		// move on to the next triggering node
+		return (false);
+	}
+
+	// log the hypo
+	std::string st = glass3::util::Date::encodeDateTime(hypo->getTOrigin());
+	glass3::util::Logger::log(
+			"debug",
+			"CPick::nucleate: TRG site:" + pickSite->getSCNL() + "; tPick:"
+					+ pt + "; sID:" + m_sID + " => web:"
+					+ triggeringWeb + "; hyp: " + hypo->getID()
+					+ "; lat:"
+					+ glass3::util::to_string_with_precision(hypo->getLatitude(), 3)
+					+ "; lon:"
+					+ glass3::util::to_string_with_precision(hypo->getLongitude(), 3)
+					+ "; z:"
+					+ glass3::util::to_string_with_precision(hypo->getDepth())
+					+ "; bayes:"
+					+ glass3::util::to_string_with_precision(hypo->getBayesValue())
+					+ "; tOrg:" + st);
+
+	// if we got this far, the hypo has enough supporting data to
+	// merit adding it to the hypo list
+	CGlass::getHypoList()->addHypo(hypo, true, parentThread);
+
+	if (parentThread != NULL) {
+		parentThread->setThreadHealth();
+	}
+
+	// a hypo was created
 	return (true);
 }
 
@@ -1,7 +1,12 @@
 #include "PickList.h"
 #include <json.h>
 #include <date.h>
+#include <clock.h>
 #include <logger.h>
+#include <latencytracer.h>
+#include <metricsregistry.h>
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <utility>
 #include <memory>
@@ -10,6 +15,7 @@
 #include <set>
 #include <vector>
 #include <ctime>
+#include <chrono>
 #include "Site.h"
 #include "Pick.h"
 #include "Glass.h"
@@ -28,6 +34,7 @@ const int CPickList::k_ProcessQueueMaximumSize;
 CPickList::CPickList(int numThreads, int sleepTime, int checkInterval)
 		: glass3::util::ThreadBaseClass("PickList", sleepTime, numThreads,
 										checkInterval) {
+	m_PickListMutex.setName("CPickList::m_PickListMutex");
 	clear();
 
 	// start up the threads
@@ -40,7 +47,8 @@ CPickList::~CPickList() {
 
 // ---------------------------------------------------------~clear
 void CPickList::clear() {
-	std::lock_guard<std::recursive_mutex> pickListGuard(m_PickListMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> pickListGuard(
+			m_PickListMutex);
 
 	m_pSiteList = NULL;
 
@@ -55,6 +63,7 @@ void CPickList::clear() {
 
 	// reset nPick
 	m_iCountOfTotalPicksProcessed = 0;
+	m_iTotalNucleationMicroseconds = 0;
 	m_iMaxAllowablePickCount = k_nMaxAllowablePickCountDefault;
 
 	// init the upper and lower values
@@ -198,7 +207,8 @@ std::vector<std::weak_ptr<CPick>> CPickList::getPicks(double t1, double t2) {
 	// that this be in the form of a std::shared_ptr<CPick>
 	m_UpperValue->setTSort(t2);
 
-	std::lock_guard<std::recursive_mutex> listGuard(m_PickListMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> listGuard(
+			m_PickListMutex);
 
 	// don't bother if the list is empty
 	if (m_msPickList.size() == 0) {
@@ -393,8 +403,6 @@ bool CPickList::scavenge(std::shared_ptr<CHypo> hyp, double tDuration) {
 
 // ---------------------------------------------------------work
 glass3::util::WorkState CPickList::work() {
-	bool bNucleateThisPick = true;
-
 	// make sure we have a HypoList
 	if (CGlass::getHypoList() == NULL) {
 		// on to the next loop
@@ -432,6 +440,13 @@ glass3::util::WorkState CPickList::work() {
 	// get the next pick
 	std::shared_ptr<json::Object> jsonPick = m_qPicksToProcess.front();
 	m_qPicksToProcess.pop();
+	std::chrono::steady_clock::time_point tDequeue =
+			std::chrono::steady_clock::now();
+
+	static std::atomic<double> &queueGauge =
+			glass3::util::MetricsRegistry::getInstance().getGauge(
+					"picklist.queue");
+	queueGauge = m_qPicksToProcess.size();
 
 	// done with queue
 	m_PicksToProcessMutex.unlock();
@@ -443,6 +458,28 @@ glass3::util::WorkState CPickList::work() {
 		return (glass3::util::WorkState::OK);
 	}
 
+	processPick(jsonPick, tDequeue);
+
+	// when replaying in simulated time, the data drives the clock, advance it
+	// once the pick has been processed, rather than when it was queued, so
+	// that picks still waiting to be processed don't see a later time
+	if ((glass3::util::Clock::isSimulated() == true)
+			&& (jsonPick->HasKey("Time"))
+			&& ((*jsonPick)["Time"].GetType() == json::ValueType::StringVal)) {
+		glass3::util::Clock::advanceSimulatedTime(
+				glass3::util::Date::convertISO8601ToEpochTime(
+						(*jsonPick)["Time"].ToString()));
+	}
+
+	// give up some time at the end of the loop
+	return (glass3::util::WorkState::OK);
+}
+
+// ---------------------------------------------------------processPick
+void CPickList::processPick(std::shared_ptr<json::Object> jsonPick,
+							std::chrono::steady_clock::time_point tDequeue) {
+	bool bNucleateThisPick = true;
+
 	// create new pick from json message
 	CPick * newPick = new CPick(jsonPick, m_pSiteList);
 
@@ -455,12 +492,15 @@ glass3::util::WorkState CPickList::work() {
 		delete (newPick);
 
 		// message was processed
-		return (glass3::util::WorkState::OK);
+		return;
 	}
 
 	// signal that the thread is still alive after pick parsing
 	setThreadHealth();
 
+	glass3::util::LatencyTracer::getInstance().mark(
+			newPick->getID(), glass3::util::LatencyTracer::Dequeue, tDequeue);
+
 	// check if pick is duplicate
 	std::shared_ptr<CPick> existingPick = getDuplicate(
 			newPick->getTPick(), newPick->getSite()->getSCNL(),
@@ -494,6 +534,10 @@ glass3::util::WorkState CPickList::work() {
 			// update the position of the pick in the sort
 			updatePosition(existingPick);
 
+			// and at its site, which also restacks the pick at the site's
+			// nodes when using incremental nucleation
+			existingPick->getSite()->updatePosition(existingPick);
+
 			// if the pick was associated to a hypo,
 			// reprocess that hypo
 			std::shared_ptr<CHypo> hypo = existingPick->getHypoReference();
@@ -511,7 +555,7 @@ glass3::util::WorkState CPickList::work() {
 		delete (newPick);
 
 		// message was processed
-		return (glass3::util::WorkState::OK);
+		return;
 	}
 
 	// are we configured to check pick noise classification
@@ -528,7 +572,7 @@ glass3::util::WorkState CPickList::work() {
 				// cleanup
 				delete (newPick);
 				// message was processed (rejected)
-				return (glass3::util::WorkState::OK);
+				return;
 			}
 		}
 	}
@@ -539,6 +583,11 @@ glass3::util::WorkState CPickList::work() {
 
 	m_iCountOfTotalPicksProcessed++;
 
+	static std::atomic<int64_t> &pickCounter =
+			glass3::util::MetricsRegistry::getInstance().getCounter(
+					"picklist.picks");
+	pickCounter++;
+
 	// get maximum number of picks
 	// use max picks from pGlass if we have it
 	if (CGlass::getMaxNumPicks() > 0) {
@@ -566,7 +615,7 @@ glass3::util::WorkState CPickList::work() {
 			m_PickListMutex.unlock();
 			// it is, don't insert
 			// message was processed
-			return (glass3::util::WorkState::OK);
+			return;
 		}
 
 		// remove from site specific pick list
@@ -640,22 +689,35 @@ glass3::util::WorkState CPickList::work() {
 
 	// Attempt nucleation unless we were told not to.
 	if (bNucleateThisPick == true) {
+		std::chrono::high_resolution_clock::time_point tNucleateStartTime =
+				std::chrono::high_resolution_clock::now();
+
 		pick->nucleate(this);
-	}
 
-	// give up some time at the end of the loop
-	return (glass3::util::WorkState::OK);
+		int64_t nucleateMicroseconds = std::chrono::duration_cast<
+				std::chrono::microseconds>(
+				std::chrono::high_resolution_clock::now() - tNucleateStartTime)
+				.count();
+		m_iTotalNucleationMicroseconds += nucleateMicroseconds;
+
+		static glass3::util::LatencyHistogram &nucleateHistogram =
+				glass3::util::MetricsRegistry::getInstance().getHistogram(
+						"picklist.nucleate_us");
+		nucleateHistogram.record(nucleateMicroseconds);
+	}
 }
 
 // ---------------------------------------------------------getSiteList
 const CSiteList* CPickList::getSiteList() const {
-	std::lock_guard<std::recursive_mutex> pickListGuard(m_PickListMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> pickListGuard(
+			m_PickListMutex);
 	return (m_pSiteList);
 }
 
 // ---------------------------------------------------------setSiteList
 void CPickList::setSiteList(CSiteList* siteList) {
-	std::lock_guard<std::recursive_mutex> pickListGuard(m_PickListMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> pickListGuard(
+			m_PickListMutex);
 	m_pSiteList = siteList;
 }
 
@@ -676,10 +738,22 @@ int CPickList::getCountOfTotalPicksProcessed() const {
 
 // ---------------------------------------------------------size
 int CPickList::length() const {
-	std::lock_guard<std::recursive_mutex> vPickGuard(m_PickListMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> vPickGuard(
+			m_PickListMutex);
 	return (m_msPickList.size());
 }
 
+// -------------------------------------------getPickProcessingQueueLength
+int CPickList::getPickProcessingQueueLength() {
+	std::lock_guard<std::mutex> queueGuard(m_PicksToProcessMutex);
+	return (m_qPicksToProcess.size());
+}
+
+// ---------------------------------------------------getTotalNucleationTime
+double CPickList::getTotalNucleationTime() const {
+	return (static_cast<double>(m_iTotalNucleationMicroseconds) / 1000000.0);
+}
+
 // ---------------------------------------------------------updatePosition
 void CPickList::updatePosition(std::shared_ptr<CPick> pick) {
 	// nullchecks
@@ -687,7 +761,8 @@ void CPickList::updatePosition(std::shared_ptr<CPick> pick) {
 		return;
 	}
 
-	std::lock_guard<std::recursive_mutex> listGuard(m_PickListMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> listGuard(
+			m_PickListMutex);
 
 	// from my research, the best way to "update" the position of an item
 	// in a multiset when the key value has changed (in this case, the pick
@@ -711,7 +786,8 @@ void CPickList::eraseFromMultiset(std::shared_ptr<CPick> pick) {
 		return;
 	}
 
-	std::lock_guard<std::recursive_mutex> listGuard(m_PickListMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> listGuard(
+			m_PickListMutex);
 
 	if (m_msPickList.size() == 0) {
 		return;
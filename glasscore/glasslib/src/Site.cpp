@@ -1,6 +1,7 @@
 #include "Site.h"
 
 #include <date.h>
+#include <clock.h>
 
 #include <json.h>
 #include <logger.h>
@@ -13,9 +14,11 @@
 #include <memory>
 #include <vector>
 #include <set>
+#include <map>
 #include <algorithm>
 #include <mutex>
 #include <ctime>
+#include <limits>
 #include "Glass.h"
 #include "Pick.h"
 #include "PickList.h"
@@ -381,6 +384,7 @@ void CSite::clear() {
 	// clear lists
 	m_vNodeMutex.lock();
 	m_vNode.clear();
+	m_bHasPicks = false;
 	m_vNodeMutex.unlock();
 
 	vPickMutex.lock();
@@ -399,7 +403,7 @@ void CSite::clear() {
 	vPickMutex.unlock();
 
 	// reset last pick added time
-	m_tLastPickAdded = std::time(NULL);
+	m_tLastPickAdded = glass3::util::Clock::now();
 
 	// reset picks since last check
 	setPickCountSinceCheck(0);
@@ -513,9 +517,6 @@ double CSite::getDistance(std::shared_ptr<CSite> site) {
 
 // ---------------------------------------------------------addPick
 void CSite::addPick(std::shared_ptr<CPick> pck) {
-	// lock for editing
-	std::lock_guard<std::mutex> guard(vPickMutex);
-
 	// nullcheck
 	if (pck == NULL) {
 		glass3::util::Logger::log("warning",
@@ -532,14 +533,33 @@ void CSite::addPick(std::shared_ptr<CPick> pck) {
 		return;
 	}
 
-	// add pick to site pick multiset
-	m_msPickList.insert(pck);
+	bool firstPick = false;
+	{
+		// lock for editing
+		std::lock_guard<std::mutex> guard(vPickMutex);
+
+		// add pick to site pick multiset
+		m_msPickList.insert(pck);
+		firstPick = (m_msPickList.size() == 1);
+
+		// remember the time the last pick was added
+		m_tLastPickAdded = glass3::util::Clock::now();
 
-	// remember the time the last pick was added
-	m_tLastPickAdded = std::time(NULL);
+		// keep track of how many picks
+		setPickCountSinceCheck(getPickCountSinceCheck() + 1);
+	}
+
+	// the site just became active, let the linked nodes know, done after
+	// unlock to avoid site-node deadlocks
+	if (firstPick == true) {
+		updateNodeActivity();
+	}
 
-	// keep track of how many picks
-	setPickCountSinceCheck(getPickCountSinceCheck() + 1);
+	// stack the pick at the linked nodes, done after unlock to avoid
+	// site-node deadlocks
+	if (CGlass::getIncrementalNucleation() == true) {
+		addPickToNodeStacks(pck);
+	}
 }
 
 // ---------------------------------------------------------removePick
@@ -554,10 +574,26 @@ void CSite::removePick(std::shared_ptr<CPick> pck) {
 		return;
 	}
 
-	std::lock_guard<std::mutex> guard(vPickMutex);
+	bool lastPick = false;
+	{
+		std::lock_guard<std::mutex> guard(vPickMutex);
+
+		// erase it
+		eraseFromMultiset(pck);
+		lastPick = m_msPickList.empty();
+	}
+
+	// the site may have just become idle, let the linked nodes know, done
+	// after unlock to avoid site-node deadlocks
+	if (lastPick == true) {
+		updateNodeActivity();
+	}
 
-	// erase it
-	eraseFromMultiset(pck);
+	// unstack the pick at the linked nodes, done after unlock to avoid
+	// site-node deadlocks
+	if (CGlass::getIncrementalNucleation() == true) {
+		removePickFromNodeStacks(pck);
+	}
 }
 
 // ---------------------------------------------------------getVPick
@@ -672,6 +708,26 @@ void CSite::addNode(std::shared_ptr<CNode> node, double distDeg,
 	NodeLink link = std::make_tuple(node, travelTime1, phase1, travelTime2,
 		phase2, distDeg);
 	m_vNode.push_back(link);
+
+	// the node counts this site if it has picks
+	if (m_bHasPicks == true) {
+		node->addActiveSite(travelTime1, travelTime2);
+	}
+
+	// stack the picks this site already has at the node. This is done while
+	// holding the node list lock, which also guards stacking and unstacking
+	// picks at the linked nodes, so that a pick added or removed while the
+	// node is being linked ends up stacked exactly when it is at the site
+	if ((CGlass::getIncrementalNucleation() == true)
+			&& (node->getCoarse() == false)) {
+		std::vector<std::shared_ptr<CPick>> vSitePicks = getPicks(
+				std::numeric_limits<double>::lowest(),
+				std::numeric_limits<double>::max());
+		for (auto pick : vSitePicks) {
+			node->addPickToStack(pick, distDeg, travelTime1, phase1,
+									travelTime2, phase2);
+		}
+	}
 }
 
 // ---------------------------------------------------------removeNode
@@ -699,6 +755,12 @@ void CSite::removeNode(std::string nodeID) {
 		if (auto aNode = std::get<LINK_PTR>(*it).lock()) {
 			// erase target pick
 			if (aNode->getID() == nodeID) {
+				// the node no longer counts this site
+				if (m_bHasPicks == true) {
+					aNode->removeActiveSite(std::get<LINK_TT1>(*it),
+											std::get<LINK_TT2>(*it));
+				}
+
 				it = m_vNode.erase(it);
 				return;
 			} else {
@@ -726,79 +788,124 @@ std::vector<std::shared_ptr<CTrigger>> CSite::nucleate(double tPick,
 	}
 	m_SiteMutex.unlock();
 
-	// for each node linked to this site
+	// in a hierarchical web, a fine node is only worth nucleating if its
+	// coarse node came close to triggering. The coarse nodes linked to this
+	// site are nucleated first, with their own travel times. A coarse node
+	// that isn't linked to this site is nucleated once, at the origin times
+	// of the first fine node under it, its residual allowance covers the
+	// origin times of the others
+	std::map<CNode *, bool> coarseNodesOpen;
 	for (const auto &link : m_vNode) {
-		if (parentThread != NULL) {
-			parentThread->setThreadHealth();
+		std::shared_ptr<CNode> node = std::get<LINK_PTR>(link).lock();
+		if ((node == NULL) || (node->getCoarse() == false)) {
+			continue;
+		}
+		if (node->getEnabled() == false) {
+			continue;
 		}
 
-		// compute potential origin time from tPick and travel time to node
-		// first get traveltime1 to node
-		double travelTime1 = std::get< LINK_TT1>(link);
-
-		// second get traveltime2 to node
-		double travelTime2 = std::get< LINK_TT2>(link);
+		coarseNodesOpen[node.get()] = (nucleateNode(link, node, tPick,
+													parentThread) != NULL);
+	}
 
-		// third get shared pointer to node
+	// for each node linked to this site
+	for (const auto &link : m_vNode) {
+		// get shared pointer to node
 		std::shared_ptr<CNode> node = std::get<LINK_PTR>(link).lock();
 
 		if (node == NULL) {
 			continue;
 		}
 
-		if (node->getEnabled() == false) {
+		if ((node->getEnabled() == false) || (node->getCoarse() == true)) {
 			continue;
 		}
 
-		// compute first origin time
-		double tOrigin1 = -1;
-		if (travelTime1 > 0) {
-			tOrigin1 = tPick - travelTime1;
-		}
-
-		// compute second origin time
-		double tOrigin2 = -1;
-		if (travelTime2 > 0) {
-			tOrigin2 = tPick - travelTime2;
-		}
+		// skip nodes under a coarse node that didn't come close, a disabled
+		// coarse node doesn't gate the nodes under it
+		std::shared_ptr<CNode> parent = node->getParentNode();
+		if ((parent != NULL) && (parent->getEnabled() == true)) {
+			auto coarseNode = coarseNodesOpen.find(parent.get());
+			if (coarseNode == coarseNodesOpen.end()) {
+				coarseNode = coarseNodesOpen.insert(
+						std::make_pair(
+								parent.get(),
+								nucleateNode(link, parent, tPick, parentThread)
+										!= NULL)).first;
+			}
 
-		// attempt to nucleate an event located
-		// at the current node with the potential origin times
-		bool primarySuccessful = false;
-		if (tOrigin1 > 0) {
-			std::shared_ptr<CTrigger> trigger1 = node->nucleate(tOrigin1,
-				parentThread);
-
-			if (trigger1 != NULL) {
-				// if node triggered, add to triggered vector
-				addTriggerToList(&vTrigger, trigger1);
-				primarySuccessful = true;
+			if (coarseNode->second == false) {
+				if (node->getWeb() != NULL) {
+					node->getWeb()->countNucleationSkip();
+				}
+				continue;
 			}
 		}
 
-		// only attempt secondary phase nucleation if primary nucleation
-		// was unsuccessful
-		if ((primarySuccessful == false) && (tOrigin2 > 0)) {
-			std::shared_ptr<CTrigger> trigger2 = node->nucleate(tOrigin2,
-				parentThread);
+		// if node triggered, add to triggered vector
+		addTriggerToList(&vTrigger,
+							nucleateNode(link, node, tPick, parentThread));
+	}
 
-			if (trigger2 != NULL) {
-				// if node triggered, add to triggered vector
-				addTriggerToList(&vTrigger, trigger2);
-			}
-		}
+	return (vTrigger);
+}
 
-		if ((tOrigin1 < 0) && (tOrigin2 < 0)) {
-			glass3::util::Logger::log(
-					"warning",
-					"CSite::nucleate: " + m_sSCNL + " No valid travel times. ("
-							+ std::to_string(travelTime1) + ", "
-							+ std::to_string(travelTime2) + ") web: "
-							+ node->getWeb()->getName());
+// ---------------------------------------------------------nucleateNode
+std::shared_ptr<CTrigger> CSite::nucleateNode(const NodeLink &link,
+												std::shared_ptr<CNode> node,
+												double tPick,
+												CPickList* parentThread) {
+	if (parentThread != NULL) {
+		parentThread->setThreadHealth();
+	}
+
+	// compute potential origin time from tPick and travel time to node
+	// first get traveltime1 to node
+	double travelTime1 = std::get< LINK_TT1>(link);
+
+	// second get traveltime2 to node
+	double travelTime2 = std::get< LINK_TT2>(link);
+
+	// compute first origin time
+	double tOrigin1 = -1;
+	if (travelTime1 > 0) {
+		tOrigin1 = tPick - travelTime1;
+	}
+
+	// compute second origin time
+	double tOrigin2 = -1;
+	if (travelTime2 > 0) {
+		tOrigin2 = tPick - travelTime2;
+	}
+
+	if ((tOrigin1 < 0) && (tOrigin2 < 0)) {
+		glass3::util::Logger::log(
+				"warning",
+				"CSite::nucleate: " + m_sSCNL + " No valid travel times. ("
+						+ std::to_string(travelTime1) + ", "
+						+ std::to_string(travelTime2) + ") web: "
+						+ node->getWeb()->getName());
+		return (NULL);
+	}
+
+	// attempt to nucleate an event located
+	// at the current node with the potential origin times
+	if (tOrigin1 > 0) {
+		std::shared_ptr<CTrigger> trigger1 = node->nucleate(tOrigin1,
+			parentThread);
+
+		if (trigger1 != NULL) {
+			return (trigger1);
 		}
 	}
 
-	return (vTrigger);
+	// only attempt secondary phase nucleation if primary nucleation
+	// was unsuccessful
+	if (tOrigin2 > 0) {
+		return (node->nucleate(tOrigin2, parentThread));
+	}
+
+	return (NULL);
 }
 
 // ---------------------------------------------------------addTrigger
@@ -961,21 +1068,94 @@ void CSite::updatePosition(std::shared_ptr<CPick> pick) {
 		return;
 	}
 
-	std::lock_guard<std::recursive_mutex> listGuard(m_SiteMutex);
+	{
+		std::lock_guard<std::recursive_mutex> listGuard(m_SiteMutex);
+
+		// from my research, the best way to "update" the position of an item
+		// in a multiset when the key value has changed (in this case, the pick
+		// time) is to remove and re-add the item. This will give us O(log n)
+		// complexity for updating one item, which is better than a full sort
+		// (which I'm not really sure how to do on a multiset)
+		// erase
+		eraseFromMultiset(pick);
+
+		// update tSort
+		pick->setTSort(pick->getTPick());
+
+		// insert
+		m_msPickList.insert(pick);
+	}
+
+	// the pick time changed, so restack the pick at the linked nodes, done
+	// after unlock to avoid site-node deadlocks
+	if (CGlass::getIncrementalNucleation() == true) {
+		addPickToNodeStacks(pick);
+	}
+}
 
-	// from my research, the best way to "update" the position of an item
-	// in a multiset when the key value has changed (in this case, the pick
-	// time) is to remove and re-add the item. This will give us O(log n)
-	// complexity for updating one item, which is better than a full sort
-	// (which I'm not really sure how to do on a multiset)
-	// erase
-	eraseFromMultiset(pick);
+// ---------------------------------------------------------addPickToNodeStacks
+void CSite::addPickToNodeStacks(std::shared_ptr<CPick> pick) {
+	std::lock_guard<std::mutex> guard(m_vNodeMutex);
 
-	// update tSort
-	pick->setTSort(pick->getTPick());
+	// for each node linked to this site
+	for (const auto &link : m_vNode) {
+		std::shared_ptr<CNode> node = std::get<LINK_PTR>(link).lock();
 
-	// insert
-	m_msPickList.insert(pick);
+		// coarse nodes scan their sites' picks rather than stacking them
+		if ((node == NULL) || (node->getCoarse() == true)) {
+			continue;
+		}
+
+		node->addPickToStack(pick, std::get< LINK_DIST>(link),
+								std::get< LINK_TT1>(link),
+								std::get< LINK_PHS1>(link),
+								std::get< LINK_TT2>(link),
+								std::get< LINK_PHS2>(link));
+	}
+}
+
+// ---------------------------------------------------------updateNodeActivity
+void CSite::updateNodeActivity() {
+	std::lock_guard<std::mutex> guard(m_vNodeMutex);
+
+	// check whether we have picks now, another thread may have already
+	// caught up with the change, or reversed it
+	bool hasPicks = (getPickCount() > 0);
+	if (hasPicks == m_bHasPicks) {
+		return;
+	}
+	m_bHasPicks = hasPicks;
+
+	// for each node linked to this site
+	for (const auto &link : m_vNode) {
+		std::shared_ptr<CNode> node = std::get<LINK_PTR>(link).lock();
+		if (node == NULL) {
+			continue;
+		}
+
+		if (hasPicks == true) {
+			node->addActiveSite(std::get< LINK_TT1>(link),
+								std::get< LINK_TT2>(link));
+		} else {
+			node->removeActiveSite(std::get< LINK_TT1>(link),
+									std::get< LINK_TT2>(link));
+		}
+	}
+}
+
+// ---------------------------------------------------------removePickFromNodeStacks
+void CSite::removePickFromNodeStacks(std::shared_ptr<CPick> pick) {
+	std::lock_guard<std::mutex> guard(m_vNodeMutex);
+
+	// for each node linked to this site
+	for (const auto &link : m_vNode) {
+		std::shared_ptr<CNode> node = std::get<LINK_PTR>(link).lock();
+		if ((node == NULL) || (node->getCoarse() == true)) {
+			continue;
+		}
+
+		node->removePickFromStack(pick);
+	}
 }
 
 // ---------------------------------------------------------eraseFromMultiset
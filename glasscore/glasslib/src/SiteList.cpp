@@ -1,12 +1,14 @@
 #include "SiteList.h"
 #include <json.h>
 #include <logger.h>
+#include <clock.h>
 #include <cmath>
 #include <string>
 #include <memory>
 #include <mutex>
 #include <vector>
 #include <ctime>
+#include <functional>
 #include "Glass.h"
 #include "Site.h"
 #include "WebList.h"
@@ -22,6 +24,11 @@ const int CSiteList::k_nHoursToSeconds;
 CSiteList::CSiteList(int numThreads, int sleepTime, int checkInterval)
 		: glass3::util::ThreadBaseClass("SiteList", sleepTime, numThreads,
 										checkInterval) {
+	m_SiteListMutex.setName("CSiteList::m_SiteListMutex");
+	m_iCheckTimerID = -1;
+	m_bCheckDue = false;
+
+	// clear also starts the site check timer
 	clear();
 
 	// start up the thread
@@ -30,11 +37,28 @@ CSiteList::CSiteList(int numThreads, int sleepTime, int checkInterval)
 
 // ---------------------------------------------------------~CSiteList
 CSiteList::~CSiteList() {
+	// make sure the site check doesn't run once we're gone
+	if (m_iCheckTimerID >= 0) {
+		glass3::util::TimerService::getInstance().removeTimer(m_iCheckTimerID);
+	}
 }
 
 // ---------------------------------------------------------clear
 void CSiteList::clear() {
-	std::lock_guard<std::recursive_mutex> siteListGuard(m_SiteListMutex);
+	// restart the hourly site check, this waits for a running check, so it
+	// must be done before locking the site list
+	glass3::util::TimerService &timerService =
+			glass3::util::TimerService::getInstance();
+	if (m_iCheckTimerID >= 0) {
+		timerService.removeTimer(m_iCheckTimerID);
+	}
+	m_iCheckTimerID = timerService.addTimer(
+			"SiteList check", k_nHoursToSeconds * 1000,
+			std::bind(&CSiteList::checkDue, this), true);
+	m_bCheckDue = false;
+
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> siteListGuard(
+			m_SiteListMutex);
 
 	// clear sites
 	for (auto site : m_vSite) {
@@ -49,9 +73,9 @@ void CSiteList::clear() {
 	m_iMaxHoursWithoutPicking = -1;
 	m_iHoursBeforeLookingUp = -1;
 	m_iMaxPicksPerHour = -1;
-	m_tLastChecked = std::time(NULL);
-	m_tLastUpdated = std::time(NULL);
-	m_tCreated = std::time(NULL);
+	m_tLastChecked = glass3::util::Clock::now();
+	m_tLastUpdated = glass3::util::Clock::now();
+	m_tCreated = glass3::util::Clock::now();
 }
 
 // -------------------------------------------------------receiveExternalMessage
@@ -169,8 +193,7 @@ bool CSiteList::addListOfSitesFromJSON(std::shared_ptr<json::Object> com) {
 	}
 
 	// what time is it
-	time_t tNow;
-	std::time(&tNow);
+	time_t tNow = glass3::util::Clock::now();
 	int siteCount = 0;
 	int usedSiteCount = 0;
 
@@ -266,7 +289,8 @@ bool CSiteList::addSite(std::shared_ptr<CSite> site) {
 	// check to see if we have an existing site
 	std::shared_ptr<CSite> oldSite = getSite(site->getSCNL());
 
-	std::lock_guard<std::recursive_mutex> guard(m_SiteListMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_SiteListMutex);
 
 	// check if we already had this site
 	if (oldSite) {
@@ -289,8 +313,7 @@ bool CSiteList::addSite(std::shared_ptr<CSite> site) {
 	}
 
 	// what time is it
-	time_t tNow;
-	std::time(&tNow);
+	time_t tNow = glass3::util::Clock::now();
 
 	// list was modified
 	m_tLastUpdated = tNow;
@@ -310,7 +333,8 @@ std::shared_ptr<CSite> CSiteList::getSite(std::string scnl) {
 		return (NULL);
 	}
 
-	std::lock_guard<std::recursive_mutex> guard(m_SiteListMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_SiteListMutex);
 
 	// lookup the site in the map by scnl
 	auto itsite = m_mSite.find(scnl);
@@ -382,11 +406,11 @@ std::shared_ptr<CSite> CSiteList::getSite(std::string site, std::string comp,
 	// send request for information about this station
 	if (m_iHoursBeforeLookingUp >= 0) {
 		// what time is it
-		time_t tNow;
-		std::time(&tNow);
+		time_t tNow = glass3::util::Clock::now();
 
 		// lock while we are searching / editing m_mLastTimeSiteLookedUp
-		std::lock_guard<std::recursive_mutex> guard(m_SiteListMutex);
+		std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+				m_SiteListMutex);
 
 		// get what time this station has been looked up before
 		int tLookup = 0;
@@ -427,7 +451,8 @@ std::shared_ptr<CSite> CSiteList::getSite(std::string site, std::string comp,
 
 // ---------------------------------------------------------getListOfSites
 std::vector<std::shared_ptr<CSite>> CSiteList::getListOfSites() {
-	std::lock_guard<std::recursive_mutex> guard(m_SiteListMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_SiteListMutex);
 
 	std::vector<std::shared_ptr<CSite>> siteList;
 
@@ -449,7 +474,8 @@ std::shared_ptr<json::Object> CSiteList::generateSiteListMessage(bool send) {
 	// array to hold data
 	json::Array stationList;
 
-	std::lock_guard<std::recursive_mutex> guard(m_SiteListMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> guard(
+			m_SiteListMutex);
 
 	// move through whole vector
 	for (const auto &site : m_vSite) {
@@ -493,12 +519,18 @@ std::shared_ptr<json::Object> CSiteList::generateSiteListMessage(bool send) {
 
 // ------------------------------------------------------size
 int CSiteList::size() const {
-	std::lock_guard<std::recursive_mutex> vSiteGuard(m_SiteListMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> vSiteGuard(
+			m_SiteListMutex);
 	return (m_vSite.size());
 }
 
 // ------------------------------------------------------work
 glass3::util::WorkState CSiteList::work() {
+	// only check when the hourly timer says so
+	if (m_bCheckDue.exchange(false) == false) {
+		return (glass3::util::WorkState::Idle);
+	}
+
 	// don't bother if we're not configured to check sites
 	if ((getMaxHoursWithoutPicking() < 0) && (getHoursBeforeLookingUp() < 0)
 			&& (getMaxPicksPerHour() < 0)) {
@@ -510,8 +542,7 @@ glass3::util::WorkState CSiteList::work() {
 	}
 
 	// what time is it
-	time_t tNow;
-	std::time(&tNow);
+	time_t tNow = glass3::util::Clock::now();
 
 	// check every hour
 	// NOTE: hardcoded to one hour, any more often seemed excessive
@@ -693,6 +724,11 @@ glass3::util::WorkState CSiteList::work() {
 	return (glass3::util::WorkState::OK);
 }
 
+// ------------------------------------------------------checkDue
+void CSiteList::checkDue() {
+	m_bCheckDue = true;
+}
+
 // ----------------------------------------------------setMaxHoursWithoutPicking
 void CSiteList::setMaxHoursWithoutPicking(int hoursWithoutPicking) {
 	m_iMaxHoursWithoutPicking = hoursWithoutPicking;
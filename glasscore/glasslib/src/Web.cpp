@@ -1,7 +1,9 @@
 #include "Web.h"
 #include <json.h>
 #include <logger.h>
+#include <metricsregistry.h>
 #include <geo.h>
+#include <chrono>
 #include <cmath>
 #include <algorithm>
 #include <string>
@@ -32,6 +34,7 @@ const int CWeb::k_iNodeLatitudeIndex;
 const int CWeb::k_iNodeLongitudeIndex;
 const int CWeb::k_iNodeDepthIndex;
 constexpr double CWeb::k_dMinimumMaxNodeDepth;
+constexpr double CWeb::k_dCoarseThresholdFactorDefault;
 
 // site sorting function
 // Compares nodal distance for nearest site assignment
@@ -50,6 +53,7 @@ bool sortSite(const std::pair<double, std::shared_ptr<CSite>> &lhs,
 CWeb::CWeb(int numThreads, int sleepTime, int checkInterval)
 		: glass3::util::ThreadBaseClass("Web", sleepTime, numThreads,
 										checkInterval) {
+	m_WebMutex.setName("CWeb::m_WebMutex");
 	clear();
 
 	// start up the threads
@@ -65,6 +69,7 @@ CWeb::CWeb(std::string name, double thresh, int numDetect, int numNucleate,
 			double aSeismicThresh, int numASeismicNucleate)
 		: glass3::util::ThreadBaseClass("Web", sleepTime, numThreads,
 										checkInterval) {
+	m_WebMutex.setName("CWeb::m_WebMutex");
 	clear();
 
 	initialize(name, thresh, numDetect, numNucleate, resolution, update,
@@ -81,7 +86,8 @@ CWeb::~CWeb() {
 
 // ---------------------------------------------------------clear
 void CWeb::clear() {
-	std::lock_guard<std::recursive_mutex> webGuard(m_WebMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> webGuard(
+			m_WebMutex);
 	m_iNumStationsPerNode = 10;
 	m_iNucleationDataCountThreshold = 5;
 	m_dNucleationStackThreshold = 2.5;
@@ -96,6 +102,12 @@ void CWeb::clear() {
 	m_bAllowControllingWebs = false;
 	m_dAzimuthTaper = k_dAzimuthTaperDefault;
 	m_dMaxDepth = CGlass::k_dMaximumDepth;
+	m_dCoarseResolution = 0;
+	m_dCoarseThresholdFactor = k_dCoarseThresholdFactorDefault;
+	m_iCoarseNodeCount = 0;
+	m_iNucleationCount = 0;
+	m_iNucleationEarlyExitCount = 0;
+	m_iNucleationSkipCount = 0;
 
 	// clear out all the nodes in the web
 	try {
@@ -155,7 +167,8 @@ bool CWeb::initialize(std::string name, double thresh, int numDetect,
 						std::shared_ptr<traveltime::CTravelTime> secondTrav,
 						double aziTap, double maxDep, double aSeismicThresh,
 						int numASeismicNucleate) {
-	std::lock_guard<std::recursive_mutex> webGuard(m_WebMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> webGuard(
+			m_WebMutex);
 
 	m_sName = name;
 	m_dNucleationStackThreshold = thresh;
@@ -272,20 +285,45 @@ bool CWeb::generateGlobalGrid(std::shared_ptr<json::Object> gridConfiguration) {
 		return (false);
 	}
 
-	// calculate the number of nodes from the desired resolution
-	// using a function that was EMPIRICALLY determined via using different
-	// numNode values and computing the average resolution from a node to
-	// the nearest other 6 nodes. The spreadsheet used to calculate this function
-	// is located in ** NodesToResoultionCalculations.xlsx **
-	// The intention is to calculate the number of nodes to ensure the desired
-	// node resolution when the grid is generated below
-	int numNodes = 5.3E8 * std::pow(getNodeResolution(), -1.965);
+	// optional coarse level resolution, making this a hierarchical web
+	if (((*gridConfiguration).HasKey("CoarseResolution"))
+			&& ((*gridConfiguration)["CoarseResolution"].GetType()
+					== json::ValueType::DoubleVal)) {
+		double coarseResolution = (*gridConfiguration)["CoarseResolution"]
+				.ToDouble();
 
-	// should have an odd number of nodes (see paper named below)
-	if ((numNodes % 2) == 0) {
-		numNodes += 1;
+		if (coarseResolution > getNodeResolution()) {
+			m_dCoarseResolution = coarseResolution;
+
+			glass3::util::Logger::log(
+					"info",
+					"CWeb::generateGlobalGrid: Using CoarseResolution: "
+							+ std::to_string(m_dCoarseResolution));
+		} else {
+			glass3::util::Logger::log(
+					"warning",
+					"CWeb::generateGlobalGrid: CoarseResolution must be "
+					"larger than NodeResolution, not using a coarse level.");
+		}
 	}
 
+	// the coarse threshold factor
+	if (((*gridConfiguration).HasKey("CoarseThresholdFactor"))
+			&& ((*gridConfiguration)["CoarseThresholdFactor"].GetType()
+					== json::ValueType::DoubleVal)) {
+		m_dCoarseThresholdFactor = (*gridConfiguration)["CoarseThresholdFactor"]
+				.ToDouble();
+
+		glass3::util::Logger::log(
+				"info",
+				"CWeb::generateGlobalGrid: Using CoarseThresholdFactor: "
+						+ std::to_string(m_dCoarseThresholdFactor));
+	}
+
+	std::vector<std::pair<double, double>> vVertices = generateGlobalVertices(
+			getNodeResolution());
+	int numNodes = vVertices.size();
+
 	snprintf(sLog, sizeof(sLog),
 				"CWeb::generateGlobalGrid: Calculated numNodes:%d;", numNodes);
 	glass3::util::Logger::log(sLog);
@@ -310,24 +348,12 @@ bool CWeb::generateGlobalGrid(std::shared_ptr<json::Object> gridConfiguration) {
 	m_dWidth = 360.0;
 
 	// Generate equally spaced grid of nodes over the globe (more or less)
-	// Follows Paper (Gonzalez, 2010) Measurement of Areas on a Sphere Using
-	// Fibonacci and Latitude Longitude Lattices
-	// std::vector<std::pair<double, double>> vVert;
 	int iNodeCount = 0;
-	int numSamples = (numNodes - 1) / 2;
-
-	for (int i = (-1 * numSamples); i <= numSamples; i++) {
-		double aLat = std::asin((2 * i) / ((2.0 * numSamples) + 1))
-				* (180.0 / glass3::util::GlassMath::k_Pi);
-		double aLon = fmod(i, k_dFibonacciRatio) * (360.0 / k_dFibonacciRatio);
+	std::vector<std::shared_ptr<CNode>> vFineNodes;
 
-		// longitude bounds check
-		if (aLon < glass3::util::Geo::k_MinimumLongitude) {
-			aLon += glass3::util::Geo::k_LongitudeWrap;
-		}
-		if (aLon > glass3::util::Geo::k_MaximumLongitude) {
-			aLon -= glass3::util::Geo::k_LongitudeWrap;
-		}
+	for (const auto &vertex : vVertices) {
+		double aLat = vertex.first;
+		double aLon = vertex.second;
 
 		// lock the site list while adding a node
 		std::lock_guard<std::mutex> guard(m_vSiteMutex);
@@ -367,6 +393,11 @@ bool CWeb::generateGlobalGrid(std::shared_ptr<json::Object> gridConfiguration) {
 			if (addNode(node) == true) {
 				iNodeCount++;
 
+				// keep track of the fine nodes to put under the coarse ones
+				if (m_dCoarseResolution > 0) {
+					vFineNodes.push_back(node);
+				}
+
 				// write node to generateLocalGrid file
 				if (getSaveGrid()) {
 					double obs = 1.0;
@@ -393,6 +424,55 @@ bool CWeb::generateGlobalGrid(std::shared_ptr<json::Object> gridConfiguration) {
 		outstafile.close();
 	}
 
+	// generate the coarse level of a hierarchical web, with the same depth
+	// layers, and put each fine node under the closest coarse node
+	if (m_dCoarseResolution > 0) {
+		std::vector<std::shared_ptr<CNode>> vCoarseNodes;
+		std::vector<std::pair<double, double>> vCoarseVertices =
+				generateGlobalVertices(m_dCoarseResolution);
+
+		for (const auto &vertex : vCoarseVertices) {
+			double aLat = vertex.first;
+			double aLon = vertex.second;
+
+			// lock the site list while adding a node
+			std::lock_guard<std::mutex> guard(m_vSiteMutex);
+
+			double dMaxNodeDepth = m_dMaxDepth;
+			if (m_pZoneStats != NULL) {
+				double aDepth = m_pZoneStats->getMaxDepthForLatLon(aLat, aLon);
+				if (aDepth != m_pZoneStats->depthInvalid) {
+					dMaxNodeDepth = aDepth;
+				}
+			}
+
+			for (auto z : depthLayerArray) {
+				if (z > std::max(dMaxNodeDepth, k_dMinimumMaxNodeDepth)) {
+					break;
+				}
+
+				sortSiteListForNode(aLat, aLon, z);
+
+				std::shared_ptr<CNode> node = generateNode(aLat, aLon, z,
+															m_dCoarseResolution,
+															true);
+				if (addNode(node) == true) {
+					vCoarseNodes.push_back(node);
+				}
+			}
+		}
+
+		m_iCoarseNodeCount = vCoarseNodes.size();
+		assignCoarseParents(vFineNodes, vCoarseNodes);
+
+		snprintf(sLog, sizeof(sLog),
+					"CWeb::generateGlobalGrid sName:%s; coarse resol:%.2f;"
+					" iCoarseNodeCount:%d;",
+					m_sName.c_str(), static_cast<double>(m_dCoarseResolution),
+					static_cast<int>(m_iCoarseNodeCount));
+		glass3::util::Logger::log("info", sLog);
+	}
+
 	std::string phases = "";
 	if (m_pNucleationTravelTime1 != NULL) {
 		phases += m_pNucleationTravelTime1->m_sPhase;
@@ -422,6 +502,97 @@ bool CWeb::generateGlobalGrid(std::shared_ptr<json::Object> gridConfiguration) {
 	return (true);
 }
 
+// ---------------------------------------------------------generateGlobalVertices
+std::vector<std::pair<double, double>> CWeb::generateGlobalVertices(
+		double resolution) {
+	std::vector<std::pair<double, double>> vertices;
+
+	// calculate the number of nodes from the desired resolution
+	// using a function that was EMPIRICALLY determined via using different
+	// numNode values and computing the average resolution from a node to
+	// the nearest other 6 nodes. The spreadsheet used to calculate this function
+	// is located in ** NodesToResoultionCalculations.xlsx **
+	// The intention is to calculate the number of nodes to ensure the desired
+	// node resolution when the grid is generated below
+	int numNodes = 5.3E8 * std::pow(resolution, -1.965);
+
+	// should have an odd number of nodes (see paper named below)
+	if ((numNodes % 2) == 0) {
+		numNodes += 1;
+	}
+
+	// Generate equally spaced grid of vertices over the globe (more or less)
+	// Follows Paper (Gonzalez, 2010) Measurement of Areas on a Sphere Using
+	// Fibonacci and Latitude Longitude Lattices
+	int numSamples = (numNodes - 1) / 2;
+
+	for (int i = (-1 * numSamples); i <= numSamples; i++) {
+		double aLat = std::asin((2 * i) / ((2.0 * numSamples) + 1))
+				* (180.0 / glass3::util::GlassMath::k_Pi);
+		double aLon = fmod(i, k_dFibonacciRatio) * (360.0 / k_dFibonacciRatio);
+
+		// longitude bounds check
+		if (aLon < glass3::util::Geo::k_MinimumLongitude) {
+			aLon += glass3::util::Geo::k_LongitudeWrap;
+		}
+		if (aLon > glass3::util::Geo::k_MaximumLongitude) {
+			aLon -= glass3::util::Geo::k_LongitudeWrap;
+		}
+
+		vertices.push_back(std::make_pair(aLat, aLon));
+	}
+
+	return (vertices);
+}
+
+// ---------------------------------------------------------assignCoarseParents
+void CWeb::assignCoarseParents(
+		const std::vector<std::shared_ptr<CNode>> &fineNodes,
+		const std::vector<std::shared_ptr<CNode>> &coarseNodes) {
+	// bin the coarse nodes by depth and latitude band, a band being about
+	// the coarse resolution wide, so the closest coarse node to a fine node
+	// is in the same or an adjacent band
+	double bandDegrees = m_dCoarseResolution / glass3::util::Geo::k_DegreesToKm;
+	std::map<double, std::map<int, std::vector<std::shared_ptr<CNode>>>> mBands;
+	for (const auto &coarseNode : coarseNodes) {
+		int band = static_cast<int>(std::floor(
+				coarseNode->getLatitude() / bandDegrees));
+		mBands[coarseNode->getDepth()][band].push_back(coarseNode);
+	}
+
+	for (const auto &fineNode : fineNodes) {
+		auto depthBands = mBands.find(fineNode->getDepth());
+		if (depthBands == mBands.end()) {
+			// no coarse nodes at this depth, the fine node is always nucleated
+			continue;
+		}
+
+		glass3::util::Geo geoFine = fineNode->getGeo();
+		int band = static_cast<int>(std::floor(
+				fineNode->getLatitude() / bandDegrees));
+
+		std::shared_ptr<CNode> closest;
+		double closestDistance = std::numeric_limits<double>::max();
+		for (int i = band - 1; i <= band + 1; i++) {
+			auto coarseBand = depthBands->second.find(i);
+			if (coarseBand == depthBands->second.end()) {
+				continue;
+			}
+
+			for (const auto &coarseNode : coarseBand->second) {
+				glass3::util::Geo geoCoarse = coarseNode->getGeo();
+				double distance = geoFine.delta(&geoCoarse);
+				if (distance < closestDistance) {
+					closestDistance = distance;
+					closest = coarseNode;
+				}
+			}
+		}
+
+		fineNode->setParentNode(closest);
+	}
+}
+
 // ---------------------------------------------------------generateLocalGrid
 bool CWeb::generateLocalGrid(std::shared_ptr<json::Object> gridConfiguration) {
 	glass3::util::Logger::log("debug", "CWeb::generateLocalGrid");
@@ -1272,7 +1443,8 @@ bool CWeb::loadFilters(std::shared_ptr<json::Object> gridConfiguration) {
 		return (false);
 	}
 
-	std::lock_guard<std::recursive_mutex> webGuard(m_WebMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> webGuard(
+			m_WebMutex);
 
 	// Get the network names to be included in this web.
 	if ((*gridConfiguration).HasKey("IncludeNetworks")
@@ -1627,7 +1799,7 @@ bool CWeb::removeSiteFromSiteList(std::shared_ptr<CSite> site) {
 
 // ---------------------------------------------------------generateNode
 std::shared_ptr<CNode> CWeb::generateNode(double lat, double lon, double z,
-											double resol) {
+											double resol, bool coarse) {
 	// nullcheck
 	if ((m_pNucleationTravelTime1 == NULL)
 			&& (m_pNucleationTravelTime2 == NULL)) {
@@ -1655,12 +1827,18 @@ std::shared_ptr<CNode> CWeb::generateNode(double lat, double lon, double z,
 	// returns true if no zonestats
 	bool aSeismic = getZoneStatsAseismic(lat, lon);
 
-	// create node
-	std::shared_ptr<CNode> node(new CNode(m_sName, lat, lon, z, resol, maxZ,
+	// create node, coarse nodes get their own name so that their ids don't
+	// collide with fine nodes at the same location
+	std::string nodeName = m_sName;
+	if (coarse == true) {
+		nodeName += ".Coarse";
+	}
+	std::shared_ptr<CNode> node(new CNode(nodeName, lat, lon, z, resol, maxZ,
 			aSeismic));
 
 	// set parent web
 	node->setWeb(this);
+	node->setCoarse(coarse);
 
 	// return empty node if we don't
 	// have any sites
@@ -2002,6 +2180,13 @@ void CWeb::addSite(std::shared_ptr<CSite> site) {
 			std::chrono::duration_cast<std::chrono::duration<double>>(
 					tEndTime - tStartTime).count();
 
+	static glass3::util::LatencyHistogram &addSiteHistogram =
+			glass3::util::MetricsRegistry::getInstance().getHistogram(
+					"web.add_site_us");
+	addSiteHistogram.record(
+			std::chrono::duration_cast<std::chrono::microseconds>(
+					tEndTime - tStartTime).count());
+
 	// log info if we've added a site
 	if (nodeModCount > 0) {
 		char sLog[glass3::util::Logger::k_nMaxLogEntrySize];
@@ -2218,6 +2403,13 @@ void CWeb::removeSite(std::shared_ptr<CSite> site) {
 			std::chrono::duration_cast<std::chrono::duration<double>>(
 					tEndTime - tStartTime).count();
 
+	static glass3::util::LatencyHistogram &removeSiteHistogram =
+			glass3::util::MetricsRegistry::getInstance().getHistogram(
+					"web.remove_site_us");
+	removeSiteHistogram.record(
+			std::chrono::duration_cast<std::chrono::microseconds>(
+					tEndTime - tStartTime).count());
+
 	// log info if we've removed a site
 	if (nodeModCount > 0) {
 		char sLog[glass3::util::Logger::k_nMaxLogEntrySize];
@@ -2325,13 +2517,15 @@ double CWeb::getMaxDepth() const {
 
 // ---------------------------------------------------------getSiteList
 const CSiteList* CWeb::getSiteList() const {
-	std::lock_guard<std::recursive_mutex> webGuard(m_WebMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> webGuard(
+			m_WebMutex);
 	return (m_pSiteList);
 }
 
 // ---------------------------------------------------------setSiteList
 void CWeb::setSiteList(CSiteList* siteList) {
-	std::lock_guard<std::recursive_mutex> webGuard(m_WebMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> webGuard(
+			m_WebMutex);
 	m_pSiteList = siteList;
 }
 
@@ -2377,31 +2571,36 @@ const std::string& CWeb::getName() const {
 
 // -----------------------------------------------------getNucleationTravelTime1
 const std::shared_ptr<traveltime::CTravelTime>& CWeb::getNucleationTravelTime1() const {  // NOLINT
-	std::lock_guard<std::recursive_mutex> webGuard(m_WebMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> webGuard(
+			m_WebMutex);
 	return (m_pNucleationTravelTime1);
 }
 
 // -----------------------------------------------------getNucleationTravelTime2
 const std::shared_ptr<traveltime::CTravelTime>& CWeb::getNucleationTravelTime2() const {  // NOLINT
-	std::lock_guard<std::recursive_mutex> webGuard(m_WebMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> webGuard(
+			m_WebMutex);
 	return (m_pNucleationTravelTime2);
 }
 
 // -----------------------------------------------------getNetworksFilterSize
 int CWeb::getNetworksFilterSize() const {
-	std::lock_guard<std::recursive_mutex> webGuard(m_WebMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> webGuard(
+			m_WebMutex);
 	return (m_vNetworksFilter.size());
 }
 
 // ------------------------------------------------getUseOnlyTeleseismicStations
 bool CWeb::getUseOnlyTeleseismicStations() const {
-	std::lock_guard<std::recursive_mutex> webGuard(m_WebMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> webGuard(
+			m_WebMutex);
 	return (m_bUseOnlyTeleseismicStations);
 }
 
 // -----------------------------------------------------getSitesFilterSize
 int CWeb::getSitesFilterSize() const {
-	std::lock_guard<std::recursive_mutex> webGuard(m_WebMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> webGuard(
+			m_WebMutex);
 	return (m_vSitesFilter.size());
 }
 
@@ -2413,7 +2612,8 @@ int CWeb::size() const {
 
 // ----------------------------------------------getZoneStatsAseismic
 bool CWeb::getZoneStatsAseismic(double dLat, double dLon) {
-	std::lock_guard<std::recursive_mutex> webGuard(m_WebMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> webGuard(
+			m_WebMutex);
 
 	if (m_pZoneStats == NULL) {
 		return(false);
@@ -2431,7 +2631,8 @@ bool CWeb::getZoneStatsAseismic(double dLat, double dLon) {
 
 // ----------------------------------------------getZoneStatDepth
 double CWeb::getZoneStatsMaxDepth(double dLat, double dLon) {
-	std::lock_guard<std::recursive_mutex> webGuard(m_WebMutex);
+	std::lock_guard<glass3::util::InstrumentedRecursiveMutex> webGuard(
+			m_WebMutex);
 
 	if (m_pZoneStats == NULL) {
 		return(m_dMaxDepth);
@@ -2453,6 +2654,50 @@ int CWeb::getASeismicNucleationDataCountThreshold() const {
 	return (m_iASeismicNucleationDataCountThreshold);
 }
 
+// --------------------------------getCoarseResolution
+double CWeb::getCoarseResolution() const {
+	return (m_dCoarseResolution);
+}
+
+// --------------------------------getCoarseThresholdFactor
+double CWeb::getCoarseThresholdFactor() const {
+	return (m_dCoarseThresholdFactor);
+}
+
+// --------------------------------getCoarseNodeCount
+int CWeb::getCoarseNodeCount() const {
+	return (m_iCoarseNodeCount);
+}
+
+// --------------------------------countNucleation
+void CWeb::countNucleation(bool exitedEarly) {
+	m_iNucleationCount++;
+	if (exitedEarly == true) {
+		m_iNucleationEarlyExitCount++;
+	}
+}
+
+// --------------------------------getNucleationCount
+int64_t CWeb::getNucleationCount() const {
+	return (m_iNucleationCount);
+}
+
+// --------------------------------getNucleationEarlyExitCount
+int64_t CWeb::getNucleationEarlyExitCount() const {
+	return (m_iNucleationEarlyExitCount);
+}
+
+// --------------------------------countNucleationSkip
+void CWeb::countNucleationSkip() {
+	m_iNucleationCount++;
+	m_iNucleationSkipCount++;
+}
+
+// --------------------------------getNucleationSkipCount
+int64_t CWeb::getNucleationSkipCount() const {
+	return (m_iNucleationSkipCount);
+}
+
 // --------------------------------isWithin
 double CWeb::isWithin(double dLat, double dLon) {
 	if (m_dHeight == 0.0) {
@@ -76,6 +76,12 @@
 #define LOCALIZE_RES_TIME 3648515731.985167
 #define LOCALIZE_RES_BAYES 31.389001001003624
 
+#define REFINE_ITERATIONS 10
+#define REFINE_OFFSET_LATITUDE 0.1
+#define REFINE_OFFSET_TIME 1.0
+
+#define LOCATOR_SEED 42
+
 #define PRUNESIZE 0
 #define RESOLVESIZE 36
 
@@ -606,6 +612,287 @@ TEST(HypoTest, Localize) {
 	ASSERT_NEAR(bayes, expectedBayes, 1.0);
 }
 
+// test to see if the site cache matches direct calculations
+TEST(HypoTest, SiteCache) {
+	glass3::util::Logger::disable();
+
+	// load files
+	// stationlist
+	std::ifstream stationFile;
+	stationFile.open(
+			"./" + std::string(TESTPATH) + "/" + std::string(STATIONFILENAME),
+			std::ios::in);
+	std::string stationLine = "";
+	std::getline(stationFile, stationLine);
+	stationFile.close();
+
+	// hypo
+	std::ifstream hypoFile;
+	hypoFile.open(
+			"./" + std::string(TESTPATH) + "/" + std::string(HYPOFILENAME),
+			std::ios::in);
+	std::string hypoLine = "";
+	std::getline(hypoFile, hypoLine);
+	hypoFile.close();
+
+	// load config file
+	std::ifstream initFile;
+	initFile.open(
+			"./" + std::string(TESTPATH) + "/" + std::string(INITFILENAME),
+			std::ios::in);
+	std::string initLine = "";
+	std::getline(initFile, initLine);
+	initFile.close();
+
+	std::shared_ptr<json::Object> siteList = std::make_shared<json::Object>(
+			json::Deserialize(stationLine));
+	std::shared_ptr<json::Object> hypoMessage = std::make_shared<json::Object>(
+			json::Deserialize(hypoLine));
+	std::shared_ptr<json::Object> initConfig = std::make_shared<json::Object>(
+			json::Deserialize(initLine));
+	std::shared_ptr<traveltime::CTravelTime> nullTrav;
+
+	// construct a sitelist
+	glasscore::CSiteList * testSiteList = new glasscore::CSiteList();
+	testSiteList->receiveExternalMessage(siteList);
+
+	// construct a glass
+	glasscore::CGlass * testGlass = new glasscore::CGlass();
+	testGlass->receiveExternalMessage(initConfig);
+
+	// construct a hypo
+	glasscore::CHypo * testHypo = new glasscore::CHypo(
+			hypoMessage, testGlass->getNucleationStackThreshold(),
+			testGlass->getNucleationDataCountThreshold(),
+			testGlass->getDefaultNucleationTravelTime(), nullTrav,
+			testGlass->getAssociationTravelTimes(), 100, 360.0, 800.0,
+			testSiteList);
+
+	std::vector<std::shared_ptr<glasscore::CPick>> picks =
+			testHypo->getPickData();
+	ASSERT_GT(picks.size(), 0)<< "has picks";
+
+	// an independent copy of the travel times to check against
+	traveltime::CTTT ttt(*testGlass->getAssociationTravelTimes());
+
+	// check the cached values twice, once filling the cache and once using it
+	for (int pass = 0; pass < 2; pass++) {
+		ttt.setTTOrigin(testHypo->getLatitude(), testHypo->getLongitude(),
+						testHypo->getDepth());
+		glass3::util::Geo hypoGeo;
+		hypoGeo.setGeographic(
+				testHypo->getLatitude(), testHypo->getLongitude(),
+				glass3::util::Geo::k_EarthRadiusKm - testHypo->getDepth());
+
+		for (auto pick : picks) {
+			double tObs = pick->getTPick() - testHypo->getTOrigin();
+			double expectedResidual = tObs
+					- ttt.T(&pick->getSite()->getGeo(), tObs);
+			std::string phase;
+			ASSERT_DOUBLE_EQ(expectedResidual,
+						testHypo->calculateResidual(pick, NULL, &phase))
+			<< "residual";
+			ASSERT_STREQ(ttt.m_sPhase.c_str(), phase.c_str())<< "phase";
+
+			ASSERT_DOUBLE_EQ(
+					glass3::util::GlassMath::k_RadiansToDegrees
+							* hypoGeo.delta(&pick->getSite()->getGeo()),
+					testHypo->calculateDistanceToPick(pick))<< "distance";
+
+			double delta = glass3::util::GlassMath::k_RadiansToDegrees
+					* hypoGeo.delta(&pick->getSite()->getGeo());
+			ASSERT_DOUBLE_EQ(ttt.Td(delta, "P", testHypo->getDepth()),
+						testHypo->getTravelTimeForPhase(pick, "P"))
+			<< "travel time for phase";
+		}
+
+		ASSERT_GT(testHypo->getSiteCacheSize(), 0)<< "cache filled";
+		ASSERT_LE(testHypo->getSiteCacheSize(), picks.size())<< "one per site";
+	}
+
+	// moving the hypo invalidates the cache
+	testHypo->setLatitude(testHypo->getLatitude() + 1.0);
+	double tObs = picks[0]->getTPick() - testHypo->getTOrigin();
+	ttt.setTTOrigin(testHypo->getLatitude(), testHypo->getLongitude(),
+					testHypo->getDepth());
+	ASSERT_DOUBLE_EQ(tObs - ttt.T(&picks[0]->getSite()->getGeo(), tObs),
+				testHypo->calculateResidual(picks[0]))<< "moved residual";
+	ASSERT_EQ(1, testHypo->getSiteCacheSize())<< "cache refilled";
+}
+
+// test to see if the gradient location refinement works
+TEST(HypoTest, RefineLocation) {
+	glass3::util::Logger::disable();
+
+	// load files
+	// stationlist
+	std::ifstream stationFile;
+	stationFile.open(
+			"./" + std::string(TESTPATH) + "/" + std::string(STATIONFILENAME),
+			std::ios::in);
+	std::string stationLine = "";
+	std::getline(stationFile, stationLine);
+	stationFile.close();
+
+	// hypo
+	std::ifstream hypoFile;
+	hypoFile.open(
+			"./" + std::string(TESTPATH) + "/" + std::string(HYPOFILENAME),
+			std::ios::in);
+	std::string hypoLine = "";
+	std::getline(hypoFile, hypoLine);
+	hypoFile.close();
+
+	// load config file
+	std::ifstream initFile;
+	initFile.open(
+			"./" + std::string(TESTPATH) + "/" + std::string(INITFILENAME),
+			std::ios::in);
+	std::string initLine = "";
+	std::getline(initFile, initLine);
+	initFile.close();
+
+	std::shared_ptr<json::Object> siteList = std::make_shared<json::Object>(
+			json::Deserialize(stationLine));
+	std::shared_ptr<json::Object> hypoMessage = std::make_shared<json::Object>(
+			json::Deserialize(hypoLine));
+	std::shared_ptr<json::Object> initConfig = std::make_shared<json::Object>(
+			json::Deserialize(initLine));
+	std::shared_ptr<traveltime::CTravelTime> nullTrav;
+
+	// construct a sitelist
+	glasscore::CSiteList * testSiteList = new glasscore::CSiteList();
+	testSiteList->receiveExternalMessage(siteList);
+
+	// construct a glass
+	glasscore::CGlass * testGlass = new glasscore::CGlass();
+	testGlass->receiveExternalMessage(initConfig);
+	testGlass->setMinimizeTTLocator(false);
+
+	// construct a hypo
+	glasscore::CHypo * testHypo = new glasscore::CHypo(
+			hypoMessage, testGlass->getNucleationStackThreshold(),
+			testGlass->getNucleationDataCountThreshold(),
+			testGlass->getDefaultNucleationTravelTime(), nullTrav,
+			testGlass->getAssociationTravelTimes(), 100, 360.0, 800.0,
+			testSiteList);
+
+	// relocate it with a short anneal and refinement
+	testGlass->setLocatorRefinementIterations(REFINE_ITERATIONS);
+	testHypo->localize();
+
+	ASSERT_NEAR(testHypo->getLatitude(), LOCALIZE_LATITUDE, 1.0);
+	ASSERT_NEAR(testHypo->getLongitude(), LOCALIZE_LONGITUDE, 1.0);
+	ASSERT_NEAR(testHypo->getDepth(), LOCALIZE_DEPTH, 10.0);
+	ASSERT_NEAR(testHypo->getTOrigin(), LOCALIZE_TIME, 1.0);
+	ASSERT_NEAR(testHypo->getBayesValue(), LOCALIZE_BAYES, 1.0);
+
+	double latitude = testHypo->getLatitude();
+	double longitude = testHypo->getLongitude();
+	double time = testHypo->getTOrigin();
+
+	// move the hypo off of the solution
+	testHypo->setLatitude(latitude + REFINE_OFFSET_LATITUDE);
+	testHypo->setTOrigin(time + REFINE_OFFSET_TIME);
+	double offsetBayes = testHypo->calculateCurrentBayes();
+
+	// refinement should bring it back without getting worse
+	ASSERT_GT(testHypo->refineLocation(REFINE_ITERATIONS), 0)<< "improved";
+	ASSERT_GT(testHypo->getBayesValue(), offsetBayes)<< "better bayes";
+	ASSERT_NEAR(testHypo->getLatitude(), latitude, REFINE_OFFSET_LATITUDE);
+	ASSERT_NEAR(testHypo->getLongitude(), longitude, REFINE_OFFSET_LATITUDE);
+	ASSERT_NEAR(testHypo->getTOrigin(), time, REFINE_OFFSET_TIME);
+
+	// fixed hypos are not refined
+	testHypo->setFixed(true);
+	ASSERT_EQ(testHypo->refineLocation(REFINE_ITERATIONS), 0)<< "fixed";
+
+	testGlass->setLocatorRefinementIterations(0);
+}
+
+// test to see if seeded locations are reproducible
+TEST(HypoTest, ReproducibleLocalize) {
+	glass3::util::Logger::disable();
+
+	// load files
+	// stationlist
+	std::ifstream stationFile;
+	stationFile.open(
+			"./" + std::string(TESTPATH) + "/" + std::string(STATIONFILENAME),
+			std::ios::in);
+	std::string stationLine = "";
+	std::getline(stationFile, stationLine);
+	stationFile.close();
+
+	// hypo
+	std::ifstream hypoFile;
+	hypoFile.open(
+			"./" + std::string(TESTPATH) + "/" + std::string(HYPOFILENAME),
+			std::ios::in);
+	std::string hypoLine = "";
+	std::getline(hypoFile, hypoLine);
+	hypoFile.close();
+
+	// load config file
+	std::ifstream initFile;
+	initFile.open(
+			"./" + std::string(TESTPATH) + "/" + std::string(INITFILENAME),
+			std::ios::in);
+	std::string initLine = "";
+	std::getline(initFile, initLine);
+	initFile.close();
+
+	std::shared_ptr<json::Object> siteList = std::make_shared<json::Object>(
+			json::Deserialize(stationLine));
+	std::shared_ptr<json::Object> hypoMessage = std::make_shared<json::Object>(
+			json::Deserialize(hypoLine));
+	std::shared_ptr<json::Object> initConfig = std::make_shared<json::Object>(
+			json::Deserialize(initLine));
+	std::shared_ptr<traveltime::CTravelTime> nullTrav;
+
+	// construct a sitelist
+	glasscore::CSiteList * testSiteList = new glasscore::CSiteList();
+	testSiteList->receiveExternalMessage(siteList);
+
+	// construct a glass
+	glasscore::CGlass * testGlass = new glasscore::CGlass();
+	testGlass->receiveExternalMessage(initConfig);
+	testGlass->setMinimizeTTLocator(false);
+	testGlass->setLocatorRandomSeed(LOCATOR_SEED);
+
+	// construct two identical hypos
+	glasscore::CHypo * testHypo = new glasscore::CHypo(
+			hypoMessage, testGlass->getNucleationStackThreshold(),
+			testGlass->getNucleationDataCountThreshold(),
+			testGlass->getDefaultNucleationTravelTime(), nullTrav,
+			testGlass->getAssociationTravelTimes(), 100, 360.0, 800.0,
+			testSiteList);
+	glasscore::CHypo * testHypo2 = new glasscore::CHypo(
+			hypoMessage, testGlass->getNucleationStackThreshold(),
+			testGlass->getNucleationDataCountThreshold(),
+			testGlass->getDefaultNucleationTravelTime(), nullTrav,
+			testGlass->getAssociationTravelTimes(), 100, 360.0, 800.0,
+			testSiteList);
+
+	// the same seed and starting state give the same location
+	testHypo->localize();
+	testHypo2->localize();
+
+	ASSERT_DOUBLE_EQ(testHypo->getLatitude(), testHypo2->getLatitude());
+	ASSERT_DOUBLE_EQ(testHypo->getLongitude(), testHypo2->getLongitude());
+	ASSERT_DOUBLE_EQ(testHypo->getDepth(), testHypo2->getDepth());
+	ASSERT_DOUBLE_EQ(testHypo->getTOrigin(), testHypo2->getTOrigin());
+	ASSERT_DOUBLE_EQ(testHypo->getBayesValue(), testHypo2->getBayesValue());
+
+	// and are still good locations
+	ASSERT_NEAR(testHypo->getLatitude(), LOCALIZE_LATITUDE, 1.0);
+	ASSERT_NEAR(testHypo->getLongitude(), LOCALIZE_LONGITUDE, 1.0);
+	ASSERT_NEAR(testHypo->getDepth(), LOCALIZE_DEPTH, 10.0);
+	ASSERT_NEAR(testHypo->getTOrigin(), LOCALIZE_TIME, 1.0);
+
+	testGlass->setLocatorRandomSeed(-1);
+}
+
 // test to see if the localize operation works
 TEST(HypoTest, Prune) {
 	// glass3::util::log_init("localizetest", "debug", ".", true);
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <memory>
 #include <string>
+#include <map>
 #include <sstream>
 #include <iostream>
 #include <fstream>
@@ -49,6 +50,8 @@ TEST(HypoListTest, Construction) {
 	// lists
 	ASSERT_EQ(0, testHypoList->length())<< "vHypo.size() is 0";
 	ASSERT_EQ(0, testHypoList->getHypoProcessingQueueLength())<< "qFifo.size() is 0";
+	ASSERT_EQ(0, static_cast<int>(testHypoList->getProcessingStageTimes().size()))
+	<< "no stage times";
 }
 
 // test various hypo operations
@@ -142,6 +145,76 @@ TEST(HypoListTest, HypoOperations) {
 			(int)testHypoList->getCountOfTotalHyposProcessed())<< "Cleared Hypos";
 }
 
+// test getting hypos by time and distance
+TEST(HypoListTest, SpaceTimeQuery) {
+	glass3::util::Logger::disable();
+
+	// create hypo objects
+	std::shared_ptr<traveltime::CTravelTime> nullTrav;
+	std::shared_ptr<traveltime::CTTT> nullTTT;
+	std::shared_ptr<glasscore::CHypo> hypo1 =
+			std::make_shared<glasscore::CHypo>(-21.84, 170.03, 10.0,
+												3648585210.926340, "1", "Test",
+												0.0, 0.5, 6, nullTrav, nullTrav,
+												nullTTT);
+	std::shared_ptr<glasscore::CHypo> hypo2 =
+			std::make_shared<glasscore::CHypo>(22.84, 70.03, 12.0,
+												3648585208.926340, "2", "Test",
+												0.0, 0.5, 6, nullTrav, nullTrav,
+												nullTTT);
+	std::shared_ptr<glasscore::CHypo> hypo3 =
+			std::make_shared<glasscore::CHypo>(1.84, -170.03, 67.0,
+												3648585233.926340, "3", "Test",
+												0.0, 0.5, 6, nullTrav, nullTrav,
+												nullTTT);
+	std::shared_ptr<glasscore::CHypo> hypo4 =
+			std::make_shared<glasscore::CHypo>(-20.84, 171.03, 10.0,
+												3648585290.926340, "4", "Test",
+												0.0, 0.5, 6, nullTrav, nullTrav,
+												nullTTT);
+
+	// construct a hypolist
+	glasscore::CHypoList * testHypoList = new glasscore::CHypoList();
+	glasscore::CGlass::setMaxNumHypos(-1);
+
+	testHypoList->addHypo(hypo1, false);
+	testHypoList->addHypo(hypo2, false);
+	testHypoList->addHypo(hypo3, false);
+	testHypoList->addHypo(hypo4, false);
+
+	// only hypo1 is near in space and time
+	std::vector<std::weak_ptr<glasscore::CHypo>> testHypos = testHypoList
+			->getHypos(TSTART - 20.0, TEND, -21.0, 170.0, 10.0);
+	ASSERT_EQ(1, (int)testHypos.size())<< "one hypo near in space and time";
+	ASSERT_STREQ("1", testHypos[0].lock()->getID().c_str())<< "found hypo1";
+
+	// search across the dateline
+	testHypos = testHypoList->getHypos(TSTART - 20.0, TEND, -21.84, -179.0,
+										15.0);
+	ASSERT_EQ(1, (int)testHypos.size())<< "one hypo across dateline";
+	ASSERT_STREQ("1", testHypos[0].lock()->getID().c_str())<< "found hypo1";
+
+	// a larger distance finds hypo3 as well, in time order
+	testHypos = testHypoList->getHypos(TSTART - 20.0, TEND, -21.84, -179.0,
+										40.0);
+	ASSERT_EQ(2, (int)testHypos.size())<< "two hypos in larger distance";
+	ASSERT_STREQ("1", testHypos[0].lock()->getID().c_str())<< "hypo1 first";
+	ASSERT_STREQ("3", testHypos[1].lock()->getID().c_str())<< "hypo3 second";
+
+	// no distance restriction matches the time only query
+	testHypos = testHypoList->getHypos(TSTART - 20.0, TEND, 0.0, 0.0, -1.0);
+	ASSERT_EQ(3, (int)testHypos.size())<< "all hypos in time range";
+
+	// removed hypos are no longer found
+	testHypoList->removeHypo(hypo1, false);
+	testHypos = testHypoList->getHypos(TSTART - 20.0, TEND, -21.0, 170.0,
+										10.0);
+	ASSERT_EQ(0, (int)testHypos.size())<< "removed hypo not found";
+
+	testHypoList->clear();
+	delete(testHypoList);
+}
+
 // test process
 TEST(HypoListTest, ProcessTest) {
 	//glass3::util::log_init("processtest", "debug", ".", true);
@@ -259,6 +332,16 @@ TEST(HypoListTest, ProcessTest) {
 	// check
 	expectedSize = 2;
 	ASSERT_EQ(expectedSize, testHypoList->length())<< "processed Hypos";
+
+	// check stage times
+	std::map<std::string, double> stageTimes =
+			testHypoList->getProcessingStageTimes();
+	ASSERT_TRUE(stageTimes.find("localize") != stageTimes.end())
+	<< "localize time recorded";
+	ASSERT_TRUE(stageTimes.find("evolve") != stageTimes.end())
+	<< "evolve time recorded";
+	ASSERT_GE(stageTimes["evolve"], stageTimes["localize"])
+	<< "evolve time includes localize time";
 }
 
 // test process
@@ -1,11 +1,16 @@
 #include <gtest/gtest.h>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <logger.h>
 
 #include "Node.h"
 #include "Site.h"
+#include "Pick.h"
+#include "Web.h"
+#include "Trigger.h"
+#include "Glass.h"
 
 // test data
 #define NAME "testNode"
@@ -22,6 +27,14 @@
 #define PHASE "P"
 #define DISTANCE_FOR_TT 8.5
 
+#define STACKSITEJSON "{\"Type\":\"StationInfo\",\"Elevation\":2326.000000,\"Latitude\":45.822170,\"Longitude\":-112.451000,\"Site\":{\"Station\":\"LRM%d\",\"Channel\":\"EHZ\",\"Network\":\"MB\",\"Location\":\"\"},\"Enable\":true,\"Quality\":1.0,\"UseForTeleseismic\":true}"  // NOLINT
+#define STACKWEBNAME "stackWeb"
+#define STACKTHRESH 2.0
+#define STACKNUMDETECT 3
+#define STACKNUMNUCLEATE 3
+#define STACKORIGINTIME 3648585210.0
+#define STACKNUMSITES 5
+
 // NOTE: Need to consider testing nucleate, but that would need a much more
 // involved set of real data, and possibly a glass refactor to better support
 // unit testing
@@ -155,3 +168,419 @@ TEST(NodeTest, FailTests) {
 	// nucleate
 	ASSERT_TRUE(testNode->nucleate(-1, NULL) == NULL);
 }
+
+// tests to see if nucleating from the incremental pick stack matches
+// nucleating by scanning the linked sites
+TEST(NodeTest, IncrementalNucleation) {
+	glass3::util::Logger::disable();
+	glasscore::CGlass::setIncrementalNucleation(true);
+
+	// construct a web and a node in it
+	std::shared_ptr<traveltime::CTravelTime> nullTrav;
+	glasscore::CWeb testWeb(std::string(STACKWEBNAME), STACKTHRESH,
+							STACKNUMDETECT, STACKNUMNUCLEATE, RESOLUTION, false,
+							false, false, nullTrav, nullTrav);
+	std::shared_ptr<glasscore::CNode> testNode(
+			new glasscore::CNode(std::string(NAME), LATITUDE, LONGITUDE, DEPTH,
+									RESOLUTION, MAXDEPTH, ASEISMIC));
+	testNode->setWeb(&testWeb);
+
+	// link sites to the node, and make picks at them
+	std::vector<std::shared_ptr<glasscore::CSite>> sites;
+	std::vector<std::shared_ptr<glasscore::CPick>> picks;
+	for (int i = 0; i < STACKNUMSITES; i++) {
+		char siteString[256];
+		snprintf(siteString, sizeof(siteString), STACKSITEJSON, i);
+		std::shared_ptr<glasscore::CSite> site(
+				new glasscore::CSite(
+						std::make_shared<json::Object>(
+								json::Deserialize(std::string(siteString)))));
+		sites.push_back(site);
+
+		double travelTime = 20.0 * (i + 1);
+		double distDeg = 1.5 * (i + 1);
+		ASSERT_TRUE(testNode->linkSite(site, testNode, distDeg, travelTime,
+			PHASE, travelTime * 1.8, "S"));  // NOLINT
+
+		// a pick close to the predicted P, and an unrelated one
+		std::shared_ptr<glasscore::CPick> pick(
+				new glasscore::CPick(site, STACKORIGINTIME + travelTime + 0.5 * i,
+										std::to_string(i), -1, -1));
+		std::shared_ptr<glasscore::CPick> noisePick(
+				new glasscore::CPick(site, STACKORIGINTIME + 600.0 + 7.0 * i,
+										"noise" + std::to_string(i), -1, -1));
+		site->addPick(pick);
+		site->addPick(noisePick);
+		picks.push_back(pick);
+	}
+
+	// every pick is stacked
+	ASSERT_EQ(2 * STACKNUMSITES, testNode->getPickStackCount())<< "stacked";
+
+	// compare the incremental and scanning engines over a range of origin
+	// times
+	for (double offset = -30.0; offset <= 700.0; offset += 0.75) {
+		glasscore::CGlass::setIncrementalNucleation(true);
+		std::shared_ptr<glasscore::CTrigger> stackTrigger = testNode->nucleate(
+				STACKORIGINTIME + offset, NULL);
+		glasscore::CGlass::setIncrementalNucleation(false);
+		std::shared_ptr<glasscore::CTrigger> scanTrigger = testNode->nucleate(
+				STACKORIGINTIME + offset, NULL);
+
+		ASSERT_EQ(stackTrigger == NULL, scanTrigger == NULL)<< "same trigger "
+		<< offset;
+		if (stackTrigger != NULL) {
+			ASSERT_NEAR(stackTrigger->getBayesValue(),
+						scanTrigger->getBayesValue(), 1e-9)<< "same sum "
+			<< offset;
+			ASSERT_EQ(stackTrigger->getPickCount(), scanTrigger->getPickCount())
+			<< "same count " << offset;
+		}
+	}
+
+	// the node nucleates at the origin time
+	glasscore::CGlass::setIncrementalNucleation(true);
+	ASSERT_TRUE(testNode->nucleate(STACKORIGINTIME, NULL) != NULL)
+	<< "nucleated";
+
+	// removing picks removes them from the stack
+	for (int i = 0; i < STACKNUMSITES; i++) {
+		sites[i]->removePick(picks[i]);
+	}
+	ASSERT_EQ(STACKNUMSITES, testNode->getPickStackCount())<< "removed";
+	ASSERT_TRUE(testNode->nucleate(STACKORIGINTIME, NULL) == NULL)
+	<< "no longer nucleated";
+
+	// unlinking a site removes its picks from the stack
+	ASSERT_TRUE(testNode->unlinkSite(sites[0]));
+	ASSERT_EQ(STACKNUMSITES - 1, testNode->getPickStackCount())<< "unlinked";
+
+	// linking a site stacks its existing picks
+	ASSERT_TRUE(testNode->linkSite(sites[0], testNode, 1.5, 20.0, PHASE));
+	ASSERT_EQ(STACKNUMSITES, testNode->getPickStackCount())<< "relinked";
+
+	// clearing the links clears the stack
+	testNode->clearSiteLinks();
+	ASSERT_EQ(0, testNode->getPickStackCount())<< "cleared";
+
+	glasscore::CGlass::setIncrementalNucleation(false);
+}
+
+// tests that both engines pick the earlier of two equally significant picks
+TEST(NodeTest, NucleationTies) {
+	glass3::util::Logger::disable();
+
+	// construct a web and a node in it
+	std::shared_ptr<traveltime::CTravelTime> nullTrav;
+	glasscore::CWeb testWeb(std::string(STACKWEBNAME), STACKTHRESH,
+							STACKNUMDETECT, STACKNUMNUCLEATE, RESOLUTION, false,
+							false, false, nullTrav, nullTrav);
+	std::shared_ptr<glasscore::CNode> testNode(
+			new glasscore::CNode(std::string(NAME), LATITUDE, LONGITUDE, DEPTH,
+									RESOLUTION, MAXDEPTH, ASEISMIC));
+	testNode->setWeb(&testWeb);
+
+	// link sites to the node, and make two picks at each of them, both
+	// within the residual allowance of the predicted P, the later one first
+	glasscore::CGlass::setIncrementalNucleation(true);
+	std::vector<std::shared_ptr<glasscore::CPick>> earlyPicks;
+	for (int i = 0; i < STACKNUMSITES; i++) {
+		char siteString[256];
+		snprintf(siteString, sizeof(siteString), STACKSITEJSON, i);
+		std::shared_ptr<glasscore::CSite> site(
+				new glasscore::CSite(
+						std::make_shared<json::Object>(
+								json::Deserialize(std::string(siteString)))));
+
+		double travelTime = 20.0 * (i + 1);
+		double distDeg = 1.5 * (i + 1);
+		ASSERT_TRUE(testNode->linkSite(site, testNode, distDeg, travelTime,
+										PHASE));
+
+		std::shared_ptr<glasscore::CPick> latePick(
+				new glasscore::CPick(site, STACKORIGINTIME + travelTime + 1.0,
+										"late" + std::to_string(i), -1, -1));
+		std::shared_ptr<glasscore::CPick> earlyPick(
+				new glasscore::CPick(site, STACKORIGINTIME + travelTime + 0.5,
+										"early" + std::to_string(i), -1, -1));
+		site->addPick(latePick);
+		site->addPick(earlyPick);
+		earlyPicks.push_back(earlyPick);
+	}
+
+	for (bool incremental : { true, false }) {
+		glasscore::CGlass::setIncrementalNucleation(incremental);
+		std::shared_ptr<glasscore::CTrigger> trigger = testNode->nucleate(
+				STACKORIGINTIME, NULL);
+		ASSERT_TRUE(trigger != NULL)<< "nucleated " << incremental;
+
+		std::vector<std::shared_ptr<glasscore::CPick>> triggerPicks = trigger
+				->getVPick();
+		ASSERT_EQ(STACKNUMSITES, triggerPicks.size())<< "count "
+		<< incremental;
+		for (int i = 0; i < STACKNUMSITES; i++) {
+			ASSERT_EQ(earlyPicks[i], triggerPicks[i])<< "early pick " << i
+			<< " " << incremental;
+		}
+	}
+
+	glasscore::CGlass::setIncrementalNucleation(false);
+}
+
+// tests that nucleation stops early when the thresholds can't be reached
+TEST(NodeTest, BoundedNucleation) {
+	glass3::util::Logger::disable();
+	glasscore::CGlass::setIncrementalNucleation(false);
+
+	// construct a web and a node in it
+	std::shared_ptr<traveltime::CTravelTime> nullTrav;
+	glasscore::CWeb testWeb(std::string(STACKWEBNAME), STACKTHRESH,
+							STACKNUMDETECT, STACKNUMNUCLEATE, RESOLUTION, false,
+							false, false, nullTrav, nullTrav);
+	std::shared_ptr<glasscore::CNode> testNode(
+			new glasscore::CNode(std::string(NAME), LATITUDE, LONGITUDE, DEPTH,
+									RESOLUTION, MAXDEPTH, ASEISMIC));
+	testNode->setWeb(&testWeb);
+
+	// link sites to the node, with only a P travel time
+	std::vector<std::shared_ptr<glasscore::CSite>> sites;
+	for (int i = 0; i < STACKNUMSITES; i++) {
+		char siteString[256];
+		snprintf(siteString, sizeof(siteString), STACKSITEJSON, i);
+		std::shared_ptr<glasscore::CSite> site(
+				new glasscore::CSite(
+						std::make_shared<json::Object>(
+								json::Deserialize(std::string(siteString)))));
+		sites.push_back(site);
+
+		ASSERT_TRUE(testNode->linkSite(site, testNode, 1.5 * (i + 1),
+			20.0 * (i + 1), PHASE));  // NOLINT
+	}
+
+	ASSERT_EQ(0, testWeb.getNucleationCount())<< "no nucleations";
+	ASSERT_EQ(0, testWeb.getNucleationEarlyExitCount())<< "no early exits";
+	ASSERT_EQ(0, testWeb.getNucleationSkipCount())<< "no skips";
+
+	// no picks, nothing to stack, so the node is skipped
+	ASSERT_TRUE(testNode->nucleate(STACKORIGINTIME, NULL) == NULL)
+	<< "no picks";
+	ASSERT_EQ(1, testWeb.getNucleationCount())<< "one nucleation";
+	ASSERT_EQ(0, testWeb.getNucleationEarlyExitCount())<< "no early exit";
+	ASSERT_EQ(1, testWeb.getNucleationSkipCount())<< "one skip";
+
+	// picks at fewer sites than the count threshold
+	for (int i = 0; i < STACKNUMNUCLEATE - 1; i++) {
+		std::shared_ptr<glasscore::CPick> pick(
+				new glasscore::CPick(sites[i],
+										STACKORIGINTIME + 20.0 * (i + 1) + 0.5,
+										std::to_string(i), -1, -1));
+		sites[i]->addPick(pick);
+	}
+	ASSERT_TRUE(testNode->nucleate(STACKORIGINTIME, NULL) == NULL)
+	<< "too few picks";
+	ASSERT_EQ(2, testWeb.getNucleationCount())<< "two nucleations";
+	ASSERT_EQ(0, testWeb.getNucleationEarlyExitCount())<< "still no early exit";
+	ASSERT_EQ(2, testWeb.getNucleationSkipCount())<< "two skips";
+
+	// picks at every site
+	for (int i = STACKNUMNUCLEATE - 1; i < STACKNUMSITES; i++) {
+		std::shared_ptr<glasscore::CPick> pick(
+				new glasscore::CPick(sites[i],
+										STACKORIGINTIME + 20.0 * (i + 1) + 0.5,
+										std::to_string(i), -1, -1));
+		sites[i]->addPick(pick);
+	}
+	ASSERT_TRUE(testNode->nucleate(STACKORIGINTIME, NULL) != NULL)
+	<< "nucleated";
+	ASSERT_EQ(3, testWeb.getNucleationCount())<< "three nucleations";
+	ASSERT_EQ(0, testWeb.getNucleationEarlyExitCount())<< "no early exits yet";
+	ASSERT_EQ(2, testWeb.getNucleationSkipCount())<< "still two skips";
+
+	// far from the picks, the node gives up early
+	ASSERT_TRUE(testNode->nucleate(STACKORIGINTIME + 300.0, NULL) == NULL)
+	<< "not nucleated";
+	ASSERT_EQ(1, testWeb.getNucleationEarlyExitCount())<< "one early exit";
+	ASSERT_EQ(2, testWeb.getNucleationSkipCount())<< "skips unchanged";
+}
+
+// tests that the node keeps track of which linked sites have picks
+TEST(NodeTest, ActiveSites) {
+	glass3::util::Logger::disable();
+
+	// construct a web and a node in it
+	std::shared_ptr<traveltime::CTravelTime> nullTrav;
+	glasscore::CWeb testWeb(std::string(STACKWEBNAME), STACKTHRESH,
+							STACKNUMDETECT, STACKNUMNUCLEATE, RESOLUTION, false,
+							false, false, nullTrav, nullTrav);
+	std::shared_ptr<glasscore::CNode> testNode(
+			new glasscore::CNode(std::string(NAME), LATITUDE, LONGITUDE, DEPTH,
+									RESOLUTION, MAXDEPTH, ASEISMIC));
+	testNode->setWeb(&testWeb);
+
+	// link sites to the node, the first with both a P and S travel time
+	std::vector<std::shared_ptr<glasscore::CSite>> sites;
+	for (int i = 0; i < STACKNUMSITES; i++) {
+		char siteString[256];
+		snprintf(siteString, sizeof(siteString), STACKSITEJSON, i);
+		std::shared_ptr<glasscore::CSite> site(
+				new glasscore::CSite(
+						std::make_shared<json::Object>(
+								json::Deserialize(std::string(siteString)))));
+		sites.push_back(site);
+
+		if (i == 0) {
+			ASSERT_TRUE(testNode->linkSite(site, testNode, 1.5, 20.0, PHASE,
+				36.0, "S"));  // NOLINT
+		} else {
+			ASSERT_TRUE(testNode->linkSite(site, testNode, 1.5 * (i + 1),
+				20.0 * (i + 1), PHASE));  // NOLINT
+		}
+	}
+
+	ASSERT_EQ(0, testNode->getActiveSiteCount())<< "no active sites";
+	ASSERT_EQ(0, testNode->getActivePickLimit())<< "no active picks";
+
+	// picks at the first two sites
+	std::shared_ptr<glasscore::CPick> pick1(
+			new glasscore::CPick(sites[0], STACKORIGINTIME + 20.5, "1", -1, -1));
+	std::shared_ptr<glasscore::CPick> pick2(
+			new glasscore::CPick(sites[0], STACKORIGINTIME + 36.5, "2", -1, -1));
+	std::shared_ptr<glasscore::CPick> pick3(
+			new glasscore::CPick(sites[1], STACKORIGINTIME + 40.5, "3", -1, -1));
+	sites[0]->addPick(pick1);
+	sites[0]->addPick(pick2);
+	sites[1]->addPick(pick3);
+
+	ASSERT_EQ(2, testNode->getActiveSiteCount())<< "two active sites";
+	ASSERT_EQ(3, testNode->getActivePickLimit())<< "three active picks";
+
+	// the first site adds both a P and an S pick, enough to nucleate
+	ASSERT_TRUE(testNode->nucleate(STACKORIGINTIME, NULL) != NULL)
+	<< "nucleated";
+	ASSERT_EQ(0, testWeb.getNucleationEarlyExitCount())<< "no early exits";
+	ASSERT_EQ(0, testWeb.getNucleationSkipCount())<< "no skips";
+
+	// a site stays active until its last pick is removed
+	sites[0]->removePick(pick1);
+	ASSERT_EQ(2, testNode->getActiveSiteCount())<< "still two active sites";
+	sites[0]->removePick(pick2);
+	ASSERT_EQ(1, testNode->getActiveSiteCount())<< "one active site";
+	ASSERT_EQ(1, testNode->getActivePickLimit())<< "one active pick";
+
+	// too few active sites to nucleate, so the node is skipped
+	ASSERT_TRUE(testNode->nucleate(STACKORIGINTIME, NULL) == NULL)
+	<< "skipped";
+	ASSERT_EQ(1, testWeb.getNucleationSkipCount())<< "one skip";
+	ASSERT_EQ(0, testWeb.getNucleationEarlyExitCount())<< "not an early exit";
+
+	// unlinking and relinking an active site
+	ASSERT_TRUE(testNode->unlinkSite(sites[1]));
+	ASSERT_EQ(0, testNode->getActiveSiteCount())<< "unlinked";
+	ASSERT_TRUE(testNode->linkSite(sites[1], testNode, 3.0, 40.0, PHASE));
+	ASSERT_EQ(1, testNode->getActiveSiteCount())<< "relinked";
+
+	// clearing the links
+	testNode->clearSiteLinks();
+	ASSERT_EQ(0, testNode->getActiveSiteCount())<< "cleared";
+	ASSERT_EQ(0, testNode->getActivePickLimit())<< "cleared picks";
+}
+
+// tests that fine nodes are only nucleated when their coarse node comes
+// close, and that coarse nodes don't stack picks
+TEST(NodeTest, CoarseNodes) {
+	glass3::util::Logger::disable();
+
+	// construct a web, with a fine node and two coarse nodes
+	std::shared_ptr<traveltime::CTravelTime> nullTrav;
+	glasscore::CWeb testWeb(std::string(STACKWEBNAME), STACKTHRESH,
+							STACKNUMDETECT, STACKNUMNUCLEATE, RESOLUTION, false,
+							false, false, nullTrav, nullTrav);
+	std::shared_ptr<glasscore::CNode> fineNode(
+			new glasscore::CNode(std::string(NAME), LATITUDE, LONGITUDE, DEPTH,
+									RESOLUTION, MAXDEPTH, ASEISMIC));
+	fineNode->setWeb(&testWeb);
+	std::shared_ptr<glasscore::CNode> coarseNode(
+			new glasscore::CNode(std::string(NAME) + ".Coarse", LATITUDE,
+									LONGITUDE, DEPTH, 4 * RESOLUTION, MAXDEPTH,
+									ASEISMIC));
+	coarseNode->setWeb(&testWeb);
+	coarseNode->setCoarse(true);
+	std::shared_ptr<glasscore::CNode> farCoarseNode(
+			new glasscore::CNode(std::string(NAME) + ".Coarse", LATITUDE + 10.0,
+									LONGITUDE, DEPTH, 4 * RESOLUTION, MAXDEPTH,
+									ASEISMIC));
+	farCoarseNode->setWeb(&testWeb);
+	farCoarseNode->setCoarse(true);
+
+	ASSERT_FALSE(fineNode->getCoarse())<< "fine";
+	ASSERT_TRUE(coarseNode->getCoarse())<< "coarse";
+	ASSERT_TRUE(fineNode->getParentNode() == NULL)<< "no parent";
+
+	// link sites to the nodes, the far coarse node with travel times that
+	// don't fit the picks, and make picks at them
+	glasscore::CGlass::setIncrementalNucleation(true);
+	std::vector<std::shared_ptr<glasscore::CSite>> sites;
+	for (int i = 0; i < STACKNUMSITES; i++) {
+		char siteString[256];
+		snprintf(siteString, sizeof(siteString), STACKSITEJSON, i);
+		std::shared_ptr<glasscore::CSite> site(
+				new glasscore::CSite(
+						std::make_shared<json::Object>(
+								json::Deserialize(std::string(siteString)))));
+		sites.push_back(site);
+
+		double travelTime = 20.0 * (i + 1);
+		double distDeg = 1.5 * (i + 1);
+		ASSERT_TRUE(fineNode->linkSite(site, fineNode, distDeg, travelTime,
+			PHASE));  // NOLINT
+		ASSERT_TRUE(coarseNode->linkSite(site, coarseNode, distDeg, travelTime,
+			PHASE));  // NOLINT
+		ASSERT_TRUE(farCoarseNode->linkSite(site, farCoarseNode, distDeg,
+			travelTime + 100.0 * i, PHASE));  // NOLINT
+
+		std::shared_ptr<glasscore::CPick> pick(
+				new glasscore::CPick(site, STACKORIGINTIME + travelTime + 0.5 * i,
+										std::to_string(i), -1, -1));
+		site->addPick(pick);
+	}
+
+	// only the fine node stacks the picks
+	ASSERT_EQ(STACKNUMSITES, fineNode->getPickStackCount())<< "fine stack";
+	ASSERT_EQ(0, coarseNode->getPickStackCount())<< "no coarse stack";
+
+	// under the close coarse node, the fine node triggers
+	fineNode->setParentNode(coarseNode);
+	ASSERT_TRUE(fineNode->getParentNode() == coarseNode)<< "parent";
+	std::vector<std::shared_ptr<glasscore::CTrigger>> triggers =
+			sites[0]->nucleate(STACKORIGINTIME + 20.0, NULL);
+	ASSERT_EQ(1, triggers.size())<< "triggered under close coarse node";
+	ASSERT_DOUBLE_EQ(LATITUDE, triggers[0]->getLatitude())<< "fine trigger";
+	ASSERT_DOUBLE_EQ(RESOLUTION, triggers[0]->getWebResolution())
+	<< "fine trigger resolution";
+
+	// under the far coarse node, the fine node is skipped
+	fineNode->setParentNode(farCoarseNode);
+	triggers = sites[0]->nucleate(STACKORIGINTIME + 20.0, NULL);
+	ASSERT_EQ(0, triggers.size())<< "skipped under far coarse node";
+
+	// a coarse node not linked to the site still gates the fine node
+	farCoarseNode->unlinkSite(sites[0]);
+	triggers = sites[0]->nucleate(STACKORIGINTIME + 20.0, NULL);
+	ASSERT_EQ(0, triggers.size())<< "skipped under unlinked far coarse node";
+
+	// a fine node triggers when its coarse node only reaches the scaled
+	// thresholds, here seeing fewer picks than the count threshold, and
+	// isn't linked to the site
+	fineNode->setParentNode(coarseNode);
+	ASSERT_TRUE(coarseNode->unlinkSite(sites[0]));
+	ASSERT_TRUE(coarseNode->unlinkSite(sites[3]));
+	ASSERT_TRUE(coarseNode->unlinkSite(sites[4]));
+	ASSERT_GT(STACKNUMNUCLEATE, coarseNode->getSiteLinksCount())
+	<< "coarse node sees too few picks to trigger";
+	triggers = sites[0]->nucleate(STACKORIGINTIME + 20.0, NULL);
+	ASSERT_EQ(1, triggers.size())<< "fine only trigger";
+	ASSERT_DOUBLE_EQ(RESOLUTION, triggers[0]->getWebResolution())
+	<< "fine only trigger resolution";
+
+	glasscore::CGlass::setIncrementalNucleation(false);
+}
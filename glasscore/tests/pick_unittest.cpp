@@ -9,6 +9,7 @@
 #include "Site.h"
 #include "Hypo.h"
 #include "Pick.h"
+#include "Trigger.h"
 
 #define SITEJSON "{\"Type\":\"StationInfo\",\"Elevation\":2326.000000,\"Latitude\":45.822170,\"Longitude\":-112.451000,\"Site\":{\"Station\":\"LRM\",\"Channel\":\"EHZ\",\"Network\":\"MB\",\"Location\":\"\"},\"Enable\":true,\"Quality\":1.0,\"UseForTeleseismic\":true}"  // NOLINT
 #define PICKJSON "{\"ID\":\"20682837\",\"Phase\":\"P\",\"Polarity\":\"up\",\"Site\":{\"Channel\":\"EHZ\",\"Location\":\"\",\"Network\":\"MB\",\"Station\":\"LRM\"},\"Source\":{\"AgencyID\":\"228041013\",\"Author\":\"228041013\"},\"Time\":\"2014-12-23T00:01:43.599Z\",\"Type\":\"Pick\",\"Beam\":{\"BackAzimuth\":2.65,\"Slowness\":1.44},\"ClassificationInfo\":{\"Phase\":\"P\",\"PhaseProbability\":0.22,\"Distance\":0.442559,\"DistanceProbability\":22.5,\"Azimuth\":0.418479,\"AzimuthProbability\":0.16,\"Magnitude\":2.14,\"MagnitudeType\":\"Mb\",\"MagnitudeProbability\":0.55,\"Depth\":32.44,\"DepthProbability\":11.2,\"EventType\":{\"Type\":\"Earthquake\",\"Certainty\":\"Suspected\"},\"EventTypeProbability\":1.1,\"Source\":{\"AgencyID\":\"US\",\"Author\":\"TestAuthor\"}}}"  // NOLINT
@@ -299,3 +300,48 @@ TEST(PickTest, FailTests) {
 	glasscore::CPick aBadPick4(badPick4, NULL);
 	ASSERT_STREQ("", aBadPick4.getID().c_str());
 }
+
+// tests clustering nearby triggers
+TEST(PickTest, ClusterTriggers) {
+	glass3::util::Logger::disable();
+
+	std::vector<std::shared_ptr<glasscore::CPick>> picks;
+	std::vector<std::shared_ptr<glasscore::CTrigger>> triggers;
+
+	// a strong trigger, a weaker one 20km and 2s away, a distant one,
+	// and one nearby but a minute later
+	std::shared_ptr<glasscore::CTrigger> best = std::make_shared<
+			glasscore::CTrigger>(45.0, -112.0, 10.0, PICKTIME, 100.0, 800.0,
+									5.0, 5, false, picks, nullptr);
+	std::shared_ptr<glasscore::CTrigger> near = std::make_shared<
+			glasscore::CTrigger>(45.18, -112.0, 10.0, PICKTIME + 2.0, 100.0,
+									800.0, 3.0, 5, false, picks, nullptr);
+	std::shared_ptr<glasscore::CTrigger> far = std::make_shared<
+			glasscore::CTrigger>(35.0, -112.0, 10.0, PICKTIME, 100.0, 800.0,
+									4.0, 5, false, picks, nullptr);
+	std::shared_ptr<glasscore::CTrigger> later = std::make_shared<
+			glasscore::CTrigger>(45.0, -112.0, 10.0, PICKTIME + 60.0, 100.0,
+									800.0, 2.0, 5, false, picks, nullptr);
+	triggers.push_back(later);
+	triggers.push_back(near);
+	triggers.push_back(far);
+	triggers.push_back(best);
+
+	std::vector<std::vector<std::shared_ptr<glasscore::CTrigger>>> clusters =
+			glasscore::CPick::clusterTriggers(triggers);
+
+	// best first, with the nearby trigger in its cluster
+	ASSERT_EQ(3, clusters.size())<< "cluster count";
+	ASSERT_EQ(2, clusters[0].size())<< "first cluster size";
+	ASSERT_TRUE(clusters[0][0] == best)<< "first cluster best";
+	ASSERT_TRUE(clusters[0][1] == near)<< "first cluster near";
+	ASSERT_EQ(1, clusters[1].size())<< "second cluster size";
+	ASSERT_TRUE(clusters[1][0] == far)<< "second cluster";
+	ASSERT_EQ(1, clusters[2].size())<< "third cluster size";
+	ASSERT_TRUE(clusters[2][0] == later)<< "third cluster";
+
+	// nothing to cluster
+	std::vector<std::shared_ptr<glasscore::CTrigger>> noTriggers;
+	ASSERT_EQ(0, glasscore::CPick::clusterTriggers(noTriggers).size())
+	<< "no clusters";
+}
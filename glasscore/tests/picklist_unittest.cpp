@@ -3,6 +3,8 @@
 #include <string>
 
 #include <logger.h>
+#include <clock.h>
+#include <date.h>
 
 #include "Pick.h"
 #include "PickList.h"
@@ -46,6 +48,8 @@ TEST(PickListTest, Construction) {
 
 	// lists
 	ASSERT_EQ(0, testPickList->length())<< "getVPickSize() is 0";
+	ASSERT_EQ(0, testPickList->getPickProcessingQueueLength())<< "queue is 0";
+	ASSERT_EQ(0, testPickList->getTotalNucleationTime())<< "nucleation time 0";
 
 	// pointers
 	ASSERT_EQ(NULL, testPickList->getSiteList())<< "pSiteList null";
@@ -121,3 +125,37 @@ TEST(PickListTest, PickOperations) {
 	expectedSize = 0;
 	ASSERT_EQ(expectedSize, testPickList->getCountOfTotalPicksProcessed())<< "Cleared Picks";
 }
+
+// tests that processing a pick advances the simulated clock
+TEST(PickListTest, SimulatedTime) {
+	glass3::util::Logger::disable();
+
+	std::shared_ptr<json::Object> siteJSON = std::make_shared<json::Object>(
+			json::Object(json::Deserialize(std::string(SITEJSON))));
+	std::shared_ptr<json::Object> pickJSON = std::make_shared<json::Object>(
+			json::Object(json::Deserialize(std::string(PICKJSON))));
+
+	glasscore::CSiteList * testSiteList = new glasscore::CSiteList();
+	testSiteList->addSiteFromJSON(siteJSON);
+
+	glasscore::CPickList * testPickList = new glasscore::CPickList();
+	testPickList->setSiteList(testSiteList);
+
+	// start the clock before the pick
+	double pickTime = glass3::util::Date::convertISO8601ToEpochTime(
+			(*pickJSON)["Time"].ToString());
+	glass3::util::Clock::setSimulatedTime(pickTime - 60.0);
+
+	testPickList->addPick(pickJSON);
+
+	// give time for work
+	std::this_thread::sleep_for(std::chrono::seconds(1));
+
+	ASSERT_EQ(1, testPickList->getCountOfTotalPicksProcessed())<< "processed";
+	ASSERT_DOUBLE_EQ(pickTime, glass3::util::Clock::getEpochTime())
+	<< "clock advanced to the pick";
+
+	glass3::util::Clock::useRealTime();
+	delete (testPickList);
+	delete (testSiteList);
+}
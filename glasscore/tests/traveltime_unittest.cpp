@@ -26,6 +26,7 @@
 #define GEOTIME 529.217199
 #define TIME2 169.71368
 #define BILINEAR 529.217200
+#define DERIVATIVESTEP 1.0
 
 // tests to see if the traveltime can be constructed
 TEST(TravelTimeTest, Construction) {
@@ -204,3 +205,109 @@ TEST(TravelTimeTest, Operations) {
 	// bilinear
 	// ASSERT_NEAR(BILINEAR, traveltime.bilinear(DISTANCE,DEPTH), 0.001)<< "bilinear Check"; // NOLINT
 }
+
+// tests the traveltime derivatives
+TEST(TravelTimeTest, Derivatives) {
+	glass3::util::Logger::disable();
+
+	std::string phasefile = "./" + std::string(TESTPATH) + "/"
+			+ std::string(PHASEFILENAME);
+	std::string phasename = std::string(PHASE);
+
+	// construct a traveltime
+	traveltime::CTravelTime traveltime;
+
+	// no derivatives before setup
+	double dTdDelta = 0;
+	double dTdDepth = 0;
+	ASSERT_FALSE(traveltime.calculateDerivatives(DISTANCE, &dTdDelta,
+													&dTdDepth))
+	<< "no derivatives";
+
+	// setup
+	traveltime.setup(phasename, phasefile);
+	ASSERT_TRUE(NULL != traveltime.m_pDTDDistanceArray)<< "distance array";
+	ASSERT_TRUE(NULL != traveltime.m_pDTDDepthArray)<< "depth array";
+
+	// set origin
+	traveltime.setTTOrigin(LATITUDE, LONGITUDE, DEPTH);
+
+	ASSERT_TRUE(traveltime.calculateDerivatives(DISTANCE, &dTdDelta,
+												&dTdDepth))
+	<< "derivatives";
+
+	// compare against finite differences of the travel times
+	double expectedDTDDelta = (traveltime.T(DISTANCE + DERIVATIVESTEP)
+			- traveltime.T(DISTANCE - DERIVATIVESTEP)) / (2.0 * DERIVATIVESTEP);
+	ASSERT_NEAR(expectedDTDDelta, dTdDelta, 0.1)<< "dTdDelta Check";
+
+	traveltime.setTTOrigin(LATITUDE, LONGITUDE, DEPTH + DERIVATIVESTEP);
+	double after = traveltime.T(DISTANCE);
+	traveltime.setTTOrigin(LATITUDE, LONGITUDE, DEPTH - DERIVATIVESTEP);
+	double before = traveltime.T(DISTANCE);
+	double expectedDTDDepth = (after - before) / (2.0 * DERIVATIVESTEP);
+	ASSERT_NEAR(expectedDTDDepth, dTdDepth, 0.01)<< "dTdDepth Check";
+
+	// travel time increases with distance and decreases with depth
+	ASSERT_GT(dTdDelta, 0)<< "dTdDelta positive";
+	ASSERT_LT(dTdDepth, 0)<< "dTdDepth negative";
+
+	// copies keep the derivatives
+	traveltime::CTravelTime traveltime2(traveltime);
+	traveltime2.setTTOrigin(LATITUDE, LONGITUDE, DEPTH);
+	double dTdDelta2 = 0;
+	double dTdDepth2 = 0;
+	ASSERT_TRUE(traveltime2.calculateDerivatives(DISTANCE, &dTdDelta2,
+													&dTdDepth2))
+	<< "copied derivatives";
+	ASSERT_DOUBLE_EQ(dTdDelta, dTdDelta2)<< "copied dTdDelta";
+	ASSERT_DOUBLE_EQ(dTdDepth, dTdDepth2)<< "copied dTdDepth";
+
+	// out of range
+	ASSERT_FALSE(traveltime.calculateDerivatives(MAXDIST + 1.0, &dTdDelta,
+													&dTdDepth))
+	<< "out of range";
+}
+
+// tests the traveltime ranges
+TEST(TravelTimeTest, TimeRange) {
+	glass3::util::Logger::disable();
+
+	std::string phasefile = "./" + std::string(TESTPATH) + "/"
+			+ std::string(PHASEFILENAME);
+	std::string phasename = std::string(PHASE);
+
+	// construct a traveltime
+	traveltime::CTravelTime traveltime;
+
+	// setup
+	traveltime.setup(phasename, phasefile);
+
+	// set origin
+	traveltime.setTTOrigin(LATITUDE, LONGITUDE, DEPTH);
+
+	// every valid travel time lies within its range
+	for (double distance = MINDIST; distance < MAXDIST; distance += 0.9) {
+		double minTime = 0;
+		double maxTime = 0;
+		double travelTime = traveltime.T(distance);
+		if (traveltime.getTravelTimeRange(distance, &minTime, &maxTime)
+				== false) {
+			ASSERT_LT(travelTime, 0)<< "no range at " << distance;
+			continue;
+		}
+
+		ASSERT_LE(minTime, maxTime)<< "ordered range at " << distance;
+		if (travelTime >= 0) {
+			ASSERT_GE(travelTime, minTime)<< "above minimum at " << distance;
+			ASSERT_LE(travelTime, maxTime)<< "below maximum at " << distance;
+		}
+	}
+
+	// out of range
+	double minTime = 0;
+	double maxTime = 0;
+	ASSERT_FALSE(traveltime.getTravelTimeRange(MAXDIST + 1.0, &minTime,
+												&maxTime))
+	<< "out of range";
+}
@@ -266,3 +266,55 @@ TEST(TTTTest, TFailTests) {
 	delete[] (assocRange);
 }
 
+
+// tests that the indexed best phase search matches checking every phase
+TEST(TTTTest, BestPhaseIndex) {
+	glass3::util::Logger::disable();
+
+	std::string phase1file = "./" + std::string(TESTPATH) + "/"
+			+ std::string(PHASE1FILENAME);
+	std::string phase1name = std::string(PHASE1);
+
+	std::string phase2file = "./" + std::string(TESTPATH) + "/"
+			+ std::string(PHASE2FILENAME);
+	std::string phase2name = std::string(PHASE2);
+
+	// construct a traveltime
+	traveltime::CTTT ttt;
+
+	double * assocRange = new double[2];
+	assocRange[0] = 10;
+	assocRange[1] = 90;
+
+	// add phases
+	ttt.addPhase(phase1name, NULL, phase1file, true, true);
+	ttt.addPhase(phase2name, assocRange, phase2file, true, true);
+
+	double travelTimes[traveltime::CTTT::k_iMaximumNumberOfTravelTimes];
+	for (double depth = 0; depth <= BADDEPTH; depth += 175.0) {
+		ttt.setTTOrigin(LATITUDE, LONGITUDE, depth);
+
+		for (double distance = 0; distance < 180.0; distance += 3.7) {
+			glass3::util::Geo testGeo;
+			testGeo.setGeographic(LATITUDE, LONGITUDE + distance, DEPTH);
+
+			for (double tObs = -10.0; tObs < 1500.0; tObs += 23.0) {
+				// every phase
+				double delta = ttt.calculateTravelTimes(&testGeo,
+														travelTimes);
+				double expected = ttt.selectBestTravelTime(travelTimes, delta,
+															tObs);
+				std::string expectedPhase = ttt.m_sPhase;
+
+				// indexed
+				ASSERT_DOUBLE_EQ(expected, ttt.T(&testGeo, tObs))
+				<< "T(geo, tobs) at " << distance << " " << depth << " "
+				<< tObs;
+				ASSERT_STREQ(expectedPhase.c_str(), ttt.m_sPhase.c_str())
+				<< "phase at " << distance << " " << depth << " " << tObs;
+			}
+		}
+	}
+
+	delete[] (assocRange);
+}
@@ -54,6 +54,8 @@
 #define GLOBALNUMZ 2
 #define GLOBALNUMNODES 21350
 #define GLOBALNUMNETEXLUDE 13
+#define GLOBALCOARSERESOLUTION 750.0
+#define GLOBALCOARSEFACTOR 0.8
 
 #define GRIDNAME "TestGrid"
 #define GRIDTHRESH 0.5
@@ -326,6 +328,61 @@ TEST(WebTest, GlobalTest) {
 	// delete (testSiteList);
 }
 
+// test creating a hierarchical global grid
+TEST(WebTest, GlobalCoarseTest) {
+	glass3::util::Logger::disable();
+
+	// load files
+	// stationlist
+	std::ifstream stationFile;
+	stationFile.open(
+			"./" + std::string(TESTPATH) + "/" + std::string(STATIONFILENAME),
+			std::ios::in);
+	std::string stationLine = "";
+	std::getline(stationFile, stationLine);
+	stationFile.close();
+
+	// global config
+	std::ifstream globalFile;
+	globalFile.open(
+			"./" + std::string(TESTPATH) + "/" + std::string(GLOBALFILENAME),
+			std::ios::in);
+	std::string globalLine = "";
+	std::getline(globalFile, globalLine);
+	globalFile.close();
+
+	std::shared_ptr<json::Object> siteList = std::make_shared<json::Object>(
+			json::Deserialize(stationLine));
+	std::shared_ptr<json::Object> globalConfig = std::make_shared<json::Object>(
+			json::Deserialize(globalLine));
+
+	// add a coarse level
+	(*globalConfig)["CoarseResolution"] = GLOBALCOARSERESOLUTION;
+	(*globalConfig)["CoarseThresholdFactor"] = GLOBALCOARSEFACTOR;
+	(*globalConfig)["SaveGrid"] = false;
+
+	// construct a sitelist
+	glasscore::CSiteList * testSiteList = new glasscore::CSiteList();
+	testSiteList->receiveExternalMessage(siteList);
+
+	// construct a web
+	glasscore::CWeb testGlobalWeb(NUMTHREADS);
+	testGlobalWeb.setSiteList(testSiteList);
+	testGlobalWeb.receiveExternalMessage(globalConfig);
+
+	ASSERT_EQ(GLOBALCOARSERESOLUTION, testGlobalWeb.getCoarseResolution())<<
+	"Web getCoarseResolution() Check";
+	ASSERT_EQ(GLOBALCOARSEFACTOR, testGlobalWeb.getCoarseThresholdFactor())<<
+	"Web getCoarseThresholdFactor() Check";
+
+	// the fine level is unchanged, with the coarse nodes on top
+	ASSERT_LT(0, testGlobalWeb.getCoarseNodeCount())<< "coarse nodes";
+	ASSERT_GT(GLOBALNUMNODES, testGlobalWeb.getCoarseNodeCount())
+	<< "fewer coarse nodes";
+	ASSERT_EQ(GLOBALNUMNODES + testGlobalWeb.getCoarseNodeCount(),
+				(int)testGlobalWeb.size())<< "node list";
+}
+
 // test creating a regional/local grid
 // NOTE: Need to check that grid boundries are as expected.
 TEST(WebTest, GridTest) {
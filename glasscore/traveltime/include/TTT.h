@@ -161,7 +161,8 @@ class CTTT {
 	 * \brief Calculate best travel time in seconds
 	 *
 	 * Calculate best travel time in seconds given geographic location and
-	 * the observed arrival time
+	 * the observed arrival time. Only phases whose travel time range at the
+	 * location could beat the best residual so far are interpolated.
 	 *
 	 * \param geo - A pointer to a glass3::util::Geo object representing the location
 	 * to calculate the travel time from
@@ -171,6 +172,80 @@ class CTTT {
 	 */
 	double T(glass3::util::Geo *geo, double tobs);
 
+	/**
+	 * \brief Calculate travel times for all phases
+	 *
+	 * Calculate the travel time in seconds for every phase given geographic
+	 * location, so that callers evaluating several picks at the same site can
+	 * select phases with selectTravelTime() or selectBestTravelTime() without
+	 * repeating the calculations.
+	 *
+	 * \param geo - A pointer to a glass3::util::Geo object representing the
+	 * location to calculate the travel times from
+	 * \param travelTimes - A pointer to an array of at least
+	 * k_iMaximumNumberOfTravelTimes doubles to hold the travel time for each
+	 * phase, or -1.0 where there is no valid travel time
+	 * \return Returns the distance in degrees to the given location
+	 */
+	double calculateTravelTimes(glass3::util::Geo *geo, double *travelTimes);
+
+	/**
+	 * \brief Select the travel time for a phase
+	 *
+	 * Select the travel time for the desired phase from travel times computed
+	 * by calculateTravelTimes(), setting m_sPhase, m_bUseForLocations, and
+	 * m_bPublishable as T(geo, phase) does.
+	 *
+	 * \param travelTimes - A pointer to the array of travel times computed by
+	 * calculateTravelTimes()
+	 * \param delta - A double containing the distance in degrees returned by
+	 * calculateTravelTimes()
+	 * \param phase - A std::string containing the phase to select
+	 * \return Returns the travel time in seconds, or -1.0 if there is
+	 * no valid travel time
+	 */
+	double selectTravelTime(const double *travelTimes, double delta,
+							std::string phase);
+
+	/**
+	 * \brief Select the best travel time
+	 *
+	 * Select the travel time with the least residual from travel times
+	 * computed by calculateTravelTimes() given the observed arrival time,
+	 * setting m_sPhase, m_bUseForLocations, and m_bPublishable as
+	 * T(geo, tobs) does.
+	 *
+	 * \param travelTimes - A pointer to the array of travel times computed by
+	 * calculateTravelTimes()
+	 * \param delta - A double containing the distance in degrees returned by
+	 * calculateTravelTimes()
+	 * \param tobs - A double value containing the observed arrival time.
+	 * \return Returns the travel time in seconds, or -1.0 if there is
+	 * no valid travel time
+	 */
+	double selectBestTravelTime(const double *travelTimes, double delta,
+								double tobs);
+
+	/**
+	 * \brief Calculate travel time derivatives, setting depth
+	 *
+	 * Calculate the derivatives of the travel time with respect to distance
+	 * and depth given distance in degrees, depth, and the desired phase
+	 *
+	 * \param delta - A double value containing the distance in degrees
+	 * to calculate the derivatives from
+	 * \param phase - A std::string containing the phase to use in calculating
+	 * the derivatives
+	 * \param depth - A double containing specific depth
+	 * \param dTdDelta - A pointer to a double to hold the derivative of the
+	 * travel time with respect to distance in seconds per degree
+	 * \param dTdDepth - A pointer to a double to hold the derivative of the
+	 * travel time with respect to depth in seconds per kilometer
+	 * \return Returns true if the derivatives are valid, false otherwise
+	 */
+	bool calculateDerivatives(double delta, std::string phase, double depth,
+								double *dTdDelta, double *dTdDepth);
+
 	/**
 	 * \brief Print Travel Times to File
 	 *
@@ -184,6 +259,12 @@ class CTTT {
 	 */
 	static constexpr double k_dTTTooLargeToBeValid = 1000.0;
 
+	/**
+	 * \brief The tolerance in seconds allowed for rounding when ruling out
+	 * phases using their travel time ranges
+	 */
+	static constexpr double k_dTimeRangeTolerance = 1.0e-6;
+
 	/**
 	 * \brief The maximum number of supported travel times
 	 */
@@ -158,6 +158,63 @@ class CTravelTime {
 	 */
 	double T(int deltaIndex, int depthIndex);
 
+	/**
+	 * \brief Calculate travel time derivatives
+	 *
+	 * Interpolate the derivatives of the travel time with respect to distance
+	 * and depth given distance in degrees, at the depth set by setTTOrigin(),
+	 * from the derivative arrays generated when the branch was loaded.
+	 *
+	 * \param delta - A double value containing the distance in degrees
+	 * to calculate the derivatives from
+	 * \param dTdDelta - A pointer to a double to hold the derivative of the
+	 * travel time with respect to distance in seconds per degree
+	 * \param dTdDepth - A pointer to a double to hold the derivative of the
+	 * travel time with respect to depth in seconds per kilometer
+	 * \return Returns true if the derivatives are valid, false if there is no
+	 * valid travel time at the given distance and depth
+	 */
+	bool calculateDerivatives(double delta, double *dTdDelta, double *dTdDepth);
+
+	/**
+	 * \brief Generate travel time derivative arrays
+	 *
+	 * Generate the arrays of travel time derivatives with respect to distance
+	 * and depth from the travel time array using central differences (one
+	 * sided differences at the edges of the array or of the valid travel
+	 * times). Called by setup() once the travel time array is loaded.
+	 */
+	void generateDerivativeArrays();
+
+	/**
+	 * \brief Get the range of possible travel times
+	 *
+	 * Get the minimum and maximum travel time that T() can return for any
+	 * distance and depth near the given distance, at the depth set by
+	 * setTTOrigin(), from the travel time range arrays generated when the
+	 * branch was loaded. Used to rule out this phase without interpolating.
+	 *
+	 * \param delta - A double value containing the distance in degrees
+	 * \param minTime - A pointer to a double to hold the minimum travel time in
+	 * seconds
+	 * \param maxTime - A pointer to a double to hold the maximum travel time in
+	 * seconds
+	 * \return Returns true if there may be a valid travel time at the given
+	 * distance and depth, false if there can not be
+	 */
+	bool getTravelTimeRange(double delta, double *minTime, double *maxTime);
+
+	/**
+	 * \brief Generate travel time range arrays
+	 *
+	 * Generate the arrays of the minimum and maximum valid travel times within
+	 * each block of k_iTimeRangeBlockSize by k_iTimeRangeBlockSize points of the
+	 * travel time array, including the points shared with the next blocks so
+	 * that the range covers every interpolation within the block. Called by
+	 * setup() once the travel time array is loaded.
+	 */
+	void generateTimeRangeArrays();
+
 	/**
 	 * \brief Compute bilinear interpolation
 	 *
@@ -276,6 +333,46 @@ class CTravelTime {
 	 */
 	double * m_pTravelTimeArray;
 
+	/**
+	 * \brief An array of double values containing the derivatives of the travel
+	 * times with respect to distance, in seconds per degree, indexed by depth
+	 * and distance
+	 */
+	double * m_pDTDDistanceArray;
+
+	/**
+	 * \brief An array of double values containing the derivatives of the travel
+	 * times with respect to depth, in seconds per kilometer, indexed by depth
+	 * and distance
+	 */
+	double * m_pDTDDepthArray;
+
+	/**
+	 * \brief An integer variable containing the number of distance blocks in
+	 * the travel time range arrays
+	 */
+	int m_iNumRangeDistances;
+
+	/**
+	 * \brief An integer variable containing the number of depth blocks in
+	 * the travel time range arrays
+	 */
+	int m_iNumRangeDepths;
+
+	/**
+	 * \brief An array of double values containing the minimum valid travel
+	 * time in each block, indexed by depth and distance block, or -1.0 if the
+	 * block has no valid travel times
+	 */
+	double * m_pMinimumTimeRangeArray;
+
+	/**
+	 * \brief An array of double values containing the maximum valid travel
+	 * time in each block, indexed by depth and distance block, or -1.0 if the
+	 * block has no valid travel times
+	 */
+	double * m_pMaximumTimeRangeArray;
+
 	/**
 	 * \brief A std::string containing the name of the phase used for this
 	 * CTravelTime
@@ -324,6 +421,12 @@ class CTravelTime {
 	 */
 	static constexpr double k_dTravelTimeInvalid = -1.0;
 
+	/**
+	 * \brief the number of travel time array points along each side of a
+	 * travel time range block
+	 */
+	static const int k_iTimeRangeBlockSize = 8;
+
 	/**
 	 * \brief the string for an invalid phase name
 	 */
@@ -10,6 +10,7 @@ namespace traveltime {
 
 // constants
 constexpr double CTTT::k_dTTTooLargeToBeValid;
+constexpr double CTTT::k_dTimeRangeTolerance;
 const int CTTT::k_iMaximumNumberOfTravelTimes;
 
 // ---------------------------------------------------------CTTT
@@ -218,6 +219,28 @@ double CTTT::T(double delta, std::string phase) {
 	return (CTravelTime::k_dTravelTimeInvalid);
 }
 
+// ---------------------------------------------------------calculateDerivatives
+bool CTTT::calculateDerivatives(double delta, std::string phase, double depth,
+								double *dTdDelta, double *dTdDepth) {
+	m_geoTTOrigin.m_dGeocentricRadius = glass3::util::Geo::k_EarthRadiusKm
+			- depth;
+
+	// for each phase
+	for (int i = 0; i < m_iNumTravelTimes; i++) {
+		// is this the phase we're looking for
+		if (m_pTravelTimes[i]->m_sPhase == phase) {
+			// set origin and depth
+			m_pTravelTimes[i]->setTTOrigin(m_geoTTOrigin);
+
+			return (m_pTravelTimes[i]->calculateDerivatives(delta, dTdDelta,
+															dTdDepth));
+		}
+	}
+
+	// no valid derivatives
+	return (false);
+}
+
 // ---------------------------------------------------------testTravelTimes
 /* double CTTT::testTravelTimes(std::string phase) {
 	// Calculate time from delta (degrees)
@@ -256,7 +279,165 @@ double CTTT::T(double delta, std::string phase) {
 // ---------------------------------------------------------T
 double CTTT::T(glass3::util::Geo *geo, double tObserved) {
 	// Find Phase with least residual, returns time
+	// compute the distance once for all phases
+	double delta = glass3::util::GlassMath::k_RadiansToDegrees
+			* m_geoTTOrigin.delta(geo);
+
+	// find the candidate phases that could have a valid travel time here,
+	// ordered by the smallest residual their travel time range allows
+	int candidates[k_iMaximumNumberOfTravelTimes];
+	double lowerBounds[k_iMaximumNumberOfTravelTimes];
+	int numCandidates = 0;
+	for (int i = 0; i < m_iNumTravelTimes; i++) {
+		CTravelTime * aTrv = m_pTravelTimes[i];
+
+		// check to see if phase is associable at this distance
+		if ((m_adMinimumAssociationValues[i] >= 0)
+				&& (delta < m_adMinimumAssociationValues[i])) {
+			continue;
+		}
+		if ((m_adMaximumAssociationValues[i] >= 0)
+				&& (delta > m_adMaximumAssociationValues[i])) {
+			continue;
+		}
+
+		// set origin
+		aTrv->setTTOrigin(m_geoTTOrigin);
+
+		// check to see if this phase exists here
+		double minTime = 0;
+		double maxTime = 0;
+		if (aTrv->getTravelTimeRange(delta, &minTime, &maxTime) == false) {
+			continue;
+		}
+
+		// smallest possible residual for this phase
+		double lowerBound = 0;
+		if (tObserved < minTime) {
+			lowerBound = minTime - tObserved;
+		} else if (tObserved > maxTime) {
+			lowerBound = tObserved - maxTime;
+		}
+		if (lowerBound >= k_dTTTooLargeToBeValid) {
+			continue;
+		}
+
+		// insertion sort, keeping phase order for equal bounds
+		int insert = numCandidates;
+		while ((insert > 0) && (lowerBounds[insert - 1] > lowerBound)) {
+			candidates[insert] = candidates[insert - 1];
+			lowerBounds[insert] = lowerBounds[insert - 1];
+			insert--;
+		}
+		candidates[insert] = i;
+		lowerBounds[insert] = lowerBound;
+		numCandidates++;
+	}
+
+	double bestTraveltime = CTravelTime::k_dTravelTimeInvalid;
+	int bestIndex = -1;
+	double bestResidual = k_dTTTooLargeToBeValid;
+
+	// evaluate candidates until none can beat the best residual
+	for (int c = 0; c < numCandidates; c++) {
+		if (lowerBounds[c] > bestResidual + k_dTimeRangeTolerance) {
+			break;
+		}
+
+		int i = candidates[c];
+		double traveltime = m_pTravelTimes[i]->T(delta);
+
+		// check traveltime
+		if (traveltime <= CTravelTime::k_dTravelTimeInvalid) {
+			continue;
+		}
+
+		// compute residual
+		double residual = std::abs(tObserved - traveltime);
+
+		// check to see if this residual is better than the previous
+		// best, the first phase wins ties as in selectBestTravelTime()
+		if ((residual < bestResidual)
+				|| ((residual == bestResidual) && (i < bestIndex))) {
+			bestResidual = residual;
+			bestTraveltime = traveltime;
+			bestIndex = i;
+		}
+	}
+
+	// check to see if minimum residual is valid
+	if (bestIndex >= 0) {
+		CTravelTime * aTrv = m_pTravelTimes[bestIndex];
+		m_sPhase = aTrv->m_sPhase;
+		m_bUseForLocations = aTrv->m_bUseForLocations;
+
+		if ((delta >= aTrv->m_dMinDeltaPublishable) &&
+			(delta <= aTrv->m_dMaxDeltaPublishable)) {
+			m_bPublishable = true;
+		} else {
+			m_bPublishable = false;
+		}
+
+		return (bestTraveltime);
+	}
+
+	// no valid travel time
+	m_sPhase = "?";
+	m_bUseForLocations = false;
+	m_bPublishable = false;
+	return (CTravelTime::k_dTravelTimeInvalid);
+}
+
+// ---------------------------------------------------------calculateTravelTimes
+double CTTT::calculateTravelTimes(glass3::util::Geo *geo,
+									double *travelTimes) {
+	// compute the distance once for all phases
+	double delta = glass3::util::GlassMath::k_RadiansToDegrees
+			* m_geoTTOrigin.delta(geo);
+
+	// for each phase
+	for (int i = 0; i < m_iNumTravelTimes; i++) {
+		// set origin
+		m_pTravelTimes[i]->setTTOrigin(m_geoTTOrigin);
+
+		// get traveltime
+		travelTimes[i] = m_pTravelTimes[i]->T(delta);
+	}
+
+	return (delta);
+}
+
+// ---------------------------------------------------------selectTravelTime
+double CTTT::selectTravelTime(const double *travelTimes, double delta,
+								std::string phase) {
+	// for each phase
+	for (int i = 0; i < m_iNumTravelTimes; i++) {
+		// is this the phase we're looking for
+		if (m_pTravelTimes[i]->m_sPhase == phase) {
+			m_sPhase = phase;
+			m_bUseForLocations = m_pTravelTimes[i]->m_bUseForLocations;
+
+			if ((delta >= m_pTravelTimes[i]->m_dMinDeltaPublishable) &&
+				(delta <= m_pTravelTimes[i]->m_dMaxDeltaPublishable)) {
+				m_bPublishable = true;
+			} else {
+				m_bPublishable = false;
+			}
 
+			return (travelTimes[i]);
+		}
+	}
+
+	// no valid travel time
+	m_sPhase = "?";
+	m_bUseForLocations = false;
+	m_bPublishable = false;
+	return (CTravelTime::k_dTravelTimeInvalid);
+}
+
+// ---------------------------------------------------------selectBestTravelTime
+double CTTT::selectBestTravelTime(const double *travelTimes, double delta,
+									double tObserved) {
 	double bestTraveltime = CTravelTime::k_dTravelTimeInvalid;
 	std::string bestPhase = "?";
 	bool useForLocations = true;
@@ -268,11 +449,8 @@ double CTTT::T(glass3::util::Geo *geo, double tObserved) {
 		// get current aTrv
 		CTravelTime * aTrv = m_pTravelTimes[i];
 
-		// set origin
-		aTrv->setTTOrigin(m_geoTTOrigin);
-
 		// get traveltime
-		double traveltime = aTrv->T(geo);
+		double traveltime = travelTimes[i];
 
 		// check traveltime
 		if (traveltime <= CTravelTime::k_dTravelTimeInvalid) {
@@ -282,7 +460,7 @@ double CTTT::T(glass3::util::Geo *geo, double tObserved) {
 		// check to see if phase is associable
 		// based on minimum assoc distance, if present
 		if (m_adMinimumAssociationValues[i] >= 0) {
-			if (aTrv->m_dDelta < m_adMinimumAssociationValues[i]) {
+			if (delta < m_adMinimumAssociationValues[i]) {
 				// this phase is not associable  at this distance
 				continue;
 			}
@@ -291,7 +469,7 @@ double CTTT::T(glass3::util::Geo *geo, double tObserved) {
 		// check to see if phase is associable
 		// based on maximum assoc distance, if present
 		if (m_adMaximumAssociationValues[i] >= 0) {
-			if (aTrv->m_dDelta > m_adMaximumAssociationValues[i]) {
+			if (delta > m_adMaximumAssociationValues[i]) {
 				// this phase is not associable  at this distance
 				continue;
 			}
@@ -309,8 +487,8 @@ double CTTT::T(glass3::util::Geo *geo, double tObserved) {
 			bestTraveltime = traveltime;
 			useForLocations = aTrv->m_bUseForLocations;
 
-			if ((aTrv->m_dDelta >= aTrv->m_dMinDeltaPublishable) &&
-				(aTrv->m_dDelta <= aTrv->m_dMaxDeltaPublishable)) {
+			if ((delta >= aTrv->m_dMinDeltaPublishable) &&
+				(delta <= aTrv->m_dMaxDeltaPublishable)) {
 				publishable = true;
 			} else {
 				publishable = false;
@@ -11,12 +11,17 @@ namespace traveltime {
 
 // constants
 constexpr double CTravelTime::k_dTravelTimeInvalid;
+const int CTravelTime::k_iTimeRangeBlockSize;
 const std::string CTravelTime::k_dPhaseInvalid = ""; // NOLINT
 
 // ---------------------------------------------------------CTravelTime
 CTravelTime::CTravelTime(bool useForLocations, double minPublishable,
 		double maxPublishable) {
 	m_pTravelTimeArray = NULL;
+	m_pDTDDistanceArray = NULL;
+	m_pDTDDepthArray = NULL;
+	m_pMinimumTimeRangeArray = NULL;
+	m_pMaximumTimeRangeArray = NULL;
 
 	clear();
 
@@ -28,6 +33,10 @@ CTravelTime::CTravelTime(bool useForLocations, double minPublishable,
 // ---------------------------------------------------------CTravelTime
 CTravelTime::CTravelTime(const CTravelTime &travelTime) {
 	m_pTravelTimeArray = NULL;
+	m_pDTDDistanceArray = NULL;
+	m_pDTDDepthArray = NULL;
+	m_pMinimumTimeRangeArray = NULL;
+	m_pMaximumTimeRangeArray = NULL;
 
 	clear();
 
@@ -55,6 +64,34 @@ CTravelTime::CTravelTime(const CTravelTime &travelTime) {
 	for (int i = 0; i < (m_iNumDistances * m_iNumDepths); i++) {
 		m_pTravelTimeArray[i] = travelTime.m_pTravelTimeArray[i];
 	}
+
+	// copy the derivative arrays if the source has them
+	if ((travelTime.m_pDTDDistanceArray != NULL)
+			&& (travelTime.m_pDTDDepthArray != NULL)) {
+		m_pDTDDistanceArray = new double[m_iNumDistances * m_iNumDepths];
+		m_pDTDDepthArray = new double[m_iNumDistances * m_iNumDepths];
+
+		for (int i = 0; i < (m_iNumDistances * m_iNumDepths); i++) {
+			m_pDTDDistanceArray[i] = travelTime.m_pDTDDistanceArray[i];
+			m_pDTDDepthArray[i] = travelTime.m_pDTDDepthArray[i];
+		}
+	}
+
+	// copy the range arrays if the source has them
+	if ((travelTime.m_pMinimumTimeRangeArray != NULL)
+			&& (travelTime.m_pMaximumTimeRangeArray != NULL)) {
+		m_iNumRangeDistances = travelTime.m_iNumRangeDistances;
+		m_iNumRangeDepths = travelTime.m_iNumRangeDepths;
+		m_pMinimumTimeRangeArray = new double[m_iNumRangeDistances
+				* m_iNumRangeDepths];
+		m_pMaximumTimeRangeArray = new double[m_iNumRangeDistances
+				* m_iNumRangeDepths];
+
+		for (int i = 0; i < (m_iNumRangeDistances * m_iNumRangeDepths); i++) {
+			m_pMinimumTimeRangeArray[i] = travelTime.m_pMinimumTimeRangeArray[i];
+			m_pMaximumTimeRangeArray[i] = travelTime.m_pMaximumTimeRangeArray[i];
+		}
+	}
 }
 
 // ---------------------------------------------------------~CTravelTime
@@ -86,6 +123,27 @@ void CTravelTime::clear() {
 		delete (m_pTravelTimeArray);
 	}
 	m_pTravelTimeArray = NULL;
+
+	if (m_pDTDDistanceArray) {
+		delete[] (m_pDTDDistanceArray);
+	}
+	m_pDTDDistanceArray = NULL;
+
+	if (m_pDTDDepthArray) {
+		delete[] (m_pDTDDepthArray);
+	}
+	m_pDTDDepthArray = NULL;
+
+	m_iNumRangeDistances = 0;
+	m_iNumRangeDepths = 0;
+	if (m_pMinimumTimeRangeArray) {
+		delete[] (m_pMinimumTimeRangeArray);
+	}
+	m_pMinimumTimeRangeArray = NULL;
+	if (m_pMaximumTimeRangeArray) {
+		delete[] (m_pMaximumTimeRangeArray);
+	}
+	m_pMaximumTimeRangeArray = NULL;
 }
 
 // -----------------------------------------------------writeToFile
@@ -269,6 +327,12 @@ bool CTravelTime::setup(std::string phase, std::string file) {
 	m_dDepthStep = (m_dMaximumDepth - m_dMinimumDepth) /
 		static_cast<double>(m_iNumDepths);
 
+	// derive the travel time derivative arrays used by the locator
+	generateDerivativeArrays();
+
+	// summarize the travel time ranges used to skip phases
+	generateTimeRangeArrays();
+
 	glass3::util::Logger::log(
 		"debug",
 		"CTravelTime::Setup: Read: Branch Name |" + std::string(branch)
@@ -365,6 +429,229 @@ double CTravelTime::T(double delta) {
 	return (outTravelTime);
 }
 
+// ---------------------------------------------------------calculateDerivatives
+bool CTravelTime::calculateDerivatives(double delta, double *dTdDelta,
+										double *dTdDepth) {
+	if ((dTdDelta == NULL) || (dTdDepth == NULL)) {
+		return (false);
+	}
+	if ((m_pDTDDistanceArray == NULL) || (m_pDTDDepthArray == NULL)) {
+		return (false);
+	}
+
+	// bounds checks
+	if ((delta < m_dMinimumDistance) || (delta > m_dMaximumDistance)) {
+		return (false);
+	}
+	if ((m_dDepth < m_dMinimumDepth) || (m_dDepth > m_dMaximumDepth)) {
+		return (false);
+	}
+
+	// calculate distance interpolation indexes and values
+	int distanceIndex1 = getIndexFromDistance(delta);
+	double distance1 = getDistanceFromIndex(distanceIndex1);
+	int distanceIndex2 = distanceIndex1 + 1;
+	double distance2 = getDistanceFromIndex(distanceIndex2);
+
+	// calculate depth interpolation indexes and values
+	int depthIndex1 = getIndexFromDepth(m_dDepth);
+	double depth1 = getDepthFromIndex(depthIndex1);
+	int depthIndex2 = depthIndex1 + 1;
+	double depth2 = getDepthFromIndex(depthIndex2);
+
+	// the derivatives are only valid where the travel time is
+	if ((T(distanceIndex1, depthIndex1) < 0)
+		|| (T(distanceIndex1, depthIndex2) < 0)
+		|| (T(distanceIndex2, depthIndex1) < 0)
+		|| (T(distanceIndex2, depthIndex2) < 0)) {
+		return (false);
+	}
+
+	int index11 = depthIndex1 * m_iNumDistances + distanceIndex1;
+	int index12 = depthIndex2 * m_iNumDistances + distanceIndex1;
+	int index21 = depthIndex1 * m_iNumDistances + distanceIndex2;
+	int index22 = depthIndex2 * m_iNumDistances + distanceIndex2;
+
+	// get the derivatives via bilinear interpolation using the values and
+	// input distance/depth
+	*dTdDelta = bilinearInterpolation(
+		m_pDTDDistanceArray[index11], m_pDTDDistanceArray[index12],
+		m_pDTDDistanceArray[index21], m_pDTDDistanceArray[index22],
+		distance1, depth1, distance2, depth2, delta, m_dDepth);
+	*dTdDepth = bilinearInterpolation(
+		m_pDTDDepthArray[index11], m_pDTDDepthArray[index12],
+		m_pDTDDepthArray[index21], m_pDTDDepthArray[index22],
+		distance1, depth1, distance2, depth2, delta, m_dDepth);
+
+	return (true);
+}
+
+// -----------------------------------------------------generateDerivativeArrays
+void CTravelTime::generateDerivativeArrays() {
+	if (m_pDTDDistanceArray) {
+		delete[] (m_pDTDDistanceArray);
+	}
+	m_pDTDDistanceArray = NULL;
+	if (m_pDTDDepthArray) {
+		delete[] (m_pDTDDepthArray);
+	}
+	m_pDTDDepthArray = NULL;
+
+	if ((m_pTravelTimeArray == NULL) || (m_iNumDistances <= 0)
+		|| (m_iNumDepths <= 0) || (m_dDistanceStep <= 0)
+		|| (m_dDepthStep <= 0)) {
+		return;
+	}
+
+	m_pDTDDistanceArray = new double[m_iNumDistances * m_iNumDepths];
+	m_pDTDDepthArray = new double[m_iNumDistances * m_iNumDepths];
+
+	for (int depthIndex = 0; depthIndex < m_iNumDepths; depthIndex++) {
+		for (int deltaIndex = 0; deltaIndex < m_iNumDistances; deltaIndex++) {
+			int index = depthIndex * m_iNumDistances + deltaIndex;
+			m_pDTDDistanceArray[index] = 0;
+			m_pDTDDepthArray[index] = 0;
+
+			// no derivative without a travel time
+			double travelTime = T(deltaIndex, depthIndex);
+			if (travelTime < 0) {
+				continue;
+			}
+
+			// distance derivative, central difference where both neighbors
+			// have valid travel times, one sided otherwise
+			double before = T(deltaIndex - 1, depthIndex);
+			double after = T(deltaIndex + 1, depthIndex);
+			if ((before >= 0) && (after >= 0)) {
+				m_pDTDDistanceArray[index] = (after - before)
+						/ (2.0 * m_dDistanceStep);
+			} else if (after >= 0) {
+				m_pDTDDistanceArray[index] = (after - travelTime)
+						/ m_dDistanceStep;
+			} else if (before >= 0) {
+				m_pDTDDistanceArray[index] = (travelTime - before)
+						/ m_dDistanceStep;
+			}
+
+			// depth derivative, same approach
+			before = T(deltaIndex, depthIndex - 1);
+			after = T(deltaIndex, depthIndex + 1);
+			if ((before >= 0) && (after >= 0)) {
+				m_pDTDDepthArray[index] = (after - before)
+						/ (2.0 * m_dDepthStep);
+			} else if (after >= 0) {
+				m_pDTDDepthArray[index] = (after - travelTime) / m_dDepthStep;
+			} else if (before >= 0) {
+				m_pDTDDepthArray[index] = (travelTime - before) / m_dDepthStep;
+			}
+		}
+	}
+}
+
+// ---------------------------------------------------------getTravelTimeRange
+bool CTravelTime::getTravelTimeRange(double delta, double *minTime,
+										double *maxTime) {
+	if ((minTime == NULL) || (maxTime == NULL)) {
+		return (false);
+	}
+	if ((m_pMinimumTimeRangeArray == NULL)
+			|| (m_pMaximumTimeRangeArray == NULL)) {
+		return (false);
+	}
+
+	// bounds checks, as in T()
+	if ((delta < m_dMinimumDistance) || (delta > m_dMaximumDistance)) {
+		return (false);
+	}
+	if ((m_dDepth < m_dMinimumDepth) || (m_dDepth > m_dMaximumDepth)) {
+		return (false);
+	}
+
+	// find the block containing the first interpolation point
+	int distanceBlock = getIndexFromDistance(delta) / k_iTimeRangeBlockSize;
+	int depthBlock = getIndexFromDepth(m_dDepth) / k_iTimeRangeBlockSize;
+	if (distanceBlock >= m_iNumRangeDistances) {
+		distanceBlock = m_iNumRangeDistances - 1;
+	}
+	if (depthBlock >= m_iNumRangeDepths) {
+		depthBlock = m_iNumRangeDepths - 1;
+	}
+
+	int index = depthBlock * m_iNumRangeDistances + distanceBlock;
+	if (m_pMinimumTimeRangeArray[index] < 0) {
+		// no valid travel times in this block
+		return (false);
+	}
+
+	*minTime = m_pMinimumTimeRangeArray[index];
+	*maxTime = m_pMaximumTimeRangeArray[index];
+
+	return (true);
+}
+
+// -----------------------------------------------------generateTimeRangeArrays
+void CTravelTime::generateTimeRangeArrays() {
+	m_iNumRangeDistances = 0;
+	m_iNumRangeDepths = 0;
+	if (m_pMinimumTimeRangeArray) {
+		delete[] (m_pMinimumTimeRangeArray);
+	}
+	m_pMinimumTimeRangeArray = NULL;
+	if (m_pMaximumTimeRangeArray) {
+		delete[] (m_pMaximumTimeRangeArray);
+	}
+	m_pMaximumTimeRangeArray = NULL;
+
+	if ((m_pTravelTimeArray == NULL) || (m_iNumDistances <= 0)
+		|| (m_iNumDepths <= 0)) {
+		return;
+	}
+
+	m_iNumRangeDistances = (m_iNumDistances - 1) / k_iTimeRangeBlockSize + 1;
+	m_iNumRangeDepths = (m_iNumDepths - 1) / k_iTimeRangeBlockSize + 1;
+	m_pMinimumTimeRangeArray = new double[m_iNumRangeDistances
+			* m_iNumRangeDepths];
+	m_pMaximumTimeRangeArray = new double[m_iNumRangeDistances
+			* m_iNumRangeDepths];
+
+	for (int depthBlock = 0; depthBlock < m_iNumRangeDepths; depthBlock++) {
+		for (int distanceBlock = 0; distanceBlock < m_iNumRangeDistances;
+				distanceBlock++) {
+			double minTime = k_dTravelTimeInvalid;
+			double maxTime = k_dTravelTimeInvalid;
+
+			// include the last points of the block's interpolation cells,
+			// which are the first points of the next blocks
+			int firstDepth = depthBlock * k_iTimeRangeBlockSize;
+			int firstDistance = distanceBlock * k_iTimeRangeBlockSize;
+			for (int depthIndex = firstDepth;
+					depthIndex <= firstDepth + k_iTimeRangeBlockSize;
+					depthIndex++) {
+				for (int deltaIndex = firstDistance;
+						deltaIndex <= firstDistance + k_iTimeRangeBlockSize;
+						deltaIndex++) {
+					// T() returns invalid beyond the array
+					double travelTime = T(deltaIndex, depthIndex);
+					if (travelTime < 0) {
+						continue;
+					}
+
+					if ((minTime < 0) || (travelTime < minTime)) {
+						minTime = travelTime;
+					}
+					if ((maxTime < 0) || (travelTime > maxTime)) {
+						maxTime = travelTime;
+					}
+				}
+			}
+
+			int index = depthBlock * m_iNumRangeDistances + distanceBlock;
+			m_pMinimumTimeRangeArray[index] = minTime;
+			m_pMaximumTimeRangeArray[index] = maxTime;
+		}
+	}
+}
+
 // ------------------------------------------------------getIndexFromDistance
 int CTravelTime::getIndexFromDistance(double distance) {
 	if (m_dDistanceStep < 0) {
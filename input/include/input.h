@@ -16,7 +16,11 @@
 #include <ccparser.h>
 #include <simplepickparser.h>
 #include <queue.h>
+#include <threadpool.h>
 
+#include <chrono>
+#include <cstdint>
+#include <map>
 #include <thread>
 #include <mutex>
 #include <future>
@@ -57,6 +61,10 @@ namespace input {
  * https://github.com/usgs/earthquake-detection-formats/tree/master/format-docs
  * that are then passed to the associator/glasscore via a queue.
  *
+ * Optionally, parsing can be spread across a pool of parser threads, in which
+ * case the work thread only fetches data, and parsed data is committed to the
+ * queue in the order it was fetched.
+ *
  * The Input class is intended to be inherited from to define application
  * specific input mechanisms (i.e. input from disk files).
  *
@@ -157,11 +165,23 @@ class Input : public glass3::util::iInput,
 	 */
 	int getInputDataMaxSize();
 
+	/**
+	 * \brief Function to retrieve the number of parser threads
+	 *
+	 * This function retrieves the number of threads used to parse Input data,
+	 * 0 indicates that data is parsed on the work thread as it is fetched
+	 *
+	 * \return Returns an integer value containing the number of parser threads
+	 */
+	int getNumParseThreads();
+
  protected:
 	/**
 	 * \brief Input work function
 	 *
-	 * The function (from threadclassbase) used to do work.
+	 * The function (from threadclassbase) used to do work. Fetches a batch of
+	 * messages with fetchRawDataBatch(), as many as there is room for, and
+	 * either parses them or spreads them over the parser threads.
 	 * \return returns true if work was successful, false otherwise.
 	 */
 	glass3::util::WorkState work() override;
@@ -191,7 +211,106 @@ class Input : public glass3::util::iInput,
 	 */
 	virtual std::string fetchRawData(std::string* pOutType) = 0;
 
+	/**
+	 * \brief get a batch of Input data strings and their type
+	 *
+	 * Retrieves up to maxCount data messages, all of the same type, from an
+	 * Input source, so that a source that receives data in bulk can hand it
+	 * off to parsing in one go. The default fetches a single message with
+	 * fetchRawData().
+	 *
+	 * \param maxCount - An integer containing the maximum number of messages
+	 * to fetch
+	 * \param pMessages - A pointer to a std::vector of std::string to append
+	 * the messages to
+	 * \param pOutType - A pointer to a std::string used to pass out the type
+	 * of the data
+	 * \return returns the number of messages fetched
+	 */
+	virtual int fetchRawDataBatch(int maxCount,
+									std::vector<std::string> *pMessages,
+									std::string* pOutType);
+
  private:
+	/**
+	 * \brief parse raw data function
+	 *
+	 * Parses a fetched Input message, logging and discarding any exception
+	 * thrown by the parser
+	 *
+	 * \param inputType - A std::string containing the type of data to parse
+	 * \param inputMessage - A std::string containing the input message to parse
+	 * \param fetchTime - A std::chrono::steady_clock::time_point containing
+	 * when the message was fetched, used to trace pick latency
+	 * \return returns a shared pointer to a json::Object containing the parsed
+	 * data, or NULL if the message could not be parsed
+	 */
+	std::shared_ptr<json::Object> parseRawData(
+			const std::string &inputType, const std::string &inputMessage,
+			std::chrono::steady_clock::time_point fetchTime);
+
+	/**
+	 * \brief parse and commit function
+	 *
+	 * The parser thread job, parses part of a fetched batch of Input messages
+	 * and commits them to the data queue in fetch order
+	 *
+	 * \param sequence - An unsigned 64 bit integer containing the fetch order
+	 * sequence number of the first message
+	 * \param inputType - A std::string containing the type of data to parse
+	 * \param inputMessages - A std::vector of std::string containing the input
+	 * messages to parse
+	 * \param fetchTime - A std::chrono::steady_clock::time_point containing
+	 * when the messages were fetched, used to trace pick latency
+	 */
+	void parseAndCommit(uint64_t sequence, const std::string &inputType,
+						const std::vector<std::string> &inputMessages,
+						std::chrono::steady_clock::time_point fetchTime);
+
+	/**
+	 * \brief commit parsed data function
+	 *
+	 * Holds the parsed data for the given sequence numbers until all earlier
+	 * sequence numbers have been committed, then adds every data that is
+	 * now in order to the data queue.
+	 *
+	 * \param sequence - An unsigned 64 bit integer containing the fetch order
+	 * sequence number of the first data
+	 * \param data - A std::vector of shared pointers to json::Object
+	 * containing the parsed data in fetch order, NULL where a message could
+	 * not be parsed
+	 */
+	void commitParsedData(
+			uint64_t sequence,
+			const std::vector<std::shared_ptr<json::Object>> &data);
+
+	/**
+	 * \brief update queue gauge function
+	 *
+	 * Updates the "input.queue" metric with the size of the data queue
+	 */
+	void updateQueueGauge();
+
+	/**
+	 * \brief get pick id function
+	 *
+	 * Gets the id of parsed data if it is a pick, used to trace pick latency
+	 *
+	 * \param data - A shared pointer to a json::Object containing the parsed
+	 * data
+	 * \return returns a std::string containing the id of the pick, or an
+	 * empty string if the data is not a pick
+	 */
+	static std::string getPickID(std::shared_ptr<json::Object> data);
+
+	/**
+	 * \brief stop the parser threads
+	 *
+	 * Stops and deletes the parser thread pool, and forgets any data that was
+	 * fetched but not yet committed
+	 */
+	void stopParseThreads();
+
 	/**
 	 * \brief the integer configuration value indicating the maximum size of the
 	 * data queue
@@ -240,6 +359,60 @@ class Input : public glass3::util::iInput,
 	 * \brief the simple pick format parsing object
 	 */
 	glass3::parse::SimplePickParser * m_SimplePickParser;
+
+	/**
+	 * \brief the integer configuration value indicating the number of parser
+	 * threads, 0 to parse on the work thread
+	 */
+	std::atomic<int> m_iNumParseThreads;
+
+	/**
+	 * \brief the pool of parser threads, NULL when parsing on the work thread
+	 */
+	glass3::util::ThreadPool * m_ParseThreadPool;
+
+	/**
+	 * \brief the mutex protecting the parse sequence numbers and the parsed
+	 * data waiting to be committed
+	 */
+	std::mutex m_ParseMutex;
+
+	/**
+	 * \brief the sequence number to give the next fetched message
+	 */
+	uint64_t m_iNextParseSequence;
+
+	/**
+	 * \brief the sequence number of the next parsed data to commit
+	 */
+	uint64_t m_iNextCommitSequence;
+
+	/**
+	 * \brief the parsed data waiting for earlier data to be parsed, keyed by
+	 * sequence number
+	 */
+	std::map<uint64_t, std::shared_ptr<json::Object>> m_mParsedData;
+
+	/**
+	 * \brief the number of messages fetched but not yet committed
+	 */
+	std::atomic<int> m_iParseBacklog;
+
+	/**
+	 * \brief the maximum number of messages fetched but not yet committed per
+	 * parser thread, so fetching does not get too far ahead of parsing
+	 */
+	static const int k_iMaxParseBacklogPerThread = 100;
+
+	/**
+	 * \brief the maximum number of messages to fetch in one work loop
+	 */
+	static const int k_iMaxFetchBatchSize = 100;
+
+	/**
+	 * \brief the time the parser threads sleep when there is nothing to parse
+	 */
+	static const int k_iParseSleepTimeMS = 10;
 };
 }  // namespace input
 }  // namespace glass3
@@ -4,7 +4,14 @@
 #include <detection-formats.h>
 #include <logger.h>
 #include <fileutil.h>
-
+#include <latencytracer.h>
+#include <metricsregistry.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <thread>
 #include <mutex>
 #include <future>
@@ -12,7 +19,9 @@
 #include <sstream>
 #include <iostream>
 #include <fstream>
+#include <iterator>
 #include <memory>
+#include <utility>
 #include <vector>
 
 // JSON Keys
@@ -21,6 +30,11 @@
 namespace glass3 {
 namespace input {
 
+// constants
+const int Input::k_iMaxParseBacklogPerThread;
+const int Input::k_iMaxFetchBatchSize;
+const int Input::k_iParseSleepTimeMS;
+
 // ---------------------------------------------------------Input
 Input::Input()
 		: glass3::util::ThreadBaseClass("input") {
@@ -30,6 +44,7 @@ Input::Input()
 	m_JSONParser = NULL;
 	m_CCParser = NULL;
 	m_SimplePickParser = NULL;
+	m_ParseThreadPool = NULL;
 
 	m_DataQueue = new glass3::util::Queue();
 
@@ -43,6 +58,7 @@ Input::Input(std::shared_ptr<const json::Object> config)
 	m_JSONParser = NULL;
 	m_CCParser = NULL;
 	m_SimplePickParser = NULL;
+	m_ParseThreadPool = NULL;
 	m_DataQueue = new glass3::util::Queue();
 
 	// do basic construction
@@ -57,6 +73,9 @@ Input::Input(std::shared_ptr<const json::Object> config)
 
 // ---------------------------------------------------------~Input
 Input::~Input() {
+	// the parser threads use the parsers and the queue
+	stopParseThreads();
+
 	if (m_DataQueue != NULL) {
 		// clear the queue
 		m_DataQueue->clear();
@@ -156,6 +175,27 @@ bool Input::setup(std::shared_ptr<const json::Object> config) {
 						+ std::to_string(getInputDataMaxSize()) + ".");
 	}
 
+	// number of parser threads
+	if (!(config->HasKey("NumParseThreads")
+			&& ((*config)["NumParseThreads"].GetType()
+					== json::ValueType::IntVal))) {
+		// parser threads are optional
+		m_iNumParseThreads = 0;
+		glass3::util::Logger::log(
+				"info",
+				"Input::setup(): Defaulting to 0 for NumParseThreads (parse on "
+				"the input thread).");
+	} else {
+		m_iNumParseThreads = (*config)["NumParseThreads"].ToInt();
+		glass3::util::Logger::log(
+				"info",
+				"Input::setup(): Using NumParseThreads: "
+						+ std::to_string(getNumParseThreads()) + ".");
+	}
+
+	// the parser threads use the parsers, stop them before replacing them
+	stopParseThreads();
+
 	// need to (re)create the parsers to use the agency id / author
 	if (m_GPickParser != NULL) {
 		delete (m_GPickParser);
@@ -181,6 +221,11 @@ bool Input::setup(std::shared_ptr<const json::Object> config) {
 	m_SimplePickParser = new glass3::parse::SimplePickParser(getDefaultAgencyId(),
 																getDefaultAuthor());
 
+	if (getNumParseThreads() > 0) {
+		m_ParseThreadPool = new glass3::util::ThreadPool(
+				"inputparse", getNumParseThreads(), k_iParseSleepTimeMS);
+	}
+
 	glass3::util::Logger::log("debug", "Input::setup(): Done Setting Up.");
 
 	// finally do baseclass setup;
@@ -198,6 +243,9 @@ void Input::clear() {
 	setDefaultAgencyId("");
 	setDefaultAuthor("");
 	setInputDataMaxSize(-1);
+	m_iNumParseThreads = 0;
+
+	stopParseThreads();
 
 	if (m_DataQueue != NULL)
 		m_DataQueue->clear();
@@ -227,37 +275,241 @@ int Input::getInputDataCount() {
 
 // ---------------------------------------------------------work
 glass3::util::WorkState Input::work() {
-	// check to see if we have room
-	if ((getInputDataMaxSize() != -1)
-			&& (getInputDataCount() >= getInputDataMaxSize())) {
-		// we don't, yet
+	// fetch as much as there is room for, counting the data still being parsed
+	int maxFetch = k_iMaxFetchBatchSize;
+	if (getInputDataMaxSize() != -1) {
+		maxFetch = std::min(
+				maxFetch,
+				getInputDataMaxSize() - getInputDataCount() - m_iParseBacklog);
+	}
+
+	// don't get too far ahead of the parser threads
+	int numParseThreads = std::max(getNumParseThreads(), 1);
+	if (m_ParseThreadPool != NULL) {
+		maxFetch = std::min(
+				maxFetch,
+				k_iMaxParseBacklogPerThread * numParseThreads - m_iParseBacklog);
+	}
+
+	if (maxFetch <= 0) {
+		// no room, yet
 		return (glass3::util::WorkState::Idle);
 	}
 
 	// get next data
 	std::string type = "";
-	std::string message = fetchRawData(&type);
+	std::vector<std::string> messages;
+	int numMessages = fetchRawDataBatch(maxFetch, &messages, &type);
 
-	if (message == "") {
+	if (numMessages <= 0) {
 		return (glass3::util::WorkState::Idle);
 	}
+	std::chrono::steady_clock::time_point tFetch =
+			std::chrono::steady_clock::now();
+
+	static std::atomic<int64_t> &fetchCounter =
+			glass3::util::MetricsRegistry::getInstance().getCounter(
+					"input.fetched");
+	fetchCounter += numMessages;
+
+	if (m_ParseThreadPool == NULL) {
+		// parse it here
+		for (const std::string &message : messages) {
+			std::shared_ptr<json::Object> newdata = parseRawData(type, message,
+																	tFetch);
+
+			if (newdata != NULL) {
+				m_DataQueue->addDataToQueue(newdata);
+				if (glass3::util::LatencyTracer::getEnabled() == true) {
+					glass3::util::LatencyTracer::getInstance().mark(
+							getPickID(newdata),
+							glass3::util::LatencyTracer::InputQueue);
+				}
+			}
+		}
+		updateQueueGauge();
+
+		// work was successful
+		return (glass3::util::WorkState::OK);
+	}
+
+	// number the data in fetch order
+	uint64_t sequence = 0;
+	{
+		std::lock_guard<std::mutex> guard(m_ParseMutex);
+		sequence = m_iNextParseSequence;
+		m_iNextParseSequence += numMessages;
+		m_iParseBacklog += numMessages;
+	}
+
+	// and spread it over the parser threads
+	int chunkSize = (numMessages + numParseThreads - 1) / numParseThreads;
+	for (int start = 0; start < numMessages; start += chunkSize) {
+		int end = std::min(start + chunkSize, numMessages);
+		std::vector<std::string> chunk(
+				std::make_move_iterator(messages.begin() + start),
+				std::make_move_iterator(messages.begin() + end));
+
+		m_ParseThreadPool->addJob(
+				std::bind(&Input::parseAndCommit, this, sequence + start, type,
+							std::move(chunk), tFetch));
+	}
+
+	// work was successful
+	return (glass3::util::WorkState::OK);
+}
+
+// ---------------------------------------------------------fetchRawDataBatch
+int Input::fetchRawDataBatch(int maxCount, std::vector<std::string> *pMessages,
+								std::string* pOutType) {
+	if ((maxCount <= 0) || (pMessages == NULL)) {
+		return (0);
+	}
+
+	std::string message = fetchRawData(pOutType);
+	if (message == "") {
+		return (0);
+	}
+
+	pMessages->push_back(message);
+	return (1);
+}
 
+// ---------------------------------------------------------parseRawData
+std::shared_ptr<json::Object> Input::parseRawData(
+		const std::string &inputType, const std::string &inputMessage,
+		std::chrono::steady_clock::time_point fetchTime) {
+	static glass3::util::LatencyHistogram &parseHistogram =
+			glass3::util::MetricsRegistry::getInstance().getHistogram(
+					"input.parse_us");
+	static std::atomic<int64_t> &failureCounter =
+			glass3::util::MetricsRegistry::getInstance().getCounter(
+					"input.parse_failures");
+
+	std::chrono::steady_clock::time_point tParseStart =
+			std::chrono::steady_clock::now();
 	std::shared_ptr<json::Object> newdata;
 	try {
-		newdata = parse(type, message);
+		newdata = parse(inputType, inputMessage);
 	} catch (const std::exception &e) {
 		glass3::util::Logger::log(
 				"debug",
-				"Input::work(): Exception:" + std::string(e.what())
-						+ " processing Input: " + message);
+				"Input::parseRawData(): Exception:" + std::string(e.what())
+						+ " processing Input: " + inputMessage);
 	}
 
-	if (newdata != NULL) {
-		m_DataQueue->addDataToQueue(newdata);
+	parseHistogram.record(
+			std::chrono::duration_cast<std::chrono::microseconds>(
+					std::chrono::steady_clock::now() - tParseStart).count());
+	if (newdata == NULL) {
+		failureCounter++;
 	}
 
-	// work was successful
-	return (glass3::util::WorkState::OK);
+	// the pick id isn't known until it is parsed
+	if (glass3::util::LatencyTracer::getEnabled() == true) {
+		std::string pickID = getPickID(newdata);
+		if (pickID != "") {
+			glass3::util::LatencyTracer &tracer =
+					glass3::util::LatencyTracer::getInstance();
+			tracer.mark(pickID, glass3::util::LatencyTracer::Fetch, fetchTime);
+			tracer.mark(pickID, glass3::util::LatencyTracer::Parse);
+		}
+	}
+
+	return (newdata);
+}
+
+// ---------------------------------------------------------parseAndCommit
+void Input::parseAndCommit(uint64_t sequence, const std::string &inputType,
+							const std::vector<std::string> &inputMessages,
+							std::chrono::steady_clock::time_point fetchTime) {
+	// parse outside of the lock, so the parser threads run concurrently
+	std::vector<std::shared_ptr<json::Object>> parsedData;
+	parsedData.reserve(inputMessages.size());
+	for (const std::string &message : inputMessages) {
+		parsedData.push_back(parseRawData(inputType, message, fetchTime));
+	}
+
+	commitParsedData(sequence, parsedData);
+}
+
+// ---------------------------------------------------------commitParsedData
+void Input::commitParsedData(
+		uint64_t sequence,
+		const std::vector<std::shared_ptr<json::Object>> &data) {
+	std::lock_guard<std::mutex> guard(m_ParseMutex);
+
+	// hold on to the data until the earlier data is committed, failed parses
+	// are held as NULL so they don't stall the later data
+	for (const std::shared_ptr<json::Object> &parsed : data) {
+		m_mParsedData[sequence++] = parsed;
+	}
+
+	// commit everything that is now in order
+	auto next = m_mParsedData.begin();
+	while ((next != m_mParsedData.end())
+			&& (next->first == m_iNextCommitSequence)) {
+		if (next->second != NULL) {
+			m_DataQueue->addDataToQueue(next->second);
+			if (glass3::util::LatencyTracer::getEnabled() == true) {
+				glass3::util::LatencyTracer::getInstance().mark(
+						getPickID(next->second),
+						glass3::util::LatencyTracer::InputQueue);
+			}
+		}
+
+		next = m_mParsedData.erase(next);
+		m_iNextCommitSequence++;
+		m_iParseBacklog--;
+	}
+
+	updateQueueGauge();
+}
+
+// ---------------------------------------------------------updateQueueGauge
+void Input::updateQueueGauge() {
+	static std::atomic<double> &queueGauge =
+			glass3::util::MetricsRegistry::getInstance().getGauge("input.queue");
+	queueGauge = m_DataQueue->size();
+}
+
+// ---------------------------------------------------------getPickID
+std::string Input::getPickID(std::shared_ptr<json::Object> data) {
+	if (data == NULL) {
+		return ("");
+	}
+
+	std::string type = "";
+	if ((data->HasKey("Type"))
+			&& ((*data)["Type"].GetType() == json::ValueType::StringVal)) {
+		type = (*data)["Type"].ToString();
+	} else if ((data->HasKey("Cmd"))
+			&& ((*data)["Cmd"].GetType() == json::ValueType::StringVal)) {
+		type = (*data)["Cmd"].ToString();
+	}
+
+	if ((type != "Pick") || (data->HasKey("ID") == false)
+			|| ((*data)["ID"].GetType() != json::ValueType::StringVal)) {
+		return ("");
+	}
+
+	return ((*data)["ID"].ToString());
+}
+
+// ---------------------------------------------------------stopParseThreads
+void Input::stopParseThreads() {
+	if (m_ParseThreadPool != NULL) {
+		m_ParseThreadPool->stop();
+		delete (m_ParseThreadPool);
+		m_ParseThreadPool = NULL;
+	}
+
+	// any data not yet committed is lost with the pool's queued jobs
+	std::lock_guard<std::mutex> guard(m_ParseMutex);
+	m_mParsedData.clear();
+	m_iNextParseSequence = 0;
+	m_iNextCommitSequence = 0;
+	m_iParseBacklog = 0;
 }
 
 // ---------------------------------------------------------parse
@@ -295,5 +547,10 @@ int Input::getInputDataMaxSize() {
 	return (m_QueueMaxSize);
 }
 
+// ---------------------------------------------------------getNumParseThreads
+int Input::getNumParseThreads() {
+	return (m_iNumParseThreads);
+}
+
 }  // namespace input
 }  // namespace glass3
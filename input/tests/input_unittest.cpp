@@ -13,6 +13,7 @@
 #define TESTAGENCYID "US"
 #define TESTAUTHOR "glasstest"
 #define DATACOUNT 5
+#define NUMPARSETHREADS 4
 
 // glass3::input::Input is an abstract class and
 // must be derived into a concrete class before use.
@@ -71,6 +72,23 @@ class inputStub : public glass3::input::Input {
 	std::ifstream m_InputFile;
 };
 
+// an input that hands off the whole file in one batch
+class batchInputStub : public inputStub {
+ protected:
+	int fetchRawDataBatch(int maxCount, std::vector<std::string> *messages,
+							std::string* type) override {
+		int count = 0;
+		while ((count < maxCount) && (m_bFileProcessed == false)) {
+			std::string message = fetchRawData(type);
+			if (message != "") {
+				messages->push_back(message);
+				count++;
+			}
+		}
+		return (count);
+	}
+};
+
 // tests to see input can be constructed
 TEST(InputTest, Construction) {
 	inputStub TestInput;
@@ -84,6 +102,9 @@ TEST(InputTest, Construction) {
 
 	// assert queue max size is -1
 	ASSERT_EQ(TestInput.getInputDataMaxSize(), -1)<< "queue max size check";
+
+	// assert parsing on the input thread
+	ASSERT_EQ(TestInput.getNumParseThreads(), 0)<< "parse threads check";
 }
 
 // tests to see if the input can be configured
@@ -198,3 +219,118 @@ TEST(InputTest, JSONTest) {
 
 	TestInput.stop();
 }
+
+// tests to see if parser threads preserve the input order
+TEST(InputTest, ParseThreadsTest) {
+	// create configfilestring
+	std::string configfile = std::string(CONFIGFILENAME);
+	std::string configdirectory = std::string(TESTPATH);
+
+	// load configuration
+	glass3::util::Config * InputConfig = new glass3::util::Config(
+			configdirectory, configfile);
+	std::shared_ptr<const json::Object> InputJSON = InputConfig->getJSON();
+
+	// parse on the input thread
+	inputStub SerialInput;
+	SerialInput.setup(InputJSON);
+	SerialInput.m_DataType = std::string(GPICK_TYPE);
+	SerialInput.start();
+
+	// parse on parser threads
+	std::shared_ptr<json::Object> ParallelJSON = std::make_shared<json::Object>(
+			*InputJSON);
+	(*ParallelJSON)["NumParseThreads"] = NUMPARSETHREADS;
+
+	inputStub ParallelInput;
+	ParallelInput.setup(ParallelJSON);
+	ParallelInput.m_DataType = std::string(GPICK_TYPE);
+	ASSERT_EQ(ParallelInput.getNumParseThreads(), NUMPARSETHREADS)
+	<< "parse threads check";
+	ParallelInput.start();
+
+	// wait a bit for the files to process
+	std::this_thread::sleep_for(std::chrono::seconds(1));
+
+	// check that the right ammount of data is in the queue
+	ASSERT_EQ(SerialInput.getInputDataCount(), DATACOUNT)<< "serial queue size";
+	ASSERT_EQ(ParallelInput.getInputDataCount(), DATACOUNT)
+	<< "parallel queue size";
+
+	// check that the data is in the same order
+	for (int i = 0; i < DATACOUNT; i++) {
+		std::shared_ptr<json::Object> serialData = SerialInput.getInputData();
+		std::shared_ptr<json::Object> parallelData =
+				ParallelInput.getInputData();
+
+		ASSERT_TRUE(serialData != NULL)<< "serial data";
+		ASSERT_TRUE(parallelData != NULL)<< "parallel data";
+		ASSERT_STREQ(json::Serialize(*serialData).c_str(),
+						json::Serialize(*parallelData).c_str())<< "same order";
+	}
+
+	SerialInput.stop();
+	ParallelInput.stop();
+}
+
+// tests to see if batches are parsed in input order
+TEST(InputTest, BatchTest) {
+	// create configfilestring
+	std::string configfile = std::string(CONFIGFILENAME);
+	std::string configdirectory = std::string(TESTPATH);
+
+	// load configuration
+	glass3::util::Config * InputConfig = new glass3::util::Config(
+			configdirectory, configfile);
+	std::shared_ptr<const json::Object> InputJSON = InputConfig->getJSON();
+
+	// one message at a time
+	inputStub SingleInput;
+	SingleInput.setup(InputJSON);
+	SingleInput.m_DataType = std::string(GPICK_TYPE);
+	SingleInput.start();
+
+	// batches parsed on the input thread
+	batchInputStub SerialInput;
+	SerialInput.setup(InputJSON);
+	SerialInput.m_DataType = std::string(GPICK_TYPE);
+	SerialInput.start();
+
+	// batches spread over parser threads
+	std::shared_ptr<json::Object> ParallelJSON = std::make_shared<json::Object>(
+			*InputJSON);
+	(*ParallelJSON)["NumParseThreads"] = NUMPARSETHREADS;
+
+	batchInputStub ParallelInput;
+	ParallelInput.setup(ParallelJSON);
+	ParallelInput.m_DataType = std::string(GPICK_TYPE);
+	ParallelInput.start();
+
+	// wait a bit for the files to process
+	std::this_thread::sleep_for(std::chrono::seconds(1));
+
+	// check that the right ammount of data is in the queue
+	ASSERT_EQ(SingleInput.getInputDataCount(), DATACOUNT)<< "single queue size";
+	ASSERT_EQ(SerialInput.getInputDataCount(), DATACOUNT)<< "serial queue size";
+	ASSERT_EQ(ParallelInput.getInputDataCount(), DATACOUNT)
+	<< "parallel queue size";
+
+	// check that the data is in the same order
+	for (int i = 0; i < DATACOUNT; i++) {
+		std::string singleData = json::Serialize(*SingleInput.getInputData());
+		std::shared_ptr<json::Object> serialData = SerialInput.getInputData();
+		std::shared_ptr<json::Object> parallelData =
+				ParallelInput.getInputData();
+
+		ASSERT_TRUE(serialData != NULL)<< "serial data";
+		ASSERT_TRUE(parallelData != NULL)<< "parallel data";
+		ASSERT_STREQ(singleData.c_str(), json::Serialize(*serialData).c_str())
+		<< "serial order";
+		ASSERT_STREQ(singleData.c_str(), json::Serialize(*parallelData).c_str())
+		<< "parallel order";
+	}
+
+	SingleInput.stop();
+	SerialInput.stop();
+	ParallelInput.stop();
+}
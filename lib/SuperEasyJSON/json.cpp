@@ -282,6 +282,13 @@ Object& Object::operator =(const Object& obj)
 	return *this;
 }
 
+// A shared NULL value returned by the const lookups for missing keys
+static const Value& NullValue()
+{
+	static const Value null_value;
+	return null_value;
+}
+
 Value& Object::operator [](const std::string& key)
 {
 	return mValues[key];
@@ -290,6 +297,8 @@ Value& Object::operator [](const std::string& key)
 const Value& Object::operator [](const std::string& key) const
 {
 	ValueMap::const_iterator it = mValues.find(key);
+	if (it == mValues.end())
+		return NullValue();
 	return it->second;
 }
 
@@ -301,6 +310,8 @@ Value& Object::operator [](const char* key)
 const Value& Object::operator [](const char* key) const
 {
 	ValueMap::const_iterator it = mValues.find(key);
+	if (it == mValues.end())
+		return NullValue();
 	return it->second;
 }
 
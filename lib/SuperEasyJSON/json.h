@@ -26,6 +26,15 @@
 
 	CHANGELOG:
 	==========
+ 	glass3:
+ 	-------
+ 	* Added AsString, AsObject and AsArray to Value, which return const
+ 		references to the contained string/object/array instead of copies,
+ 		so nested objects can be read without deep copying them. The
+ 		references are only valid as long as the Value they came from.
+ 	* The const [] operators of Object (and so Value) now return a NULL
+ 		Value for missing keys instead of dereferencing end().
+
  	2/8/2014:
  	--------- 
  	MAJOR BUG FIXES, all courtesy of Per Rovegård, Ph.D.
@@ -364,6 +373,11 @@ namespace json
 			std::string	ToString() const	{assert(mValueType == StringVal); return mStringVal;}
 			Object 		ToObject() const	{assert(mValueType == ObjectVal); return mObjectVal;}
 			Array 		ToArray() const		{assert(mValueType == ArrayVal); return mArrayVal;}
+
+			// const reference versions, these do not copy the contained value
+			const std::string&	AsString() const	{assert(mValueType == StringVal); return mStringVal;}
+			const Object& 		AsObject() const	{assert(mValueType == ObjectVal); return mObjectVal;}
+			const Array& 		AsArray() const		{assert(mValueType == ArrayVal); return mArrayVal;}
 			
 			// Please note that as per C++ rules, implicitly casting a Value to a std::string won't work.
 			// This is because it could use the int/float/double/bool operators as well. So to assign a
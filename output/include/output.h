@@ -11,10 +11,13 @@
 #include <threadbaseclass.h>
 #include <outputinterface.h>
 #include <associatorinterface.h>
-#include <cache.h>
+#include <timerwheel.h>
+#include <timerservice.h>
 #include <queue.h>
 #include <threadpool.h>
+#include <trackingdata.h>
 
+#include <atomic>
 #include <thread>
 #include <mutex>
 #include <future>
@@ -24,6 +27,8 @@
 #include <fstream>
 #include <vector>
 #include <memory>
+#include <map>
+#include <list>
 
 namespace glass3 {
 
@@ -135,6 +140,17 @@ class output : public glass3::util::iOutput,
 	 */
 	bool start() override;
 
+	/**
+	 * \brief work thread stop function
+	 *
+	 * Overrides ThreadBaseClass::stop() to remove the heartbeat and site list
+	 * request timers before stopping the threads
+	 *
+	 * \return returns true if successful, false if ThreadBaseClass::stop()
+	 * failed.
+	 */
+	bool stop() override;
+
 	/**
 	 * \brief output heath check function
 	 *
@@ -321,9 +337,9 @@ class output : public glass3::util::iOutput,
 	/**
 	 * \brief get tracking information from the output tracking cache
 	 *
-	 * Get the first ready tracking data from the cache by starting at the
-	 * beginning of the cache and evaluating each tracking data with
-	 * isDataReady()
+	 * Get the first ready tracking data from the cache by advancing the
+	 * publication timer wheel to the current time and evaluating only the
+	 * tracking data that is due with isDataReady()
 	 *
 	 *\return Returns a shared_ptr to the json object containing the glasscore
 	 * event message used for storing tracking information if found, NULL if no
@@ -386,7 +402,9 @@ class output : public glass3::util::iOutput,
 	/**
 	 * \brief check to see if tracking information is ready for output
 	 *
-	 * Check the given tracking information to see if it is ready for output
+	 * Check the given tracking information to see if it is ready for output.
+	 * This is a query, the tracking cache and the publication schedule are
+	 * not changed, and the information does not need to be tracked.
 	 *
 	 * \param data - A shared_ptr to a json::Object containing the glasscore
 	 * event message used as the tracking information to check
@@ -465,6 +483,11 @@ class output : public glass3::util::iOutput,
 	 */
 	static constexpr int k_iMinimumPublicationTime = 10;
 
+	/**
+	 * \brief The interval in milliseconds between calls to sendHeartbeat()
+	 */
+	static constexpr int k_iHeartbeatIntervalMS = 1000;
+
  protected:
 	/**
 	 * \brief output tracking data background work function
@@ -488,15 +511,69 @@ class output : public glass3::util::iOutput,
 	virtual void sendOutput(const std::string &type, const std::string &id,
 							const std::string &message) = 0;
 
+	/**
+	 * \brief Send output data with routing information
+	 *
+	 * This function is used to send output data along with the routing
+	 * information already known when the message was generated, so that an
+	 * implementing class can route the message without parsing it again. By
+	 * default it calls sendOutput(type, id, message), it is expected that an
+	 * implementing class that routes messages by location will override it.
+	 *
+	 * \param type - A std::string containing the type of the message
+	 * \param id - A std::string containing the id of the message
+	 * \param latitude - A double containing the latitude of the message in
+	 * degrees, or NaN if the message does not have a location
+	 * \param longitude - A double containing the longitude of the message in
+	 * degrees, or NaN if the message does not have a location
+	 * \param message - A std::string containing the message
+	 */
+	virtual void sendOutput(const std::string &type, const std::string &id,
+							double latitude, double longitude,
+							const std::string &message);
+
 	/**
 	 * \brief Send heartbeats
 	 *
 	 * This function is optionally used by an overriding class to implement a
 	 * specific heartbeat method, i.e. to disk, memory, socket, kafka, etc.
+	 * Called about once a second from the work thread, so it may block.
 	 */
 	virtual void sendHeartbeat();
 
  private:
+	/**
+	 * \brief Mark a heartbeat as due
+	 *
+	 * The heartbeat timer callback. The shared timer thread must not block,
+	 * so it only flags the heartbeat, which the work thread then sends.
+	 */
+	void heartbeatDue();
+
+	/**
+	 * \brief Request the site list
+	 *
+	 * The site list request timer callback, sends a ReqSiteList message to
+	 * the associator
+	 */
+	void requestSiteList();
+
+	/**
+	 * \brief Start the timers
+	 *
+	 * Adds the heartbeat timer, and the site list request timer if the site
+	 * list is to be requested, to the shared glass3::util::TimerService
+	 */
+	void startTimers();
+
+	/**
+	 * \brief Stop the timers
+	 *
+	 * Removes the heartbeat and site list request timers, waiting for any
+	 * running timer callback to finish
+	 */
+	void stopTimers();
+
 	/**
 	 * \brief A std::vector of integers containing the times in seconds
 	 * since initial report that events should generate detection messages. An
@@ -544,10 +621,22 @@ class output : public glass3::util::iOutput,
 	std::atomic<int> m_iSiteListRequestInterval;
 
 	/**
-	 * \brief pointer to the glass3::util::cache class used to
-	 * store output tracking information
+	 * \brief A std::map containing the output tracking information for each
+	 * tracked event, indexed by the std::string event id
+	 */
+	std::map<std::string, std::shared_ptr<trackingData>> m_TrackingCache;
+
+	/**
+	 * \brief The glass3::util::TimerWheel used to schedule the tracked event
+	 * ids by their next publication time
 	 */
-	glass3::util::Cache * m_TrackingCache;
+	glass3::util::TimerWheel m_PublicationTimerWheel;
+
+	/**
+	 * \brief A std::list containing the ids of tracked events that are due
+	 * for publication but have not been checked with isDataReady() yet
+	 */
+	std::list<std::string> m_DueTrackingIDs;
 
 	/**
 	 * \brief mutex used to control access to the tracking cache
@@ -614,9 +703,27 @@ class output : public glass3::util::iOutput,
 	std::time_t tLastWorkReport;
 
 	/**
-	 * \brief the last time a site list was requested
+	 * \brief the id of the heartbeat timer, -1 when the timers are not
+	 * started
+	 */
+	int64_t m_iHeartbeatTimerID;
+
+	/**
+	 * \brief a boolean flag indicating that the heartbeat timer has fired
+	 * and the work thread should call sendHeartbeat()
+	 */
+	std::atomic<bool> m_bHeartbeatDue;
+
+	/**
+	 * \brief the id of the site list request timer, -1 when the site list is
+	 * not being requested
 	 */
-	std::time_t m_tLastSiteRequest;
+	int64_t m_iSiteListTimerID;
+
+	/**
+	 * \brief A mutex to control access to the timer ids
+	 */
+	std::mutex m_TimerMutex;
 
 	/**
 	 * \brief pointer to the glass3::util::threadpool used to queue and
@@ -625,6 +732,33 @@ class output : public glass3::util::iOutput,
 	glass3::util::ThreadPool *m_ThreadPool;
 
  private:
+	/**
+	 * \brief check to see if tracking information is ready for output
+	 *
+	 * Check the given tracking information to see if it is ready for output,
+	 * and update the publication log if it is. The tracking cache mutex must
+	 * be held when calling this function.
+	 *
+	 * \param data - A shared_ptr to the trackingData to check
+	 * \param tNow - A std::time_t containing the current time
+	 * \return Returns true if the tracking information is ready, false if not.
+	 */
+	bool isDataReady(std::shared_ptr<trackingData> data, std::time_t tNow);
+
+	/**
+	 * \brief schedule tracking information for its next publication
+	 *
+	 * Schedule the given tracking information in the publication timer wheel
+	 * at its next publication time, or remove it from the wheel if it has no
+	 * more publication times. The tracking cache mutex must be held when
+	 * calling this function.
+	 *
+	 * \param data - A shared_ptr to the trackingData to schedule
+	 * \param tNow - A std::time_t containing the current time
+	 */
+	void scheduleTrackingData(std::shared_ptr<trackingData> data,
+								std::time_t tNow);
+
 	/**
 	 * \brief Retrieves a reference to the class member containing the mutex
 	 * used to control access to class members
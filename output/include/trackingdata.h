@@ -0,0 +1,201 @@
+/*****************************************
+ * This file is documented for Doxygen.
+ * If you modify this file please update
+ * the comments so that Doxygen will still
+ * be able to work.
+ ****************************************/
+#ifndef TRACKINGDATA_H
+#define TRACKINGDATA_H
+
+#include <json.h>
+
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace glass3 {
+namespace output {
+/**
+ * \brief glass output tracking data class
+ *
+ * The glass3 output trackingData class holds the publication tracking
+ * information for a single event. It is built from the glasscore Event
+ * message as defined at
+ * https://github.com/usg/neic-glass3/blob/code-review/doc/internal-formats/Event.md  // NOLINT
+ * with the id, command, version, bayes value and create time parsed once when
+ * the message is received, and a publication log containing the event version
+ * published at each publication time (0 if not published).
+ *
+ * The publication log has one entry per publication time, plus an extra entry
+ * at the beginning if the event was immediately published.
+ */
+class trackingData {
+ public:
+	/**
+	 * \brief trackingData constructor
+	 *
+	 * The constructor for the trackingData class.
+	 * Initializes members to default values.
+	 */
+	trackingData();
+
+	/**
+	 * \brief trackingData advanced constructor
+	 *
+	 * The advanced constructor for the trackingData class. Initializes members
+	 * from the provided tracking json
+	 *
+	 * \param data - A shared_ptr to a json::Object containing the glasscore
+	 * event message used as the tracking information, optionally including a
+	 * PubLog array
+	 */
+	explicit trackingData(std::shared_ptr<const json::Object> data);
+
+	/**
+	 * \brief trackingData destructor
+	 *
+	 * The destructor for the trackingData class.
+	 */
+	~trackingData();
+
+	/**
+	 * \brief trackingData clear function
+	 *
+	 * Resets members to default values.
+	 */
+	void clear();
+
+	/**
+	 * \brief trackingData initialization function
+	 *
+	 * Initializes members from the provided tracking json
+	 *
+	 * \param data - A shared_ptr to a json::Object containing the glasscore
+	 * event message used as the tracking information, optionally including a
+	 * PubLog array, the publication log is empty if not
+	 * \return Returns true if the tracking json contained an id, false
+	 * otherwise
+	 */
+	bool initialize(std::shared_ptr<const json::Object> data);
+
+	/**
+	 * \brief update tracking data
+	 *
+	 * Update this tracking data with the message information of newer
+	 * tracking data for the same event, keeping the current publication log
+	 *
+	 * \param newData - A trackingData containing the newer information
+	 */
+	void update(const trackingData &newData);
+
+	/**
+	 * \brief check to see if tracking data has changed
+	 *
+	 * \return Returns true if the current version has not been published,
+	 * false otherwise.
+	 */
+	bool isChanged() const;
+
+	/**
+	 * \brief check to see if tracking data has been published
+	 *
+	 * \param ignoreVersion - A boolen flag indicating whether to ignore
+	 * the current version, if false a publication of the current version is
+	 * not counted
+	 * \return Returns true if the tracking data has been published, false if
+	 * not.
+	 */
+	bool isPublished(bool ignoreVersion = true) const;
+
+	/**
+	 * \brief check to see if tracking data is finished
+	 *
+	 * \return Returns true if every publication log entry has been published,
+	 * false if not.
+	 */
+	bool isFinished() const;
+
+	/**
+	 * \brief Get the tracking data as json
+	 *
+	 * \return Returns a shared_ptr to a json::Object containing the glasscore
+	 * event message with the current publication log as the PubLog array
+	 */
+	std::shared_ptr<json::Object> toJSON() const;
+
+	/**
+	 * \brief Get the event id
+	 */
+	const std::string & getID() const;
+
+	/**
+	 * \brief Get the message command, i.e. "Event"
+	 */
+	const std::string & getCommand() const;
+
+	/**
+	 * \brief Get the event version
+	 */
+	int getVersion() const;
+
+	/**
+	 * \brief Get the event bayes value
+	 */
+	double getBayes() const;
+
+	/**
+	 * \brief Get the event create time in epoch seconds
+	 */
+	int getCreateTime() const;
+
+	/**
+	 * \brief Get the publication log
+	 */
+	std::vector<int> & getPubLog();
+
+	/**
+	 * \brief Get the publication log
+	 */
+	const std::vector<int> & getPubLog() const;
+
+ private:
+	/**
+	 * \brief A std::string containing the event id
+	 */
+	std::string m_sID;
+
+	/**
+	 * \brief A std::string containing the message command
+	 */
+	std::string m_sCommand;
+
+	/**
+	 * \brief An integer containing the event version
+	 */
+	int m_iVersion;
+
+	/**
+	 * \brief A double containing the event bayes value
+	 */
+	double m_dBayes;
+
+	/**
+	 * \brief An integer containing the event create time in epoch seconds
+	 */
+	int m_iCreateTime;
+
+	/**
+	 * \brief A std::vector of integers containing the version published at
+	 * each publication time, 0 if not published
+	 */
+	std::vector<int> m_PubLog;
+
+	/**
+	 * \brief A shared_ptr to the json::Object containing the glasscore event
+	 * message
+	 */
+	std::shared_ptr<const json::Object> m_Data;
+};
+}  // namespace output
+}  // namespace glass3
+#endif  // TRACKINGDATA_H
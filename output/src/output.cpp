@@ -5,7 +5,13 @@
 #include <logger.h>
 #include <fileutil.h>
 #include <date.h>
+#include <clock.h>
+#include <latencytracer.h>
+#include <metricsregistry.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <thread>
 #include <mutex>
 #include <future>
@@ -15,6 +21,9 @@
 #include <fstream>
 #include <memory>
 #include <vector>
+#include <map>
+#include <list>
+#include <limits>
 
 // JSON Keys
 #define TYPE_KEY "Type"
@@ -25,18 +34,24 @@
 #define PUBLOG_KEY "PubLog"
 #define VERSION_KEY "Version"
 #define BAYES_KEY "Bayes"
+#define LATITUDE_KEY "Latitude"
+#define LONGITUDE_KEY "Longitude"
+#define DATA_KEY "Data"
 
 namespace glass3 {
 namespace output {
 
 // constants
 constexpr int output::k_iMinimumPublicationTime;
+constexpr int output::k_iHeartbeatIntervalMS;
 
 // ---------------------------------------------------------output
 output::output()
 		: glass3::util::ThreadBaseClass("output") {
 	std::time(&tLastWorkReport);
-	std::time(&m_tLastSiteRequest);
+	m_iHeartbeatTimerID = -1;
+	m_bHeartbeatDue = false;
+	m_iSiteListTimerID = -1;
 
 	// interval to report performance statistics
 	setReportInterval(60);
@@ -51,7 +66,6 @@ output::output()
 	m_iSiteListCounter = 0;
 
 	// allocation
-	m_TrackingCache = new glass3::util::Cache();
 	m_OutputQueue = new glass3::util::Queue();
 	m_LookupQueue = new glass3::util::Queue();
 
@@ -66,13 +80,11 @@ output::output()
 
 // ---------------------------------------------------------~output
 output::~output() {
+	// make sure no timer callbacks run once we're gone
+	stopTimers();
+
 	// cleanup
-	// cppcheck-suppress nullPointerRedundantCheck
-	if (m_TrackingCache != NULL) {
-		m_TrackingCache->clear();
-		delete (m_TrackingCache);
-		m_TrackingCache = NULL;
-	}
+	clearTrackingData();
 
 	// cppcheck-suppress nullPointerRedundantCheck
 	if (m_OutputQueue != NULL) {
@@ -294,19 +306,22 @@ bool output::start() {
 	// now create a thread for the checkEventsLoop loop
 	// and add it to ThreadBaseClass list of threads, so that ThreadBaseClass
 	// can monitor and manage it
-	m_WorkThreads.push_back(std::thread(&output::checkEventsLoop, this));
+	addWorkThread([this]() { checkEventsLoop(); });
 
-	// add to status map if we're tracking status
-	if (getHealthCheckInterval() > 0) {
-		// insert a new key into the health map for this thread
-		// to track status
-		m_ThreadHealthMap[m_WorkThreads.back().get_id()] = std::time(nullptr);
-	}
+	// periodic heartbeats and site list requests
+	startTimers();
 
 	// done
 	return (true);
 }
 
+// ---------------------------------------------------------stop
+bool output::stop() {
+	stopTimers();
+
+	return (ThreadBaseClass::stop());
+}
+
 // ---------------------------------------------------------healthCheck
 bool output::healthCheck() {
 	// don't check threadpool if it is not created yet
@@ -331,61 +346,44 @@ bool output::addTrackingData(std::shared_ptr<json::Object> data) {
 		return (false);
 	}
 
-	// get the id
-	std::string id = "";
-	if ((*data).HasKey(ID_KEY)) {
-		id = (*data)[ID_KEY].ToString();
-	} else if ((*data).HasKey(PID_KEY)) {
-		id = (*data)[PID_KEY].ToString();
-	} else {
+	// make sure we have an id
+	if ((!(*data).HasKey(ID_KEY)) && (!(*data).HasKey(PID_KEY))) {
 		glass3::util::Logger::log(
 				"error", "output::addtrackingdata(): No ID found data json.");
 		return (false);
 	}
 
-	// don't do anything if we didn't get an ID
-	if (id == "") {
+	// parse the tracking information
+	std::shared_ptr<trackingData> newData = std::make_shared<trackingData>();
+	if (newData->initialize(data) == false) {
 		glass3::util::Logger::log(
 				"error", "output::addtrackingdata(): Bad ID from data json.");
 		return (false);
 	}
+	std::string id = newData->getID();
 
 	// check to see if this event is already being tracked
-	std::shared_ptr<const json::Object> existingdata = m_TrackingCache
-			->getFromCache(id);
-	if (existingdata != NULL) {
-		// it is, copy the pub log for an existing event
-		if (!(*existingdata).HasKey(PUBLOG_KEY)) {
-			glass3::util::Logger::log(
-					"error",
-					"output::addtrackingdata(): existing event missing pub log! :"
-							+ json::Serialize(*existingdata));
-
-			return (false);
-		} else {
-			json::Array pubLog = (*existingdata)[PUBLOG_KEY].ToArray();
-			(*data)[PUBLOG_KEY] = pubLog;
-		}
+	auto existing = m_TrackingCache.find(id);
+	if (existing != m_TrackingCache.end()) {
+		// it is, keep the pub log for an existing event
+		existing->second->update(*newData);
+		newData = existing->second;
 	} else {
-		// it isn't generate the pub log for a new event
-		json::Array pubLog;
-
-		// for each pub time
-		for (auto pubTime : getPubTimes()) {
-			// generate a pub log entry
-			pubLog.push_back(0);
-		}
-		(*data)[PUBLOG_KEY] = pubLog;
+		// it isn't, generate the pub log for a new event
+		newData->getPubLog().assign(getPubTimes().size(), 0);
+		m_TrackingCache[id] = newData;
 	}
 
 	glass3::util::Logger::log(
 			"debug",
 			"output::addTrackingData(): New tracking data: "
-					+ json::Serialize(*data));
+					+ json::Serialize(*newData->toJSON()));
+
+	// schedule (or reschedule) the next publication check for this event
+	time_t tNow = glass3::util::Clock::now();
+	scheduleTrackingData(newData, tNow);
 
-	// addToCache (is really add_or_update_cache), so call it and it will ensure
-	// the data ends up properly in the cache
-	return (m_TrackingCache->addToCache(data, id));
+	return (true);
 }
 
 // ---------------------------------------------------------removeTrackingData
@@ -422,11 +420,10 @@ bool output::removeTrackingData(std::string ID) {
 		return (false);
 	}
 
-	if (m_TrackingCache->isInCache(ID) == true) {
-		return (m_TrackingCache->removeFromCache(ID));
-	} else {
-		return (false);
-	}
+	// stop checking this event for publication
+	m_PublicationTimerWheel.cancel(ID);
+
+	return (m_TrackingCache.erase(ID) > 0);
 }
 
 // ---------------------------------------------------------getTrackingData
@@ -438,27 +435,50 @@ std::shared_ptr<const json::Object> output::getTrackingData(std::string id) {
 		return (NULL);
 	}
 
+	auto data = m_TrackingCache.find(id);
+	if (data == m_TrackingCache.end()) {
+		return (NULL);
+	}
+
 	// return the value
-	return (m_TrackingCache->getFromCache(id));
+	return (data->second->toJSON());
 }
 
 // ---------------------------------------------------------getNextTrackingData
 std::shared_ptr<const json::Object> output::getNextTrackingData() {
 	std::lock_guard<std::mutex> guard(m_TrackingCacheMutex);
-	// get the first tracking data from the cache
-	std::shared_ptr<const json::Object> data =
-			m_TrackingCache->getNextFromCache(true);
 
-	// loop until we hit the end of the list
-	while (data != NULL) {
+	// what time is it now
+	time_t tNow = glass3::util::Clock::now();
+
+	// get the events that have come due since we last checked
+	if (m_DueTrackingIDs.empty() == true) {
+		std::vector<std::string> dueIDs = m_PublicationTimerWheel.advance(tNow);
+		m_DueTrackingIDs.insert(m_DueTrackingIDs.end(), dueIDs.begin(),
+								dueIDs.end());
+	}
+
+	// check each due event until we find one to release
+	while (m_DueTrackingIDs.empty() == false) {
+		std::string id = m_DueTrackingIDs.front();
+		m_DueTrackingIDs.pop_front();
+
+		// it may have been removed since it came due
+		auto data = m_TrackingCache.find(id);
+		if (data == m_TrackingCache.end()) {
+			continue;
+		}
+
 		// check to see if we can release the data we just got
-		if (isDataReady(data) == true) {
+		bool ready = isDataReady(data->second, tNow);
+
+		// schedule the next check for this event
+		scheduleTrackingData(data->second, tNow);
+
+		if (ready == true) {
 			// return the value
-			return (data);
+			return (data->second->toJSON());
 		}
-
-		// get the next tracking data from the cache
-		data = m_TrackingCache->getNextFromCache(false);
 	}
 
 	// if we found nothing that we can send out, we're done
@@ -498,13 +518,15 @@ bool output::haveTrackingData(std::string ID) {
 		return (false);
 	}
 
-	return (m_TrackingCache->isInCache(ID));
+	return (m_TrackingCache.find(ID) != m_TrackingCache.end());
 }
 
 // ---------------------------------------------------------clearTrackingData
 void output::clearTrackingData() {
 	std::lock_guard<std::mutex> guard(m_TrackingCacheMutex);
-	m_TrackingCache->clear();
+	m_TrackingCache.clear();
+	m_PublicationTimerWheel.clear();
+	m_DueTrackingIDs.clear();
 }
 
 // ---------------------------------------------------------checkEventsLoop
@@ -609,39 +631,6 @@ void output::checkEventsLoop() {
 
 // ---------------------------------------------------------work
 glass3::util::WorkState output::work() {
-	// request current stationlist
-	if (getSiteListRequestInterval() > 0) {
-		// what time is it
-		time_t tNowRequest;
-		std::time(&tNowRequest);
-
-		// every interval
-		if ((tNowRequest - m_tLastSiteRequest)
-				>= getSiteListRequestInterval()) {
-			// Request the sitelist from associator
-			if (getAssociator() != NULL) {
-				// build the ReqSiteList Message, which is defined at
-				// https://github.com/usg/neic-glass3/blob/code-review/doc/internal-formats/ReqSiteList.md  // NOLINT
-				std::shared_ptr<json::Object> datarequest = std::make_shared<
-						json::Object>(json::Object());
-				(*datarequest)[CMD_KEY] = "ReqSiteList";
-
-				glass3::util::Logger::log(
-						"debug", "output::work(): Requesting site list.");
-
-				// send the request to glasscore
-				getAssociator()->sendToAssociator(datarequest);
-			}
-
-			// this is now the last time we wrote
-			m_tLastSiteRequest = tNowRequest;
-		}
-	}
-
-	// send any optional hearbeat messages (implementation specific via
-	// overriding sendHeartbeat)
-	m_ThreadPool->addJob(std::bind(&output::sendHeartbeat, this));
-
 	// null check
 	if ((m_OutputQueue == NULL) || (m_LookupQueue == NULL)) {
 		// no message queues means we've got big problems
@@ -651,6 +640,13 @@ glass3::util::WorkState output::work() {
 		return (glass3::util::WorkState::Error);
 	}
 
+	// send any optional hearbeat messages (implementation specific via
+	// overriding sendHeartbeat) here rather than on the timer thread, since
+	// they may block
+	if (m_bHeartbeatDue.exchange(false) == true) {
+		sendHeartbeat();
+	}
+
 	// first see what we're supposed to do with a new message
 	// see if there's an output in the message queue
 	std::shared_ptr<json::Object> message = m_OutputQueue->getDataFromQueue();
@@ -914,12 +910,56 @@ void output::writeOutput(std::shared_ptr<json::Object> data) {
 	std::string agency = getDefaultAgencyId();
 	std::string author = getDefaultAuthor();
 
+	static glass3::util::LatencyHistogram &writeHistogram =
+			glass3::util::MetricsRegistry::getInstance().getHistogram(
+					"output.write_us");
+	static std::atomic<int64_t> &detectionCounter =
+			glass3::util::MetricsRegistry::getInstance().getCounter(
+					"output.detections");
+	static std::atomic<int64_t> &retractionCounter =
+			glass3::util::MetricsRegistry::getInstance().getCounter(
+					"output.retractions");
+	std::chrono::steady_clock::time_point tWriteStart =
+			std::chrono::steady_clock::now();
+
 	if (dataType == "Hypo") {
 		// convert a hypo to a detection
 		std::string detectionString = glass3::parse::hypoToJSONDetection(
 				data, agency, author);
 
-		sendOutput("Detection", ID, detectionString);
+		// pass the location along with the detection so that it can be routed
+		// without parsing the detection again
+		double latitude = std::numeric_limits<double>::quiet_NaN();
+		double longitude = std::numeric_limits<double>::quiet_NaN();
+		if ((data->HasKey(LATITUDE_KEY)) && (data->HasKey(LONGITUDE_KEY))) {
+			latitude = (*data)[LATITUDE_KEY].ToDouble();
+			longitude = (*data)[LONGITUDE_KEY].ToDouble();
+		}
+
+		sendOutput("Detection", ID, latitude, longitude, detectionString);
+		detectionCounter++;
+
+		// the picks in the detection have been published, only the first
+		// publication of each pick is traced
+		if ((glass3::util::LatencyTracer::getEnabled() == true)
+				&& (data->HasKey(DATA_KEY))
+				&& ((*data)[DATA_KEY].GetType() == json::ValueType::ArrayVal)) {
+			const json::Array &pickData = (*data)[DATA_KEY].AsArray();
+			for (const json::Value &pick : pickData) {
+				if (pick.GetType() != json::ValueType::ObjectVal) {
+					continue;
+				}
+				const json::Object &pickObject = pick.AsObject();
+				std::string pickID = "";
+				if (pickObject.HasKey(ID_KEY)) {
+					pickID = pickObject[ID_KEY].ToString();
+				} else if (pickObject.HasKey(PID_KEY)) {
+					pickID = pickObject[PID_KEY].ToString();
+				}
+				glass3::util::LatencyTracer::getInstance().mark(
+						pickID, glass3::util::LatencyTracer::Publish);
+			}
+		}
 	} else if (dataType == "Cancel") {
 		// convert a cancel to a retract
 		std::string retractString = glass3::parse::cancelToJSONRetract(data,
@@ -927,6 +967,7 @@ void output::writeOutput(std::shared_ptr<json::Object> data) {
 																		author);
 
 		sendOutput("Retraction", ID, retractString);
+		retractionCounter++;
 	} else if (dataType == "SiteLookup") {
 		// convert a site lookup to a station info request
 		std::string stationInfoRequestString =
@@ -943,6 +984,18 @@ void output::writeOutput(std::shared_ptr<json::Object> data) {
 	} else {
 		return;
 	}
+
+	writeHistogram.record(
+			std::chrono::duration_cast<std::chrono::microseconds>(
+					std::chrono::steady_clock::now() - tWriteStart).count());
+}
+
+// ---------------------------------------------------------sendOutput
+void output::sendOutput(const std::string &type, const std::string &id,
+						double latitude, double longitude,
+						const std::string &message) {
+	// by default the routing information is not used
+	sendOutput(type, id, message);
 }
 
 // ---------------------------------------------------------isDataReady
@@ -970,44 +1023,36 @@ bool output::isDataReady(std::shared_ptr<const json::Object> data) {
 		return (false);
 	}
 
-	// get the id
-	std::string id = "";
-	if ((*data).HasKey(ID_KEY)) {
-		id = (*data)[ID_KEY].ToString();
-	} else if ((*data).HasKey(PID_KEY)) {
-		id = (*data)[PID_KEY].ToString();
-	} else {
-		id = "";
-	}
-
-	// get the time the hypo was created
-	std::string createTimeString = (*data)["CreateTime"].ToString();
-	int createTime = glass3::util::Date::convertISO8601ToEpochTime(
-			createTimeString);
+	// evaluate a copy of the given data, so that neither the tracking cache
+	// nor the publication schedule is changed
+	std::shared_ptr<trackingData> checkData = std::make_shared<trackingData>(
+			data);
 
-	// get the pub log
-	json::Array pubLog = (*data)[PUBLOG_KEY].ToArray();
+	return (isDataReady(checkData, glass3::util::Clock::now()));
+}
 
-	// get the current version
-	int currentVersion = (*data)[VERSION_KEY].ToInt();
+// ---------------------------------------------------------isDataReady
+bool output::isDataReady(std::shared_ptr<trackingData> data, time_t tNow) {
+	if (data == NULL) {
+		return (false);
+	}
 
-	// what time is it now
-	time_t tNow;
-	std::time(&tNow);
+	const std::string &id = data->getID();
+	std::vector<int> &pubLog = data->getPubLog();
+	int currentVersion = data->getVersion();
+	int createTime = data->getCreateTime();
+	std::vector<int> pubTimes = getPubTimes();
 
 	// handle immediate publication if required
 	// this should only ever be a first pub
 	if (getImmediatePubThreshold() > 0.0) {
 		// don't bother with this if we've already been
 		// published
-		if (isDataPublished(data) == false) {
+		if (data->isPublished() == false) {
 			// get the bayes value
-			double currentBayes = (*data)[BAYES_KEY].ToDouble();
+			double currentBayes = data->getBayes();
 
 			// does the bayes value exceed the threshold
-			// and have we exceeded the minimum pub time?
-			// if ((currentBayes >= getImmediatePubThreshold()) &&
-			// (tNow >= (createTime + output::k_iMinimumPublicationTime))) {
 			if (currentBayes >= getImmediatePubThreshold()) {
 				// it does,
 				// log what we're doing
@@ -1021,17 +1066,8 @@ bool output::isDataReady(std::shared_ptr<const json::Object> data) {
 							+ std::to_string(getImmediatePubThreshold()));
 
 				// insert a pub record at the beginning
-				// of the pub log, and update tracking
-				std::shared_ptr<json::Object> newData =
-						std::make_shared<json::Object>(*data);
-				pubLog.insert(0, currentVersion);
-				(*newData)[PUBLOG_KEY] = pubLog;
-				m_TrackingCache->addToCache(newData, id);
-
-				glass3::util::Logger::log(
-				"debug",
-				"output::isDataReady(): Updated data after immediate pub: "
-						+ json::Serialize(*m_TrackingCache->getFromCache(id)));
+				// of the pub log
+				pubLog.insert(pubLog.begin(), currentVersion);
 
 				// yes this is publishable
 				return(true);
@@ -1040,24 +1076,30 @@ bool output::isDataReady(std::shared_ptr<const json::Object> data) {
 	}
 
 	// has this hypo changed?
-	bool changed = isDataChanged(data);
+	bool changed = data->isChanged();
 
 	// for each publication time
-	for (int timeIndex = 0; timeIndex < getPubTimes().size(); timeIndex++) {
+	for (int timeIndex = 0; timeIndex < pubTimes.size(); timeIndex++) {
 		// need to adjust if an immediate pub occured
 		// by default the log index is the same as the time index
 		int logIndex = timeIndex;
-		if (pubLog.size() > getPubTimes().size()) {
+		if (pubLog.size() > pubTimes.size()) {
 			// if we had an immediate pub, then the log indexis one past
 			// what the time index would be
 			logIndex = timeIndex + 1;
 		}
 
+		// the publication times may have been reconfigured since this
+		// data was tracked
+		if (logIndex >= pubLog.size()) {
+			break;
+		}
+
 		// get the published version (if any) for this pub time
-		int pubVersion = pubLog[logIndex].ToInt();
+		int pubVersion = pubLog[logIndex];
 
 		// get the corrsponding publish time
-		int pubTime = getPubTimes()[timeIndex];
+		int pubTime = pubTimes[timeIndex];
 
 		// has this pub time been published?
 		if (pubVersion > 0) {
@@ -1072,13 +1114,7 @@ bool output::isDataReady(std::shared_ptr<const json::Object> data) {
 		}
 
 		// update pubLog for this time
-		std::shared_ptr<json::Object> newData = std::make_shared<json::Object>(
-				*data);
 		pubLog[logIndex] = currentVersion;
-		(*newData)[PUBLOG_KEY] = pubLog;
-
-		// update data in cache
-		m_TrackingCache->addToCache(newData, id);
 
 		// depending on whether this version has already been changed
 		if (changed == true) {
@@ -1095,11 +1131,6 @@ bool output::isDataReady(std::shared_ptr<const json::Object> data) {
 							+ " getPubTimes()[i]: "
 							+ std::to_string(pubTime) + ")");
 
-			glass3::util::Logger::log(
-				"debug",
-				"output::isDataReady(): Updated data after pub: "
-						+ json::Serialize(*m_TrackingCache->getFromCache(id)));
-
 			// ready to publish
 			return (true);
 		} else {
@@ -1110,11 +1141,6 @@ bool output::isDataReady(std::shared_ptr<const json::Object> data) {
 							+ " version: " + std::to_string(currentVersion)
 							+ "; because the version has not changed since the last pub.");
 
-			glass3::util::Logger::log(
-				"debug",
-				"output::isDataReady(): Updated data after skip: "
-						+ json::Serialize(*m_TrackingCache->getFromCache(id)));
-
 			// already published, don't publish
 			return (false);
 		}
@@ -1124,6 +1150,54 @@ bool output::isDataReady(std::shared_ptr<const json::Object> data) {
 	return (false);
 }
 
+// ---------------------------------------------------------scheduleTrackingData
+void output::scheduleTrackingData(std::shared_ptr<trackingData> data,
+									time_t tNow) {
+	if (data == NULL) {
+		return;
+	}
+
+	const std::vector<int> &pubLog = data->getPubLog();
+	std::vector<int> pubTimes = getPubTimes();
+
+	// an immediate publication is due now
+	if ((getImmediatePubThreshold() > 0.0) && (data->isPublished() == false)
+			&& (data->getBayes() >= getImmediatePubThreshold())) {
+		m_PublicationTimerWheel.schedule(data->getID(), tNow);
+		return;
+	}
+
+	// otherwise find the earliest unpublished publication time
+	int64_t nextTime = -1;
+	for (int timeIndex = 0; timeIndex < pubTimes.size(); timeIndex++) {
+		int logIndex = timeIndex;
+		if (pubLog.size() > pubTimes.size()) {
+			logIndex = timeIndex + 1;
+		}
+		if (logIndex >= pubLog.size()) {
+			break;
+		}
+
+		// already published
+		if (pubLog[logIndex] > 0) {
+			continue;
+		}
+
+		int64_t pubTime = static_cast<int64_t>(data->getCreateTime())
+				+ pubTimes[timeIndex];
+		if ((nextTime < 0) || (pubTime < nextTime)) {
+			nextTime = pubTime;
+		}
+	}
+
+	if (nextTime < 0) {
+		// no more publications for this data
+		m_PublicationTimerWheel.cancel(data->getID());
+	} else {
+		m_PublicationTimerWheel.schedule(data->getID(), nextTime);
+	}
+}
+
 // ---------------------------------------------------------isDataChanged
 bool output::isDataChanged(std::shared_ptr<const json::Object> data) {
 	if (data == NULL) {
@@ -1148,26 +1222,7 @@ bool output::isDataChanged(std::shared_ptr<const json::Object> data) {
 		return (false);
 	}
 
-	// get the pub log
-	json::Array pubLog = (*data)[PUBLOG_KEY].ToArray();
-
-	// get the current version
-	int currentVersion = (*data)[VERSION_KEY].ToInt();
-
-	// for each entry in the pub log
-	for (int i = 0; i < pubLog.size(); i++) {
-		// get the published version for this log entry
-		int pubVersion = pubLog[i].ToInt();
-
-		// has the current version been published?
-		if (pubVersion == currentVersion) {
-			// yes, no change
-			return (false);
-		}
-	}
-
-	// it's changed.
-	return (true);
+	return (trackingData(data).isChanged());
 }
 
 // ---------------------------------------------------------isDataPublished
@@ -1190,36 +1245,7 @@ bool output::isDataPublished(std::shared_ptr<const json::Object> data,
 		return (false);
 	}
 
-	// get the pub log
-	json::Array pubLog = (*data)[PUBLOG_KEY].ToArray();
-	int currentVersion = (*data)[VERSION_KEY].ToInt();
-
-	// for each entry in the pub log
-	for (int i = 0; i < pubLog.size(); i++) {
-		// get whether this one was  published
-		int pubVersion = pubLog[i].ToInt();
-
-		// pub version less than 1 means not published
-		if (pubVersion < 1) {
-			continue;
-		}
-
-		// check to see if the published version is the current
-		// version.
-		// if we're writing a detection, and we want to know if an event is new
-		//   or an update, we care about this
-		// if we're writing a retraction, we don't care about this
-		if ((ignoreVersion == false) && (pubVersion == currentVersion)) {
-			// we don't count our current version as published
-			continue;
-		}
-
-		// published
-		return (true);
-	}
-
-	// not published
-	return (false);
+	return (trackingData(data).isPublished(ignoreVersion));
 }
 
 // ---------------------------------------------------------isDataFinished
@@ -1241,33 +1267,94 @@ bool output::isDataFinished(std::shared_ptr<const json::Object> data) {
 		return (false);
 	}
 
-	// get the pub log
-	json::Array pubLog = (*data)[PUBLOG_KEY].ToArray();
+	return (trackingData(data).isFinished());
+}
 
-	// for each entry in the pub log
-	for (int i = 0; i < pubLog.size(); i++) {
-		// get whether this one was published
-		int pubVersion = pubLog[i].ToInt();
+// ---------------------------------------------------------sendHeartbeat
+void output::sendHeartbeat() {
+}
 
-		// pub version less than 1 means not published
-		// which means not finished
-		if (pubVersion < 1) {
-			return (false);
-		}
+// ---------------------------------------------------------heartbeatDue
+void output::heartbeatDue() {
+	m_bHeartbeatDue = true;
+}
+
+// ---------------------------------------------------------requestSiteList
+void output::requestSiteList() {
+	// Request the sitelist from associator
+	if (getAssociator() != NULL) {
+		// build the ReqSiteList Message, which is defined at
+		// https://github.com/usg/neic-glass3/blob/code-review/doc/internal-formats/ReqSiteList.md  // NOLINT
+		std::shared_ptr<json::Object> datarequest = std::make_shared<
+				json::Object>(json::Object());
+		(*datarequest)[CMD_KEY] = "ReqSiteList";
+
+		glass3::util::Logger::log(
+				"debug", "output::requestSiteList(): Requesting site list.");
+
+		// send the request to glasscore
+		getAssociator()->sendToAssociator(datarequest);
 	}
+}
 
-	// all pub log entries were greater than 0,
-	// so event was finished
-	return (true);
+// ---------------------------------------------------------startTimers
+void output::startTimers() {
+	std::lock_guard<std::mutex> guard(m_TimerMutex);
+	glass3::util::TimerService &timerService =
+			glass3::util::TimerService::getInstance();
+
+	// periodically have the work thread send any optional hearbeat messages
+	if (m_iHeartbeatTimerID < 0) {
+		m_iHeartbeatTimerID = timerService.addTimer(
+				getThreadName() + " heartbeat", k_iHeartbeatIntervalMS,
+				std::bind(&output::heartbeatDue, this));
+	}
+
+	// request current stationlist every interval, measured in the same
+	// (possibly simulated) time as the data
+	if ((m_iSiteListTimerID < 0) && (getSiteListRequestInterval() > 0)) {
+		m_iSiteListTimerID = timerService.addTimer(
+				getThreadName() + " site list request",
+				getSiteListRequestInterval() * 1000,
+				std::bind(&output::requestSiteList, this), true);
+	}
 }
 
-// ---------------------------------------------------------sendHeartbeat
-void output::sendHeartbeat() {
+// ---------------------------------------------------------stopTimers
+void output::stopTimers() {
+	std::lock_guard<std::mutex> guard(m_TimerMutex);
+
+	if (m_iHeartbeatTimerID >= 0) {
+		glass3::util::TimerService::getInstance().removeTimer(
+				m_iHeartbeatTimerID);
+		m_iHeartbeatTimerID = -1;
+	}
+
+	if (m_iSiteListTimerID >= 0) {
+		glass3::util::TimerService::getInstance().removeTimer(
+				m_iSiteListTimerID);
+		m_iSiteListTimerID = -1;
+	}
 }
 
 // ---------------------------------------------------------setSiteListRequestInterval
 void output::setSiteListRequestInterval(int delay) {
 	m_iSiteListRequestInterval = delay;
+
+	// restart the site list request timer with the new interval if the
+	// timers are running
+	std::lock_guard<std::mutex> guard(m_TimerMutex);
+	if (m_iSiteListTimerID >= 0) {
+		glass3::util::TimerService::getInstance().removeTimer(
+				m_iSiteListTimerID);
+		m_iSiteListTimerID = -1;
+	}
+
+	if ((m_iHeartbeatTimerID >= 0) && (delay > 0)) {
+		m_iSiteListTimerID = glass3::util::TimerService::getInstance().addTimer(
+				getThreadName() + " site list request", delay * 1000,
+				std::bind(&output::requestSiteList, this), true);
+	}
 }
 
 // ---------------------------------------------------------getSiteListRequestInterval
@@ -0,0 +1,226 @@
+#include <trackingdata.h>
+#include <json.h>
+#include <date.h>
+
+#include <string>
+#include <vector>
+#include <memory>
+
+// JSON Keys
+#define CMD_KEY "Cmd"
+#define ID_KEY "ID"
+#define PID_KEY "Pid"
+#define PUBLOG_KEY "PubLog"
+#define VERSION_KEY "Version"
+#define BAYES_KEY "Bayes"
+#define CREATETIME_KEY "CreateTime"
+
+namespace glass3 {
+namespace output {
+
+// ---------------------------------------------------------trackingData
+trackingData::trackingData() {
+	clear();
+}
+
+// ---------------------------------------------------------trackingData
+trackingData::trackingData(std::shared_ptr<const json::Object> data) {
+	initialize(data);
+}
+
+// ---------------------------------------------------------~trackingData
+trackingData::~trackingData() {
+}
+
+// ---------------------------------------------------------clear
+void trackingData::clear() {
+	m_sID = "";
+	m_sCommand = "";
+	m_iVersion = 0;
+	m_dBayes = 0;
+	m_iCreateTime = 0;
+	m_PubLog.clear();
+	m_Data = NULL;
+}
+
+// ---------------------------------------------------------initialize
+bool trackingData::initialize(std::shared_ptr<const json::Object> data) {
+	clear();
+
+	if (data == NULL) {
+		return (false);
+	}
+
+	// each key is looked up once, a missing key gives a NULL value
+	const json::Object &dataobj = *data;
+
+	// get the id
+	const json::Value &idValue = dataobj[ID_KEY];
+	if (idValue.GetType() != json::ValueType::NULLVal) {
+		m_sID = idValue.AsString();
+	} else {
+		const json::Value &pidValue = dataobj[PID_KEY];
+		if (pidValue.GetType() != json::ValueType::NULLVal) {
+			m_sID = pidValue.AsString();
+		}
+	}
+
+	const json::Value &cmdValue = dataobj[CMD_KEY];
+	if (cmdValue.GetType() != json::ValueType::NULLVal) {
+		m_sCommand = cmdValue.AsString();
+	}
+	const json::Value &versionValue = dataobj[VERSION_KEY];
+	if (versionValue.GetType() != json::ValueType::NULLVal) {
+		m_iVersion = versionValue.ToInt();
+	}
+	const json::Value &bayesValue = dataobj[BAYES_KEY];
+	if (bayesValue.GetType() != json::ValueType::NULLVal) {
+		m_dBayes = bayesValue.ToDouble();
+	}
+
+	// parse the create time once, here, rather than on every check
+	const json::Value &createTimeValue = dataobj[CREATETIME_KEY];
+	if (createTimeValue.GetType() != json::ValueType::NULLVal) {
+		m_iCreateTime = glass3::util::Date::convertISO8601ToEpochTime(
+				createTimeValue.AsString());
+	}
+
+	// use the existing pub log if there is one
+	const json::Value &pubLogValue = dataobj[PUBLOG_KEY];
+	if (pubLogValue.GetType() != json::ValueType::NULLVal) {
+		const json::Array &pubLog = pubLogValue.AsArray();
+		for (int i = 0; i < pubLog.size(); i++) {
+			m_PubLog.push_back(pubLog[i].ToInt());
+		}
+	}
+
+	m_Data = data;
+
+	return (m_sID != "");
+}
+
+// ---------------------------------------------------------update
+void trackingData::update(const trackingData &newData) {
+	m_sCommand = newData.m_sCommand;
+	m_iVersion = newData.m_iVersion;
+	m_dBayes = newData.m_dBayes;
+	m_iCreateTime = newData.m_iCreateTime;
+	m_Data = newData.m_Data;
+}
+
+// ---------------------------------------------------------isChanged
+bool trackingData::isChanged() const {
+	// for each entry in the pub log
+	for (auto pubVersion : m_PubLog) {
+		// has the current version been published?
+		if (pubVersion == m_iVersion) {
+			// yes, no change
+			return (false);
+		}
+	}
+
+	// it's changed.
+	return (true);
+}
+
+// ---------------------------------------------------------isPublished
+bool trackingData::isPublished(bool ignoreVersion) const {
+	// for each entry in the pub log
+	for (auto pubVersion : m_PubLog) {
+		// pub version less than 1 means not published
+		if (pubVersion < 1) {
+			continue;
+		}
+
+		// check to see if the published version is the current
+		// version.
+		// if we're writing a detection, and we want to know if an event is new
+		//   or an update, we care about this
+		// if we're writing a retraction, we don't care about this
+		if ((ignoreVersion == false) && (pubVersion == m_iVersion)) {
+			// we don't count our current version as published
+			continue;
+		}
+
+		// published
+		return (true);
+	}
+
+	// not published
+	return (false);
+}
+
+// ---------------------------------------------------------isFinished
+bool trackingData::isFinished() const {
+	// for each entry in the pub log
+	for (auto pubVersion : m_PubLog) {
+		// pub version less than 1 means not published
+		// which means not finished
+		if (pubVersion < 1) {
+			return (false);
+		}
+	}
+
+	// all pub log entries were greater than 0,
+	// so event was finished
+	return (true);
+}
+
+// ---------------------------------------------------------toJSON
+std::shared_ptr<json::Object> trackingData::toJSON() const {
+	std::shared_ptr<json::Object> data;
+	if (m_Data != NULL) {
+		data = std::make_shared<json::Object>(*m_Data);
+	} else {
+		data = std::make_shared<json::Object>(json::Object());
+		(*data)[ID_KEY] = m_sID;
+		(*data)[CMD_KEY] = m_sCommand;
+		(*data)[VERSION_KEY] = m_iVersion;
+		(*data)[BAYES_KEY] = m_dBayes;
+	}
+
+	json::Array pubLog;
+	for (auto pubVersion : m_PubLog) {
+		pubLog.push_back(pubVersion);
+	}
+	(*data)[PUBLOG_KEY] = pubLog;
+
+	return (data);
+}
+
+// ---------------------------------------------------------getID
+const std::string & trackingData::getID() const {
+	return (m_sID);
+}
+
+// ---------------------------------------------------------getCommand
+const std::string & trackingData::getCommand() const {
+	return (m_sCommand);
+}
+
+// ---------------------------------------------------------getVersion
+int trackingData::getVersion() const {
+	return (m_iVersion);
+}
+
+// ---------------------------------------------------------getBayes
+double trackingData::getBayes() const {
+	return (m_dBayes);
+}
+
+// ---------------------------------------------------------getCreateTime
+int trackingData::getCreateTime() const {
+	return (m_iCreateTime);
+}
+
+// ---------------------------------------------------------getPubLog
+std::vector<int> & trackingData::getPubLog() {
+	return (m_PubLog);
+}
+
+// ---------------------------------------------------------getPubLog
+const std::vector<int> & trackingData::getPubLog() const {
+	return (m_PubLog);
+}
+}  // namespace output
+}  // namespace glass3
@@ -484,6 +484,59 @@ TEST(Output, TrackingTests) {
 	outputThread.stop();
 }
 
+TEST(Output, ReadyTests) {
+	// create output stub
+	OutputStub outputThread;
+
+	time_t tNow;
+	std::time(&tNow);
+
+	// configure output
+	glass3::util::Config * OutputConfig = new glass3::util::Config(
+			std::string(TESTPATH), std::string(CONFIGFILENAME));
+	std::shared_ptr<const json::Object> OutputJSON = OutputConfig->getJSON();
+
+	// setup
+	ASSERT_TRUE(outputThread.setup(OutputJSON))<< "output config is successful";
+
+	// tracking data past its first publication time
+	std::shared_ptr<json::Object> tracking = std::make_shared<json::Object>(
+			json::Object(json::Deserialize(TRACKING2)));
+	(*tracking)["CreateTime"] = glass3::util::Date::convertEpochTimeToISO8601(
+			tNow - 10);
+	json::Array pubLog;
+	pubLog.push_back(0);
+	pubLog.push_back(0);
+	(*tracking)["PubLog"] = pubLog;
+
+	// data that isn't tracked can be checked, and isn't tracked by checking
+	ASSERT_TRUE(outputThread.isDataReady(tracking))<< "untracked ready";
+	ASSERT_FALSE(outputThread.haveTrackingData(std::string(ID1)))
+	<< "untracked still not tracked";
+
+	// data before its first publication time is not ready
+	std::shared_ptr<json::Object> early = std::make_shared<json::Object>(
+			*tracking);
+	(*early)["CreateTime"] = glass3::util::Date::convertEpochTimeToISO8601(
+			tNow + 100);
+	ASSERT_FALSE(outputThread.isDataReady(early))<< "early not ready";
+
+	// checking tracked data does not change its publication log
+	ASSERT_TRUE(outputThread.addTrackingData(tracking));
+	std::shared_ptr<const json::Object> tracked = outputThread.getTrackingData(
+			std::string(ID1));
+	ASSERT_TRUE(outputThread.isDataReady(tracked))<< "tracked ready";
+	ASSERT_TRUE(outputThread.isDataReady(tracked))<< "tracked still ready";
+
+	tracked = outputThread.getTrackingData(std::string(ID1));
+	json::Array trackedPubLog = (*tracked)["PubLog"].ToArray();
+	ASSERT_EQ(0, trackedPubLog[0].ToInt())<< "first pub not logged";
+	ASSERT_EQ(0, trackedPubLog[1].ToInt())<< "second pub not logged";
+
+	outputThread.clearTrackingData();
+	outputThread.stop();
+}
+
 TEST(Output, OutputTest) {
 	// glass3::util::log_init("outputtest", spdlog::level::debug,
 	// std::string(TESTPATH), true);
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <trackingdata.h>
+#include <json.h>
+#include <date.h>
+
+#include <string>
+#include <memory>
+#include <vector>
+
+#define TRACKINGSTRING "{\"Cmd\":\"Event\",\"ID\":\"TESTID\",\"Version\":2,\"Bayes\":5.5,\"CreateTime\":\"2015-08-14T03:35:25.947Z\",\"PubLog\":[1,0]}"  // NOLINT
+#define UPDATESTRING "{\"Cmd\":\"Event\",\"ID\":\"TESTID\",\"Version\":3,\"Bayes\":7.5,\"CreateTime\":\"2015-08-14T03:36:25.947Z\"}"  // NOLINT
+#define NOIDSTRING "{\"Cmd\":\"Event\",\"Version\":2}"
+#define TESTID "TESTID"
+#define TESTCMD "Event"
+#define TESTVERSION 2
+#define TESTBAYES 5.5
+#define TESTCREATETIME "2015-08-14T03:35:25.947Z"
+
+// tests to see if the tracking data constructs and initializes correctly
+TEST(TrackingDataTest, Construction) {
+	glass3::output::trackingData emptyData;
+	ASSERT_STREQ(emptyData.getID().c_str(), "")<< "empty id";
+	ASSERT_EQ(emptyData.getVersion(), 0)<< "empty version";
+	ASSERT_EQ(static_cast<int>(emptyData.getPubLog().size()), 0)
+	<< "empty pub log";
+
+	std::shared_ptr<const json::Object> data = std::make_shared<json::Object>(
+			json::Deserialize(std::string(TRACKINGSTRING)));
+	glass3::output::trackingData testData(data);
+
+	ASSERT_STREQ(testData.getID().c_str(), TESTID)<< "id";
+	ASSERT_STREQ(testData.getCommand().c_str(), TESTCMD)<< "cmd";
+	ASSERT_EQ(testData.getVersion(), TESTVERSION)<< "version";
+	ASSERT_DOUBLE_EQ(testData.getBayes(), TESTBAYES)<< "bayes";
+	ASSERT_EQ(testData.getCreateTime(),
+			static_cast<int>(glass3::util::Date::convertISO8601ToEpochTime(
+					TESTCREATETIME)))<< "create time";
+	ASSERT_EQ(static_cast<int>(testData.getPubLog().size()), 2)<< "pub log";
+	ASSERT_EQ(testData.getPubLog()[0], 1)<< "pub log 0";
+	ASSERT_EQ(testData.getPubLog()[1], 0)<< "pub log 1";
+
+	// no id
+	glass3::output::trackingData noIDData;
+	ASSERT_FALSE(noIDData.initialize(std::make_shared<json::Object>(
+			json::Deserialize(std::string(NOIDSTRING)))))<< "no id";
+	ASSERT_FALSE(noIDData.initialize(NULL))<< "null data";
+}
+
+// tests to see if the tracking data state checks work
+TEST(TrackingDataTest, StateTest) {
+	std::shared_ptr<const json::Object> data = std::make_shared<json::Object>(
+			json::Deserialize(std::string(TRACKINGSTRING)));
+	glass3::output::trackingData testData(data);
+
+	// version 1 published, current version 2 not
+	ASSERT_TRUE(testData.isChanged())<< "changed";
+	ASSERT_TRUE(testData.isPublished())<< "published";
+	ASSERT_TRUE(testData.isPublished(false))<< "published, not ignoring version";
+	ASSERT_FALSE(testData.isFinished())<< "not finished";
+
+	// publish the current version
+	testData.getPubLog()[1] = TESTVERSION;
+	ASSERT_FALSE(testData.isChanged())<< "not changed";
+	ASSERT_TRUE(testData.isFinished())<< "finished";
+
+	// only the current version published
+	testData.getPubLog()[0] = 0;
+	ASSERT_TRUE(testData.isPublished())<< "published, ignoring version";
+	ASSERT_FALSE(testData.isPublished(false))<< "not published, not ignoring "
+	"version";
+}
+
+// tests to see if the tracking data updates and converts to json
+TEST(TrackingDataTest, UpdateTest) {
+	std::shared_ptr<const json::Object> data = std::make_shared<json::Object>(
+			json::Deserialize(std::string(TRACKINGSTRING)));
+	glass3::output::trackingData testData(data);
+
+	std::shared_ptr<const json::Object> updateData =
+			std::make_shared<json::Object>(
+					json::Deserialize(std::string(UPDATESTRING)));
+	testData.update(glass3::output::trackingData(updateData));
+
+	ASSERT_EQ(testData.getVersion(), 3)<< "updated version";
+	ASSERT_DOUBLE_EQ(testData.getBayes(), 7.5)<< "updated bayes";
+	ASSERT_EQ(static_cast<int>(testData.getPubLog().size()), 2)
+	<< "kept pub log";
+	ASSERT_EQ(testData.getPubLog()[0], 1)<< "kept pub log 0";
+
+	std::shared_ptr<json::Object> jsonData = testData.toJSON();
+	ASSERT_TRUE(jsonData->HasKey("PubLog"))<< "json has pub log";
+	ASSERT_EQ((*jsonData)["Version"].ToInt(), 3)<< "json version";
+	json::Array pubLog = (*jsonData)["PubLog"].ToArray();
+	ASSERT_EQ(static_cast<int>(pubLog.size()), 2)<< "json pub log size";
+	ASSERT_EQ(pubLog[0].ToInt(), 1)<< "json pub log 0";
+}
@@ -1,6 +1,7 @@
 #include <convert.h>
 
 #include <date.h>
+#include <clock.h>
 
 #include <json.h>
 #include <logger.h>
@@ -74,8 +75,7 @@ std::string hypoToJSONDetection(std::shared_ptr<json::Object> data,
 			"hypoToJSONDetection(): data = |" + json::Serialize(*data) + "|.");
 
 	// what time is it now
-	time_t tNow;
-	std::time(&tNow);
+	time_t tNow = glass3::util::Clock::now();
 
 	std::string outputString = "";
 
@@ -13,9 +13,12 @@
 #include <outputinterface.h>
 #include <associatorinterface.h>
 #include <threadbaseclass.h>
+#include <timerservice.h>
 #include <queue.h>
+#include <chrono>
 #include <ctime>
 #include <memory>
+#include <mutex>
 
 namespace glass3 {
 
@@ -117,19 +120,43 @@ class Associator : public glasscore::IGlassSend,
 	 */
 	bool healthCheck() override;
 
+	/**
+	 * \brief get the time of input data
+	 *
+	 * Get the time of the provided input data, the arrival time for picks and
+	 * correlations, or the origin time for detections. Used to drive the
+	 * glass3::util::Clock when running in simulated time.
+	 *
+	 * \param data - A shared_ptr to a json::Object containing the input data
+	 * \return Returns a double containing the data time in epoch seconds, or
+	 * -1 if the data has no time (i.e. station data)
+	 */
+	static double getDataTime(std::shared_ptr<const json::Object> data);
+
  protected:
 	/**
 	 * \brief associator work function
 	 *
 	 * The function (from threadclassbase) used to do work. For Associator,
 	 * this includes sending configuration, messages, and input data to the
-	 * glasscore library
+	 * glasscore library, and advancing the glass3::util::Clock to the time of
+	 * the input data once glasscore has processed it when running in
+	 * simulated time (glasscore advances it for picks)
 	 *
 	 * \return returns true if work was successful, false otherwise.
 	 */
 	glass3::util::WorkState work() override;
 
  private:
+	/**
+	 * \brief associator performance report function
+	 *
+	 * The performance report timer callback, logs the pending input queue
+	 * size, data sent to glasscore, average glasscore processing time, data
+	 * per second and running average of data per second since the last report
+	 */
+	void reportPerformance();
+
 	/**
 	 * \brief Integer holding the count of input data sent to glasscore since
 	 * the last informational report.
@@ -171,6 +198,17 @@ class Associator : public glasscore::IGlassSend,
 	 */
 	int m_iReportInterval;
 
+	/**
+	 * \brief The id of the performance report timer
+	 */
+	int64_t m_iReportTimerID;
+
+	/**
+	 * \brief A mutex to control access to the performance counters shared
+	 * between the work thread and the performance report timer
+	 */
+	std::mutex m_PerformanceMutex;
+
 	/**
 	 * \brief The queue of pending messages to send to glasscore
 	 */
@@ -1,8 +1,16 @@
 #include <associator.h>
 #include <logger.h>
+#include <metricsregistry.h>
+#include <clock.h>
+#include <date.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <ctime>
+#include <functional>
 #include <string>
 #include <memory>
+#include <mutex>
 #include <Glass.h>
 #include <HypoList.h>
 #include <PickList.h>
@@ -39,10 +47,19 @@ Associator::Associator(glass3::util::iInput* inputint,
 
 	// clear / create object(s)
 	clear();
+
+	// generate periodic performance reports, on the wall clock since they
+	// monitor processing rather than the data
+	m_iReportTimerID = glass3::util::TimerService::getInstance().addTimer(
+			"Associator performance report", m_iReportInterval * 1000,
+			std::bind(&Associator::reportPerformance, this));
 }
 
 // ---------------------------------------------------------~Associator
 Associator::~Associator() {
+	// make sure no report runs once we're gone
+	glass3::util::TimerService::getInstance().removeTimer(m_iReportTimerID);
+
 	m_Input = NULL;
 	m_Output = NULL;
 
@@ -123,6 +140,34 @@ void Associator::sendToAssociator(std::shared_ptr<json::Object> &message) {
 	}
 }
 
+// ---------------------------------------------------------getDataTime
+double Associator::getDataTime(std::shared_ptr<const json::Object> data) {
+	if (data == NULL) {
+		return (-1);
+	}
+
+	std::string timeString = "";
+	if (data->HasKey("Time")
+			&& ((*data)["Time"].GetType() == json::ValueType::StringVal)) {
+		// picks and correlations
+		timeString = (*data)["Time"].ToString();
+	} else if (data->HasKey("Hypocenter")
+			&& ((*data)["Hypocenter"].GetType() == json::ValueType::ObjectVal)) {
+		// detections
+		json::Object hypocenter = (*data)["Hypocenter"].ToObject();
+		if (hypocenter.HasKey("Time")
+				&& (hypocenter["Time"].GetType() == json::ValueType::StringVal)) {
+			timeString = hypocenter["Time"].ToString();
+		}
+	}
+
+	if (timeString == "") {
+		return (-1);
+	}
+
+	return (glass3::util::Date::convertISO8601ToEpochTime(timeString));
+}
+
 // -----------------------------------------------------------------------work
 glass3::util::WorkState Associator::work() {
 	// nullchecks
@@ -142,9 +187,6 @@ glass3::util::WorkState Associator::work() {
 		glasscore::CGlass::receiveExternalMessage(message);
 	}
 
-	std::time_t tNow;
-	std::time(&tNow);
-
 	// now get the next input data from the input library,
 	// can be a pick, correlation, station, or detection
 	std::shared_ptr<json::Object> data = m_Input->getInputData();
@@ -160,81 +202,46 @@ glass3::util::WorkState Associator::work() {
 		std::chrono::high_resolution_clock::time_point tGlassEndTime =
 				std::chrono::high_resolution_clock::now();
 
-		m_iInputCounter++;
-
-		// keep track of the time we spent in glassland
-		tGlasscoreDuration += std::chrono::duration_cast<
-				std::chrono::duration<double>>(tGlassEndTime - tGlassStartTime);
-	}
-
-	// generate periodic performance reports, reporting our pending input
-	// queue size, data sent to glasscore, average glasscore processing time,
-	// data per second and running average of data per second
-	// this is used to monitor glasscore performance
-	if ((tNow - tLastPerformanceReport) >= m_iReportInterval) {
-		int pendingdata = m_Input->getInputDataCount();
-		double averageglasstime = tGlasscoreDuration.count() / m_iInputCounter;
-
-		if (m_iInputCounter == 0) {
-			glass3::util::Logger::log(
-					"warning",
-					"associator::work(): Sent NO data to glass in the last "
-							+ std::to_string(
-									static_cast<int>(tNow
-											- tLastPerformanceReport))
-							+ " seconds.");
-		} else {
-			int hypoListSize = 0;
-			int pickListSize = 0;
-			if (glasscore::CGlass::getHypoList()) {
-				hypoListSize = glasscore::CGlass::getHypoList()->length();
-			}
-			if (glasscore::CGlass::getPickList()) {
-				pickListSize = glasscore::CGlass::getPickList()->length();
+		// when replaying in simulated time, the data drives the clock, so
+		// that glass makes the same time based decisions it would have made
+		// when the data arrived live. The clock is advanced once glass has
+		// processed the data, picks are only queued here, so glasscore
+		// advances the clock itself as it processes each pick
+		if (glass3::util::Clock::isSimulated() == true) {
+			std::string dataType = "";
+			if (data->HasKey("Type")
+					&& ((*data)["Type"].GetType()
+							== json::ValueType::StringVal)) {
+				dataType = (*data)["Type"].ToString();
+			} else if (data->HasKey("Cmd")
+					&& ((*data)["Cmd"].GetType()
+							== json::ValueType::StringVal)) {
+				dataType = (*data)["Cmd"].ToString();
 			}
 
-			// update the total input count with the input count
-			// since the last report
-			m_iTotalInputCounter += m_iInputCounter;
-
-			// calculate data per second average since the last report
-			double dataAverage = static_cast<double>(m_iInputCounter)
-					/ static_cast<double>((tNow - tLastPerformanceReport));
-
-			// calculate running average of the data per second
-			m_iRunningAverageCounter++;
-			if (m_iRunningAverageCounter == 1) {
-				m_dRunningDPSAverage = dataAverage;
+			double dataTime = getDataTime(data);
+			if ((dataType != "Pick") && (dataTime > 0)) {
+				glass3::util::Clock::advanceSimulatedTime(dataTime);
 			}
-			m_dRunningDPSAverage = (m_dRunningDPSAverage
-					* (m_iRunningAverageCounter - 1) + dataAverage)
-					/ m_iRunningAverageCounter;
-
-			// log the report
-			glass3::util::Logger::log(
-					"info",
-					"Associator::work(): Sent "
-							+ std::to_string(m_iInputCounter)
-							+ " data to glasscore ("
-							+ std::to_string(pendingdata) + " in queue, "
-							+ std::to_string(m_iTotalInputCounter)
-							+ " total) in "
-							+ std::to_string(
-									static_cast<int>(tNow
-											- tLastPerformanceReport))
-							+ " seconds. (" + std::to_string(dataAverage)
-							+ " dps) (" + std::to_string(m_dRunningDPSAverage)
-							+ " avg dps) (" + std::to_string(averageglasstime)
-							+ " avg glass time) (" + "vPickSize: "
-							+ std::to_string(pickListSize) + " vHypoSize: "
-							+ std::to_string(hypoListSize) + ").");
 		}
 
-		// reset for next report
-		tLastPerformanceReport = tNow;
-		m_iInputCounter = 0;
-		tGlasscoreDuration = std::chrono::duration<double>::zero();
-	}  // end if it is time to generate a performance report
+		static std::atomic<int64_t> &dataCounter =
+				glass3::util::MetricsRegistry::getInstance().getCounter(
+						"associator.data");
+		static glass3::util::LatencyHistogram &glasscoreHistogram =
+				glass3::util::MetricsRegistry::getInstance().getHistogram(
+						"associator.glasscore_us");
+		dataCounter++;
+		glasscoreHistogram.record(
+				std::chrono::duration_cast<std::chrono::microseconds>(
+						tGlassEndTime - tGlassStartTime).count());
+
+		// keep track of the time we spent in glassland
+		std::lock_guard<std::mutex> guard(m_PerformanceMutex);
+		m_iInputCounter++;
+		tGlasscoreDuration += std::chrono::duration_cast<
+				std::chrono::duration<double>>(tGlassEndTime - tGlassStartTime);
+	}
 
 	// return idle if there was no data
 	if (data == NULL) {
@@ -247,6 +254,88 @@ glass3::util::WorkState Associator::work() {
 	return (glass3::util::WorkState::OK);
 }
 
+// ---------------------------------------------------------reportPerformance
+void Associator::reportPerformance() {
+	std::time_t tNow;
+	std::time(&tNow);
+
+	// take the counters since the last report, and reset them for the next
+	int inputCounter = 0;
+	double glasscoreDuration = 0;
+	{
+		std::lock_guard<std::mutex> guard(m_PerformanceMutex);
+		inputCounter = m_iInputCounter;
+		glasscoreDuration = tGlasscoreDuration.count();
+		m_iInputCounter = 0;
+		tGlasscoreDuration = std::chrono::duration<double>::zero();
+	}
+
+	int pendingdata = 0;
+	if (m_Input != NULL) {
+		pendingdata = m_Input->getInputDataCount();
+	}
+	double averageglasstime = glasscoreDuration / inputCounter;
+
+	if (inputCounter == 0) {
+		glass3::util::Logger::log(
+				"warning",
+				"associator::reportPerformance(): Sent NO data to glass in the "
+				"last "
+						+ std::to_string(
+								static_cast<int>(tNow
+										- tLastPerformanceReport))
+						+ " seconds.");
+	} else {
+		int hypoListSize = 0;
+		int pickListSize = 0;
+		if (glasscore::CGlass::getHypoList()) {
+			hypoListSize = glasscore::CGlass::getHypoList()->length();
+		}
+		if (glasscore::CGlass::getPickList()) {
+			pickListSize = glasscore::CGlass::getPickList()->length();
+		}
+
+		// update the total input count with the input count
+		// since the last report
+		m_iTotalInputCounter += inputCounter;
+
+		// calculate data per second average since the last report
+		double dataAverage = static_cast<double>(inputCounter)
+				/ static_cast<double>((tNow - tLastPerformanceReport));
+
+		// calculate running average of the data per second
+		m_iRunningAverageCounter++;
+		if (m_iRunningAverageCounter == 1) {
+			m_dRunningDPSAverage = dataAverage;
+		}
+		m_dRunningDPSAverage = (m_dRunningDPSAverage
+				* (m_iRunningAverageCounter - 1) + dataAverage)
+				/ m_iRunningAverageCounter;
+
+		// log the report
+		glass3::util::Logger::log(
+				"info",
+				"Associator::reportPerformance(): Sent "
+						+ std::to_string(inputCounter)
+						+ " data to glasscore ("
+						+ std::to_string(pendingdata) + " in queue, "
+						+ std::to_string(m_iTotalInputCounter)
+						+ " total) in "
+						+ std::to_string(
+								static_cast<int>(tNow
+										- tLastPerformanceReport))
+						+ " seconds. (" + std::to_string(dataAverage)
+						+ " dps) (" + std::to_string(m_dRunningDPSAverage)
+						+ " avg dps) (" + std::to_string(averageglasstime)
+						+ " avg glass time) (" + "vPickSize: "
+						+ std::to_string(pickListSize) + " vHypoSize: "
+						+ std::to_string(hypoListSize) + ").");
+	}
+
+	// reset for next report
+	tLastPerformanceReport = tNow;
+}
+
 // -----------------------------------------------------------------healthCheck
 bool Associator::healthCheck() {
 	// check glass
@@ -0,0 +1,271 @@
+/*****************************************
+ * This file is documented for Doxygen.
+ * If you modify this file please update
+ * the comments so that Doxygen will still
+ * be able to work.
+ ****************************************/
+#ifndef APPENDLOG_H
+#define APPENDLOG_H
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+namespace glass3 {
+namespace util {
+
+/**
+ * \brief glassutil rolling append log class
+ *
+ * The AppendLog class writes records, one per line, to a rolling series of
+ * log files in a directory instead of one file per record. Records are
+ * buffered in memory and written in batches, either once enough records are
+ * buffered, or once the flush interval has passed (see flushIfDue()).
+ *
+ * A log file is written with the extension ".active", and is renamed to the
+ * configured extension when it is rotated (once it reaches the maximum size
+ * or age) or the log is closed, so that anything reading the directory only
+ * ever sees complete log files.
+ *
+ * If a batch can not be written, the log file it was being written to is
+ * completed without it, and the records stay buffered to be written to a
+ * new log file on the next write.
+ *
+ * AppendLog is thread safe, and can not be copied.
+ */
+class AppendLog {
+ public:
+	/**
+	 * \brief AppendLog constructor
+	 *
+	 * The constructor for the AppendLog class.
+	 */
+	AppendLog();
+
+	/**
+	 * \brief AppendLog destructor
+	 *
+	 * The destructor for the AppendLog class, flushes and closes the log
+	 */
+	~AppendLog();
+
+	AppendLog(const AppendLog &) = delete;
+	AppendLog & operator=(const AppendLog &) = delete;
+
+	/**
+	 * \brief AppendLog configuration function
+	 *
+	 * Configures where and how the log is written, closing any current log
+	 * file first.
+	 *
+	 * \param directory - A std::string containing the directory to write log
+	 * files to
+	 * \param prefix - A std::string containing the prefix for log file names
+	 * \param extension - A std::string containing the extension for completed
+	 * log files, without the "."
+	 * \param maxFileSize - An integer containing the size in bytes at which to
+	 * rotate log files, 0 to not rotate by size
+	 * \param maxFileAgeS - An integer containing the age in seconds at which to
+	 * rotate log files, 0 to not rotate by age
+	 * \param flushRecords - An integer containing the number of buffered
+	 * records at which to write to the log file, 1 to write every record
+	 * \param flushIntervalMS - An integer containing the maximum time in
+	 * milliseconds to keep records buffered, see flushIfDue()
+	 * \return Returns true if the configuration is valid, false otherwise
+	 */
+	bool setup(const std::string &directory, const std::string &prefix,
+				const std::string &extension, int64_t maxFileSize,
+				int maxFileAgeS, int flushRecords, int flushIntervalMS);
+
+	/**
+	 * \brief Append a record
+	 *
+	 * Buffers a record, writing the buffered records to the log file if
+	 * enough records are now buffered. A newline is added to the record.
+	 *
+	 * \param record - A std::string containing the record to append
+	 * \return Returns true if successful, false if the records could not be
+	 * written
+	 */
+	bool append(const std::string &record);
+
+	/**
+	 * \brief Write the buffered records
+	 *
+	 * Writes any buffered records to the log file.
+	 *
+	 * \return Returns true if successful, false if the records could not be
+	 * written
+	 */
+	bool flush();
+
+	/**
+	 * \brief Write the buffered records if they are due
+	 *
+	 * Writes any buffered records to the log file if the flush interval has
+	 * passed since they were last written, and completes the current log
+	 * file if it has reached its maximum age. Intended to be called
+	 * periodically so that records aren't held when no more are appended.
+	 *
+	 * \return Returns true if successful, false if the records could not be
+	 * written
+	 */
+	bool flushIfDue();
+
+	/**
+	 * \brief Close the log
+	 *
+	 * Writes any buffered records, and completes the current log file
+	 */
+	void close();
+
+	/**
+	 * \brief Get the current log file name
+	 *
+	 * \return Returns a std::string containing the path and name of the log
+	 * file currently being written, empty if there is none
+	 */
+	std::string getFileName();
+
+	/**
+	 * \brief Get the number of buffered records
+	 *
+	 * \return Returns an integer containing the number of records that have
+	 * not yet been written to the log file
+	 */
+	int getBufferedRecordCount();
+
+	/**
+	 * \brief Get the number of completed log files
+	 *
+	 * \return Returns an integer containing the number of log files that have
+	 * been completed since the log was set up
+	 */
+	int getCompletedFileCount();
+
+ private:
+	/**
+	 * \brief Write the buffered records, the mutex must be held
+	 *
+	 * \return Returns true if successful, false otherwise
+	 */
+	bool writeBuffer();
+
+	/**
+	 * \brief Open a new log file, the mutex must be held
+	 *
+	 * \return Returns true if successful, false otherwise
+	 */
+	bool openFile();
+
+	/**
+	 * \brief Complete the current log file, the mutex must be held
+	 *
+	 * Closes the current log file, and renames it to the configured extension
+	 */
+	void completeFile();
+
+	/**
+	 * \brief The directory to write log files to
+	 */
+	std::string m_sDirectory;
+
+	/**
+	 * \brief The prefix for log file names
+	 */
+	std::string m_sPrefix;
+
+	/**
+	 * \brief The extension for completed log files
+	 */
+	std::string m_sExtension;
+
+	/**
+	 * \brief The size in bytes at which to rotate log files, 0 to not rotate
+	 * by size
+	 */
+	int64_t m_iMaxFileSize;
+
+	/**
+	 * \brief The age in seconds at which to rotate log files, 0 to not rotate
+	 * by age
+	 */
+	int m_iMaxFileAgeS;
+
+	/**
+	 * \brief The number of buffered records at which to write to the log file
+	 */
+	int m_iFlushRecords;
+
+	/**
+	 * \brief The maximum time in milliseconds to keep records buffered
+	 */
+	int m_iFlushIntervalMS;
+
+	/**
+	 * \brief The records that have not yet been written
+	 */
+	std::string m_sBuffer;
+
+	/**
+	 * \brief The number of records that have not yet been written
+	 */
+	int m_iBufferedRecords;
+
+	/**
+	 * \brief The log file currently being written
+	 */
+	std::ofstream m_File;
+
+	/**
+	 * \brief The path and name of the log file currently being written
+	 */
+	std::string m_sFileName;
+
+	/**
+	 * \brief The number of bytes written to the current log file
+	 */
+	int64_t m_iFileSize;
+
+	/**
+	 * \brief The number of log files opened since the log was set up, used to
+	 * keep file names unique
+	 */
+	int m_iFileCount;
+
+	/**
+	 * \brief The number of log files completed since the log was set up
+	 */
+	int m_iCompletedFileCount;
+
+	/**
+	 * \brief When the current log file was opened
+	 */
+	std::chrono::steady_clock::time_point m_tFileOpened;
+
+	/**
+	 * \brief When the buffered records were last written
+	 */
+	std::chrono::steady_clock::time_point m_tLastFlush;
+
+	/**
+	 * \brief A mutex to control access to class members
+	 */
+	std::mutex m_Mutex;
+
+	/**
+	 * \brief The extension for log files that are being written
+	 */
+	static constexpr const char * k_sActiveExtension = "active";
+
+	/**
+	 * \brief The size in bytes the records that could not be written are
+	 * allowed to grow to before they are dropped
+	 */
+	static const int64_t k_iMaxBufferSize = 64 * 1024 * 1024;
+};
+}  // namespace util
+}  // namespace glass3
+#endif  // APPENDLOG_H
@@ -0,0 +1,126 @@
+/*****************************************
+ * This file is documented for Doxygen.
+ * If you modify this file please update
+ * the comments so that Doxygen will still
+ * be able to work.
+ ****************************************/
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <atomic>
+#include <ctime>
+
+namespace glass3 {
+namespace util {
+
+/**
+ * \brief glassutil clock class
+ *
+ * The Clock class is the single source of the "current time" used by glass3
+ * for data driven decisions, such as when to publish an event, when a site
+ * was last picked, or when a hypo was created.
+ *
+ * By default the Clock reports the wall clock time. In simulated mode the
+ * Clock instead reports a simulated time that is set and advanced by the
+ * caller, typically from the time of the data being processed, so that
+ * archived data can be replayed faster (or slower) than real time while
+ * making the same time based decisions as when processed live. The simulated
+ * time only ever moves forward.
+ *
+ * Times used purely for operational monitoring (thread health checks,
+ * performance reports, log timestamps) should continue to use the wall
+ * clock.
+ *
+ * Clock is thread safe.
+ */
+class Clock {
+ public:
+	/**
+	 * \brief Clock constructor
+	 *
+	 * The constructor for the Clock class.
+	 */
+	Clock();
+
+	/**
+	 * \brief Clock destructor
+	 *
+	 * The destructor for the Clock class.
+	 */
+	virtual ~Clock();
+
+	/**
+	 * \brief Get the current time
+	 *
+	 * Get the current time, either the wall clock time or the simulated time
+	 * if simulated mode is enabled.
+	 *
+	 * \return Returns a std::time_t containing the current time in epoch
+	 * seconds
+	 */
+	static std::time_t now();
+
+	/**
+	 * \brief Get the current time with sub-second precision
+	 *
+	 * Get the current time, either the wall clock time or the simulated time
+	 * if simulated mode is enabled.
+	 *
+	 * \return Returns a double containing the current time in epoch seconds
+	 */
+	static double getEpochTime();
+
+	/**
+	 * \brief Enable simulated mode
+	 *
+	 * Enable simulated mode and set the simulated time, after which now() and
+	 * getEpochTime() report the simulated time. The simulated time is set
+	 * unconditionally, even if it is before the current simulated time.
+	 *
+	 * \param epochTime - A double containing the simulated time to start at in
+	 * epoch seconds
+	 */
+	static void setSimulatedTime(double epochTime);
+
+	/**
+	 * \brief Advance the simulated time
+	 *
+	 * Advance the simulated time to the provided time. Times before the
+	 * current simulated time are ignored, so that out of order data does not
+	 * move the clock backwards. Does nothing if simulated mode is not enabled.
+	 *
+	 * \param epochTime - A double containing the time to advance to in epoch
+	 * seconds
+	 * \return Returns true if the simulated time was advanced, false otherwise
+	 */
+	static bool advanceSimulatedTime(double epochTime);
+
+	/**
+	 * \brief Disable simulated mode
+	 *
+	 * Disable simulated mode, after which now() and getEpochTime() report the
+	 * wall clock time.
+	 */
+	static void useRealTime();
+
+	/**
+	 * \brief Check if simulated mode is enabled
+	 *
+	 * \return Returns true if simulated mode is enabled, false otherwise
+	 */
+	static bool isSimulated();
+
+ private:
+	/**
+	 * \brief A boolean flag indicating whether simulated mode is enabled
+	 */
+	static std::atomic<bool> m_bSimulated;
+
+	/**
+	 * \brief A double containing the current simulated time in epoch seconds
+	 */
+	static std::atomic<double> m_dSimulatedTime;
+};
+}  // namespace util
+}  // namespace glass3
+#endif  // CLOCK_H
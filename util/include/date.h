@@ -85,7 +85,8 @@ class Date {
 	/**
 	 * \brief CDate current time function
 	 *
-	 * gets the current time in Gregorian seconds
+	 * gets the current time in Gregorian seconds, as reported by the
+	 * glass3::util::Clock
 	 * \return Returns a double containing the Gregorian seconds.
 	 */
 	static double now();
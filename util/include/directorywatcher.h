@@ -0,0 +1,154 @@
+/*****************************************
+ * This file is documented for Doxygen.
+ * If you modify this file please update
+ * the comments so that Doxygen will still
+ * be able to work.
+ ****************************************/
+#ifndef DIRECTORYWATCHER_H
+#define DIRECTORYWATCHER_H
+
+#include <deque>
+#include <string>
+
+namespace glass3 {
+namespace util {
+
+/**
+ * \brief glassutil directory watcher class
+ *
+ * The DirectoryWatcher class keeps a queue of the files matching an extension
+ * that become ready in a directory, using inotify to be told when a file is
+ * finished being written to (or is moved into) the directory, so that new
+ * files are found as soon as they arrive without rescanning the directory.
+ *
+ * Files that were already in the directory when watching started are not
+ * reported, and if the kernel event queue overflows some files may be
+ * missed, see hasOverflowed(). Callers should scan the directory (e.g. with
+ * getFirstFileNameByExtension()) in both cases. On platforms without inotify
+ * watch() fails and callers should always scan.
+ *
+ * DirectoryWatcher is not thread safe, and can not be copied.
+ */
+class DirectoryWatcher {
+ public:
+	/**
+	 * \brief DirectoryWatcher constructor
+	 *
+	 * The constructor for the DirectoryWatcher class.
+	 */
+	DirectoryWatcher();
+
+	/**
+	 * \brief DirectoryWatcher destructor
+	 *
+	 * The destructor for the DirectoryWatcher class, stops watching
+	 */
+	~DirectoryWatcher();
+
+	DirectoryWatcher(const DirectoryWatcher &) = delete;
+	DirectoryWatcher & operator=(const DirectoryWatcher &) = delete;
+
+	/**
+	 * \brief Start watching a directory
+	 *
+	 * Starts watching the given directory for files containing the given
+	 * extension, stopping any previous watch.
+	 *
+	 * \param path - A std::string containing the directory to watch
+	 * \param extension - A std::string containing the extension to filter with
+	 * \return Returns true if the directory is being watched, false if it
+	 * could not be watched, or watching is not supported on this platform
+	 */
+	bool watch(const std::string &path, const std::string &extension);
+
+	/**
+	 * \brief Stop watching
+	 *
+	 * Stops watching the directory and forgets any queued files
+	 */
+	void stop();
+
+	/**
+	 * \brief Check if a directory is being watched
+	 *
+	 * \return Returns true if a directory is being watched, false otherwise
+	 */
+	bool isWatching() const;
+
+	/**
+	 * \brief Get the path being watched
+	 *
+	 * \return Returns a std::string containing the watched directory
+	 */
+	const std::string & getPath() const;
+
+	/**
+	 * \brief Get the next ready file
+	 *
+	 * Gets the next file that became ready in the watched directory, waiting
+	 * up to timeoutMS milliseconds for one if none are queued. Files that no
+	 * longer exist (such as ones already found by a directory scan and
+	 * processed) are skipped.
+	 *
+	 * \param fileName - A pointer to a std::string to return the path and
+	 * name of the file in
+	 * \param timeoutMS - An integer containing the maximum time to wait in
+	 * milliseconds, 0 to not wait
+	 * \return Returns true if a file was found, false otherwise
+	 */
+	bool getNextFileName(std::string *fileName, int timeoutMS);
+
+	/**
+	 * \brief Check whether files may have been missed
+	 *
+	 * Checks, and clears, whether the kernel event queue has overflowed (or
+	 * the watch was lost) since the last check, meaning that some ready files
+	 * may not have been queued.
+	 *
+	 * \return Returns true if files may have been missed, false otherwise
+	 */
+	bool hasOverflowed();
+
+ private:
+	/**
+	 * \brief Read the pending watch events, queueing the ready files
+	 *
+	 * \param timeoutMS - An integer containing the maximum time to wait for
+	 * events in milliseconds, 0 to not wait
+	 */
+	void readEvents(int timeoutMS);
+
+	/**
+	 * \brief The inotify file descriptor, -1 when not watching
+	 */
+	int m_iNotifyFD;
+
+	/**
+	 * \brief The inotify watch descriptor, -1 when not watching
+	 */
+	int m_iWatchDescriptor;
+
+	/**
+	 * \brief The directory being watched
+	 */
+	std::string m_sPath;
+
+	/**
+	 * \brief The extension to filter with
+	 */
+	std::string m_sExtension;
+
+	/**
+	 * \brief The names of the files that have become ready, in the order they
+	 * became ready
+	 */
+	std::deque<std::string> m_ReadyFiles;
+
+	/**
+	 * \brief A boolean flag indicating that files may have been missed
+	 */
+	bool m_bOverflowed;
+};
+}  // namespace util
+}  // namespace glass3
+#endif  // DIRECTORYWATCHER_H
@@ -17,6 +17,12 @@
 
 #include <string>
 
+/**
+ * \brief The extension added to files that could not be moved, these files
+ * are skipped when looking for files
+ */
+#define MOVEERROREXTENSION ".moveerror"
+
 namespace glass3 {
 namespace util {
 /**
@@ -7,7 +7,7 @@
 #ifndef GLASSMATH_H
 #define GLASSMATH_H
 
-#include <random>
+#include <cstdint>
 
 namespace glass3 {
 namespace util {
@@ -47,9 +47,8 @@ class GlassMath {
 	/**
 	 * \brief Generate Random Number
 	 *
-	 * Generates random number between x and y. This function is used by gauss
-	 * in determining the randomized step sizes for relocation (anneal and
-	 * localize)
+	 * Generates random number between x and y using the calling thread's
+	 * RandomStream.
 	 *
 	 * \param x - The minimum random number
 	 * \param y - The maximum random number
@@ -60,12 +59,11 @@ class GlassMath {
 	/**
 	 * \brief Calculate Gaussian random sample
 	 *
-	 * Calculate random normal gaussian deviate value using Box-Muller method.
-	 * This function is used in determining the randomized step sizes for
-	 * relocation (anneal and localize)
+	 * Calculate random normal gaussian deviate value using the calling
+	 * thread's RandomStream (ziggurat method).
 	 *
-	 * \param avg - The mean average value to use in the Box-Muller method
-	 * \param std - The standard deviation value to use in the Box-Muller method
+	 * \param avg - The mean of the distribution
+	 * \param std - The standard deviation of the distribution
 	 * \return Returns the Gaussian random sample
 	 */
 	static double gauss(double avg, double std);
@@ -73,10 +71,20 @@ class GlassMath {
 	/**
 	 * \brief initialize random number generator
 	 *
-	 * Initializes the random number generator by seeding m_RandomGenerator.
+	 * Reseeds the calling thread's RandomStream from std::random_device.
 	 */
 	static void initializeRandom();
 
+	/**
+	 * \brief seed random number generator
+	 *
+	 * Seeds the calling thread's RandomStream, so that the following random()
+	 * and gauss() calls on this thread are reproducible.
+	 *
+	 * \param seed - An unsigned 64 bit integer containing the seed
+	 */
+	static void seedRandom(uint64_t seed);
+
 	/**
 	 * \brief get angle difference between two angles
 	 *
@@ -88,6 +96,23 @@ class GlassMath {
 	 */
 	static double angleDifference(double angle1, double angle2);
 
+	/**
+	 * \brief Solve a small dense linear system
+	 *
+	 * Solves the n by n linear system A x = b in place using Gaussian
+	 * elimination with partial pivoting. This function is used by the
+	 * location refinement to solve the damped normal equations.
+	 *
+	 * \param n - An integer containing the size of the system
+	 * \param matrix - A pointer to an array of n * n doubles containing the
+	 * row major matrix A, which is overwritten during elimination
+	 * \param vector - A pointer to an array of n doubles containing b, which
+	 * is overwritten with the solution x
+	 * \return Returns true if the system was solved, false if the matrix is
+	 * singular
+	 */
+	static bool solveLinearSystem(int n, double *matrix, double *vector);
+
 	// Mathmatical constants
 	/**
 	 * \brief Radians to Degrees conversion factor
@@ -108,17 +133,6 @@ class GlassMath {
 	 * \brief Two Pi value
 	 */
 	static constexpr double k_TwoPi = 6.283185307179586;
-
- private:
-	/**
-	 * \brief A boolean flag to disable all logging
-	 */
-	static bool m_bInitialized;
-
-	/**
-	 * \brief The random engine for random()
-	 */
-	static std::default_random_engine m_RandomGenerator;
 };
 }  // namespace util
 }  // namespace glass3
@@ -0,0 +1,295 @@
+/*****************************************
+ * This file is documented for Doxygen.
+ * If you modify this file please update
+ * the comments so that Doxygen will still
+ * be able to work.
+ ****************************************/
+#ifndef INSTRUMENTEDMUTEX_H
+#define INSTRUMENTEDMUTEX_H
+
+#include <latencyhistogram.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace glass3 {
+namespace util {
+
+/**
+ * \brief glass3::util::LockProfile class - the lock profiling shared by
+ * every glass3::util::InstrumentedLock
+ *
+ * The glass3::util::LockProfile class holds the switch that turns lock
+ * profiling on and off, and the statistics of each named lock. Every lock
+ * with the same name shares one set of statistics, so the statistics of a
+ * per object lock, such as the lock of each hypo, are for all of them
+ * together.
+ *
+ * The statistics of the lock "name" are kept in the shared
+ * glass3::util::MetricsRegistry as the counters "lock.name.acquisitions" and
+ * "lock.name.contended", and the histograms "lock.name.wait_us" of the time
+ * spent waiting for a contended lock and "lock.name.hold_us" of the time the
+ * lock was held, so they are part of every metrics snapshot. report() logs
+ * a summary of them.
+ *
+ * Profiling is off by default, when it is off a lock costs one relaxed
+ * atomic load more than the plain mutex.
+ */
+class LockProfile {
+ public:
+	/**
+	 * \brief The statistics of a named lock
+	 */
+	typedef struct _LockStats {
+		/**
+		 * \brief The number of times the lock was taken
+		 */
+		std::atomic<int64_t> * pAcquisitions;
+
+		/**
+		 * \brief The number of times the lock had to be waited for
+		 */
+		std::atomic<int64_t> * pContended;
+
+		/**
+		 * \brief The time spent waiting for the lock in microseconds
+		 */
+		glass3::util::LatencyHistogram * pWaitTime;
+
+		/**
+		 * \brief The time the lock was held in microseconds
+		 */
+		glass3::util::LatencyHistogram * pHoldTime;
+	} LockStats;
+
+	/**
+	 * \brief Turn lock profiling on or off
+	 *
+	 * \param enabled - A boolean flag, true to profile locks
+	 */
+	static void setEnabled(bool enabled);
+
+	/**
+	 * \brief Get whether lock profiling is on
+	 *
+	 * \return Returns true if locks are being profiled, false otherwise
+	 */
+	static bool getEnabled();
+
+	/**
+	 * \brief Get the statistics of a named lock
+	 *
+	 * Gets the statistics of the lock with the given name, creating them if
+	 * needed. The statistics live as long as the program.
+	 *
+	 * \param name - A std::string containing the name of the lock
+	 * \return Returns a pointer to the LockStats of the lock
+	 */
+	static LockStats * getLockStats(const std::string &name);
+
+	/**
+	 * \brief Log the lock statistics
+	 *
+	 * Logs the acquisitions, contention, wait time and hold time of every
+	 * named lock that has been profiled.
+	 */
+	static void report();
+
+ private:
+	/**
+	 * \brief Whether locks are being profiled
+	 */
+	static std::atomic<bool> m_bEnabled;
+};
+
+/**
+ * \brief glass3::util::InstrumentedLock class - a mutex that profiles itself
+ *
+ * The glass3::util::InstrumentedLock class wraps a standard mutex, and when
+ * lock profiling is on (see glass3::util::LockProfile) records how often it
+ * is taken, how often and how long threads wait for it, and how long it is
+ * held, under the name given with setName(). An unnamed lock is never
+ * profiled.
+ *
+ * It has the same lock(), try_lock() and unlock() as the mutex it wraps, so
+ * it works with std::lock_guard and std::unique_lock. For a recursive mutex
+ * every acquisition is counted, but the hold time is measured from the
+ * outermost lock() to the matching unlock().
+ *
+ * Use the glass3::util::InstrumentedMutex and
+ * glass3::util::InstrumentedRecursiveMutex typedefs.
+ *
+ * \tparam MutexType - The mutex to wrap, std::mutex or std::recursive_mutex
+ */
+template<class MutexType>
+class InstrumentedLock {
+ public:
+	/**
+	 * \brief InstrumentedLock constructor
+	 *
+	 * The constructor for the InstrumentedLock class.
+	 * Initializes members to default values, the lock is unnamed.
+	 */
+	InstrumentedLock() {
+		m_pName = NULL;
+		m_pStats = NULL;
+		m_iDepth = 0;
+	}
+
+	/**
+	 * \brief InstrumentedLock advanced constructor
+	 *
+	 * The advanced constructor for the InstrumentedLock class.
+	 * Initializes members to default values and names the lock.
+	 *
+	 * \param name - A pointer to the name of the lock, see setName()
+	 */
+	explicit InstrumentedLock(const char * name) {
+		m_pName = name;
+		m_pStats = NULL;
+		m_iDepth = 0;
+	}
+
+	/**
+	 * \brief Name the lock
+	 *
+	 * Sets the name the lock is profiled under. The name is not copied, since
+	 * some locks are in every object of a class, so it must outlive the
+	 * lock, normally it is a string literal such as "CHypo::m_HypoMutex".
+	 * Must be called before the lock is used.
+	 *
+	 * \param name - A pointer to the name of the lock
+	 */
+	void setName(const char * name) {
+		m_pName = name;
+		m_pStats = NULL;
+	}
+
+	/**
+	 * \brief Take the lock, waiting for it if needed
+	 */
+	void lock() {
+		if ((m_pName == NULL) || (LockProfile::getEnabled() == false)) {
+			m_Mutex.lock();
+			return;
+		}
+
+		// only time the wait if there is one
+		if (m_Mutex.try_lock() == true) {
+			acquired(false, 0);
+			return;
+		}
+
+		std::chrono::steady_clock::time_point waitStart =
+				std::chrono::steady_clock::now();
+		m_Mutex.lock();
+		int64_t waitMicroseconds =
+				std::chrono::duration_cast<std::chrono::microseconds>(
+						std::chrono::steady_clock::now() - waitStart).count();
+		acquired(true, waitMicroseconds);
+	}
+
+	/**
+	 * \brief Take the lock if it is free
+	 *
+	 * \return Returns true if the lock was taken, false otherwise
+	 */
+	bool try_lock() {
+		if (m_Mutex.try_lock() == false) {
+			return (false);
+		}
+
+		if ((m_pName != NULL) && (LockProfile::getEnabled() == true)) {
+			acquired(false, 0);
+		}
+		return (true);
+	}
+
+	/**
+	 * \brief Release the lock
+	 */
+	void unlock() {
+		// the depth is only counted while profiling, so a lock taken before
+		// profiling was turned on is released without a hold time
+		if (m_iDepth > 0) {
+			m_iDepth--;
+			if (m_iDepth == 0) {
+				m_pStats->pHoldTime->record(
+						std::chrono::duration_cast<std::chrono::microseconds>(
+								std::chrono::steady_clock::now() - m_tAcquired)
+								.count());
+			}
+		}
+
+		m_Mutex.unlock();
+	}
+
+ private:
+	/**
+	 * \brief Record a profiled acquisition, called holding the lock
+	 *
+	 * \param contended - A boolean flag, true if the lock had to be waited
+	 * for
+	 * \param waitMicroseconds - An int64_t containing how long the lock was
+	 * waited for in microseconds
+	 */
+	void acquired(bool contended, int64_t waitMicroseconds) {
+		if (m_pStats == NULL) {
+			m_pStats = LockProfile::getLockStats(m_pName);
+		}
+
+		m_pStats->pAcquisitions->fetch_add(1, std::memory_order_relaxed);
+		if (contended == true) {
+			m_pStats->pContended->fetch_add(1, std::memory_order_relaxed);
+			m_pStats->pWaitTime->record(waitMicroseconds);
+		}
+
+		if (m_iDepth == 0) {
+			m_tAcquired = std::chrono::steady_clock::now();
+		}
+		m_iDepth++;
+	}
+
+	/**
+	 * \brief The wrapped mutex
+	 */
+	MutexType m_Mutex;
+
+	/**
+	 * \brief The name of the lock, NULL if unnamed
+	 */
+	const char * m_pName;
+
+	/**
+	 * \brief The statistics of the lock, looked up on the first profiled
+	 * acquisition
+	 */
+	LockProfile::LockStats * m_pStats;
+
+	/**
+	 * \brief How many profiled acquisitions the holder has not released,
+	 * only changed while holding the lock
+	 */
+	int m_iDepth;
+
+	/**
+	 * \brief When the outermost profiled acquisition happened
+	 */
+	std::chrono::steady_clock::time_point m_tAcquired;
+};
+
+/**
+ * \brief An instrumented std::mutex
+ */
+typedef InstrumentedLock<std::mutex> InstrumentedMutex;
+
+/**
+ * \brief An instrumented std::recursive_mutex
+ */
+typedef InstrumentedLock<std::recursive_mutex> InstrumentedRecursiveMutex;
+}  // namespace util
+}  // namespace glass3
+#endif  // INSTRUMENTEDMUTEX_H
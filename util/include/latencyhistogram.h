@@ -0,0 +1,135 @@
+/*****************************************
+ * This file is documented for Doxygen.
+ * If you modify this file please update
+ * the comments so that Doxygen will still
+ * be able to work.
+ ****************************************/
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace glass3 {
+namespace util {
+
+/**
+ * \brief glass3::util::LatencyHistogram class - a lock free histogram of
+ * latencies
+ *
+ * The glass3::util::LatencyHistogram class counts latencies in microseconds
+ * in log-linear buckets, k_iSubBuckets buckets per power of two, so that
+ * recording costs O(1) and a fixed amount of memory no matter how many
+ * latencies are recorded, while percentiles are still accurate to within
+ * 1 / k_iSubBuckets of the value. The maximum is tracked exactly.
+ *
+ * The buckets are atomic, so any number of threads can record without
+ * locking. Reads while other threads are recording see a close, but not
+ * necessarily consistent, snapshot.
+ */
+class LatencyHistogram {
+ public:
+	/**
+	 * \brief LatencyHistogram constructor
+	 *
+	 * The constructor for the LatencyHistogram class.
+	 * Initializes members to default values.
+	 */
+	LatencyHistogram();
+
+	/**
+	 * \brief LatencyHistogram destructor
+	 *
+	 * The destructor for the LatencyHistogram class.
+	 */
+	~LatencyHistogram();
+
+	/**
+	 * \brief Record a latency
+	 *
+	 * \param microseconds - An int64_t containing the latency to record in
+	 * microseconds, negative latencies are recorded as 0
+	 */
+	void record(int64_t microseconds);
+
+	/**
+	 * \brief Get a percentile
+	 *
+	 * Gets the latency that the given percentage of the recorded latencies
+	 * are at or below, as the upper bound of the bucket it falls in.
+	 *
+	 * \param percentile - A double containing the percentile to get, from 0
+	 * to 100
+	 * \return Returns an int64_t containing the latency in microseconds, or 0
+	 * if nothing has been recorded
+	 */
+	int64_t getPercentile(double percentile);
+
+	/**
+	 * \brief Get the maximum recorded latency
+	 *
+	 * \return Returns an int64_t containing the maximum latency in
+	 * microseconds, or 0 if nothing has been recorded
+	 */
+	int64_t getMax();
+
+	/**
+	 * \brief Get the number of recorded latencies
+	 *
+	 * \return Returns an int64_t containing the number of recorded latencies
+	 */
+	int64_t getCount();
+
+	/**
+	 * \brief Reset the histogram
+	 *
+	 * Forgets all recorded latencies
+	 */
+	void reset();
+
+	// constants
+	/**
+	 * \brief The number of buckets per power of two
+	 */
+	static const int k_iSubBuckets = 8;
+
+	/**
+	 * \brief The number of buckets, enough for any non-negative int64_t
+	 */
+	static const int k_iNumBuckets = 61 * k_iSubBuckets;
+
+ private:
+	/**
+	 * \brief Get the bucket a latency falls in
+	 *
+	 * \param microseconds - An int64_t containing the non-negative latency
+	 * \return Returns an integer containing the index of the bucket
+	 */
+	static int getBucket(int64_t microseconds);
+
+	/**
+	 * \brief Get the largest latency that falls in a bucket
+	 *
+	 * \param bucket - An integer containing the index of the bucket
+	 * \return Returns an int64_t containing the latency
+	 */
+	static int64_t getBucketUpperBound(int bucket);
+
+	/**
+	 * \brief The count of latencies in each bucket
+	 */
+	std::atomic<int64_t> m_aBuckets[k_iNumBuckets];
+
+	/**
+	 * \brief The number of recorded latencies
+	 */
+	std::atomic<int64_t> m_iCount;
+
+	/**
+	 * \brief The maximum recorded latency
+	 */
+	std::atomic<int64_t> m_iMax;
+};
+}  // namespace util
+}  // namespace glass3
+#endif  // LATENCYHISTOGRAM_H
@@ -0,0 +1,281 @@
+/*****************************************
+ * This file is documented for Doxygen.
+ * If you modify this file please update
+ * the comments so that Doxygen will still
+ * be able to work.
+ ****************************************/
+#ifndef LATENCYTRACER_H
+#define LATENCYTRACER_H
+
+#include <latencyhistogram.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace glass3 {
+namespace util {
+
+/**
+ * \brief glass3::util::LatencyTracer class - traces the latency of picks
+ * through the processing pipeline
+ *
+ * The glass3::util::LatencyTracer class follows each pick, by id, through the
+ * stages of the pipeline: fetched by an input, parsed, added to the input
+ * queue, dequeued by glasscore's pick list, nucleated, associated to a hypo,
+ * and first published in a detection. Each stage a pick reaches is recorded
+ * once, on the monotonic steady clock, as the latency since the pick started
+ * its trace, in a glass3::util::LatencyHistogram per stage. The publication
+ * stage is therefore the end to end latency, and the earlier stages show
+ * where that latency goes.
+ *
+ * A trace starts when a pick is fetched, or when it is dequeued for picks
+ * that did not come through an input, and ends when the pick is first
+ * published. Picks that are never published are forgotten after
+ * k_iMaxTraceAgeS seconds, or sooner if more than k_iMaxTraces picks are
+ * being traced.
+ *
+ * The traces are split by pick id into k_iNumShards shards, each with its
+ * own lock, so that threads marking different picks rarely wait on each
+ * other.
+ *
+ * report() logs the p50, p99 and maximum latency of each stage and resets the
+ * histograms. The shared instance from getInstance() reports every
+ * k_iReportIntervalMS milliseconds on the glass3::util::TimerService.
+ *
+ * Tracing is off by default, when it is off mark() returns after one relaxed
+ * atomic load, and callers that build the pick id just for tracing should
+ * check getEnabled() first.
+ */
+class LatencyTracer {
+ public:
+	/**
+	 * \brief The stages of the pipeline, in processing order
+	 */
+	enum Stage {
+		Fetch = 0, /**< The pick was fetched by an input */
+		Parse = 1, /**< The pick was parsed */
+		InputQueue = 2, /**< The pick was added to the input queue */
+		Dequeue = 3, /**< The pick was dequeued by the pick list */
+		Nucleate = 4, /**< The pick was nucleated */
+		Associate = 5, /**< The pick was first associated to a hypo */
+		Publish = 6 /**< The pick was first published in a detection */
+	};
+
+	/**
+	 * \brief LatencyTracer constructor
+	 *
+	 * The constructor for the LatencyTracer class.
+	 * Initializes members to default values, does not schedule reports.
+	 */
+	LatencyTracer();
+
+	/**
+	 * \brief LatencyTracer destructor
+	 *
+	 * The destructor for the LatencyTracer class.
+	 */
+	~LatencyTracer();
+
+	/**
+	 * \brief Get the shared LatencyTracer
+	 *
+	 * Gets the process wide LatencyTracer, creating it and scheduling its
+	 * periodic reports on first use. The shared LatencyTracer is never
+	 * destroyed, so that picks can still be traced during program exit.
+	 *
+	 * \return Returns a reference to the shared LatencyTracer
+	 */
+	static LatencyTracer & getInstance();
+
+	/**
+	 * \brief Turn pick latency tracing on or off
+	 *
+	 * \param enabled - A boolean flag, true to trace picks
+	 */
+	static void setEnabled(bool enabled);
+
+	/**
+	 * \brief Get whether pick latency tracing is on
+	 *
+	 * \return Returns true if picks are being traced, false otherwise
+	 */
+	static bool getEnabled();
+
+	/**
+	 * \brief Mark that a pick reached a stage now
+	 *
+	 * \param id - A std::string containing the id of the pick
+	 * \param stage - The stage the pick reached
+	 */
+	void mark(const std::string &id, Stage stage);
+
+	/**
+	 * \brief Mark that a pick reached a stage at the given time
+	 *
+	 * Records the latency of the stage for the pick, unless the pick already
+	 * reached the stage. Fetch and Dequeue start a trace for a pick that is
+	 * not being traced, the other stages are ignored for such picks.
+	 * Publish ends the trace. Does nothing while tracing is off.
+	 *
+	 * \param id - A std::string containing the id of the pick
+	 * \param stage - The stage the pick reached
+	 * \param time - A std::chrono::steady_clock::time_point containing when
+	 * the pick reached the stage
+	 */
+	void mark(const std::string &id, Stage stage,
+				std::chrono::steady_clock::time_point time);
+
+	/**
+	 * \brief Get a stage latency percentile
+	 *
+	 * \param stage - The stage to get the latency of
+	 * \param percentile - A double containing the percentile to get, from 0
+	 * to 100
+	 * \return Returns an int64_t containing the latency since the start of
+	 * the trace in microseconds
+	 */
+	int64_t getLatency(Stage stage, double percentile);
+
+	/**
+	 * \brief Get the number of picks that reached a stage since the last
+	 * report
+	 *
+	 * \param stage - The stage to get the count of
+	 * \return Returns an int64_t containing the number of picks
+	 */
+	int64_t getCount(Stage stage);
+
+	/**
+	 * \brief Get the number of picks being traced
+	 *
+	 * \return Returns an integer containing the number of picks
+	 */
+	int getTraceCount();
+
+	/**
+	 * \brief Report the stage latencies
+	 *
+	 * Forgets picks that have been traced for longer than k_iMaxTraceAgeS,
+	 * logs the p50, p99 and maximum latency of each stage reached since the
+	 * last report, and resets the histograms.
+	 */
+	void report();
+
+	/**
+	 * \brief Get the name of a stage
+	 *
+	 * \param stage - The stage to get the name of
+	 * \return Returns a std::string containing the name of the stage
+	 */
+	static std::string getStageName(Stage stage);
+
+	// constants
+	/**
+	 * \brief The number of stages
+	 */
+	static const int k_iNumStages = 7;
+
+	/**
+	 * \brief The interval between reports of the shared LatencyTracer in
+	 * milliseconds
+	 */
+	static const int k_iReportIntervalMS = 60000;
+
+	/**
+	 * \brief The number of seconds a pick is traced before it is forgotten
+	 */
+	static const int k_iMaxTraceAgeS = 600;
+
+	/**
+	 * \brief The maximum number of picks traced at once, the oldest traces are
+	 * forgotten to make room
+	 */
+	static const int k_iMaxTraces = 100000;
+
+	/**
+	 * \brief The number of shards the traces are split into
+	 */
+	static const int k_iNumShards = 16;
+
+ private:
+	/**
+	 * \brief The trace of a pick
+	 */
+	typedef struct _PickTrace {
+		/**
+		 * \brief When the trace started
+		 */
+		std::chrono::steady_clock::time_point tStart;
+
+		/**
+		 * \brief A bit per stage, set once the pick reached the stage
+		 */
+		int iStagesReached;
+	} PickTrace;
+
+	/**
+	 * \brief The traces of the picks whose ids hash to the same shard
+	 */
+	typedef struct _TraceShard {
+		/**
+		 * \brief The traces, by pick id
+		 */
+		std::unordered_map<std::string, PickTrace> mTraces;
+
+		/**
+		 * \brief The start time and pick id of each trace, in the order the
+		 * traces started, used to forget old traces. Entries for traces that
+		 * already ended are skipped.
+		 */
+		std::deque<std::pair<std::chrono::steady_clock::time_point,
+			std::string>> qTraceOrder;
+
+		/**
+		 * \brief A mutex to control access to the shard
+		 */
+		std::mutex TraceMutex;
+	} TraceShard;
+
+	/**
+	 * \brief Forget the oldest trace of a shard, the shard's TraceMutex must
+	 * be held
+	 *
+	 * \param shard - The shard to forget the oldest trace of
+	 */
+	void forgetOldestTrace(TraceShard *shard);
+
+	/**
+	 * \brief Forget the oldest trace of all the shards, no shard's TraceMutex
+	 * may be held
+	 */
+	void forgetOldestTrace();
+
+	/**
+	 * \brief The trace shards
+	 */
+	TraceShard m_aShards[k_iNumShards];
+
+	/**
+	 * \brief The number of entries in the trace order of all the shards
+	 */
+	std::atomic<int> m_iTraceOrderSize;
+
+	/**
+	 * \brief The latency histogram of each stage
+	 */
+	LatencyHistogram m_aHistograms[k_iNumStages];
+
+	/**
+	 * \brief Whether picks are being traced
+	 */
+	static std::atomic<bool> m_bEnabled;
+};
+}  // namespace util
+}  // namespace glass3
+#endif  // LATENCYTRACER_H
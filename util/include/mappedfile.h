@@ -0,0 +1,177 @@
+/*****************************************
+ * This file is documented for Doxygen.
+ * If you modify this file please update
+ * the comments so that Doxygen will still
+ * be able to work.
+ ****************************************/
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace glass3 {
+namespace util {
+
+/**
+ * \brief A line of text within a MappedFile
+ *
+ * Points into the mapped file contents, so it is only valid while the file
+ * it came from is open. The line does not include its newline.
+ */
+typedef struct _MappedLine {
+	/**
+	 * \brief A pointer to the first character of the line
+	 */
+	const char * pData;
+
+	/**
+	 * \brief The number of characters in the line
+	 */
+	size_t iLength;
+} MappedLine;
+
+/**
+ * \brief glassutil memory mapped file class
+ *
+ * The MappedFile class provides read only access to the contents of a file
+ * by mapping the whole file into memory, so that large text files can be
+ * split into lines in bulk without copying them through a stream. On
+ * platforms without mmap the file is read into memory instead.
+ *
+ * The contents are a snapshot taken when the file is opened, call update()
+ * to pick up anything appended to the file since.
+ *
+ * MappedFile is not thread safe, and can not be copied.
+ */
+class MappedFile {
+ public:
+	/**
+	 * \brief MappedFile constructor
+	 *
+	 * The constructor for the MappedFile class.
+	 */
+	MappedFile();
+
+	/**
+	 * \brief MappedFile destructor
+	 *
+	 * The destructor for the MappedFile class, closes the file
+	 */
+	~MappedFile();
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile & operator=(const MappedFile &) = delete;
+
+	/**
+	 * \brief Open a file
+	 *
+	 * Maps the given file into memory, closing any previously opened file,
+	 * and starts reading lines from the beginning of the file.
+	 *
+	 * \param fileName - A std::string containing the file to open
+	 * \return Returns true if the file was opened, false otherwise
+	 */
+	bool open(const std::string &fileName);
+
+	/**
+	 * \brief Close the file
+	 *
+	 * Unmaps the file, invalidating any MappedLine read from it
+	 */
+	void close();
+
+	/**
+	 * \brief Check if a file is open
+	 *
+	 * \return Returns true if a file is open, false otherwise
+	 */
+	bool isOpen() const;
+
+	/**
+	 * \brief Check if all lines have been read
+	 *
+	 * \return Returns true if there are no more lines to read (or no file is
+	 * open), false otherwise
+	 */
+	bool isEnd() const;
+
+	/**
+	 * \brief Get the size of the file
+	 *
+	 * \return Returns the size of the open file in bytes
+	 */
+	size_t getSize() const;
+
+	/**
+	 * \brief Get the read position
+	 *
+	 * \return Returns the number of bytes of the file that have been read
+	 */
+	size_t getPosition() const;
+
+	/**
+	 * \brief Pick up appended data
+	 *
+	 * Checks whether the open file has grown since it was opened or last
+	 * updated, and if so maps (or reads) the new contents, keeping the read
+	 * position. Invalidates any MappedLine read from the file if it grew.
+	 *
+	 * \return Returns true if the file grew, false otherwise
+	 */
+	bool update();
+
+	/**
+	 * \brief Read lines
+	 *
+	 * Splits up to maxLines lines off of the unread part of the file and
+	 * appends them to lines. A trailing carriage return is removed from each
+	 * line.
+	 *
+	 * \param maxLines - An integer containing the maximum number of lines to
+	 * read
+	 * \param lines - A pointer to a std::vector of MappedLine to append the
+	 * lines to
+	 * \param partialLastLine - A boolean flag indicating whether to read a
+	 * last line that does not end with a newline, false to leave it unread
+	 * since the rest of it may still be being written
+	 * \return Returns the number of lines read
+	 */
+	int readLines(int maxLines, std::vector<MappedLine> *lines,
+					bool partialLastLine = true);
+
+ private:
+	/**
+	 * \brief The name of the open file
+	 */
+	std::string m_sFileName;
+
+	/**
+	 * \brief A pointer to the file contents
+	 */
+	const char * m_pData;
+
+	/**
+	 * \brief The size of the file contents in bytes
+	 */
+	size_t m_iSize;
+
+	/**
+	 * \brief The number of bytes that have been read
+	 */
+	size_t m_iPosition;
+
+	/**
+	 * \brief A boolean flag indicating whether a file is open
+	 */
+	bool m_bOpen;
+
+	/**
+	 * \brief The file contents when they were read rather than mapped
+	 */
+	std::vector<char> m_vBuffer;
+};
+}  // namespace util
+}  // namespace glass3
+#endif  // MAPPEDFILE_H
@@ -0,0 +1,180 @@
+/*****************************************
+ * This file is documented for Doxygen.
+ * If you modify this file please update
+ * the comments so that Doxygen will still
+ * be able to work.
+ ****************************************/
+#ifndef METRICSREGISTRY_H
+#define METRICSREGISTRY_H
+
+#include <json.h>
+#include <latencyhistogram.h>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace glass3 {
+namespace util {
+
+/**
+ * \brief glass3::util::MetricsRegistry class - a registry of named
+ * performance metrics
+ *
+ * The glass3::util::MetricsRegistry class holds named counters, gauges and
+ * latency histograms, so that monitoring can graph throughput and latency
+ * from a single snapshot instead of scraping log lines.
+ *
+ * A metric is created the first time it is asked for, and lives as long as
+ * the registry, so components look their metrics up once and keep the
+ * returned reference. Recording through the reference is lock free, only
+ * looking a metric up takes a lock.
+ *
+ * Metric names are dotted, lower case, starting with the component, such as
+ * "picklist.picks" or "hypolist.process_us". Histograms record microseconds.
+ *
+ * getJSON() returns a snapshot of every metric, which the
+ * glass3::util::MetricsServer serves over http, and which the registry can
+ * periodically write to a file with startDump().
+ *
+ * Most components should use the shared instance from getInstance().
+ */
+class MetricsRegistry {
+ public:
+	/**
+	 * \brief MetricsRegistry constructor
+	 *
+	 * The constructor for the MetricsRegistry class.
+	 * Initializes members to default values.
+	 */
+	MetricsRegistry();
+
+	/**
+	 * \brief MetricsRegistry destructor
+	 *
+	 * The destructor for the MetricsRegistry class.
+	 * Stops any periodic dump.
+	 */
+	~MetricsRegistry();
+
+	/**
+	 * \brief Get the shared MetricsRegistry
+	 *
+	 * Gets the process wide MetricsRegistry, creating it on first use. The
+	 * shared MetricsRegistry is never destroyed, so that references to its
+	 * metrics stay valid during program exit.
+	 *
+	 * \return Returns a reference to the shared MetricsRegistry
+	 */
+	static MetricsRegistry & getInstance();
+
+	/**
+	 * \brief Get a counter
+	 *
+	 * Gets the counter with the given name, creating it at 0 if needed.
+	 * Counters only go up.
+	 *
+	 * \param name - A std::string containing the name of the counter
+	 * \return Returns a reference to the std::atomic<int64_t> counter
+	 */
+	std::atomic<int64_t> & getCounter(const std::string &name);
+
+	/**
+	 * \brief Get a gauge
+	 *
+	 * Gets the gauge with the given name, creating it at 0 if needed. Gauges
+	 * hold the latest value of something, such as a queue length.
+	 *
+	 * \param name - A std::string containing the name of the gauge
+	 * \return Returns a reference to the std::atomic<double> gauge
+	 */
+	std::atomic<double> & getGauge(const std::string &name);
+
+	/**
+	 * \brief Get a histogram
+	 *
+	 * Gets the histogram with the given name, creating it empty if needed.
+	 *
+	 * \param name - A std::string containing the name of the histogram
+	 * \return Returns a reference to the glass3::util::LatencyHistogram
+	 */
+	glass3::util::LatencyHistogram & getHistogram(const std::string &name);
+
+	/**
+	 * \brief Get a snapshot of the metrics
+	 *
+	 * Gets every metric as a json::Object with "Counters" and "Gauges"
+	 * objects of name to value, and a "Histograms" object of name to an
+	 * object with the "Count", "P50", "P99" and "Max" of the histogram.
+	 *
+	 * \return Returns a json::Object containing the snapshot
+	 */
+	json::Object getJSON();
+
+	/**
+	 * \brief Write a snapshot of the metrics to a file
+	 *
+	 * Writes the snapshot to a temporary file and renames it into place, so
+	 * a reader never sees a partly written file.
+	 *
+	 * \param fileName - A std::string containing the file to write
+	 * \return Returns true if the file was written, false otherwise
+	 */
+	bool writeJSONFile(const std::string &fileName);
+
+	/**
+	 * \brief Start periodically writing the metrics to a file
+	 *
+	 * Writes a snapshot of the metrics to the given file every interval on
+	 * the glass3::util::TimerService, replacing any existing dump.
+	 *
+	 * \param fileName - A std::string containing the file to write
+	 * \param intervalS - An integer containing the interval between writes
+	 * in seconds
+	 * \return Returns true if the dump was started, false otherwise
+	 */
+	bool startDump(const std::string &fileName, int intervalS);
+
+	/**
+	 * \brief Stop periodically writing the metrics to a file
+	 */
+	void stopDump();
+
+ private:
+	/**
+	 * \brief The counters, by name
+	 */
+	std::map<std::string, std::unique_ptr<std::atomic<int64_t>>> m_mCounters;
+
+	/**
+	 * \brief The gauges, by name
+	 */
+	std::map<std::string, std::unique_ptr<std::atomic<double>>> m_mGauges;
+
+	/**
+	 * \brief The histograms, by name
+	 */
+	std::map<std::string, std::unique_ptr<glass3::util::LatencyHistogram>>
+		m_mHistograms;
+
+	/**
+	 * \brief The id of the periodic dump timer, -1 if not dumping
+	 */
+	int64_t m_iDumpTimerID;
+
+	/**
+	 * \brief A mutex to control access to the metric maps
+	 */
+	std::mutex m_MetricsMutex;
+
+	/**
+	 * \brief A mutex to control starting and stopping the dump
+	 */
+	std::mutex m_DumpMutex;
+};
+}  // namespace util
+}  // namespace glass3
+#endif  // METRICSREGISTRY_H
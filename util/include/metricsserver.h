@@ -0,0 +1,121 @@
+/*****************************************
+ * This file is documented for Doxygen.
+ * If you modify this file please update
+ * the comments so that Doxygen will still
+ * be able to work.
+ ****************************************/
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <threadbaseclass.h>
+
+#include <string>
+
+namespace glass3 {
+namespace util {
+
+/**
+ * \brief glass3::util::MetricsServer class - serves the metrics over http
+ *
+ * The glass3::util::MetricsServer class is a minimal http server on the
+ * loopback interface that answers "GET /metrics" with the json snapshot of
+ * the shared glass3::util::MetricsRegistry, so that local monitoring can
+ * scrape the metrics. It handles one request per connection, one connection
+ * at a time, and is only reachable from the local host.
+ *
+ * Serving is not supported on Windows, where openPort() fails.
+ *
+ * MetricsServer inherits from the glass3::util::ThreadBaseClass class.
+ */
+class MetricsServer : public glass3::util::ThreadBaseClass {
+ public:
+	/**
+	 * \brief MetricsServer constructor
+	 *
+	 * The constructor for the MetricsServer class.
+	 * Initializes members to default values, does not open a port.
+	 */
+	MetricsServer();
+
+	/**
+	 * \brief MetricsServer destructor
+	 *
+	 * The destructor for the MetricsServer class.
+	 * Stops the thread and closes the port
+	 */
+	~MetricsServer();
+
+	/**
+	 * \brief Open the port to serve on
+	 *
+	 * Listens on the given port of the loopback interface, closing any port
+	 * already open. start() the thread to begin serving.
+	 *
+	 * \param port - An integer containing the port to listen on, 0 to pick
+	 * a free port
+	 * \return Returns true if the port was opened, false otherwise
+	 */
+	bool openPort(int port);
+
+	/**
+	 * \brief Close the port
+	 */
+	void closePort();
+
+	/**
+	 * \brief Get the port being served on
+	 *
+	 * \return Returns an integer containing the port, or -1 if no port is
+	 * open
+	 */
+	int getPort();
+
+	/**
+	 * \brief MetricsServer work function
+	 *
+	 * Waits up to k_iPollTimeoutMS for a connection, and answers its
+	 * request.
+	 *
+	 * \return Returns glass3::util::WorkState::OK if a request was answered,
+	 * glass3::util::WorkState::Idle if there was no connection
+	 */
+	glass3::util::WorkState work() override;
+
+	// constants
+	/**
+	 * \brief How long work() waits for a connection in milliseconds
+	 */
+	static const int k_iPollTimeoutMS = 100;
+
+	/**
+	 * \brief How long to wait for a request on a connection in milliseconds
+	 */
+	static const int k_iRequestTimeoutMS = 1000;
+
+	/**
+	 * \brief The largest request read, anything longer is ignored
+	 */
+	static const int k_iMaxRequestSize = 4096;
+
+ private:
+	/**
+	 * \brief Build the http response to a request
+	 *
+	 * \param request - A std::string containing the http request
+	 * \return Returns a std::string containing the http response
+	 */
+	static std::string getResponse(const std::string &request);
+
+	/**
+	 * \brief The listening socket, -1 if no port is open
+	 */
+	int m_iListenFD;
+
+	/**
+	 * \brief The port being served on, -1 if no port is open
+	 */
+	int m_iPort;
+};
+}  // namespace util
+}  // namespace glass3
+#endif  // METRICSSERVER_H
@@ -0,0 +1,154 @@
+/*****************************************
+ * This file is documented for Doxygen.
+ * If you modify this file please update
+ * the comments so that Doxygen will still
+ * be able to work.
+ ****************************************/
+#ifndef RANDOMSTREAM_H
+#define RANDOMSTREAM_H
+
+#include <cstdint>
+
+namespace glass3 {
+namespace util {
+
+/**
+ * \brief glassutil random stream class
+ *
+ * The RandomStream class is a small, fast, seedable pseudo-random number
+ * stream used by the annealing locators to generate their randomized step
+ * sizes. Uniform samples come from a xoshiro256** generator, and normal
+ * samples from the Marsaglia and Tsang ziggurat method, which needs a single
+ * generator call and a table lookup for the vast majority of samples.
+ *
+ * A RandomStream is not thread safe, each thread (or each object that needs
+ * reproducible results, such as a hypo) should use its own stream.
+ * getThreadStream() provides a randomly seeded stream for the calling thread.
+ */
+class RandomStream {
+ public:
+	/**
+	 * \brief RandomStream constructor
+	 *
+	 * The constructor for the RandomStream class. Seeds the stream from
+	 * std::random_device.
+	 */
+	RandomStream();
+
+	/**
+	 * \brief RandomStream advanced constructor
+	 *
+	 * The advanced constructor for the RandomStream class. Seeds the stream
+	 * with the provided seed.
+	 *
+	 * \param seed - An unsigned 64 bit integer containing the seed
+	 */
+	explicit RandomStream(uint64_t seed);
+
+	/**
+	 * \brief RandomStream destructor
+	 *
+	 * The destructor for the RandomStream class.
+	 */
+	~RandomStream();
+
+	/**
+	 * \brief Seed the stream
+	 *
+	 * Seeds the stream, the same seed always produces the same sequence of
+	 * samples.
+	 *
+	 * \param seed - An unsigned 64 bit integer containing the seed
+	 */
+	void seed(uint64_t seed);
+
+	/**
+	 * \brief Seed the stream from std::random_device
+	 */
+	void seedRandomly();
+
+	/**
+	 * \brief Generate the next raw sample
+	 *
+	 * \return Returns an unsigned 64 bit integer containing the next sample
+	 */
+	uint64_t next();
+
+	/**
+	 * \brief Generate a uniform random sample
+	 *
+	 * Generates a uniform random sample in the half open range [x, y)
+	 *
+	 * \param x - The minimum random number
+	 * \param y - The maximum random number
+	 * \return Returns the random sample
+	 */
+	double uniform(double x, double y);
+
+	/**
+	 * \brief Generate a Gaussian random sample
+	 *
+	 * Generates a normal random deviate using the ziggurat method.
+	 *
+	 * \param avg - The mean of the distribution
+	 * \param std - The standard deviation of the distribution
+	 * \return Returns the Gaussian random sample
+	 */
+	double gauss(double avg, double std);
+
+	/**
+	 * \brief Get the calling thread's random stream
+	 *
+	 * Gets the random stream belonging to the calling thread, which is
+	 * seeded from std::random_device the first time it is used.
+	 *
+	 * \return Returns a reference to the calling thread's random stream
+	 */
+	static RandomStream & getThreadStream();
+
+	/**
+	 * \brief Combine a seed with a value
+	 *
+	 * Combines a seed with the bit pattern of a double value, used to derive
+	 * a reproducible seed from a base seed and the state being randomized,
+	 * such as a hypo location.
+	 *
+	 * \param seed - An unsigned 64 bit integer containing the seed
+	 * \param value - A double containing the value to combine
+	 * \return Returns an unsigned 64 bit integer containing the combined seed
+	 */
+	static uint64_t combineSeed(uint64_t seed, double value);
+
+	/**
+	 * \brief The number of layers in the ziggurat
+	 */
+	static const int k_iNumZigguratLayers = 128;
+
+ private:
+	/**
+	 * \brief Generate a uniform random sample in the open range (0, 1)
+	 *
+	 * \return Returns the random sample
+	 */
+	double uniformOpen();
+
+	/**
+	 * \brief Generate a standard normal sample from the ziggurat tail or
+	 * wedges
+	 *
+	 * Handles the rare samples rejected by the fast path of gauss()
+	 *
+	 * \param hz - A signed 32 bit integer containing the rejected sample
+	 * \param iz - An integer containing the rejected sample's layer
+	 * \return Returns the standard normal sample
+	 */
+	double gaussSlow(int32_t hz, int iz);
+
+	/**
+	 * \brief The xoshiro256** generator state
+	 */
+	uint64_t m_aState[4];
+};
+}  // namespace util
+}  // namespace glass3
+#endif  // RANDOMSTREAM_H
@@ -14,7 +14,9 @@
 #include <mutex>
 #include <string>
 #include <vector>
-#include <map>
+#include <memory>
+#include <functional>
+#include <atomic>
 #include <ctime>
 
 namespace glass3 {
@@ -29,6 +31,11 @@ namespace util {
  * It is intended that the derived class implement the desired thread work by
  * overriding the pure virtual function work()
  *
+ * Each work thread gets its own heartbeat slot when it is started, which
+ * setThreadHealth() stamps with a coarse clock, so that reporting health from
+ * inside tight loops costs a few nanoseconds and takes no lock. healthCheck()
+ * reads the slots.
+ *
  * This class inherits from util::BaseClass
  */
 class ThreadBaseClass : public util::BaseClass {
@@ -120,11 +127,12 @@ class ThreadBaseClass : public util::BaseClass {
 	 * \brief Function to set thread health
 	 *
 	 * This function signifies the thread health by using setLastHealthy
-	 * to set m_tLastHealthy for the current thread to now if health is true
+	 * to stamp the heartbeat slot of the current thread with now if health is
+	 * true. Does nothing when not called from one of the work threads.
 	 *
 	 * \param health = A boolean value indicating thread health, true indicates
-	 * that setLastHealthy to set m_tLastHealthy to now, false indicates
-	 * it should not
+	 * that setLastHealthy to stamp the slot with now, false indicates
+	 * it should stamp it as unhealthy
 	 */
 	void setThreadHealth(bool health = true);
 
@@ -132,9 +140,8 @@ class ThreadBaseClass : public util::BaseClass {
 	 * \brief work threads check function
 	 *
 	 * Checks to see if each thread that runs the workLoop() function is still
-	 * operational, by checking the value of m_ThreadHealthMap[id] (==true)
-	 * every m_iHealthCheckInterval seconds, setting m_ThreadHealthMap[id] to
-	 * now after the check.
+	 * operational, by checking that the heartbeat slot of every work thread
+	 * was stamped within the last m_iHealthCheckInterval seconds.
 	 *
 	 * \return returns true if the pool is still running after
 	 * m_iHealthCheckInterval seconds, false otherwise
@@ -177,9 +184,10 @@ class ThreadBaseClass : public util::BaseClass {
 	/**
 	 * \brief Function to set work threads health check interval
 	 *
-	 * This function sets the time interval after which an entry in
-	 * m_ThreadHealthMap being older than now minus the time interval (not
-	 * responded) indicates that the work thread has died in healthCheck()
+	 * This function sets the time interval after which the
+	 * heartbeat slot of a work thread being older than now minus the time
+	 * interval (not responded) indicates that the work thread has died in
+	 * healthCheck()
 	 *
 	 * \param interval = An integer value indicating the work thread health
 	 * check interval in seconds
@@ -189,9 +197,10 @@ class ThreadBaseClass : public util::BaseClass {
 	/**
 	 * \brief Function to retrieve the work threads health check interval
 	 *
-	 * This function retrieves the time interval after which an entry in
-	 * m_ThreadHealthMap being older than now minus the time interval (not
-	 * responded) indicates that the work thread has died in healthCheck()
+	 * This function retrieves the time interval after which the
+	 * heartbeat slot of a work thread being older than now minus the time
+	 * interval (not responded) indicates that the work thread has died in
+	 * healthCheck()
 	 *
 	 * \return An integer value containing the work thread health check interval
 	 * in seconds
@@ -273,26 +282,95 @@ class ThreadBaseClass : public util::BaseClass {
 	/**
 	 * \brief Function to set the last time the work thread was healthy
 	 *
-	 * This function sets the last time the work thread was healthy
+	 * This function sets the last time the work thread was healthy in the
+	 * heartbeat slot of the current thread, it does nothing when not called
+	 * from one of the work threads
 	 *
 	 * \param now - A std::time_t containing the last time the thread was
 	 * healthy
 	 */
 	void setLastHealthy(std::time_t now);
 
+	/**
+	 * \brief Function to add a work thread
+	 *
+	 * This function gives a new heartbeat slot to a new thread that runs the
+	 * provided function, and adds the thread to m_WorkThreads, so that it is
+	 * monitored by healthCheck() and joined by stop(). Derived classes use it
+	 * to run work threads of their own.
+	 *
+	 * \param threadFunction - A std::function<void()> containing the function
+	 * for the thread to run
+	 */
+	void addWorkThread(std::function<void()> threadFunction);
+
 	/**
 	 * \brief the std::vector that contains the work std::thread objects
 	 */
 	std::vector<std::thread> m_WorkThreads;
 
+ private:
 	/**
-	 * \brief A std::map containing the epoch times as std::atomic<double>> that
-	 * each work thread was last marked as healthy, identified by the
-	 * thread id
+	 * \brief The heartbeat of a work thread
+	 *
+	 * Padded so that the heartbeat of each thread has a cache line to itself
+	 * and stamping it never slows down another thread.
 	 */
-	std::map<std::thread::id, std::atomic<int>> m_ThreadHealthMap;
+	typedef struct _HealthSlot {
+		/**
+		 * \brief Padding before the heartbeat
+		 */
+		char padBefore[64];
+
+		/**
+		 * \brief The epoch time the thread was last healthy, 0 if unhealthy
+		 */
+		std::atomic<std::time_t> tLastHealthy;
+
+		/**
+		 * \brief Padding after the heartbeat
+		 */
+		char padAfter[64];
+
+		/**
+		 * \brief The ThreadBaseClass the thread works for
+		 */
+		ThreadBaseClass * pOwner;
+
+		/**
+		 * \brief The hash of the thread id, for logging
+		 */
+		size_t iThreadId;
+	} HealthSlot;
+
+	/**
+	 * \brief Get the time from a coarse clock
+	 *
+	 * Gets the epoch time from a clock that is only as precise as the
+	 * scheduler tick where available, which is cheaper to read than the
+	 * precise clock.
+	 *
+	 * \return Returns a std::time_t containing the epoch time
+	 */
+	static std::time_t getCoarseTime();
+
+	/**
+	 * \brief The heartbeat slot of the current thread, NULL if the current
+	 * thread is not a work thread
+	 */
+	static thread_local HealthSlot * m_pCurrentHealthSlot;
+
+	/**
+	 * \brief The heartbeat slots of the work threads
+	 */
+	std::vector<std::unique_ptr<HealthSlot>> m_HealthSlots;
+
+	/**
+	 * \brief A mutex to control access to m_HealthSlots, the slots
+	 * themselves are stamped without it
+	 */
+	std::mutex m_HealthSlotsMutex;
 
- private:
 	/**
 	 * \brief the std::string containing the name of the works thread,
 	 * used for logging
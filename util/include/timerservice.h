@@ -0,0 +1,252 @@
+/*****************************************
+ * This file is documented for Doxygen.
+ * If you modify this file please update
+ * the comments so that Doxygen will still
+ * be able to work.
+ ****************************************/
+#ifndef TIMERSERVICE_H
+#define TIMERSERVICE_H
+
+#include <threadbaseclass.h>
+#include <timerwheel.h>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace glass3 {
+namespace util {
+
+/**
+ * \brief glass3::util::TimerService class - a shared timer thread for
+ * periodic work
+ *
+ * The glass3::util::TimerService class runs timer callbacks on a single
+ * thread, so that components with periodic work (heartbeats, hourly checks,
+ * performance reports) register a timer instead of each checking the time
+ * on every pass of their own work loop. Due timers are found with a
+ * glass3::util::TimerWheel, so each tick only costs work for the timers that
+ * are actually due.
+ *
+ * A timer either runs on the wall clock, for operational work such as
+ * heartbeats and performance reports, or on the glass3::util::Clock, for
+ * data driven work that should follow the simulated time when replaying
+ * data. If a clock jumps backwards, or further forward than
+ * k_iMaxCatchUpTicks, its timers are restarted from the new time instead of
+ * being stepped through the jump.
+ *
+ * Callbacks run on the timer thread with k_iTickMS resolution, and should be
+ * short, as a long callback delays every other timer.
+ *
+ * Most components should use the shared instance from getInstance().
+ *
+ * TimerService inherits from the glass3::util::ThreadBaseClass class.
+ */
+class TimerService : public glass3::util::ThreadBaseClass {
+ public:
+	/**
+	 * \brief TimerService constructor
+	 *
+	 * The constructor for the TimerService class.
+	 * Initializes members to default values, does not start the thread.
+	 */
+	TimerService();
+
+	/**
+	 * \brief TimerService destructor
+	 *
+	 * The destructor for the TimerService class.
+	 * Stops the thread
+	 */
+	~TimerService();
+
+	/**
+	 * \brief Get the shared TimerService
+	 *
+	 * Gets the process wide TimerService, creating and starting it on first
+	 * use. The shared TimerService is never destroyed, so that timers can
+	 * still be removed by objects destroyed during program exit.
+	 *
+	 * \return Returns a reference to the shared TimerService
+	 */
+	static TimerService & getInstance();
+
+	/**
+	 * \brief Add a timer
+	 *
+	 * Adds a timer that calls the provided callback once the interval has
+	 * passed, and then every interval after that if it repeats.
+	 *
+	 * \param name - A std::string containing the name of the timer, used for
+	 * logging
+	 * \param intervalMS - An integer containing the timer interval in
+	 * milliseconds
+	 * \param callback - A std::function<void()> containing the function to
+	 * call when the timer is due
+	 * \param useClock - A boolean flag, true if the interval is measured on
+	 * the glass3::util::Clock (and so follows simulated time), false if it is
+	 * measured on the wall clock
+	 * \param repeat - A boolean flag, true if the timer repeats, false if it
+	 * is removed once it has been called
+	 * \return Returns an int64_t containing the id of the new timer, or -1 if
+	 * the timer could not be added
+	 */
+	int64_t addTimer(const std::string &name, int intervalMS,
+						std::function<void()> callback, bool useClock = false,
+						bool repeat = true);
+
+	/**
+	 * \brief Remove a timer
+	 *
+	 * Removes the timer with the provided id. Once this returns the timer's
+	 * callback is not running and will not be called again, so it is safe to
+	 * destroy anything the callback uses. Because this waits for any running
+	 * callback, it must not be called while holding a lock that a callback
+	 * may take.
+	 *
+	 * \param timerID - An int64_t containing the id of the timer to remove
+	 * \return Returns true if the timer existed, false otherwise
+	 */
+	bool removeTimer(int64_t timerID);
+
+	/**
+	 * \brief Check if a timer exists
+	 *
+	 * \param timerID - An int64_t containing the id of the timer to check
+	 * \return Returns true if the timer exists, false otherwise
+	 */
+	bool hasTimer(int64_t timerID);
+
+	/**
+	 * \brief Get the number of timers
+	 *
+	 * \return Returns an integer containing the number of timers
+	 */
+	int getTimerCount();
+
+	/**
+	 * \brief TimerService work function
+	 *
+	 * Advances the timer wheels to the current time, and calls the callbacks
+	 * of the timers that are due.
+	 *
+	 * \return Always returns glass3::util::WorkState::Idle, so that the
+	 * thread sleeps for a tick between calls
+	 */
+	glass3::util::WorkState work() override;
+
+	// constants
+	/**
+	 * \brief The length of a timer tick in milliseconds
+	 */
+	static const int k_iTickMS = 100;
+
+	/**
+	 * \brief The largest clock jump in ticks that is stepped through, larger
+	 * jumps restart the timers from the new time (one day)
+	 */
+	static const int64_t k_iMaxCatchUpTicks = 24 * 60 * 60 * 1000 / k_iTickMS;
+
+ private:
+	/**
+	 * \brief A timer
+	 */
+	typedef struct _TimerInfo {
+		/**
+		 * \brief The name of the timer, used for logging
+		 */
+		std::string sName;
+
+		/**
+		 * \brief The function to call when the timer is due
+		 */
+		std::function<void()> callback;
+
+		/**
+		 * \brief The timer interval in ticks
+		 */
+		int64_t iIntervalTicks;
+
+		/**
+		 * \brief The tick the timer is next due at
+		 */
+		int64_t iDueTick;
+
+		/**
+		 * \brief Whether the timer runs on the glass3::util::Clock rather than
+		 * the wall clock
+		 */
+		bool bUseClock;
+
+		/**
+		 * \brief Whether the timer repeats
+		 */
+		bool bRepeat;
+	} TimerInfo;
+
+	/**
+	 * \brief Get the current tick of the given clock
+	 *
+	 * \param useClock - A boolean flag, true for the glass3::util::Clock,
+	 * false for the wall clock
+	 * \return Returns an int64_t containing the current tick
+	 */
+	static int64_t getCurrentTick(bool useClock);
+
+	/**
+	 * \brief Advance one of the timer wheels, m_TimerMutex must be held
+	 *
+	 * \param useClock - A boolean flag, true for the glass3::util::Clock
+	 * wheel, false for the wall clock wheel
+	 * \param dueTimers - A pointer to a std::vector to append the ids of the
+	 * due timers to
+	 */
+	void advanceWheel(bool useClock, std::vector<int64_t> *dueTimers);
+
+	/**
+	 * \brief The timers, by id
+	 */
+	std::map<int64_t, TimerInfo> m_mTimers;
+
+	/**
+	 * \brief The wheel of timers on the wall clock
+	 */
+	glass3::util::TimerWheel m_WallWheel;
+
+	/**
+	 * \brief The wheel of timers on the glass3::util::Clock
+	 */
+	glass3::util::TimerWheel m_ClockWheel;
+
+	/**
+	 * \brief The wall clock tick the wall clock wheel was last advanced to
+	 */
+	int64_t m_iLastWallTick;
+
+	/**
+	 * \brief The glass3::util::Clock tick the clock wheel was last advanced to
+	 */
+	int64_t m_iLastClockTick;
+
+	/**
+	 * \brief The id to give the next timer
+	 */
+	int64_t m_iNextTimerID;
+
+	/**
+	 * \brief A mutex to control access to the timers
+	 */
+	std::mutex m_TimerMutex;
+
+	/**
+	 * \brief A mutex held while callbacks run, so that removeTimer() can wait
+	 * for a running callback. Recursive so that a callback can remove timers.
+	 */
+	std::recursive_mutex m_CallbackMutex;
+};
+}  // namespace util
+}  // namespace glass3
+#endif  // TIMERSERVICE_H
@@ -0,0 +1,216 @@
+/*****************************************
+ * This file is documented for Doxygen.
+ * If you modify this file please update
+ * the comments so that Doxygen will still
+ * be able to work.
+ ****************************************/
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <baseclass.h>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <map>
+#include <list>
+#include <vector>
+
+namespace glass3 {
+namespace util {
+/**
+ * \brief glass3::util::TimerWheel class - a thread safe hierarchical timer
+ * wheel
+ *
+ * The glass3::util::TimerWheel class is a class implementing a hierarchical
+ * timer wheel of std::string ids keyed by an integer due time (typically epoch
+ * seconds). Scheduling, rescheduling and canceling an id are O(1), and
+ * advancing the wheel costs O(1) per elapsed tick plus O(1) per due id, so the
+ * caller only does work for the ids that are actually due instead of scanning
+ * every scheduled id.
+ *
+ * The wheel has k_iNumLevels levels of k_iSlotsPerLevel slots, each level
+ * covering k_iSlotsPerLevel times the span of the level below it. Ids due
+ * beyond the span of the top level are parked in the farthest top level slot
+ * and re-placed when that slot is reached.
+ *
+ * Each id is scheduled at most once, scheduling an id that is already
+ * scheduled replaces its due time. Every scheduled id has exactly one entry in
+ * the wheel, which is moved or erased in place when the id is rescheduled or
+ * canceled, so the wheel never holds more entries than scheduled ids.
+ *
+ * TimerWheel inherits from the baseclass class.
+ */
+class TimerWheel : public util::BaseClass {
+ public:
+	/**
+	 * \brief TimerWheel constructor
+	 *
+	 * The constructor for the TimerWheel class.
+	 * Initializes members to default values.
+	 */
+	TimerWheel();
+
+	/**
+	 * \brief TimerWheel destructor
+	 *
+	 * The destructor for the TimerWheel class.
+	 */
+	virtual ~TimerWheel();
+
+	/**
+	 * \brief TimerWheel clear function
+	 *
+	 * The clear function for the TimerWheel class.
+	 * Cancel all ids currently scheduled in the TimerWheel
+	 */
+	void clear() override;
+
+	/**
+	 * \brief schedule an id
+	 *
+	 * Schedule the provided id to be due at the provided time, replacing any
+	 * existing schedule for the id. Ids scheduled at or before the current
+	 * time of the wheel will be returned by the next call to advance()
+	 *
+	 * \param id - A std::string containing the id to schedule
+	 * \param dueTime - An int64_t containing the time the id is due
+	 */
+	void schedule(const std::string &id, int64_t dueTime);
+
+	/**
+	 * \brief cancel an id
+	 *
+	 * Cancel any existing schedule for the provided id
+	 *
+	 * \param id - A std::string containing the id to cancel
+	 * \return returns true if the id was scheduled, false otherwise.
+	 */
+	bool cancel(const std::string &id);
+
+	/**
+	 * \brief check if an id is scheduled
+	 *
+	 * \param id - A std::string containing the id to check
+	 * \return returns true if the id is scheduled, false otherwise.
+	 */
+	bool isScheduled(const std::string &id);
+
+	/**
+	 * \brief advance the wheel
+	 *
+	 * Advance the wheel to the provided time, returning the ids that are due
+	 * at or before that time. Returned ids are no longer scheduled.
+	 *
+	 * \param now - An int64_t containing the time to advance the wheel to
+	 * \return returns a std::vector of std::strings containing the due ids,
+	 * in due time order.
+	 */
+	std::vector<std::string> advance(int64_t now);
+
+	/**
+	 * \brief get the number of scheduled ids
+	 *
+	 * \return returns an integer containing the number of ids scheduled in
+	 * the TimerWheel
+	 */
+	int size();
+
+	// constants
+	/**
+	 * \brief The number of bits of the due time covered by each level
+	 */
+	static const int k_iBitsPerLevel = 6;
+
+	/**
+	 * \brief The number of slots in each level
+	 */
+	static const int k_iSlotsPerLevel = 1 << k_iBitsPerLevel;
+
+	/**
+	 * \brief The number of levels in the wheel
+	 */
+	static const int k_iNumLevels = 4;
+
+ private:
+	/**
+	 * \brief The schedule of an id
+	 */
+	typedef struct _Schedule {
+		/**
+		 * \brief The time the id is due
+		 */
+		int64_t iDueTime;
+
+		/**
+		 * \brief A pointer to the slot or list holding the entry of the id
+		 */
+		std::list<std::string> * pList;
+
+		/**
+		 * \brief The entry of the id in pList
+		 */
+		std::list<std::string>::iterator itEntry;
+	} Schedule;
+
+	/**
+	 * \brief get the slot of the wheel that a due time belongs in, or the
+	 * due list if it is already due
+	 * \param dueTime - An int64_t containing the due time
+	 * \return returns a pointer to the std::list to place the entry in
+	 */
+	std::list<std::string> * getList(int64_t dueTime);
+
+	/**
+	 * \brief move an entry to the appropriate slot of the wheel, or the
+	 * due list if it is already due, and record where it now is
+	 * \param fromList - A pointer to the std::list currently holding the
+	 * entry
+	 * \param itEntry - An iterator to the entry to move
+	 */
+	void place(std::list<std::string> * fromList,
+				std::list<std::string>::iterator itEntry);
+
+	/**
+	 * \brief re-place all the entries in the given slot
+	 * \param level - An integer containing the level of the slot
+	 * \param slot - An integer containing the slot to cascade
+	 */
+	void cascade(int level, int slot);
+
+	/**
+	 * \brief The slots of the wheel, each a list of the ids placed in it
+	 */
+	std::list<std::string> m_Slots[k_iNumLevels][k_iSlotsPerLevel];
+
+	/**
+	 * \brief A std::list of the ids that were already due when they were
+	 * placed
+	 */
+	std::list<std::string> m_DueList;
+
+	/**
+	 * \brief A std::map containing the Schedule of each scheduled id
+	 */
+	std::map<std::string, Schedule> m_mSchedules;
+
+	/**
+	 * \brief The next time of the wheel that has not been processed, or -1
+	 * if the wheel has not been started
+	 */
+	int64_t m_iCurrentTime;
+
+	/**
+	 * \brief Retrieves a reference to the class member containing the mutex
+	 * used to control access to class members
+	 */
+	std::mutex & getMutex();
+
+	/**
+	 * \brief A mutex to control access to class members
+	 */
+	std::mutex m_Mutex;
+};
+}  // namespace util
+}  // namespace glass3
+#endif  // TIMERWHEEL_H
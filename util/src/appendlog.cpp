@@ -0,0 +1,300 @@
+#include <appendlog.h>
+#include <logger.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <string>
+
+namespace glass3 {
+namespace util {
+
+// constants
+constexpr const char * AppendLog::k_sActiveExtension;
+const int64_t AppendLog::k_iMaxBufferSize;
+
+// ---------------------------------------------------------AppendLog
+AppendLog::AppendLog() {
+	m_sDirectory = "";
+	m_sPrefix = "";
+	m_sExtension = "";
+	m_iMaxFileSize = 0;
+	m_iMaxFileAgeS = 0;
+	m_iFlushRecords = 1;
+	m_iFlushIntervalMS = 0;
+	m_sBuffer = "";
+	m_iBufferedRecords = 0;
+	m_sFileName = "";
+	m_iFileSize = 0;
+	m_iFileCount = 0;
+	m_iCompletedFileCount = 0;
+	m_tFileOpened = std::chrono::steady_clock::now();
+	m_tLastFlush = std::chrono::steady_clock::now();
+}
+
+// ---------------------------------------------------------~AppendLog
+AppendLog::~AppendLog() {
+	close();
+}
+
+// ---------------------------------------------------------setup
+bool AppendLog::setup(const std::string &directory, const std::string &prefix,
+						const std::string &extension, int64_t maxFileSize,
+						int maxFileAgeS, int flushRecords,
+						int flushIntervalMS) {
+	if ((directory == "") || (extension == "")) {
+		glass3::util::Logger::log(
+				"error",
+				"AppendLog::setup(): Directory and extension are required.");
+		return (false);
+	}
+
+	if ((maxFileSize < 0) || (maxFileAgeS < 0) || (flushRecords < 1)
+			|| (flushIntervalMS < 0)) {
+		glass3::util::Logger::log(
+				"error",
+				"AppendLog::setup(): Invalid rotation or flush policy.");
+		return (false);
+	}
+
+	// finish off anything from the previous setup
+	close();
+
+	std::lock_guard<std::mutex> guard(m_Mutex);
+	m_sDirectory = directory;
+	m_sPrefix = prefix;
+	m_sExtension = extension;
+	m_iMaxFileSize = maxFileSize;
+	m_iMaxFileAgeS = maxFileAgeS;
+	m_iFlushRecords = flushRecords;
+	m_iFlushIntervalMS = flushIntervalMS;
+	m_iFileCount = 0;
+	m_iCompletedFileCount = 0;
+	m_tLastFlush = std::chrono::steady_clock::now();
+
+	return (true);
+}
+
+// ---------------------------------------------------------append
+bool AppendLog::append(const std::string &record) {
+	std::lock_guard<std::mutex> guard(m_Mutex);
+
+	m_sBuffer += record;
+	m_sBuffer += "\n";
+	m_iBufferedRecords++;
+
+	if (m_iBufferedRecords < m_iFlushRecords) {
+		return (true);
+	}
+
+	return (writeBuffer());
+}
+
+// ---------------------------------------------------------flush
+bool AppendLog::flush() {
+	std::lock_guard<std::mutex> guard(m_Mutex);
+	return (writeBuffer());
+}
+
+// ---------------------------------------------------------flushIfDue
+bool AppendLog::flushIfDue() {
+	std::lock_guard<std::mutex> guard(m_Mutex);
+	std::chrono::steady_clock::time_point tNow =
+			std::chrono::steady_clock::now();
+
+	bool result = true;
+	if ((m_iBufferedRecords > 0)
+			&& (std::chrono::duration_cast<std::chrono::milliseconds>(
+					tNow - m_tLastFlush).count() >= m_iFlushIntervalMS)) {
+		result = writeBuffer();
+	}
+
+	// hand off an old log file even if nothing else is being written
+	if ((m_File.is_open() == true) && (m_iMaxFileAgeS > 0)
+			&& (std::chrono::duration_cast<std::chrono::seconds>(
+					tNow - m_tFileOpened).count() >= m_iMaxFileAgeS)) {
+		completeFile();
+	}
+
+	return (result);
+}
+
+// ---------------------------------------------------------close
+void AppendLog::close() {
+	std::lock_guard<std::mutex> guard(m_Mutex);
+	writeBuffer();
+	completeFile();
+}
+
+// ---------------------------------------------------------getFileName
+std::string AppendLog::getFileName() {
+	std::lock_guard<std::mutex> guard(m_Mutex);
+	return (m_sFileName);
+}
+
+// ---------------------------------------------------------getBufferedRecordCount
+int AppendLog::getBufferedRecordCount() {
+	std::lock_guard<std::mutex> guard(m_Mutex);
+	return (m_iBufferedRecords);
+}
+
+// ---------------------------------------------------------getCompletedFileCount
+int AppendLog::getCompletedFileCount() {
+	std::lock_guard<std::mutex> guard(m_Mutex);
+	return (m_iCompletedFileCount);
+}
+
+// ---------------------------------------------------------writeBuffer
+bool AppendLog::writeBuffer() {
+	m_tLastFlush = std::chrono::steady_clock::now();
+
+	if (m_iBufferedRecords == 0) {
+		return (true);
+	}
+
+	// rotate before the file gets too big or too old, a batch is never split
+	// across files
+	if (m_File.is_open() == true) {
+		if (((m_iMaxFileSize > 0) && (m_iFileSize > 0)
+				&& (m_iFileSize + static_cast<int64_t>(m_sBuffer.size())
+						> m_iMaxFileSize))
+				|| ((m_iMaxFileAgeS > 0)
+						&& (std::chrono::duration_cast<std::chrono::seconds>(
+								m_tLastFlush - m_tFileOpened).count()
+								>= m_iMaxFileAgeS))) {
+			completeFile();
+		}
+	}
+
+	bool result = true;
+	if ((m_File.is_open() == true) || (openFile() == true)) {
+		m_File.write(m_sBuffer.data(), m_sBuffer.size());
+		m_File.flush();
+
+		if (m_File.fail() == true) {
+			glass3::util::Logger::log(
+					"error",
+					"AppendLog::writeBuffer(): Failed to write "
+							+ std::to_string(m_iBufferedRecords)
+							+ " records to " + m_sFileName
+							+ ", will retry in a new file.");
+
+			// cut off whatever part of the batch made it into the file, so it
+			// only holds complete records, and finish with it
+			m_File.close();
+			m_File.clear();
+#ifndef _WIN32
+			if (truncate(m_sFileName.c_str(), m_iFileSize) != 0) {
+				glass3::util::Logger::log(
+						"warning",
+						"AppendLog::writeBuffer(): Unable to remove a partial "
+								"batch from " + m_sFileName + ".");
+			}
+#endif
+			completeFile();
+			result = false;
+		} else {
+			m_iFileSize += m_sBuffer.size();
+		}
+	} else {
+		glass3::util::Logger::log(
+				"error",
+				"AppendLog::writeBuffer(): Unable to write "
+						+ std::to_string(m_iBufferedRecords)
+						+ " records, no log file, will retry.");
+		result = false;
+	}
+
+	if (result == true) {
+		m_sBuffer.clear();
+		m_iBufferedRecords = 0;
+	} else if (static_cast<int64_t>(m_sBuffer.size()) > k_iMaxBufferSize) {
+		// keep the records for the next write, but don't let a bad directory
+		// or full disk grow the buffer without limit
+		glass3::util::Logger::log(
+				"error",
+				"AppendLog::writeBuffer(): Dropping "
+						+ std::to_string(m_iBufferedRecords)
+						+ " records that could not be written.");
+		m_sBuffer.clear();
+		m_iBufferedRecords = 0;
+	}
+
+	return (result);
+}
+
+// ---------------------------------------------------------openFile
+bool AppendLog::openFile() {
+	if (m_sDirectory == "") {
+		return (false);
+	}
+
+	// name the file for when it was started, keeping it unique within the
+	// second
+	std::string fileName = m_sDirectory + "/";
+	if (m_sPrefix != "") {
+		fileName += m_sPrefix + "_";
+	}
+	fileName += std::to_string(static_cast<int64_t>(std::time(NULL))) + "_"
+			+ std::to_string(m_iFileCount) + "." + k_sActiveExtension;
+	m_iFileCount++;
+
+	m_File.open(fileName, std::ios::out | std::ios::binary | std::ios::app);
+	if (m_File.is_open() == false) {
+		glass3::util::Logger::log(
+				"error",
+				"AppendLog::openFile(): Failed to create file " + fileName
+						+ ".");
+		m_File.clear();
+		return (false);
+	}
+
+	m_sFileName = fileName;
+	m_iFileSize = 0;
+	m_tFileOpened = std::chrono::steady_clock::now();
+
+	glass3::util::Logger::log(
+			"debug", "AppendLog::openFile(): Started log file " + fileName);
+	return (true);
+}
+
+// ---------------------------------------------------------completeFile
+void AppendLog::completeFile() {
+	// a file that failed a write is already closed
+	if (m_sFileName == "") {
+		return;
+	}
+
+	if (m_File.is_open() == true) {
+		m_File.close();
+		m_File.clear();
+	}
+
+	// swap the active extension for the completed one
+	std::string activeExtension = "." + std::string(k_sActiveExtension);
+	std::string completedName = m_sFileName.substr(
+			0, m_sFileName.size() - activeExtension.size()) + "."
+			+ m_sExtension;
+	if (std::rename(m_sFileName.c_str(), completedName.c_str()) != 0) {
+		glass3::util::Logger::log(
+				"error",
+				"AppendLog::completeFile(): Unable to rename " + m_sFileName
+						+ " to " + completedName + ".");
+	} else {
+		glass3::util::Logger::log(
+				"debug",
+				"AppendLog::completeFile(): Completed log file " + completedName
+						+ " (" + std::to_string(m_iFileSize) + " bytes).");
+	}
+
+	m_iCompletedFileCount++;
+	m_sFileName = "";
+	m_iFileSize = 0;
+}
+}  // namespace util
+}  // namespace glass3
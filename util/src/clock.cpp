@@ -0,0 +1,74 @@
+#include <clock.h>
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+
+namespace glass3 {
+namespace util {
+
+// static members
+std::atomic<bool> Clock::m_bSimulated(false);
+std::atomic<double> Clock::m_dSimulatedTime(0);
+
+// ---------------------------------------------------------Clock
+Clock::Clock() {
+}
+
+// ---------------------------------------------------------~Clock
+Clock::~Clock() {
+}
+
+// ---------------------------------------------------------now
+std::time_t Clock::now() {
+	if (m_bSimulated == true) {
+		return (static_cast<std::time_t>(m_dSimulatedTime.load()));
+	}
+
+	return (std::time(NULL));
+}
+
+// ---------------------------------------------------------getEpochTime
+double Clock::getEpochTime() {
+	if (m_bSimulated == true) {
+		return (m_dSimulatedTime.load());
+	}
+
+	return (std::chrono::duration<double>(
+			std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+// ---------------------------------------------------------setSimulatedTime
+void Clock::setSimulatedTime(double epochTime) {
+	m_dSimulatedTime = epochTime;
+	m_bSimulated = true;
+}
+
+// ---------------------------------------------------------advanceSimulatedTime
+bool Clock::advanceSimulatedTime(double epochTime) {
+	if (m_bSimulated == false) {
+		return (false);
+	}
+
+	// only move forward, several threads may be advancing at once
+	double current = m_dSimulatedTime.load();
+	while (epochTime > current) {
+		if (m_dSimulatedTime.compare_exchange_weak(current, epochTime)) {
+			return (true);
+		}
+	}
+
+	return (false);
+}
+
+// ---------------------------------------------------------useRealTime
+void Clock::useRealTime() {
+	m_bSimulated = false;
+}
+
+// ---------------------------------------------------------isSimulated
+bool Clock::isSimulated() {
+	return (m_bSimulated);
+}
+}  // namespace util
+}  // namespace glass3
@@ -1,4 +1,5 @@
 #include <date.h>
+#include <clock.h>
 #include <logger.h>
 
 #include <stdio.h>
@@ -79,8 +80,8 @@ void Date::clear() {
 // ---------------------------------------------------------now
 double Date::now() {
 	// get the epoch time
-	// what time is it
-	time_t epochTime = ::time(NULL);
+	// what time is it, according to the glass clock
+	time_t epochTime = glass3::util::Clock::now();
 
 	// get the time struct
 #ifdef _WIN32
@@ -0,0 +1,213 @@
+#include <directorywatcher.h>
+#include <fileutil.h>
+#include <logger.h>
+
+#ifdef __linux__
+#include <errno.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <deque>
+#include <string>
+
+namespace glass3 {
+namespace util {
+
+// ---------------------------------------------------------DirectoryWatcher
+DirectoryWatcher::DirectoryWatcher() {
+	m_iNotifyFD = -1;
+	m_iWatchDescriptor = -1;
+	m_sPath = "";
+	m_sExtension = "";
+	m_bOverflowed = false;
+}
+
+// ---------------------------------------------------------~DirectoryWatcher
+DirectoryWatcher::~DirectoryWatcher() {
+	stop();
+}
+
+// ---------------------------------------------------------watch
+bool DirectoryWatcher::watch(const std::string &path,
+								const std::string &extension) {
+	stop();
+
+#ifdef __linux__
+	m_iNotifyFD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (m_iNotifyFD < 0) {
+		glass3::util::Logger::log(
+				"warning",
+				"DirectoryWatcher::watch(): Unable to initialize inotify, "
+				"error " + std::to_string(errno));
+		return (false);
+	}
+
+	// a file is ready once its writer closes it, or it is moved in
+	m_iWatchDescriptor = inotify_add_watch(m_iNotifyFD, path.c_str(),
+											IN_CLOSE_WRITE | IN_MOVED_TO);
+	if (m_iWatchDescriptor < 0) {
+		glass3::util::Logger::log(
+				"warning",
+				"DirectoryWatcher::watch(): Unable to watch directory " + path
+						+ ", error " + std::to_string(errno));
+		close(m_iNotifyFD);
+		m_iNotifyFD = -1;
+		return (false);
+	}
+
+	m_sPath = path;
+	m_sExtension = extension;
+
+	glass3::util::Logger::log(
+			"debug", "DirectoryWatcher::watch(): Watching directory " + path);
+	return (true);
+#else
+	glass3::util::Logger::log(
+			"info",
+			"DirectoryWatcher::watch(): Directory watching is not supported on "
+			"this platform.");
+	return (false);
+#endif
+}
+
+// ---------------------------------------------------------stop
+void DirectoryWatcher::stop() {
+#ifdef __linux__
+	if (m_iNotifyFD >= 0) {
+		if (m_iWatchDescriptor >= 0) {
+			inotify_rm_watch(m_iNotifyFD, m_iWatchDescriptor);
+		}
+		close(m_iNotifyFD);
+	}
+#endif
+
+	m_iNotifyFD = -1;
+	m_iWatchDescriptor = -1;
+	m_sPath = "";
+	m_sExtension = "";
+	m_ReadyFiles.clear();
+	m_bOverflowed = false;
+}
+
+// ---------------------------------------------------------isWatching
+bool DirectoryWatcher::isWatching() const {
+	return (m_iWatchDescriptor >= 0);
+}
+
+// ---------------------------------------------------------getPath
+const std::string & DirectoryWatcher::getPath() const {
+	return (m_sPath);
+}
+
+// ---------------------------------------------------------getNextFileName
+bool DirectoryWatcher::getNextFileName(std::string *fileName, int timeoutMS) {
+	if ((fileName == NULL) || (isWatching() == false)) {
+		return (false);
+	}
+
+	// pick up anything new, only waiting if there is nothing queued
+	readEvents(0);
+	if (m_ReadyFiles.empty() == true) {
+		readEvents(timeoutMS);
+	}
+
+	while (m_ReadyFiles.empty() == false) {
+		std::string nextFile = m_sPath + "/" + m_ReadyFiles.front();
+		m_ReadyFiles.pop_front();
+
+#ifdef __linux__
+		// skip files that are already gone
+		struct stat st;
+		if (stat(nextFile.c_str(), &st) != 0) {
+			continue;
+		}
+#endif
+
+		*fileName = nextFile;
+		return (true);
+	}
+
+	return (false);
+}
+
+// ---------------------------------------------------------hasOverflowed
+bool DirectoryWatcher::hasOverflowed() {
+	bool overflowed = m_bOverflowed;
+	m_bOverflowed = false;
+	return (overflowed);
+}
+
+// ---------------------------------------------------------readEvents
+void DirectoryWatcher::readEvents(int timeoutMS) {
+#ifdef __linux__
+	if (m_iNotifyFD < 0) {
+		return;
+	}
+
+	if (timeoutMS > 0) {
+		struct pollfd pollFD;
+		pollFD.fd = m_iNotifyFD;
+		pollFD.events = POLLIN;
+		pollFD.revents = 0;
+		if (poll(&pollFD, 1, timeoutMS) <= 0) {
+			return;
+		}
+	}
+
+	// inotify events must be read into a suitably aligned buffer
+	char buffer[4096]
+			__attribute__ ((aligned(__alignof__(struct inotify_event))));
+
+	while (true) {
+		ssize_t length = read(m_iNotifyFD, buffer, sizeof(buffer));
+		if (length <= 0) {
+			// EAGAIN, nothing more to read
+			return;
+		}
+
+		for (char * ptr = buffer; ptr < buffer + length;
+				ptr += sizeof(struct inotify_event)
+						+ reinterpret_cast<struct inotify_event *>(ptr)->len) {
+			const struct inotify_event * event =
+					reinterpret_cast<const struct inotify_event *>(ptr);
+
+			if ((event->mask & IN_Q_OVERFLOW) != 0) {
+				m_bOverflowed = true;
+				continue;
+			}
+
+			// the directory went away
+			if ((event->mask & IN_IGNORED) != 0) {
+				glass3::util::Logger::log(
+						"warning",
+						"DirectoryWatcher::readEvents(): Lost watch on "
+						"directory " + m_sPath);
+				m_iWatchDescriptor = -1;
+				m_bOverflowed = true;
+				continue;
+			}
+
+			if ((event->len == 0) || ((event->mask & IN_ISDIR) != 0)) {
+				continue;
+			}
+
+			// same filtering as getFirstFileNameByExtension
+			std::string name(event->name);
+			if (name.find(std::string(MOVEERROREXTENSION))
+					!= std::string::npos) {
+				continue;
+			}
+			if (name.find("." + m_sExtension) == std::string::npos) {
+				continue;
+			}
+
+			m_ReadyFiles.push_back(name);
+		}
+	}
+#endif
+}
+}  // namespace util
+}  // namespace glass3
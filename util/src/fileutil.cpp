@@ -19,8 +19,6 @@
 #include <vector>
 #include <cstdio>
 
-#define MOVEERROREXTENSION ".moveerror"
-
 namespace glass3 {
 namespace util {
 
@@ -1,14 +1,13 @@
 #include <logger.h>
 #include <glassmath.h>
-#include <random>
+#include <randomstream.h>
+#include <cstdint>
 #include <cmath>
+#include <utility>
 
 namespace glass3 {
 namespace util {
 
-bool GlassMath::m_bInitialized = false;
-std::default_random_engine GlassMath::m_RandomGenerator;
-
 // constants
 constexpr double GlassMath::k_RadiansToDegrees;
 constexpr double GlassMath::k_DegreesToRadians;
@@ -38,41 +37,24 @@ double GlassMath::sig_laplace_pdf(double x, double sigma) {
 
 // ---------------------------------------------------------Rand
 double GlassMath::random(double x, double y) {
-	initializeRandom();
-
-	std::uniform_real_distribution<double> distribution(x, y);
-	double number = distribution(m_RandomGenerator);
-	return (number);
+	return (RandomStream::getThreadStream().uniform(x, y));
 }
 
 // ---------------------------------------------------------gauss
 // generate Gaussian pseudo-random number using the
-// polar form of the Box-Muller method
+// ziggurat method
 double GlassMath::gauss(double avg, double std) {
-	double rsq = 0;
-	double v1 = 0;
-
-	do {
-		v1 = random(-1.0, 1.0);
-		double v2 = random(-1.0, 1.0);
-		rsq = v1 * v1 + v2 * v2;
-	} while (rsq >= 1.0);
-
-	double fac = sqrt(-2.0 * log(rsq) / rsq);
-	double x = std * fac * v1 + avg;
-
-	// return random normal deviate
-	return (x);
+	return (RandomStream::getThreadStream().gauss(avg, std));
 }
 
 // ---------------------------------------------------------initializeRandom
 void GlassMath::initializeRandom() {
-	if (m_bInitialized == false) {
-		// seed the random number generator
-		std::random_device randomDevice;
-		m_RandomGenerator.seed(randomDevice());
-		m_bInitialized = true;
-	}
+	RandomStream::getThreadStream().seedRandomly();
+}
+
+// ---------------------------------------------------------seedRandom
+void GlassMath::seedRandom(uint64_t seed) {
+	RandomStream::getThreadStream().seed(seed);
 }
 
 /**
@@ -86,5 +68,57 @@ double GlassMath::angleDifference(double angle1, double angle2) {
 	return difference;
 }
 
+// ---------------------------------------------------------solveLinearSystem
+bool GlassMath::solveLinearSystem(int n, double *matrix, double *vector) {
+	if ((n <= 0) || (matrix == NULL) || (vector == NULL)) {
+		return (false);
+	}
+
+	// forward elimination
+	for (int col = 0; col < n; col++) {
+		// find the pivot row for this column
+		int pivot = col;
+		for (int row = col + 1; row < n; row++) {
+			if (std::fabs(matrix[row * n + col])
+					> std::fabs(matrix[pivot * n + col])) {
+				pivot = row;
+			}
+		}
+
+		// singular (or effectively so)
+		if (std::fabs(matrix[pivot * n + col]) < 1.0e-12) {
+			return (false);
+		}
+
+		// swap the pivot row into place
+		if (pivot != col) {
+			for (int k = 0; k < n; k++) {
+				std::swap(matrix[col * n + k], matrix[pivot * n + k]);
+			}
+			std::swap(vector[col], vector[pivot]);
+		}
+
+		// eliminate this column from the rows below
+		for (int row = col + 1; row < n; row++) {
+			double factor = matrix[row * n + col] / matrix[col * n + col];
+			for (int k = col; k < n; k++) {
+				matrix[row * n + k] -= factor * matrix[col * n + k];
+			}
+			vector[row] -= factor * vector[col];
+		}
+	}
+
+	// back substitution
+	for (int row = n - 1; row >= 0; row--) {
+		double sum = vector[row];
+		for (int k = row + 1; k < n; k++) {
+			sum -= matrix[row * n + k] * vector[k];
+		}
+		vector[row] = sum / matrix[row * n + row];
+	}
+
+	return (true);
+}
+
 }  // namespace util
 }  // namespace glass3
@@ -0,0 +1,85 @@
+#include <instrumentedmutex.h>
+#include <metricsregistry.h>
+#include <logger.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace glass3 {
+namespace util {
+
+// static members
+std::atomic<bool> LockProfile::m_bEnabled(false);
+
+namespace {
+// the statistics of each named lock, never destroyed so that locks can be
+// profiled during program exit
+std::mutex & getLockStatsMutex() {
+	static std::mutex * lockStatsMutex = new std::mutex();
+	return (*lockStatsMutex);
+}
+
+std::map<std::string, std::unique_ptr<LockProfile::LockStats>> &
+		getLockStatsMap() {
+	static std::map<std::string, std::unique_ptr<LockProfile::LockStats>> *
+			lockStatsMap = new std::map<std::string,
+					std::unique_ptr<LockProfile::LockStats>>();
+	return (*lockStatsMap);
+}
+}  // namespace
+
+// ---------------------------------------------------------setEnabled
+void LockProfile::setEnabled(bool enabled) {
+	m_bEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+// ---------------------------------------------------------getEnabled
+bool LockProfile::getEnabled() {
+	return (m_bEnabled.load(std::memory_order_relaxed));
+}
+
+// ---------------------------------------------------------getLockStats
+LockProfile::LockStats * LockProfile::getLockStats(const std::string &name) {
+	std::lock_guard<std::mutex> guard(getLockStatsMutex());
+	std::unique_ptr<LockStats> &stats = getLockStatsMap()[name];
+	if (stats == NULL) {
+		glass3::util::MetricsRegistry &registry =
+				glass3::util::MetricsRegistry::getInstance();
+
+		stats.reset(new LockStats());
+		stats->pAcquisitions = &registry.getCounter(
+				"lock." + name + ".acquisitions");
+		stats->pContended = &registry.getCounter("lock." + name + ".contended");
+		stats->pWaitTime = &registry.getHistogram("lock." + name + ".wait_us");
+		stats->pHoldTime = &registry.getHistogram("lock." + name + ".hold_us");
+	}
+	return (stats.get());
+}
+
+// ---------------------------------------------------------report
+void LockProfile::report() {
+	std::lock_guard<std::mutex> guard(getLockStatsMutex());
+	for (auto &lock : getLockStatsMap()) {
+		LockStats &stats = *lock.second;
+		glass3::util::Logger::log(
+				"info",
+				"LockProfile::report(): " + lock.first + " acquisitions: "
+						+ std::to_string(stats.pAcquisitions->load())
+						+ " contended: "
+						+ std::to_string(stats.pContended->load())
+						+ " wait p50/p99/max: "
+						+ std::to_string(stats.pWaitTime->getPercentile(50.0))
+						+ "/"
+						+ std::to_string(stats.pWaitTime->getPercentile(99.0))
+						+ "/" + std::to_string(stats.pWaitTime->getMax())
+						+ " us hold p99/max: "
+						+ std::to_string(stats.pHoldTime->getPercentile(99.0))
+						+ "/" + std::to_string(stats.pHoldTime->getMax())
+						+ " us");
+	}
+}
+}  // namespace util
+}  // namespace glass3
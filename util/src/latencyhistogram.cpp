@@ -0,0 +1,121 @@
+#include <latencyhistogram.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+namespace glass3 {
+namespace util {
+
+// constants
+const int LatencyHistogram::k_iSubBuckets;
+const int LatencyHistogram::k_iNumBuckets;
+
+// ---------------------------------------------------------LatencyHistogram
+LatencyHistogram::LatencyHistogram() {
+	reset();
+}
+
+// ---------------------------------------------------------~LatencyHistogram
+LatencyHistogram::~LatencyHistogram() {
+}
+
+// ---------------------------------------------------------record
+void LatencyHistogram::record(int64_t microseconds) {
+	if (microseconds < 0) {
+		microseconds = 0;
+	}
+
+	m_aBuckets[getBucket(microseconds)].fetch_add(1,
+													std::memory_order_relaxed);
+	m_iCount.fetch_add(1, std::memory_order_relaxed);
+
+	// raise the maximum, unless another thread raised it further
+	int64_t max = m_iMax.load(std::memory_order_relaxed);
+	while ((microseconds > max)
+			&& (m_iMax.compare_exchange_weak(max, microseconds,
+												std::memory_order_relaxed)
+					== false)) {
+	}
+}
+
+// ---------------------------------------------------------getPercentile
+int64_t LatencyHistogram::getPercentile(double percentile) {
+	int64_t total = m_iCount.load(std::memory_order_relaxed);
+	int64_t max = m_iMax.load(std::memory_order_relaxed);
+	if (total == 0) {
+		return (0);
+	}
+
+	// the rank of the latency we want, counting from 1
+	percentile = std::max(0.0, std::min(100.0, percentile));
+	int64_t rank = static_cast<int64_t>(std::ceil(
+			percentile / 100.0 * static_cast<double>(total)));
+	rank = std::max(rank, static_cast<int64_t>(1));
+
+	int64_t count = 0;
+	for (int bucket = 0; bucket < k_iNumBuckets; bucket++) {
+		count += m_aBuckets[bucket].load(std::memory_order_relaxed);
+		if (count >= rank) {
+			// no latency in the bucket is larger than the maximum
+			return (std::min(getBucketUpperBound(bucket), max));
+		}
+	}
+
+	return (max);
+}
+
+// ---------------------------------------------------------getMax
+int64_t LatencyHistogram::getMax() {
+	return (m_iMax.load(std::memory_order_relaxed));
+}
+
+// ---------------------------------------------------------getCount
+int64_t LatencyHistogram::getCount() {
+	return (m_iCount.load(std::memory_order_relaxed));
+}
+
+// ---------------------------------------------------------reset
+void LatencyHistogram::reset() {
+	for (int bucket = 0; bucket < k_iNumBuckets; bucket++) {
+		m_aBuckets[bucket].store(0, std::memory_order_relaxed);
+	}
+	m_iCount.store(0, std::memory_order_relaxed);
+	m_iMax.store(0, std::memory_order_relaxed);
+}
+
+// ---------------------------------------------------------getBucket
+int LatencyHistogram::getBucket(int64_t microseconds) {
+	// small latencies get a bucket each
+	if (microseconds < k_iSubBuckets) {
+		return (static_cast<int>(microseconds));
+	}
+
+	// find the highest set bit
+	int highBit = 0;
+	while ((microseconds >> (highBit + 1)) > 0) {
+		highBit++;
+	}
+
+	// split each power of two into k_iSubBuckets buckets using the bits
+	// below the highest set bit (k_iSubBuckets is 2^3)
+	int shift = highBit - 3;
+	int subBucket = static_cast<int>((microseconds >> shift)
+			& (k_iSubBuckets - 1));
+	return ((highBit - 2) * k_iSubBuckets + subBucket);
+}
+
+// ---------------------------------------------------------getBucketUpperBound
+int64_t LatencyHistogram::getBucketUpperBound(int bucket) {
+	if (bucket < k_iSubBuckets) {
+		return (bucket);
+	}
+
+	int shift = bucket / k_iSubBuckets - 1;
+	int64_t subBucket = bucket % k_iSubBuckets;
+	int64_t lowerBound = (k_iSubBuckets + subBucket) << shift;
+	return (lowerBound + (static_cast<int64_t>(1) << shift) - 1);
+}
+}  // namespace util
+}  // namespace glass3
@@ -0,0 +1,275 @@
+#include <latencytracer.h>
+#include <timerservice.h>
+#include <logger.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace glass3 {
+namespace util {
+
+// constants
+const int LatencyTracer::k_iNumStages;
+const int LatencyTracer::k_iReportIntervalMS;
+const int LatencyTracer::k_iMaxTraceAgeS;
+const int LatencyTracer::k_iMaxTraces;
+const int LatencyTracer::k_iNumShards;
+
+// static members
+std::atomic<bool> LatencyTracer::m_bEnabled(false);
+
+// ---------------------------------------------------------LatencyTracer
+LatencyTracer::LatencyTracer() {
+	m_iTraceOrderSize = 0;
+}
+
+// ---------------------------------------------------------~LatencyTracer
+LatencyTracer::~LatencyTracer() {
+}
+
+// ---------------------------------------------------------getInstance
+LatencyTracer & LatencyTracer::getInstance() {
+	static LatencyTracer * instance = []() {
+		LatencyTracer * tracer = new LatencyTracer();
+
+		// report on the wall clock since this monitors processing rather than
+		// the data
+		glass3::util::TimerService::getInstance().addTimer(
+				"Pick latency report", k_iReportIntervalMS,
+				std::bind(&LatencyTracer::report, tracer));
+		return (tracer);
+	}();
+
+	return (*instance);
+}
+
+// ---------------------------------------------------------setEnabled
+void LatencyTracer::setEnabled(bool enabled) {
+	m_bEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+// ---------------------------------------------------------getEnabled
+bool LatencyTracer::getEnabled() {
+	return (m_bEnabled.load(std::memory_order_relaxed));
+}
+
+// ---------------------------------------------------------mark
+void LatencyTracer::mark(const std::string &id, Stage stage) {
+	if (getEnabled() == false) {
+		return;
+	}
+
+	mark(id, stage, std::chrono::steady_clock::now());
+}
+
+// ---------------------------------------------------------mark
+void LatencyTracer::mark(const std::string &id, Stage stage,
+							std::chrono::steady_clock::time_point time) {
+	if ((getEnabled() == false) || (id == "") || (stage < 0)
+			|| (stage >= k_iNumStages)) {
+		return;
+	}
+
+	TraceShard &shard = m_aShards[std::hash<std::string>()(id) % k_iNumShards];
+	int64_t latency = 0;
+	{
+		std::lock_guard<std::mutex> guard(shard.TraceMutex);
+		auto trace = shard.mTraces.find(id);
+		if (trace == shard.mTraces.end()) {
+			// only the stages where picks enter the pipeline start a trace
+			if ((stage != Fetch) && (stage != Dequeue)) {
+				return;
+			}
+
+			PickTrace newTrace;
+			newTrace.tStart = time;
+			newTrace.iStagesReached = 0;
+			trace = shard.mTraces.emplace(id, newTrace).first;
+			shard.qTraceOrder.push_back(std::make_pair(time, id));
+			m_iTraceOrderSize++;
+		}
+
+		// only the first time a pick reaches a stage counts
+		int stageBit = 1 << stage;
+		if ((trace->second.iStagesReached & stageBit) != 0) {
+			return;
+		}
+		trace->second.iStagesReached |= stageBit;
+
+		latency = std::chrono::duration_cast<std::chrono::microseconds>(
+				time - trace->second.tStart).count();
+
+		// the first publication is the end of the pipeline
+		if (stage == Publish) {
+			shard.mTraces.erase(trace);
+		}
+	}
+
+	m_aHistograms[stage].record(latency);
+
+	// make room, outside the shard lock since the oldest trace may be in any
+	// shard
+	while (m_iTraceOrderSize > k_iMaxTraces) {
+		forgetOldestTrace();
+	}
+}
+
+// ---------------------------------------------------------getLatency
+int64_t LatencyTracer::getLatency(Stage stage, double percentile) {
+	if ((stage < 0) || (stage >= k_iNumStages)) {
+		return (0);
+	}
+
+	return (m_aHistograms[stage].getPercentile(percentile));
+}
+
+// ---------------------------------------------------------getCount
+int64_t LatencyTracer::getCount(Stage stage) {
+	if ((stage < 0) || (stage >= k_iNumStages)) {
+		return (0);
+	}
+
+	return (m_aHistograms[stage].getCount());
+}
+
+// ---------------------------------------------------------getTraceCount
+int LatencyTracer::getTraceCount() {
+	int traceCount = 0;
+	for (int i = 0; i < k_iNumShards; i++) {
+		std::lock_guard<std::mutex> guard(m_aShards[i].TraceMutex);
+		traceCount += m_aShards[i].mTraces.size();
+	}
+	return (traceCount);
+}
+
+// ---------------------------------------------------------report
+void LatencyTracer::report() {
+	// forget the picks that are never going to be published
+	int traceCount = 0;
+	std::chrono::steady_clock::time_point tOldest =
+			std::chrono::steady_clock::now()
+					- std::chrono::seconds(k_iMaxTraceAgeS);
+	for (int i = 0; i < k_iNumShards; i++) {
+		TraceShard &shard = m_aShards[i];
+		std::lock_guard<std::mutex> guard(shard.TraceMutex);
+		while ((shard.qTraceOrder.empty() == false)
+				&& (shard.qTraceOrder.front().first < tOldest)) {
+			forgetOldestTrace(&shard);
+		}
+		traceCount += shard.mTraces.size();
+	}
+
+	std::string report = "";
+	for (int i = 0; i < k_iNumStages; i++) {
+		Stage stage = static_cast<Stage>(i);
+		int64_t count = m_aHistograms[stage].getCount();
+		if (count == 0) {
+			continue;
+		}
+
+		char sStage[256];
+		snprintf(sStage, sizeof(sStage),
+					" %s: %lld picks p50 %.3f p99 %.3f max %.3f ms;",
+					getStageName(stage).c_str(),
+					static_cast<long long>(count),  // NOLINT(runtime/int)
+					m_aHistograms[stage].getPercentile(50.0) / 1000.0,
+					m_aHistograms[stage].getPercentile(99.0) / 1000.0,
+					m_aHistograms[stage].getMax() / 1000.0);
+		report += sStage;
+
+		m_aHistograms[stage].reset();
+	}
+
+	if (report == "") {
+		glass3::util::Logger::log(
+				"debug",
+				"LatencyTracer::report(): No picks traced since the last "
+						"report (" + std::to_string(traceCount)
+						+ " in progress).");
+		return;
+	}
+
+	glass3::util::Logger::log(
+			"info",
+			"LatencyTracer::report(): Pick latency by stage;" + report + " ("
+					+ std::to_string(traceCount) + " in progress).");
+}
+
+// ---------------------------------------------------------getStageName
+std::string LatencyTracer::getStageName(Stage stage) {
+	switch (stage) {
+		case Fetch:
+			return ("Fetch");
+		case Parse:
+			return ("Parse");
+		case InputQueue:
+			return ("InputQueue");
+		case Dequeue:
+			return ("Dequeue");
+		case Nucleate:
+			return ("Nucleate");
+		case Associate:
+			return ("Associate");
+		case Publish:
+			return ("Publish");
+		default:
+			return ("Unknown");
+	}
+}
+
+// ---------------------------------------------------------forgetOldestTrace
+void LatencyTracer::forgetOldestTrace(TraceShard *shard) {
+	if (shard->qTraceOrder.empty() == true) {
+		return;
+	}
+
+	// the trace may have already ended, or been restarted since
+	auto trace = shard->mTraces.find(shard->qTraceOrder.front().second);
+	if ((trace != shard->mTraces.end())
+			&& (trace->second.tStart == shard->qTraceOrder.front().first)) {
+		shard->mTraces.erase(trace);
+	}
+
+	shard->qTraceOrder.pop_front();
+	m_iTraceOrderSize--;
+}
+
+// ---------------------------------------------------------forgetOldestTrace
+void LatencyTracer::forgetOldestTrace() {
+	// find the shard with the oldest trace, one shard lock at a time
+	TraceShard * oldestShard = NULL;
+	std::chrono::steady_clock::time_point tOldest;
+	for (int i = 0; i < k_iNumShards; i++) {
+		std::lock_guard<std::mutex> guard(m_aShards[i].TraceMutex);
+		if (m_aShards[i].qTraceOrder.empty() == true) {
+			continue;
+		}
+		if ((oldestShard == NULL)
+				|| (m_aShards[i].qTraceOrder.front().first < tOldest)) {
+			oldestShard = &m_aShards[i];
+			tOldest = m_aShards[i].qTraceOrder.front().first;
+		}
+	}
+
+	if (oldestShard == NULL) {
+		return;
+	}
+
+	// another thread may have forgotten it meanwhile, in which case the
+	// caller looks again
+	std::lock_guard<std::mutex> guard(oldestShard->TraceMutex);
+	if ((oldestShard->qTraceOrder.empty() == false)
+			&& (oldestShard->qTraceOrder.front().first == tOldest)) {
+		forgetOldestTrace(oldestShard);
+	}
+}
+}  // namespace util
+}  // namespace glass3
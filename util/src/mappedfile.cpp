@@ -0,0 +1,236 @@
+#include <mappedfile.h>
+#include <logger.h>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace glass3 {
+namespace util {
+
+// ---------------------------------------------------------MappedFile
+MappedFile::MappedFile() {
+	m_pData = NULL;
+	m_iSize = 0;
+	m_iPosition = 0;
+	m_bOpen = false;
+}
+
+// ---------------------------------------------------------~MappedFile
+MappedFile::~MappedFile() {
+	close();
+}
+
+// ---------------------------------------------------------open
+bool MappedFile::open(const std::string &fileName) {
+	close();
+
+#ifdef _WIN32
+	// no mmap, read the whole file instead
+	std::ifstream inFile(fileName, std::ios::in | std::ios::binary);
+	if (!inFile) {
+		glass3::util::Logger::log(
+				"error", "MappedFile::open(): Unable to open file: " + fileName);
+		return (false);
+	}
+
+	m_vBuffer.assign(std::istreambuf_iterator<char>(inFile),
+						std::istreambuf_iterator<char>());
+	m_iSize = m_vBuffer.size();
+	m_pData = m_vBuffer.data();
+#else
+	int fd = ::open(fileName.c_str(), O_RDONLY);
+	if (fd < 0) {
+		glass3::util::Logger::log(
+				"error", "MappedFile::open(): Unable to open file: " + fileName);
+		return (false);
+	}
+
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0) {
+		glass3::util::Logger::log(
+				"error", "MappedFile::open(): Unable to stat file: " + fileName);
+		::close(fd);
+		return (false);
+	}
+
+	m_iSize = static_cast<size_t>(fileStat.st_size);
+
+	// an empty file can't be mapped, and has no lines anyway
+	if (m_iSize > 0) {
+		void * map = mmap(NULL, m_iSize, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (map == MAP_FAILED) {
+			glass3::util::Logger::log(
+					"error",
+					"MappedFile::open(): Unable to map file: " + fileName);
+			::close(fd);
+			m_iSize = 0;
+			return (false);
+		}
+
+		// the file is read front to back
+		madvise(map, m_iSize, MADV_SEQUENTIAL);
+		m_pData = static_cast<const char *>(map);
+	}
+
+	// the mapping stays valid after the descriptor is closed
+	::close(fd);
+#endif
+
+	m_sFileName = fileName;
+	m_iPosition = 0;
+	m_bOpen = true;
+	return (true);
+}
+
+// ---------------------------------------------------------close
+void MappedFile::close() {
+#ifdef _WIN32
+	m_vBuffer.clear();
+	m_vBuffer.shrink_to_fit();
+#else
+	if (m_pData != NULL) {
+		munmap(const_cast<char *>(m_pData), m_iSize);
+	}
+#endif
+
+	m_sFileName = "";
+	m_pData = NULL;
+	m_iSize = 0;
+	m_iPosition = 0;
+	m_bOpen = false;
+}
+
+// ---------------------------------------------------------update
+bool MappedFile::update() {
+	if (m_bOpen == false) {
+		return (false);
+	}
+
+#ifdef _WIN32
+	// read whatever was appended after what we have
+	std::ifstream inFile(m_sFileName, std::ios::in | std::ios::binary);
+	if (!inFile) {
+		return (false);
+	}
+	inFile.seekg(0, std::ios::end);
+	std::streamoff fileSize = inFile.tellg();
+	if ((fileSize < 0) || (static_cast<size_t>(fileSize) <= m_iSize)) {
+		return (false);
+	}
+
+	inFile.seekg(m_iSize, std::ios::beg);
+	m_vBuffer.resize(static_cast<size_t>(fileSize));
+	inFile.read(m_vBuffer.data() + m_iSize, fileSize - m_iSize);
+	m_vBuffer.resize(m_iSize + static_cast<size_t>(inFile.gcount()));
+	m_iSize = m_vBuffer.size();
+	m_pData = m_vBuffer.data();
+#else
+	int fd = ::open(m_sFileName.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return (false);
+	}
+
+	struct stat fileStat;
+	if ((fstat(fd, &fileStat) != 0)
+			|| (static_cast<size_t>(fileStat.st_size) <= m_iSize)) {
+		// not grown (a truncated file is read as it was)
+		::close(fd);
+		return (false);
+	}
+
+	size_t newSize = static_cast<size_t>(fileStat.st_size);
+	void * map = mmap(NULL, newSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (map == MAP_FAILED) {
+		glass3::util::Logger::log(
+				"error",
+				"MappedFile::update(): Unable to map file: " + m_sFileName);
+		return (false);
+	}
+
+	// the rest of the file is read front to back
+	madvise(map, newSize, MADV_SEQUENTIAL);
+	if (m_pData != NULL) {
+		munmap(const_cast<char *>(m_pData), m_iSize);
+	}
+	m_pData = static_cast<const char *>(map);
+	m_iSize = newSize;
+#endif
+
+	return (true);
+}
+
+// ---------------------------------------------------------isOpen
+bool MappedFile::isOpen() const {
+	return (m_bOpen);
+}
+
+// ---------------------------------------------------------isEnd
+bool MappedFile::isEnd() const {
+	return (m_iPosition >= m_iSize);
+}
+
+// ---------------------------------------------------------getSize
+size_t MappedFile::getSize() const {
+	return (m_iSize);
+}
+
+// ---------------------------------------------------------getPosition
+size_t MappedFile::getPosition() const {
+	return (m_iPosition);
+}
+
+// ---------------------------------------------------------readLines
+int MappedFile::readLines(int maxLines, std::vector<MappedLine> *lines,
+							bool partialLastLine) {
+	if (lines == NULL) {
+		return (0);
+	}
+
+	int numLines = 0;
+	while ((numLines < maxLines) && (m_iPosition < m_iSize)) {
+		const char * start = m_pData + m_iPosition;
+		size_t remaining = m_iSize - m_iPosition;
+
+		// find the end of the line
+		const char * end = static_cast<const char *>(memchr(start, '\n',
+															remaining));
+		size_t length = remaining;
+		if (end != NULL) {
+			length = end - start;
+			m_iPosition += length + 1;
+		} else if (partialLastLine == true) {
+			// the last line has no newline
+			m_iPosition = m_iSize;
+		} else {
+			// leave it until the rest of it is written
+			break;
+		}
+
+		// drop a windows line ending
+		if ((length > 0) && (start[length - 1] == '\r')) {
+			length--;
+		}
+
+		MappedLine line;
+		line.pData = start;
+		line.iLength = length;
+		lines->push_back(line);
+		numLines++;
+	}
+
+	return (numLines);
+}
+}  // namespace util
+}  // namespace glass3
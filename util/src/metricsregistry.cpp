@@ -0,0 +1,170 @@
+#include <metricsregistry.h>
+#include <timerservice.h>
+#include <logger.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace glass3 {
+namespace util {
+
+// ---------------------------------------------------------MetricsRegistry
+MetricsRegistry::MetricsRegistry() {
+	m_iDumpTimerID = -1;
+}
+
+// ---------------------------------------------------------~MetricsRegistry
+MetricsRegistry::~MetricsRegistry() {
+	stopDump();
+}
+
+// ---------------------------------------------------------getInstance
+MetricsRegistry & MetricsRegistry::getInstance() {
+	static MetricsRegistry * instance = new MetricsRegistry();
+	return (*instance);
+}
+
+// ---------------------------------------------------------getCounter
+std::atomic<int64_t> & MetricsRegistry::getCounter(const std::string &name) {
+	std::lock_guard<std::mutex> guard(m_MetricsMutex);
+	std::unique_ptr<std::atomic<int64_t>> &counter = m_mCounters[name];
+	if (counter == NULL) {
+		counter.reset(new std::atomic<int64_t>(0));
+	}
+	return (*counter);
+}
+
+// ---------------------------------------------------------getGauge
+std::atomic<double> & MetricsRegistry::getGauge(const std::string &name) {
+	std::lock_guard<std::mutex> guard(m_MetricsMutex);
+	std::unique_ptr<std::atomic<double>> &gauge = m_mGauges[name];
+	if (gauge == NULL) {
+		gauge.reset(new std::atomic<double>(0.0));
+	}
+	return (*gauge);
+}
+
+// ---------------------------------------------------------getHistogram
+glass3::util::LatencyHistogram & MetricsRegistry::getHistogram(
+		const std::string &name) {
+	std::lock_guard<std::mutex> guard(m_MetricsMutex);
+	std::unique_ptr<glass3::util::LatencyHistogram> &histogram =
+			m_mHistograms[name];
+	if (histogram == NULL) {
+		histogram.reset(new glass3::util::LatencyHistogram());
+	}
+	return (*histogram);
+}
+
+// ---------------------------------------------------------getJSON
+json::Object MetricsRegistry::getJSON() {
+	json::Object counters;
+	json::Object gauges;
+	json::Object histograms;
+	{
+		std::lock_guard<std::mutex> guard(m_MetricsMutex);
+
+		// json has no 64 bit integers, use doubles so large counts survive
+		for (auto &counter : m_mCounters) {
+			counters[counter.first] = static_cast<double>(counter.second->load(
+					std::memory_order_relaxed));
+		}
+		for (auto &gauge : m_mGauges) {
+			gauges[gauge.first] = gauge.second->load(std::memory_order_relaxed);
+		}
+		for (auto &histogram : m_mHistograms) {
+			glass3::util::LatencyHistogram &latencies = *histogram.second;
+			json::Object summary;
+			summary["Count"] = static_cast<double>(latencies.getCount());
+			summary["P50"] = static_cast<double>(latencies.getPercentile(50.0));
+			summary["P99"] = static_cast<double>(latencies.getPercentile(99.0));
+			summary["Max"] = static_cast<double>(latencies.getMax());
+			histograms[histogram.first] = summary;
+		}
+	}
+
+	json::Object metrics;
+	metrics["Counters"] = counters;
+	metrics["Gauges"] = gauges;
+	metrics["Histograms"] = histograms;
+	return (metrics);
+}
+
+// ---------------------------------------------------------writeJSONFile
+bool MetricsRegistry::writeJSONFile(const std::string &fileName) {
+	std::string tempName = fileName + ".tmp";
+	{
+		std::ofstream outFile(tempName, std::ios::out | std::ios::trunc);
+		if (outFile.is_open() == false) {
+			glass3::util::Logger::log(
+					"error",
+					"MetricsRegistry::writeJSONFile(): Failed to create file "
+							+ tempName + ".");
+			return (false);
+		}
+
+		outFile << json::Serialize(getJSON());
+		if (outFile.fail() == true) {
+			glass3::util::Logger::log(
+					"error",
+					"MetricsRegistry::writeJSONFile(): Failed to write file "
+							+ tempName + ".");
+			return (false);
+		}
+	}
+
+	if (std::rename(tempName.c_str(), fileName.c_str()) != 0) {
+		glass3::util::Logger::log(
+				"error",
+				"MetricsRegistry::writeJSONFile(): Unable to rename " + tempName
+						+ " to " + fileName + ".");
+		return (false);
+	}
+
+	return (true);
+}
+
+// ---------------------------------------------------------startDump
+bool MetricsRegistry::startDump(const std::string &fileName, int intervalS) {
+	if ((fileName == "") || (intervalS <= 0)) {
+		glass3::util::Logger::log(
+				"error",
+				"MetricsRegistry::startDump(): Invalid file or interval.");
+		return (false);
+	}
+
+	stopDump();
+
+	// dump on the wall clock since this monitors processing rather than the
+	// data
+	std::lock_guard<std::mutex> guard(m_DumpMutex);
+	m_iDumpTimerID = glass3::util::TimerService::getInstance().addTimer(
+			"Metrics dump", intervalS * 1000,
+			[this, fileName]() { writeJSONFile(fileName); });
+
+	glass3::util::Logger::log(
+			"info",
+			"MetricsRegistry::startDump(): Writing metrics to " + fileName
+					+ " every " + std::to_string(intervalS) + " seconds.");
+	return (m_iDumpTimerID >= 0);
+}
+
+// ---------------------------------------------------------stopDump
+void MetricsRegistry::stopDump() {
+	std::lock_guard<std::mutex> guard(m_DumpMutex);
+	if (m_iDumpTimerID < 0) {
+		return;
+	}
+
+	glass3::util::TimerService::getInstance().removeTimer(m_iDumpTimerID);
+	m_iDumpTimerID = -1;
+}
+}  // namespace util
+}  // namespace glass3
@@ -0,0 +1,196 @@
+#include <metricsserver.h>
+#include <metricsregistry.h>
+#include <logger.h>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+// not every platform has it, the send() then just isn't protected from
+// SIGPIPE
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+#endif
+
+#include <cstring>
+#include <string>
+
+namespace glass3 {
+namespace util {
+
+// constants
+const int MetricsServer::k_iPollTimeoutMS;
+const int MetricsServer::k_iRequestTimeoutMS;
+const int MetricsServer::k_iMaxRequestSize;
+
+// ---------------------------------------------------------MetricsServer
+MetricsServer::MetricsServer()
+		: glass3::util::ThreadBaseClass("metricsserver", 10) {
+	m_iListenFD = -1;
+	m_iPort = -1;
+}
+
+// ---------------------------------------------------------~MetricsServer
+MetricsServer::~MetricsServer() {
+	stop();
+	closePort();
+}
+
+// ---------------------------------------------------------openPort
+bool MetricsServer::openPort(int port) {
+	closePort();
+
+#ifndef _WIN32
+	int listenFD = socket(AF_INET, SOCK_STREAM, 0);
+	if (listenFD < 0) {
+		glass3::util::Logger::log(
+				"error",
+				"MetricsServer::openPort(): Unable to create socket, error "
+						+ std::to_string(errno));
+		return (false);
+	}
+
+	int reuse = 1;
+	setsockopt(listenFD, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+	// only serve the local host
+	struct sockaddr_in address;
+	std::memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = htons(port);
+
+	if ((bind(listenFD, reinterpret_cast<struct sockaddr *>(&address),
+				sizeof(address)) != 0) || (listen(listenFD, 4) != 0)) {
+		glass3::util::Logger::log(
+				"error",
+				"MetricsServer::openPort(): Unable to listen on port "
+						+ std::to_string(port) + ", error "
+						+ std::to_string(errno));
+		close(listenFD);
+		return (false);
+	}
+
+	// find out which port we got, in case it was picked for us
+	socklen_t addressSize = sizeof(address);
+	getsockname(listenFD, reinterpret_cast<struct sockaddr *>(&address),
+				&addressSize);
+
+	m_iListenFD = listenFD;
+	m_iPort = ntohs(address.sin_port);
+
+	glass3::util::Logger::log(
+			"info",
+			"MetricsServer::openPort(): Serving metrics on http://127.0.0.1:"
+					+ std::to_string(m_iPort) + "/metrics");
+	return (true);
+#else
+	glass3::util::Logger::log(
+			"warning",
+			"MetricsServer::openPort(): Serving metrics is not supported on "
+			"this platform.");
+	return (false);
+#endif
+}
+
+// ---------------------------------------------------------closePort
+void MetricsServer::closePort() {
+#ifndef _WIN32
+	if (m_iListenFD >= 0) {
+		close(m_iListenFD);
+	}
+#endif
+	m_iListenFD = -1;
+	m_iPort = -1;
+}
+
+// ---------------------------------------------------------getPort
+int MetricsServer::getPort() {
+	return (m_iPort);
+}
+
+// ---------------------------------------------------------work
+glass3::util::WorkState MetricsServer::work() {
+#ifndef _WIN32
+	if (m_iListenFD < 0) {
+		return (glass3::util::WorkState::Idle);
+	}
+
+	// wait for a connection
+	struct pollfd listenPoll;
+	listenPoll.fd = m_iListenFD;
+	listenPoll.events = POLLIN;
+	listenPoll.revents = 0;
+	if (poll(&listenPoll, 1, k_iPollTimeoutMS) <= 0) {
+		return (glass3::util::WorkState::Idle);
+	}
+
+	int connectionFD = accept(m_iListenFD, NULL, NULL);
+	if (connectionFD < 0) {
+		return (glass3::util::WorkState::Idle);
+	}
+
+	// read the request line, a slow or silent client is dropped
+	std::string request = "";
+	char buffer[512];
+	struct pollfd connectionPoll;
+	connectionPoll.fd = connectionFD;
+	connectionPoll.events = POLLIN;
+	while ((request.find("\r\n") == std::string::npos)
+			&& (request.size() < static_cast<size_t>(k_iMaxRequestSize))) {
+		connectionPoll.revents = 0;
+		if (poll(&connectionPoll, 1, k_iRequestTimeoutMS) <= 0) {
+			break;
+		}
+
+		ssize_t bytesRead = recv(connectionFD, buffer, sizeof(buffer), 0);
+		if (bytesRead <= 0) {
+			break;
+		}
+		request.append(buffer, bytesRead);
+	}
+
+	std::string response = getResponse(request);
+	size_t bytesSent = 0;
+	while (bytesSent < response.size()) {
+		ssize_t sent = send(connectionFD, response.data() + bytesSent,
+							response.size() - bytesSent, MSG_NOSIGNAL);
+		if (sent <= 0) {
+			break;
+		}
+		bytesSent += sent;
+	}
+
+	close(connectionFD);
+	return (glass3::util::WorkState::OK);
+#else
+	return (glass3::util::WorkState::Idle);
+#endif
+}
+
+// ---------------------------------------------------------getResponse
+std::string MetricsServer::getResponse(const std::string &request) {
+	std::string status = "200 OK";
+	std::string body = "";
+	if ((request.compare(0, 13, "GET /metrics ") == 0)
+			|| (request.compare(0, 6, "GET / ") == 0)) {
+		body = json::Serialize(
+				glass3::util::MetricsRegistry::getInstance().getJSON());
+	} else {
+		status = "404 Not Found";
+		body = "{}";
+	}
+
+	return ("HTTP/1.0 " + status + "\r\n"
+			"Content-Type: application/json\r\n"
+			"Content-Length: " + std::to_string(body.size()) + "\r\n"
+			"Connection: close\r\n\r\n" + body);
+}
+}  // namespace util
+}  // namespace glass3
@@ -0,0 +1,207 @@
+#include <randomstream.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+namespace glass3 {
+namespace util {
+
+// constants
+const int RandomStream::k_iNumZigguratLayers;
+
+namespace {
+// the rightmost layer edge and the layer area of the 128 layer ziggurat,
+// from Marsaglia and Tsang (2000)
+const double k_dZigguratEdge = 3.442619855899;
+const double k_dZigguratArea = 9.91256303526217e-3;
+
+// 2^31, the scale of the signed 32 bit samples
+const double k_dZigguratScale = 2147483648.0;
+
+/**
+ * \brief The ziggurat layer tables, built once
+ */
+struct ZigguratTables {
+	ZigguratTables() {
+		int n = RandomStream::k_iNumZigguratLayers;
+		double dn = k_dZigguratEdge;
+		double tn = dn;
+		double q = k_dZigguratArea / exp(-0.5 * dn * dn);
+
+		kn[0] = static_cast<int64_t>((dn / q) * k_dZigguratScale);
+		kn[1] = 0;
+		wn[0] = q / k_dZigguratScale;
+		wn[n - 1] = dn / k_dZigguratScale;
+		fn[0] = 1.0;
+		fn[n - 1] = exp(-0.5 * dn * dn);
+
+		for (int i = n - 2; i >= 1; i--) {
+			dn = sqrt(-2.0 * log(k_dZigguratArea / dn + exp(-0.5 * dn * dn)));
+			kn[i + 1] = static_cast<int64_t>((dn / tn) * k_dZigguratScale);
+			tn = dn;
+			fn[i] = exp(-0.5 * dn * dn);
+			wn[i] = dn / k_dZigguratScale;
+		}
+	}
+
+	// the fast path acceptance limit for each layer
+	int64_t kn[RandomStream::k_iNumZigguratLayers];
+
+	// the sample to deviate scale for each layer
+	double wn[RandomStream::k_iNumZigguratLayers];
+
+	// the density at each layer edge
+	double fn[RandomStream::k_iNumZigguratLayers];
+};
+
+const ZigguratTables & getZigguratTables() {
+	static const ZigguratTables tables;
+	return (tables);
+}
+
+// the splitmix64 generator, used to expand seeds
+uint64_t splitMix(uint64_t *state) {
+	uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return (z ^ (z >> 31));
+}
+
+uint64_t rotateLeft(uint64_t x, int k) {
+	return ((x << k) | (x >> (64 - k)));
+}
+}  // namespace
+
+// ---------------------------------------------------------RandomStream
+RandomStream::RandomStream() {
+	seedRandomly();
+}
+
+// ---------------------------------------------------------RandomStream
+RandomStream::RandomStream(uint64_t seed) {
+	this->seed(seed);
+}
+
+// ---------------------------------------------------------~RandomStream
+RandomStream::~RandomStream() {
+}
+
+// ---------------------------------------------------------seed
+void RandomStream::seed(uint64_t seed) {
+	// expand the seed so that similar seeds give unrelated streams, and the
+	// state is never all zero
+	uint64_t state = seed;
+	for (int i = 0; i < 4; i++) {
+		m_aState[i] = splitMix(&state);
+	}
+}
+
+// ---------------------------------------------------------seedRandomly
+void RandomStream::seedRandomly() {
+	std::random_device randomDevice;
+	uint64_t seed = (static_cast<uint64_t>(randomDevice()) << 32)
+			^ static_cast<uint64_t>(randomDevice());
+	this->seed(seed);
+}
+
+// ---------------------------------------------------------next
+uint64_t RandomStream::next() {
+	// xoshiro256**
+	uint64_t result = rotateLeft(m_aState[1] * 5, 7) * 9;
+	uint64_t t = m_aState[1] << 17;
+
+	m_aState[2] ^= m_aState[0];
+	m_aState[3] ^= m_aState[1];
+	m_aState[1] ^= m_aState[2];
+	m_aState[0] ^= m_aState[3];
+	m_aState[2] ^= t;
+	m_aState[3] = rotateLeft(m_aState[3], 45);
+
+	return (result);
+}
+
+// ---------------------------------------------------------uniform
+double RandomStream::uniform(double x, double y) {
+	// the top 53 bits give a double in [0, 1)
+	double u = static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+	return (x + (y - x) * u);
+}
+
+// ---------------------------------------------------------uniformOpen
+double RandomStream::uniformOpen() {
+	return ((static_cast<double>(next() >> 11) + 0.5)
+			* (1.0 / 9007199254740992.0));
+}
+
+// ---------------------------------------------------------gauss
+double RandomStream::gauss(double avg, double std) {
+	const ZigguratTables &tables = getZigguratTables();
+
+	// the high bits give the signed sample, the low bits the layer
+	uint64_t u = next();
+	int32_t hz = static_cast<int32_t>(u >> 32);
+	int iz = static_cast<int>(u & (k_iNumZigguratLayers - 1));
+
+	// the sample lies inside the layer's rectangle almost every time
+	double x = 0;
+	if (std::abs(static_cast<int64_t>(hz)) < tables.kn[iz]) {
+		x = hz * tables.wn[iz];
+	} else {
+		x = gaussSlow(hz, iz);
+	}
+
+	return (std * x + avg);
+}
+
+// ---------------------------------------------------------gaussSlow
+double RandomStream::gaussSlow(int32_t hz, int iz) {
+	const ZigguratTables &tables = getZigguratTables();
+
+	while (true) {
+		double x = hz * tables.wn[iz];
+
+		// the base layer, sample from the tail beyond the rightmost edge
+		if (iz == 0) {
+			double y = 0;
+			do {
+				x = -log(uniformOpen()) / k_dZigguratEdge;
+				y = -log(uniformOpen());
+			} while (y + y < x * x);
+
+			return ((hz > 0) ? k_dZigguratEdge + x : -k_dZigguratEdge - x);
+		}
+
+		// the wedge between the layer's rectangle and the curve
+		if (tables.fn[iz] + uniformOpen() * (tables.fn[iz - 1] - tables.fn[iz])
+				< exp(-0.5 * x * x)) {
+			return (x);
+		}
+
+		// rejected, start over
+		uint64_t u = next();
+		hz = static_cast<int32_t>(u >> 32);
+		iz = static_cast<int>(u & (k_iNumZigguratLayers - 1));
+		if (std::abs(static_cast<int64_t>(hz)) < tables.kn[iz]) {
+			return (hz * tables.wn[iz]);
+		}
+	}
+}
+
+// ---------------------------------------------------------getThreadStream
+RandomStream & RandomStream::getThreadStream() {
+	thread_local RandomStream threadStream;
+	return (threadStream);
+}
+
+// ---------------------------------------------------------combineSeed
+uint64_t RandomStream::combineSeed(uint64_t seed, double value) {
+	uint64_t bits = 0;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	uint64_t state = seed ^ rotateLeft(bits, 32);
+	return (splitMix(&state));
+}
+}  // namespace util
+}  // namespace glass3
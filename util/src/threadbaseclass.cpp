@@ -3,7 +3,9 @@
 #include <thread>
 #include <string>
 #include <vector>
-#include <map>
+#include <memory>
+#include <functional>
+#include <mutex>
 #include <ctime>
 
 namespace glass3 {
@@ -14,6 +16,10 @@ const int ThreadBaseClass::k_iHeathCheckIntervalDefault;
 const int ThreadBaseClass::k_iSleepTimeDefault;
 const int ThreadBaseClass::k_iNumThreadsDefault;
 
+// static members
+thread_local ThreadBaseClass::HealthSlot *
+		ThreadBaseClass::m_pCurrentHealthSlot = NULL;
+
 // ---------------------------------------------------------ThreadBaseClass
 ThreadBaseClass::ThreadBaseClass()
 		: util::BaseClass() {
@@ -87,15 +93,7 @@ bool ThreadBaseClass::start() {
 
 	// create threads
 	for (int i = 0; i < getNumThreads(); i++) {
-		// create thread
-		m_WorkThreads.push_back(std::thread(&ThreadBaseClass::workLoop, this));
-
-		// add to status map if we're tracking status
-		if (getHealthCheckInterval() > 0) {
-			// insert a new key into the health map for this thread
-			// to track status
-			m_ThreadHealthMap[m_WorkThreads[i].get_id()] = std::time(nullptr);
-		}
+		addWorkThread([this]() { workLoop(); });
 	}
 
 	glass3::util::Logger::log(
@@ -144,6 +142,12 @@ bool ThreadBaseClass::stop() {
 
 		m_WorkThreads.clear();
 
+		// the threads are gone, and so are their heartbeats
+		{
+			std::lock_guard<std::mutex> guard(m_HealthSlotsMutex);
+			m_HealthSlots.clear();
+		}
+
 		setWorkThreadsState(glass3::util::ThreadState::Stopped);
 	} catch (const std::system_error& e) {
 		glass3::util::Logger::log(
@@ -162,15 +166,8 @@ bool ThreadBaseClass::stop() {
 
 // ---------------------------------------------------------setThreadHealth
 void ThreadBaseClass::setThreadHealth(bool health) {
-	// don't bother if we've not got any threads
-	if (getNumThreads() <= 0) {
-		return;
-	}
-
 	if (health == true) {
-		std::time_t tNow;
-		std::time(&tNow);
-		setLastHealthy(tNow);
+		setLastHealthy(getCoarseTime());
 	} else {
 		setLastHealthy(0);
 		glass3::util::Logger::log(
@@ -219,7 +216,7 @@ bool ThreadBaseClass::healthCheck() {
 
 	// use spdlog to get thread id
 	size_t thread_id = 0;
-	int lastCheckInterval = (std::time(nullptr) - getAllLastHealthy(&thread_id));
+	int lastCheckInterval = (getCoarseTime() - getAllLastHealthy(&thread_id));
 
 	if (lastCheckInterval > getHealthCheckInterval()) {
 		glass3::util::Logger::log(
@@ -308,36 +305,33 @@ std::time_t ThreadBaseClass::getAllLastHealthy(size_t * pThreadId) {
 		return (0);
 	}
 
-	// empty check (either no threads or not tracking status)
-	if (m_ThreadHealthMap.size() == 0) {
+	// don't bother if we're not running
+	if (getWorkThreadsState() != glass3::util::ThreadState::Started) {
 		return (0);
 	}
 
-	// don't bother if we're not running
-	if (getWorkThreadsState() != glass3::util::ThreadState::Started) {
+	std::lock_guard<std::mutex> guard(m_HealthSlotsMutex);
+
+	// empty check
+	if (m_HealthSlots.size() == 0) {
 		return (0);
 	}
 
 	// init oldest time to now, everything should be older than now
-	double oldestTime = std::time(nullptr);
+	std::time_t oldestTime = getCoarseTime();
 	size_t oldest_thread_id = 0;
 
 	// go through all work threads
-	// I don't think we need a mutex here because the only function that
-	// can modify the size of a map is start()
-	std::map<std::thread::id, std::atomic<int>>::iterator StatusItr;
-	for (StatusItr = m_ThreadHealthMap.begin();
-			StatusItr != m_ThreadHealthMap.end(); ++StatusItr) {
+	for (auto &slot : m_HealthSlots) {
 		// get the thread status
-		double healthTime = static_cast<double>(StatusItr->second);
+		std::time_t healthTime = slot->tLastHealthy.load(
+				std::memory_order_relaxed);
 
 		// Only report the oldest time
 		if (healthTime < oldestTime) {
 			// remember the oldest time
 			oldestTime = healthTime;
-			oldest_thread_id =
-				static_cast<size_t>(std::hash<std::thread::id>()
-					(StatusItr->first));
+			oldest_thread_id = slot->iThreadId;
 		}
 	}
 	*pThreadId = oldest_thread_id;
@@ -405,21 +399,46 @@ const std::string& ThreadBaseClass::getThreadName() {
 
 // ---------------------------------------------------------setLastHealthy
 void ThreadBaseClass::setLastHealthy(time_t now) {
-	// don't bother if we've not got any threads
-	if (getNumThreads() <= 0) {
+	// only our own work threads have a slot here
+	HealthSlot * slot = m_pCurrentHealthSlot;
+	if ((slot == NULL) || (slot->pOwner != this)) {
 		return;
 	}
 
-	// don't bother if we're not running
-	if (getWorkThreadsState() != glass3::util::ThreadState::Started) {
-		return;
-	}
+	// only this thread writes the slot
+	slot->tLastHealthy.store(now, std::memory_order_relaxed);
+}
+
+// ---------------------------------------------------------addWorkThread
+void ThreadBaseClass::addWorkThread(std::function<void()> threadFunction) {
+	// the new thread starts out healthy
+	HealthSlot * slot = new HealthSlot();
+	slot->tLastHealthy = getCoarseTime();
+	slot->pOwner = this;
+	slot->iThreadId = 0;
+
+	std::lock_guard<std::mutex> guard(m_HealthSlotsMutex);
+	m_HealthSlots.push_back(std::unique_ptr<HealthSlot>(slot));
+
+	m_WorkThreads.push_back(std::thread([slot, threadFunction]() {
+		m_pCurrentHealthSlot = slot;
+		threadFunction();
+		m_pCurrentHealthSlot = NULL;
+	}));
+
+	slot->iThreadId = static_cast<size_t>(std::hash<std::thread::id>()(
+			m_WorkThreads.back().get_id()));
+}
 
-	// update this thread status
-	if (m_ThreadHealthMap.find(std::this_thread::get_id())
-			!= m_ThreadHealthMap.end()) {
-		m_ThreadHealthMap[std::this_thread::get_id()] = now;
+// ---------------------------------------------------------getCoarseTime
+std::time_t ThreadBaseClass::getCoarseTime() {
+#ifdef CLOCK_REALTIME_COARSE
+	struct timespec now;
+	if (clock_gettime(CLOCK_REALTIME_COARSE, &now) == 0) {
+		return (now.tv_sec);
 	}
+#endif
+	return (std::time(nullptr));
 }
 
 }  // namespace util
@@ -0,0 +1,237 @@
+#include <timerservice.h>
+#include <clock.h>
+#include <logger.h>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace glass3 {
+namespace util {
+
+// constants
+const int TimerService::k_iTickMS;
+const int64_t TimerService::k_iMaxCatchUpTicks;
+
+// ---------------------------------------------------------TimerService
+TimerService::TimerService()
+		: glass3::util::ThreadBaseClass("timerservice", k_iTickMS) {
+	m_iNextTimerID = 0;
+
+	// start the wheels at the current time
+	m_iLastWallTick = getCurrentTick(false);
+	m_iLastClockTick = getCurrentTick(true);
+	m_WallWheel.advance(m_iLastWallTick);
+	m_ClockWheel.advance(m_iLastClockTick);
+}
+
+// ---------------------------------------------------------~TimerService
+TimerService::~TimerService() {
+	// stop before the timers go away
+	stop();
+}
+
+// ---------------------------------------------------------getInstance
+TimerService & TimerService::getInstance() {
+	static TimerService * instance = []() {
+		TimerService * service = new TimerService();
+		service->start();
+		return (service);
+	}();
+
+	return (*instance);
+}
+
+// ---------------------------------------------------------addTimer
+int64_t TimerService::addTimer(const std::string &name, int intervalMS,
+								std::function<void()> callback, bool useClock,
+								bool repeat) {
+	if ((intervalMS <= 0) || (!callback)) {
+		glass3::util::Logger::log(
+				"error",
+				"TimerService::addTimer(): Invalid interval or callback for "
+				"timer " + name + ".");
+		return (-1);
+	}
+
+	TimerInfo timer;
+	timer.sName = name;
+	timer.callback = callback;
+	timer.bUseClock = useClock;
+	timer.bRepeat = repeat;
+
+	// round up to whole ticks
+	timer.iIntervalTicks = (intervalMS + k_iTickMS - 1) / k_iTickMS;
+	timer.iDueTick = getCurrentTick(useClock) + timer.iIntervalTicks;
+
+	std::lock_guard<std::mutex> guard(m_TimerMutex);
+	int64_t timerID = m_iNextTimerID++;
+	m_mTimers[timerID] = timer;
+
+	if (useClock == true) {
+		m_ClockWheel.schedule(std::to_string(timerID), timer.iDueTick);
+	} else {
+		m_WallWheel.schedule(std::to_string(timerID), timer.iDueTick);
+	}
+
+	glass3::util::Logger::log(
+			"debug",
+			"TimerService::addTimer(): Added timer " + name + " ("
+					+ std::to_string(timerID) + ") every "
+					+ std::to_string(intervalMS) + " ms.");
+	return (timerID);
+}
+
+// ---------------------------------------------------------removeTimer
+bool TimerService::removeTimer(int64_t timerID) {
+	bool found = false;
+	{
+		std::lock_guard<std::mutex> guard(m_TimerMutex);
+		auto timer = m_mTimers.find(timerID);
+		if (timer != m_mTimers.end()) {
+			if (timer->second.bUseClock == true) {
+				m_ClockWheel.cancel(std::to_string(timerID));
+			} else {
+				m_WallWheel.cancel(std::to_string(timerID));
+			}
+			m_mTimers.erase(timer);
+			found = true;
+		}
+	}
+
+	// wait for any callback that is already running
+	std::lock_guard<std::recursive_mutex> callbackGuard(m_CallbackMutex);
+	return (found);
+}
+
+// ---------------------------------------------------------hasTimer
+bool TimerService::hasTimer(int64_t timerID) {
+	std::lock_guard<std::mutex> guard(m_TimerMutex);
+	return (m_mTimers.find(timerID) != m_mTimers.end());
+}
+
+// ---------------------------------------------------------getTimerCount
+int TimerService::getTimerCount() {
+	std::lock_guard<std::mutex> guard(m_TimerMutex);
+	return (m_mTimers.size());
+}
+
+// ---------------------------------------------------------work
+glass3::util::WorkState TimerService::work() {
+	std::vector<int64_t> dueTimers;
+	{
+		std::lock_guard<std::mutex> guard(m_TimerMutex);
+		advanceWheel(false, &dueTimers);
+		advanceWheel(true, &dueTimers);
+	}
+
+	if (dueTimers.empty() == true) {
+		return (glass3::util::WorkState::Idle);
+	}
+
+	std::lock_guard<std::recursive_mutex> callbackGuard(m_CallbackMutex);
+	for (int64_t timerID : dueTimers) {
+		std::function<void()> callback;
+		std::string name;
+		{
+			std::lock_guard<std::mutex> guard(m_TimerMutex);
+
+			// removed since it came due
+			auto timer = m_mTimers.find(timerID);
+			if (timer == m_mTimers.end()) {
+				continue;
+			}
+
+			callback = timer->second.callback;
+			name = timer->second.sName;
+
+			if (timer->second.bRepeat == true) {
+				// keep to the original schedule, unless we've fallen behind
+				int64_t nowTick = timer->second.bUseClock ?
+						m_iLastClockTick : m_iLastWallTick;
+				timer->second.iDueTick += timer->second.iIntervalTicks;
+				if (timer->second.iDueTick <= nowTick) {
+					timer->second.iDueTick = nowTick
+							+ timer->second.iIntervalTicks;
+				}
+
+				if (timer->second.bUseClock == true) {
+					m_ClockWheel.schedule(std::to_string(timerID),
+											timer->second.iDueTick);
+				} else {
+					m_WallWheel.schedule(std::to_string(timerID),
+											timer->second.iDueTick);
+				}
+			} else {
+				m_mTimers.erase(timer);
+			}
+		}
+
+		try {
+			callback();
+		} catch (const std::exception &e) {
+			glass3::util::Logger::log(
+					"error",
+					"TimerService::work(): Exception in timer " + name + ": "
+							+ std::string(e.what()));
+		}
+	}
+
+	return (glass3::util::WorkState::Idle);
+}
+
+// ---------------------------------------------------------getCurrentTick
+int64_t TimerService::getCurrentTick(bool useClock) {
+	if (useClock == true) {
+		return (static_cast<int64_t>(glass3::util::Clock::getEpochTime()
+				* 1000.0) / k_iTickMS);
+	}
+
+	return (std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count()
+			/ k_iTickMS);
+}
+
+// ---------------------------------------------------------advanceWheel
+void TimerService::advanceWheel(bool useClock,
+								std::vector<int64_t> *dueTimers) {
+	glass3::util::TimerWheel * wheel =
+			useClock ? &m_ClockWheel : &m_WallWheel;
+	int64_t * lastTick = useClock ? &m_iLastClockTick : &m_iLastWallTick;
+	int64_t nowTick = getCurrentTick(useClock);
+
+	// the clock jumped, such as when switching to or from simulated time,
+	// restart the timers from now rather than stepping through the jump
+	if ((nowTick < *lastTick) || ((nowTick - *lastTick) > k_iMaxCatchUpTicks)) {
+		glass3::util::Logger::log(
+				"info",
+				"TimerService::work(): Clock jumped by "
+						+ std::to_string((nowTick - *lastTick) * k_iTickMS)
+						+ " ms, restarting timers.");
+
+		wheel->clear();
+		wheel->advance(nowTick);
+		for (auto &timer : m_mTimers) {
+			if (timer.second.bUseClock != useClock) {
+				continue;
+			}
+			timer.second.iDueTick = nowTick + timer.second.iIntervalTicks;
+			wheel->schedule(std::to_string(timer.first),
+							timer.second.iDueTick);
+		}
+
+		*lastTick = nowTick;
+		return;
+	}
+
+	*lastTick = nowTick;
+	for (const std::string &timerID : wheel->advance(nowTick)) {
+		dueTimers->push_back(std::stoll(timerID));
+	}
+}
+}  // namespace util
+}  // namespace glass3
@@ -0,0 +1,225 @@
+#include <timerwheel.h>
+#include <logger.h>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <map>
+#include <list>
+#include <vector>
+#include <algorithm>
+
+namespace glass3 {
+namespace util {
+
+// constants
+const int TimerWheel::k_iBitsPerLevel;
+const int TimerWheel::k_iSlotsPerLevel;
+const int TimerWheel::k_iNumLevels;
+
+// ---------------------------------------------------------TimerWheel
+TimerWheel::TimerWheel() {
+	clear();
+}
+
+// ---------------------------------------------------------~TimerWheel
+TimerWheel::~TimerWheel() {
+}
+
+// ---------------------------------------------------------clear
+void TimerWheel::clear() {
+	getMutex().lock();
+
+	for (int level = 0; level < k_iNumLevels; level++) {
+		for (int slot = 0; slot < k_iSlotsPerLevel; slot++) {
+			m_Slots[level][slot].clear();
+		}
+	}
+	m_DueList.clear();
+	m_mSchedules.clear();
+	m_iCurrentTime = -1;
+
+	getMutex().unlock();
+
+	// finally do baseclass clear
+	util::BaseClass::clear();
+}
+
+// ---------------------------------------------------------schedule
+void TimerWheel::schedule(const std::string &id, int64_t dueTime) {
+	std::lock_guard<std::mutex> guard(getMutex());
+
+	// start the wheel if this is the first id
+	if (m_iCurrentTime < 0) {
+		m_iCurrentTime = dueTime;
+	}
+
+	auto it = m_mSchedules.find(id);
+	if (it != m_mSchedules.end()) {
+		// don't place the same schedule twice
+		if (it->second.iDueTime == dueTime) {
+			return;
+		}
+
+		// move the existing entry
+		it->second.iDueTime = dueTime;
+		place(it->second.pList, it->second.itEntry);
+		return;
+	}
+
+	// a new entry
+	std::list<std::string> newList;
+	newList.push_back(id);
+	Schedule &newSchedule = m_mSchedules[id];
+	newSchedule.iDueTime = dueTime;
+	place(&newList, newList.begin());
+}
+
+// ---------------------------------------------------------cancel
+bool TimerWheel::cancel(const std::string &id) {
+	std::lock_guard<std::mutex> guard(getMutex());
+
+	auto it = m_mSchedules.find(id);
+	if (it == m_mSchedules.end()) {
+		return (false);
+	}
+
+	it->second.pList->erase(it->second.itEntry);
+	m_mSchedules.erase(it);
+	return (true);
+}
+
+// ---------------------------------------------------------isScheduled
+bool TimerWheel::isScheduled(const std::string &id) {
+	std::lock_guard<std::mutex> guard(getMutex());
+	return (m_mSchedules.find(id) != m_mSchedules.end());
+}
+
+// ---------------------------------------------------------advance
+std::vector<std::string> TimerWheel::advance(int64_t now) {
+	std::lock_guard<std::mutex> guard(getMutex());
+	std::vector<std::string> dueIDs;
+
+	// start the wheel if nothing has been scheduled yet
+	if (m_iCurrentTime < 0) {
+		m_iCurrentTime = now + 1;
+		return (dueIDs);
+	}
+
+	// first, anything that was already due when it was scheduled, in due
+	// time order
+	std::list<std::string> dueList;
+	dueList.swap(m_DueList);
+	std::vector<std::list<std::string>::iterator> dueEntries;
+	for (auto it = dueList.begin(); it != dueList.end(); ++it) {
+		dueEntries.push_back(it);
+	}
+	std::stable_sort(
+			dueEntries.begin(),
+			dueEntries.end(),
+			[this](const std::list<std::string>::iterator &lhs,
+					const std::list<std::string>::iterator &rhs) {
+				return (m_mSchedules[*lhs].iDueTime
+						< m_mSchedules[*rhs].iDueTime);
+			});
+	for (const auto &entry : dueEntries) {
+		auto it = m_mSchedules.find(*entry);
+		if (it->second.iDueTime > now) {
+			// not due yet after all
+			place(&dueList, entry);
+			continue;
+		}
+		dueIDs.push_back(*entry);
+		m_mSchedules.erase(it);
+	}
+
+	// then tick the wheel up to now
+	while (m_iCurrentTime <= now) {
+		// nothing left to wait for, skip ahead
+		if (m_mSchedules.empty() == true) {
+			m_iCurrentTime = now + 1;
+			break;
+		}
+
+		// everything in the current bottom level slot is due
+		std::list<std::string> slotList;
+		slotList.swap(m_Slots[0][m_iCurrentTime & (k_iSlotsPerLevel - 1)]);
+
+		for (const auto &id : slotList) {
+			dueIDs.push_back(id);
+			m_mSchedules.erase(id);
+		}
+
+		m_iCurrentTime++;
+
+		// when a level wraps, move the next slot of the level above down
+		for (int level = k_iNumLevels - 1; level > 0; level--) {
+			int shift = level * k_iBitsPerLevel;
+			if ((m_iCurrentTime & ((static_cast<int64_t>(1) << shift) - 1))
+					== 0) {
+				cascade(level,
+						(m_iCurrentTime >> shift) & (k_iSlotsPerLevel - 1));
+			}
+		}
+	}
+
+	return (dueIDs);
+}
+
+// ---------------------------------------------------------size
+int TimerWheel::size() {
+	std::lock_guard<std::mutex> guard(getMutex());
+	return (m_mSchedules.size());
+}
+
+// ---------------------------------------------------------getList
+std::list<std::string> * TimerWheel::getList(int64_t dueTime) {
+	// already due
+	if (dueTime < m_iCurrentTime) {
+		return (&m_DueList);
+	}
+
+	// find the lowest level that reaches the due time
+	for (int level = 0; level < k_iNumLevels; level++) {
+		int shift = level * k_iBitsPerLevel;
+		if (((dueTime >> shift) - (m_iCurrentTime >> shift))
+				< k_iSlotsPerLevel) {
+			return (&m_Slots[level][(dueTime >> shift)
+					& (k_iSlotsPerLevel - 1)]);
+		}
+	}
+
+	// beyond the top level, park it in the farthest top level slot, it will
+	// be placed again when that slot is reached
+	int shift = (k_iNumLevels - 1) * k_iBitsPerLevel;
+	return (&m_Slots[k_iNumLevels - 1][((m_iCurrentTime >> shift)
+			+ k_iSlotsPerLevel - 1) & (k_iSlotsPerLevel - 1)]);
+}
+
+// ---------------------------------------------------------place
+void TimerWheel::place(std::list<std::string> * fromList,
+						std::list<std::string>::iterator itEntry) {
+	Schedule &schedule = m_mSchedules[*itEntry];
+	std::list<std::string> * toList = getList(schedule.iDueTime);
+
+	// splicing keeps the entry, and so the iterator to it, valid
+	toList->splice(toList->end(), *fromList, itEntry);
+	schedule.pList = toList;
+	schedule.itEntry = itEntry;
+}
+
+// ---------------------------------------------------------cascade
+void TimerWheel::cascade(int level, int slot) {
+	std::list<std::string> slotList;
+	slotList.swap(m_Slots[level][slot]);
+
+	while (slotList.empty() == false) {
+		place(&slotList, slotList.begin());
+	}
+}
+
+// ---------------------------------------------------------getMutex
+std::mutex & TimerWheel::getMutex() {
+	return (m_Mutex);
+}
+}  // namespace util
+}  // namespace glass3
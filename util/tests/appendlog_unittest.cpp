@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+#include <appendlog.h>
+#include <logger.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <csignal>
+#endif
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#define LOGPATH "./testdata/appendlog"
+#define PREFIX "test"
+#define EXTENSION "log"
+#define ACTIVEEXTENSION ".active"
+#define RECORD1 "first record"
+#define RECORD2 "second record"
+#define RECORD3 "third record"
+#define RECORD4 "fourth record"
+
+// the name a log file gets once it is completed
+static std::string completedName(const std::string &activeName) {
+	return (activeName.substr(
+			0, activeName.size() - std::string(ACTIVEEXTENSION).size()) + "."
+			+ std::string(EXTENSION));
+}
+
+// the lines in a file
+static std::vector<std::string> readLines(const std::string &fileName) {
+	std::vector<std::string> lines;
+	std::ifstream inFile(fileName);
+	std::string line;
+	while (std::getline(inFile, line)) {
+		lines.push_back(line);
+	}
+	return (lines);
+}
+
+static void makeLogPath() {
+#ifdef _WIN32
+	_mkdir(LOGPATH);
+#else
+	mkdir(LOGPATH, 0733);
+#endif
+}
+
+static void removeLogPath() {
+#ifdef _WIN32
+	_rmdir(LOGPATH);
+#else
+	rmdir(LOGPATH);
+#endif
+}
+
+// tests rejecting bad configuration
+TEST(AppendLogTest, Setup) {
+	glass3::util::Logger::disable();
+
+	glass3::util::AppendLog appendLog;
+	ASSERT_FALSE(appendLog.setup("", PREFIX, EXTENSION, 0, 0, 1, 0))
+	<< "no directory";
+	ASSERT_FALSE(appendLog.setup(LOGPATH, PREFIX, "", 0, 0, 1, 0))
+	<< "no extension";
+	ASSERT_FALSE(appendLog.setup(LOGPATH, PREFIX, EXTENSION, -1, 0, 1, 0))
+	<< "bad size";
+	ASSERT_FALSE(appendLog.setup(LOGPATH, PREFIX, EXTENSION, 0, 0, 0, 0))
+	<< "bad flush records";
+	ASSERT_TRUE(appendLog.setup(LOGPATH, PREFIX, EXTENSION, 0, 0, 1, 0))
+	<< "good setup";
+	ASSERT_STREQ("", appendLog.getFileName().c_str())<< "no file yet";
+}
+
+// tests batching records
+TEST(AppendLogTest, Batch) {
+	glass3::util::Logger::disable();
+	makeLogPath();
+
+	glass3::util::AppendLog appendLog;
+	ASSERT_TRUE(appendLog.setup(LOGPATH, PREFIX, EXTENSION, 0, 0, 3, 60000));
+
+	// buffered until there are three records
+	ASSERT_TRUE(appendLog.append(RECORD1));
+	ASSERT_TRUE(appendLog.append(RECORD2));
+	ASSERT_EQ(2, appendLog.getBufferedRecordCount())<< "buffered";
+	ASSERT_STREQ("", appendLog.getFileName().c_str())<< "nothing written";
+
+	ASSERT_TRUE(appendLog.append(RECORD3));
+	ASSERT_EQ(0, appendLog.getBufferedRecordCount())<< "written";
+	std::string activeName = appendLog.getFileName();
+	ASSERT_NE(std::string::npos, activeName.find(ACTIVEEXTENSION))
+	<< "active file";
+	ASSERT_EQ(3, readLines(activeName).size())<< "active lines";
+
+	// not due yet
+	ASSERT_TRUE(appendLog.append(RECORD4));
+	ASSERT_TRUE(appendLog.flushIfDue());
+	ASSERT_EQ(1, appendLog.getBufferedRecordCount())<< "not due";
+
+	// closing writes the rest and completes the file
+	appendLog.close();
+	ASSERT_EQ(0, appendLog.getBufferedRecordCount())<< "closed";
+	ASSERT_EQ(1, appendLog.getCompletedFileCount())<< "completed";
+	ASSERT_STREQ("", appendLog.getFileName().c_str())<< "no active file";
+
+	std::vector<std::string> lines = readLines(completedName(activeName));
+	ASSERT_EQ(4, lines.size())<< "completed lines";
+	ASSERT_STREQ(RECORD1, lines[0].c_str());
+	ASSERT_STREQ(RECORD2, lines[1].c_str());
+	ASSERT_STREQ(RECORD3, lines[2].c_str());
+	ASSERT_STREQ(RECORD4, lines[3].c_str());
+
+	std::remove(completedName(activeName).c_str());
+	removeLogPath();
+}
+
+// tests rotating log files by size, and flushing when due
+TEST(AppendLogTest, Rotate) {
+	glass3::util::Logger::disable();
+	makeLogPath();
+
+	// room for one record per file
+	glass3::util::AppendLog appendLog;
+	ASSERT_TRUE(appendLog.setup(LOGPATH, "", EXTENSION,
+								std::string(RECORD2).size() + 1, 0, 100, 0));
+
+	std::vector<std::string> fileNames;
+	std::vector<std::string> records = { RECORD1, RECORD2, RECORD3 };
+	for (const std::string &record : records) {
+		ASSERT_TRUE(appendLog.append(record));
+		ASSERT_EQ(1, appendLog.getBufferedRecordCount())<< "buffered";
+
+		// the flush interval is 0, so the record is already due
+		ASSERT_TRUE(appendLog.flushIfDue());
+		ASSERT_EQ(0, appendLog.getBufferedRecordCount())<< "flushed";
+		fileNames.push_back(appendLog.getFileName());
+	}
+	appendLog.close();
+
+	ASSERT_EQ(3, appendLog.getCompletedFileCount())<< "completed";
+	ASSERT_NE(fileNames[0], fileNames[1])<< "rotated";
+	ASSERT_NE(fileNames[1], fileNames[2])<< "rotated again";
+
+	for (int i = 0; i < fileNames.size(); i++) {
+		std::vector<std::string> lines = readLines(completedName(fileNames[i]));
+		ASSERT_EQ(1, lines.size())<< "one record per file";
+		ASSERT_STREQ(records[i].c_str(), lines[0].c_str());
+		std::remove(completedName(fileNames[i]).c_str());
+	}
+
+	removeLogPath();
+}
+
+// tests keeping records that could not be written
+TEST(AppendLogTest, FailedWrite) {
+	glass3::util::Logger::disable();
+	removeLogPath();
+
+	glass3::util::AppendLog appendLog;
+	ASSERT_TRUE(appendLog.setup(LOGPATH, PREFIX, EXTENSION, 0, 0, 1, 0));
+
+	// no directory to write to yet
+	ASSERT_FALSE(appendLog.append(RECORD1))<< "no directory";
+	ASSERT_EQ(1, appendLog.getBufferedRecordCount())<< "kept";
+	ASSERT_STREQ("", appendLog.getFileName().c_str())<< "no file";
+
+	// written once the directory is there
+	makeLogPath();
+	ASSERT_TRUE(appendLog.append(RECORD2))<< "retried";
+	ASSERT_EQ(0, appendLog.getBufferedRecordCount())<< "written";
+	std::vector<std::string> fileNames;
+	fileNames.push_back(appendLog.getFileName());
+
+#ifndef _WIN32
+	// fail a write part way through with a file size limit
+	struct rlimit oldLimit;
+	ASSERT_EQ(0, getrlimit(RLIMIT_FSIZE, &oldLimit));
+	struct rlimit newLimit = oldLimit;
+	newLimit.rlim_cur = std::string(RECORD1).size()
+			+ std::string(RECORD2).size() + 4;
+	std::signal(SIGXFSZ, SIG_IGN);
+	ASSERT_EQ(0, setrlimit(RLIMIT_FSIZE, &newLimit));
+
+	bool written = appendLog.append(RECORD3);
+	setrlimit(RLIMIT_FSIZE, &oldLimit);
+	std::signal(SIGXFSZ, SIG_DFL);
+
+	ASSERT_FALSE(written)<< "failed write";
+	ASSERT_EQ(1, appendLog.getBufferedRecordCount())<< "kept";
+	ASSERT_STREQ("", appendLog.getFileName().c_str())<< "file closed";
+	ASSERT_EQ(1, appendLog.getCompletedFileCount())<< "file completed";
+
+	// retried in a new file
+	ASSERT_TRUE(appendLog.flush())<< "retried";
+	ASSERT_EQ(0, appendLog.getBufferedRecordCount())<< "written";
+	fileNames.push_back(appendLog.getFileName());
+#endif
+
+	appendLog.close();
+
+	// every record once, the partial write was cut off
+	std::vector<std::string> lines;
+	for (const std::string &fileName : fileNames) {
+		std::vector<std::string> fileLines = readLines(completedName(fileName));
+		lines.insert(lines.end(), fileLines.begin(), fileLines.end());
+		std::remove(completedName(fileName).c_str());
+	}
+
+#ifndef _WIN32
+	ASSERT_EQ(3, lines.size())<< "lines";
+	ASSERT_STREQ(RECORD3, lines[2].c_str());
+#else
+	ASSERT_EQ(2, lines.size())<< "lines";
+#endif
+	ASSERT_STREQ(RECORD1, lines[0].c_str());
+	ASSERT_STREQ(RECORD2, lines[1].c_str());
+
+	removeLogPath();
+}
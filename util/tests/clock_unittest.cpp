@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include <clock.h>
+#include <date.h>
+#include <ctime>
+
+#define SIMTIME 1500000000
+#define SIMTIME2 1500000600
+#define SIMTIME3 1500000300
+
+// tests the clock in real time mode
+TEST(ClockTest, RealTime) {
+	glass3::util::Clock::useRealTime();
+
+	ASSERT_FALSE(glass3::util::Clock::isSimulated())<< "not simulated";
+
+	// the clock should agree with the wall clock
+	std::time_t tNow = std::time(NULL);
+	ASSERT_NEAR(glass3::util::Clock::now(), tNow, 1)<< "now";
+	ASSERT_NEAR(glass3::util::Clock::getEpochTime(), tNow, 1)<< "epoch time";
+
+	// advancing does nothing in real time mode
+	ASSERT_FALSE(glass3::util::Clock::advanceSimulatedTime(SIMTIME))
+	<< "no advance";
+	ASSERT_FALSE(glass3::util::Clock::isSimulated())<< "still not simulated";
+}
+
+// tests the clock in simulated mode
+TEST(ClockTest, SimulatedTime) {
+	glass3::util::Clock::setSimulatedTime(SIMTIME);
+
+	ASSERT_TRUE(glass3::util::Clock::isSimulated())<< "simulated";
+	ASSERT_EQ(glass3::util::Clock::now(), SIMTIME)<< "now";
+	ASSERT_DOUBLE_EQ(glass3::util::Clock::getEpochTime(), SIMTIME)
+	<< "epoch time";
+
+	// Date uses the clock
+	glass3::util::Date simDate;
+	double simGregorianTime = simDate.decodeISO8601Time(
+			glass3::util::Date::convertEpochTimeToISO8601(
+					static_cast<double>(SIMTIME)));
+	ASSERT_NEAR(glass3::util::Date::now(), simGregorianTime, 0.001)
+	<< "date now";
+
+	// advance forward
+	ASSERT_TRUE(glass3::util::Clock::advanceSimulatedTime(SIMTIME2))
+	<< "advanced";
+	ASSERT_EQ(glass3::util::Clock::now(), SIMTIME2)<< "advanced now";
+
+	// never backward
+	ASSERT_FALSE(glass3::util::Clock::advanceSimulatedTime(SIMTIME3))
+	<< "not advanced";
+	ASSERT_EQ(glass3::util::Clock::now(), SIMTIME2)<< "not moved back";
+
+	// back to real time
+	glass3::util::Clock::useRealTime();
+	ASSERT_FALSE(glass3::util::Clock::isSimulated())<< "not simulated";
+	ASSERT_NEAR(glass3::util::Clock::now(), std::time(NULL), 1)<< "real now";
+}
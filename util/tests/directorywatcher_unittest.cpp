@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <directorywatcher.h>
+#include <fileutil.h>
+#include <logger.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#define TESTDATA "testdata"
+#define WATCHPATH "watchpath"
+#define BADPATH "nosuchpath"
+#define EXTENSION "watch"
+#define OTHEREXTENSION "other"
+#define FILE1 "file1"
+#define FILE2 "file2"
+#define FILE3 "file3"
+#define TIMEOUT 100
+
+// tests watching a directory for new files
+TEST(DirectoryWatcherTest, Watch) {
+	glass3::util::Logger::disable();
+
+	std::string watchPath = "./" + std::string(TESTDATA) + "/"
+			+ std::string(WATCHPATH);
+	std::string file1 = watchPath + "/" + std::string(FILE1) + "."
+			+ std::string(EXTENSION);
+	std::string file2 = watchPath + "/" + std::string(FILE2) + "."
+			+ std::string(EXTENSION);
+	std::string file3 = watchPath + "/" + std::string(FILE3) + "."
+			+ std::string(OTHEREXTENSION);
+
+#ifdef _WIN32
+	_mkdir(watchPath.c_str());
+#else
+	mkdir(watchPath.c_str(), 0733);
+#endif
+
+	glass3::util::DirectoryWatcher watcher;
+	ASSERT_FALSE(watcher.isWatching())<< "not watching";
+
+	// a missing directory can't be watched
+	ASSERT_FALSE(watcher.watch("./" + std::string(BADPATH),
+								std::string(EXTENSION)))<< "bad path";
+
+#ifdef __linux__
+	ASSERT_TRUE(watcher.watch(watchPath, std::string(EXTENSION)))
+	<< "watching";
+	ASSERT_TRUE(watcher.isWatching())<< "is watching";
+	ASSERT_STREQ(watchPath.c_str(), watcher.getPath().c_str())<< "path";
+
+	// nothing yet
+	std::string fileName;
+	ASSERT_FALSE(watcher.getNextFileName(&fileName, TIMEOUT))<< "no files";
+
+	// write files
+	std::ofstream outFile;
+	outFile.open(file1, std::ios::out);
+	outFile << "data";
+	outFile.close();
+	outFile.open(file3, std::ios::out);
+	outFile << "data";
+	outFile.close();
+	outFile.open(file2, std::ios::out);
+	outFile << "data";
+	outFile.close();
+
+	// the matching files, in order
+	ASSERT_TRUE(watcher.getNextFileName(&fileName, TIMEOUT))<< "first file";
+	ASSERT_STREQ(file1.c_str(), fileName.c_str())<< "first file name";
+	ASSERT_TRUE(watcher.getNextFileName(&fileName, TIMEOUT))<< "second file";
+	ASSERT_STREQ(file2.c_str(), fileName.c_str())<< "second file name";
+	ASSERT_FALSE(watcher.getNextFileName(&fileName, 0))<< "no more files";
+	ASSERT_FALSE(watcher.hasOverflowed())<< "not overflowed";
+
+	// files that are gone before they are fetched are skipped
+	outFile.open(file1, std::ios::out);
+	outFile << "data";
+	outFile.close();
+	std::remove(file1.c_str());
+	ASSERT_FALSE(watcher.getNextFileName(&fileName, TIMEOUT))<< "gone";
+
+	watcher.stop();
+	ASSERT_FALSE(watcher.isWatching())<< "stopped";
+#else
+	ASSERT_FALSE(watcher.watch(watchPath, std::string(EXTENSION)))
+	<< "not supported";
+#endif
+
+	std::remove(file1.c_str());
+	std::remove(file2.c_str());
+	std::remove(file3.c_str());
+#ifdef _WIN32
+	_rmdir(watchPath.c_str());
+#else
+	rmdir(watchPath.c_str());
+#endif
+}
@@ -21,3 +21,25 @@ TEST(GlassMathTest, CombinedTest) {
 				glass3::util::GlassMath::gauss(sg, 1.0));
 	}
 }
+
+// tests solving a small linear system
+TEST(GlassMathTest, SolveLinearSystem) {
+	glass3::util::Logger::disable();
+
+	// 2x + y - z = 8, -3x - y + 2z = -11, -2x + y + 2z = -3
+	double matrix[9] = { 2.0, 1.0, -1.0, -3.0, -1.0, 2.0, -2.0, 1.0, 2.0 };
+	double vector[3] = { 8.0, -11.0, -3.0 };
+
+	ASSERT_TRUE(glass3::util::GlassMath::solveLinearSystem(3, matrix, vector))
+	<< "solved";
+	ASSERT_NEAR(2.0, vector[0], 0.0001)<< "x";
+	ASSERT_NEAR(3.0, vector[1], 0.0001)<< "y";
+	ASSERT_NEAR(-1.0, vector[2], 0.0001)<< "z";
+
+	// singular
+	double singular[4] = { 1.0, 2.0, 2.0, 4.0 };
+	double singularVector[2] = { 1.0, 2.0 };
+	ASSERT_FALSE(glass3::util::GlassMath::solveLinearSystem(2, singular,
+															singularVector))
+	<< "singular";
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <instrumentedmutex.h>
+#include <metricsregistry.h>
+#include <logger.h>
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#define DISABLEDNAME "test.disabled_lock"
+#define RECURSIVENAME "test.recursive_lock"
+#define CONTENDEDNAME "test.contended_lock"
+
+// tests that nothing is recorded while profiling is off
+TEST(InstrumentedMutexTest, Disabled) {
+	glass3::util::Logger::disable();
+	glass3::util::LockProfile::setEnabled(false);
+
+	glass3::util::InstrumentedMutex testMutex(DISABLEDNAME);
+	{
+		std::lock_guard<glass3::util::InstrumentedMutex> guard(testMutex);
+	}
+	ASSERT_TRUE(testMutex.try_lock())<< "try_lock";
+	testMutex.unlock();
+
+	glass3::util::LockProfile::LockStats * stats =
+			glass3::util::LockProfile::getLockStats(DISABLEDNAME);
+	ASSERT_EQ(0, stats->pAcquisitions->load())<< "acquisitions";
+	ASSERT_EQ(0, stats->pHoldTime->getCount())<< "hold count";
+}
+
+// tests profiling a recursive lock
+TEST(InstrumentedMutexTest, Recursive) {
+	glass3::util::Logger::disable();
+	glass3::util::LockProfile::setEnabled(true);
+
+	glass3::util::InstrumentedRecursiveMutex testMutex;
+	testMutex.setName(RECURSIVENAME);
+	{
+		std::lock_guard<glass3::util::InstrumentedRecursiveMutex> outerGuard(
+				testMutex);
+		std::lock_guard<glass3::util::InstrumentedRecursiveMutex> innerGuard(
+				testMutex);
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	glass3::util::LockProfile::setEnabled(false);
+
+	// every acquisition is counted, but only the outermost is held
+	glass3::util::LockProfile::LockStats * stats =
+			glass3::util::LockProfile::getLockStats(RECURSIVENAME);
+	ASSERT_EQ(2, stats->pAcquisitions->load())<< "acquisitions";
+	ASSERT_EQ(0, stats->pContended->load())<< "contended";
+	ASSERT_EQ(1, stats->pHoldTime->getCount())<< "hold count";
+	ASSERT_GE(stats->pHoldTime->getMax(), 10000)<< "hold time";
+
+	// the stats are in the shared registry
+	ASSERT_EQ(2, glass3::util::MetricsRegistry::getInstance().getCounter(
+			std::string("lock.") + RECURSIVENAME + ".acquisitions").load())
+	<< "registry acquisitions";
+}
+
+// tests profiling a contended lock
+TEST(InstrumentedMutexTest, Contended) {
+	glass3::util::Logger::disable();
+	glass3::util::LockProfile::setEnabled(true);
+
+	glass3::util::InstrumentedMutex testMutex(CONTENDEDNAME);
+	testMutex.lock();
+
+	// the other thread has to wait until we unlock
+	std::thread waiter([&testMutex]() {
+		std::lock_guard<glass3::util::InstrumentedMutex> guard(testMutex);
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	testMutex.unlock();
+	waiter.join();
+
+	// a held lock can't be tried
+	testMutex.lock();
+	std::thread tryer([&testMutex]() {
+		ASSERT_FALSE(testMutex.try_lock())<< "try_lock held";
+	});
+	tryer.join();
+	testMutex.unlock();
+
+	glass3::util::LockProfile::setEnabled(false);
+
+	glass3::util::LockProfile::LockStats * stats =
+			glass3::util::LockProfile::getLockStats(CONTENDEDNAME);
+	ASSERT_EQ(3, stats->pAcquisitions->load())<< "acquisitions";
+	ASSERT_EQ(1, stats->pContended->load())<< "contended";
+	ASSERT_EQ(1, stats->pWaitTime->getCount())<< "wait count";
+	ASSERT_GE(stats->pWaitTime->getMax(), 10000)<< "wait time";
+	ASSERT_EQ(3, stats->pHoldTime->getCount())<< "hold count";
+
+	// logs without trouble
+	glass3::util::LockProfile::report();
+}
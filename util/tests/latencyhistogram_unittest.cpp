@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include <latencyhistogram.h>
+
+#include <cstdint>
+#include <limits>
+
+// tests an empty histogram
+TEST(LatencyHistogramTest, Empty) {
+	glass3::util::LatencyHistogram histogram;
+
+	ASSERT_EQ(0, histogram.getCount())<< "no latencies";
+	ASSERT_EQ(0, histogram.getMax())<< "no max";
+	ASSERT_EQ(0, histogram.getPercentile(50.0))<< "no p50";
+}
+
+// tests percentiles and the maximum
+TEST(LatencyHistogramTest, Percentiles) {
+	glass3::util::LatencyHistogram histogram;
+
+	// 1 to 1000 microseconds
+	for (int64_t i = 1; i <= 1000; i++) {
+		histogram.record(i);
+	}
+
+	ASSERT_EQ(1000, histogram.getCount())<< "count";
+	ASSERT_EQ(1000, histogram.getMax())<< "max";
+
+	// within a bucket (1/8) of the exact value
+	int64_t p50 = histogram.getPercentile(50.0);
+	ASSERT_GE(p50, 500)<< "p50 low";
+	ASSERT_LE(p50, 500 + 500 / 8)<< "p50 high";
+
+	int64_t p99 = histogram.getPercentile(99.0);
+	ASSERT_GE(p99, 990)<< "p99 low";
+	ASSERT_LE(p99, 1000)<< "p99 no more than max";
+
+	ASSERT_EQ(1000, histogram.getPercentile(100.0))<< "p100 is max";
+	ASSERT_EQ(1, histogram.getPercentile(0.0))<< "p0 is min";
+
+	// small values are exact
+	histogram.reset();
+	histogram.record(3);
+	histogram.record(5);
+	histogram.record(-1);
+	ASSERT_EQ(3, histogram.getCount())<< "count after reset";
+	ASSERT_EQ(0, histogram.getPercentile(1.0))<< "negative as 0";
+	ASSERT_EQ(3, histogram.getPercentile(50.0))<< "exact p50";
+	ASSERT_EQ(5, histogram.getMax())<< "max after reset";
+
+	// very large values
+	int64_t largest = std::numeric_limits<int64_t>::max();
+	histogram.record(largest);
+	ASSERT_EQ(largest, histogram.getPercentile(100.0))<< "largest";
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <latencytracer.h>
+#include <logger.h>
+
+#include <chrono>
+#include <string>
+
+#define PICKID1 "pick1"
+#define PICKID2 "pick2"
+#define PICKID3 "pick3"
+
+// tests tracing picks through the stages
+TEST(LatencyTracerTest, Trace) {
+	glass3::util::Logger::disable();
+	glass3::util::LatencyTracer::setEnabled(true);
+
+	glass3::util::LatencyTracer tracer;
+	std::chrono::steady_clock::time_point tStart =
+			std::chrono::steady_clock::now();
+
+	// stages other than fetch and dequeue don't start a trace
+	tracer.mark(PICKID1, glass3::util::LatencyTracer::Parse, tStart);
+	ASSERT_EQ(0, tracer.getTraceCount())<< "not started";
+	ASSERT_EQ(0, tracer.getCount(glass3::util::LatencyTracer::Parse))
+	<< "not counted";
+
+	tracer.mark(PICKID1, glass3::util::LatencyTracer::Fetch, tStart);
+	tracer.mark(PICKID2, glass3::util::LatencyTracer::Dequeue, tStart);
+	ASSERT_EQ(2, tracer.getTraceCount())<< "started";
+
+	tracer.mark(PICKID1, glass3::util::LatencyTracer::Parse,
+				tStart + std::chrono::milliseconds(2));
+	tracer.mark(PICKID1, glass3::util::LatencyTracer::Associate,
+				tStart + std::chrono::milliseconds(10));
+	tracer.mark(PICKID2, glass3::util::LatencyTracer::Associate,
+				tStart + std::chrono::milliseconds(20));
+
+	// only the first time counts
+	tracer.mark(PICKID1, glass3::util::LatencyTracer::Associate,
+				tStart + std::chrono::milliseconds(500));
+	ASSERT_EQ(2, tracer.getCount(glass3::util::LatencyTracer::Associate))
+	<< "associate count";
+	ASSERT_EQ(
+			20000,
+			tracer.getLatency(glass3::util::LatencyTracer::Associate, 100.0))
+	<< "associate max";
+	ASSERT_EQ(2000,
+				tracer.getLatency(glass3::util::LatencyTracer::Parse, 50.0))
+	<< "parse latency";
+
+	// the first publication ends the trace
+	tracer.mark(PICKID1, glass3::util::LatencyTracer::Publish,
+				tStart + std::chrono::milliseconds(30));
+	ASSERT_EQ(1, tracer.getTraceCount())<< "ended";
+	tracer.mark(PICKID1, glass3::util::LatencyTracer::Publish,
+				tStart + std::chrono::milliseconds(40));
+	ASSERT_EQ(1, tracer.getCount(glass3::util::LatencyTracer::Publish))
+	<< "published once";
+	ASSERT_EQ(30000,
+				tracer.getLatency(glass3::util::LatencyTracer::Publish, 50.0))
+	<< "end to end";
+
+	// reporting resets the histograms, but not the traces in progress
+	tracer.report();
+	ASSERT_EQ(0, tracer.getCount(glass3::util::LatencyTracer::Associate))
+	<< "reset";
+	ASSERT_EQ(1, tracer.getTraceCount())<< "still in progress";
+
+	glass3::util::LatencyTracer::setEnabled(false);
+}
+
+// tests forgetting old traces
+TEST(LatencyTracerTest, Forget) {
+	glass3::util::Logger::disable();
+	glass3::util::LatencyTracer::setEnabled(true);
+
+	glass3::util::LatencyTracer tracer;
+	std::chrono::steady_clock::time_point tOld =
+			std::chrono::steady_clock::now()
+					- std::chrono::seconds(
+							glass3::util::LatencyTracer::k_iMaxTraceAgeS + 1);
+	tracer.mark(PICKID1, glass3::util::LatencyTracer::Fetch, tOld);
+	tracer.mark(PICKID2, glass3::util::LatencyTracer::Fetch);
+	ASSERT_EQ(2, tracer.getTraceCount())<< "traced";
+
+	// reporting forgets traces that are too old
+	tracer.report();
+	ASSERT_EQ(1, tracer.getTraceCount())<< "old trace forgotten";
+	tracer.mark(PICKID1, glass3::util::LatencyTracer::Publish);
+	ASSERT_EQ(0, tracer.getCount(glass3::util::LatencyTracer::Publish))
+	<< "forgotten trace not published";
+
+	// the oldest traces are forgotten to make room
+	for (int i = 0; i < glass3::util::LatencyTracer::k_iMaxTraces; i++) {
+		tracer.mark(std::to_string(i), glass3::util::LatencyTracer::Fetch);
+	}
+	ASSERT_EQ(glass3::util::LatencyTracer::k_iMaxTraces,
+				tracer.getTraceCount())<< "full";
+	tracer.mark(PICKID2, glass3::util::LatencyTracer::Publish);
+	ASSERT_EQ(0, tracer.getCount(glass3::util::LatencyTracer::Publish))
+	<< "oldest trace forgotten";
+
+	glass3::util::LatencyTracer::setEnabled(false);
+}
+
+// tests that nothing is traced while tracing is off
+TEST(LatencyTracerTest, Disabled) {
+	glass3::util::Logger::disable();
+	glass3::util::LatencyTracer::setEnabled(false);
+
+	glass3::util::LatencyTracer tracer;
+	tracer.mark(PICKID1, glass3::util::LatencyTracer::Fetch);
+	tracer.mark(PICKID1, glass3::util::LatencyTracer::Publish);
+	ASSERT_EQ(0, tracer.getTraceCount())<< "not started";
+	ASSERT_EQ(0, tracer.getCount(glass3::util::LatencyTracer::Fetch))
+	<< "not counted";
+}
+
+// tests stage names
+TEST(LatencyTracerTest, StageNames) {
+	ASSERT_STREQ("Fetch", glass3::util::LatencyTracer::getStageName(
+			glass3::util::LatencyTracer::Fetch).c_str());
+	ASSERT_STREQ("Publish", glass3::util::LatencyTracer::getStageName(
+			glass3::util::LatencyTracer::Publish).c_str());
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <mappedfile.h>
+#include <logger.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#define TESTFILENAME "./testdata/mappedfile.test"
+#define EMPTYFILENAME "./testdata/mappedfileempty.test"
+#define GROWFILENAME "./testdata/mappedfilegrow.test"
+#define BADFILENAME "./testdata/nosuchfile.test"
+#define LINE1 "first line"
+#define LINE3 "third line"
+#define LINE4 "last line"
+
+// tests reading lines from a mapped file
+TEST(MappedFileTest, ReadLines) {
+	glass3::util::Logger::disable();
+
+	// windows line ending, empty line, no newline at the end
+	std::ofstream outFile(TESTFILENAME, std::ios::out | std::ios::binary);
+	outFile << LINE1 << "\r\n" << "\n" << LINE3 << "\n" << LINE4;
+	outFile.close();
+
+	glass3::util::MappedFile mappedFile;
+	ASSERT_FALSE(mappedFile.isOpen())<< "not open";
+	ASSERT_TRUE(mappedFile.isEnd())<< "nothing to read";
+
+	ASSERT_TRUE(mappedFile.open(TESTFILENAME))<< "opened";
+	ASSERT_TRUE(mappedFile.isOpen())<< "open";
+	ASSERT_FALSE(mappedFile.isEnd())<< "lines to read";
+	int size = std::string(LINE1).length() + std::string(LINE3).length()
+			+ std::string(LINE4).length() + 4;
+	ASSERT_EQ(size, mappedFile.getSize())<< "size";
+
+	// read in batches
+	std::vector<glass3::util::MappedLine> lines;
+	ASSERT_EQ(2, mappedFile.readLines(2, &lines))<< "first batch";
+	ASSERT_EQ(2, mappedFile.readLines(5, &lines))<< "second batch";
+	ASSERT_EQ(0, mappedFile.readLines(5, &lines))<< "no more";
+	ASSERT_TRUE(mappedFile.isEnd())<< "all read";
+	ASSERT_EQ(size, mappedFile.getPosition())<< "position";
+
+	ASSERT_EQ(4, lines.size())<< "line count";
+	ASSERT_STREQ(LINE1,
+					std::string(lines[0].pData, lines[0].iLength).c_str());
+	ASSERT_EQ(0, lines[1].iLength)<< "empty line";
+	ASSERT_STREQ(LINE3,
+					std::string(lines[2].pData, lines[2].iLength).c_str());
+	ASSERT_STREQ(LINE4,
+					std::string(lines[3].pData, lines[3].iLength).c_str());
+
+	// reopening starts over
+	lines.clear();
+	ASSERT_TRUE(mappedFile.open(TESTFILENAME))<< "reopened";
+	ASSERT_EQ(4, mappedFile.readLines(10, &lines))<< "all lines";
+
+	mappedFile.close();
+	ASSERT_FALSE(mappedFile.isOpen())<< "closed";
+	ASSERT_EQ(0, mappedFile.getSize())<< "closed size";
+
+	std::remove(TESTFILENAME);
+}
+
+// tests empty and missing files
+TEST(MappedFileTest, EmptyAndMissing) {
+	glass3::util::Logger::disable();
+
+	std::ofstream outFile(EMPTYFILENAME, std::ios::out);
+	outFile.close();
+
+	glass3::util::MappedFile mappedFile;
+	std::vector<glass3::util::MappedLine> lines;
+
+	ASSERT_TRUE(mappedFile.open(EMPTYFILENAME))<< "opened empty";
+	ASSERT_TRUE(mappedFile.isEnd())<< "nothing to read";
+	ASSERT_EQ(0, mappedFile.readLines(10, &lines))<< "no lines";
+
+	ASSERT_FALSE(mappedFile.open(BADFILENAME))<< "missing file";
+	ASSERT_FALSE(mappedFile.isOpen())<< "not open";
+
+	std::remove(EMPTYFILENAME);
+}
+
+// tests picking up data appended after the file was opened
+TEST(MappedFileTest, Update) {
+	glass3::util::Logger::disable();
+
+	// the second line is still being written
+	std::ofstream outFile(GROWFILENAME, std::ios::out | std::ios::binary);
+	outFile << LINE1 << "\n" << "third";
+	outFile.flush();
+
+	glass3::util::MappedFile mappedFile;
+	ASSERT_TRUE(mappedFile.open(GROWFILENAME))<< "opened";
+	ASSERT_FALSE(mappedFile.update())<< "not grown";
+
+	// only the complete line
+	std::vector<glass3::util::MappedLine> lines;
+	ASSERT_EQ(1, mappedFile.readLines(10, &lines, false))<< "complete lines";
+	ASSERT_STREQ(LINE1,
+					std::string(lines[0].pData, lines[0].iLength).c_str());
+	ASSERT_FALSE(mappedFile.isEnd())<< "partial line left";
+
+	// finish the line and add another
+	outFile << " line\n" << LINE4;
+	outFile.close();
+
+	ASSERT_TRUE(mappedFile.update())<< "grown";
+	ASSERT_FALSE(mappedFile.update())<< "already updated";
+	int size = std::string(LINE1).length() + std::string(LINE3).length()
+			+ std::string(LINE4).length() + 2;
+	ASSERT_EQ(size, mappedFile.getSize())<< "grown size";
+
+	lines.clear();
+	ASSERT_EQ(1, mappedFile.readLines(10, &lines, false))<< "new line";
+	ASSERT_STREQ(LINE3,
+					std::string(lines[0].pData, lines[0].iLength).c_str());
+	ASSERT_EQ(1, mappedFile.readLines(10, &lines))<< "last line";
+	ASSERT_STREQ(LINE4,
+					std::string(lines[1].pData, lines[1].iLength).c_str());
+	ASSERT_TRUE(mappedFile.isEnd())<< "all read";
+
+	mappedFile.close();
+	ASSERT_FALSE(mappedFile.update())<< "closed";
+
+	std::remove(GROWFILENAME);
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <metricsregistry.h>
+#include <logger.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#define COUNTERNAME "test.counter"
+#define GAUGENAME "test.gauge"
+#define HISTOGRAMNAME "test.latency_us"
+#define DUMPFILE "./testdata/metrics.json"
+
+// tests creating and recording metrics
+TEST(MetricsRegistryTest, Record) {
+	glass3::util::Logger::disable();
+
+	glass3::util::MetricsRegistry registry;
+
+	// the same name gets the same metric
+	registry.getCounter(COUNTERNAME)++;
+	registry.getCounter(COUNTERNAME) += 2;
+	ASSERT_EQ(3, registry.getCounter(COUNTERNAME).load())<< "counter";
+
+	registry.getGauge(GAUGENAME) = 1.5;
+	ASSERT_DOUBLE_EQ(1.5, registry.getGauge(GAUGENAME).load())<< "gauge";
+
+	registry.getHistogram(HISTOGRAMNAME).record(100);
+	ASSERT_EQ(1, registry.getHistogram(HISTOGRAMNAME).getCount())
+	<< "histogram";
+
+	// snapshot
+	json::Object metrics = registry.getJSON();
+	ASSERT_TRUE(metrics.HasKey("Counters"))<< "counters";
+	ASSERT_TRUE(metrics.HasKey("Gauges"))<< "gauges";
+	ASSERT_TRUE(metrics.HasKey("Histograms"))<< "histograms";
+
+	json::Object counters = metrics["Counters"].ToObject();
+	ASSERT_DOUBLE_EQ(3.0, counters[COUNTERNAME].ToDouble())<< "counter json";
+
+	json::Object gauges = metrics["Gauges"].ToObject();
+	ASSERT_DOUBLE_EQ(1.5, gauges[GAUGENAME].ToDouble())<< "gauge json";
+
+	json::Object histograms = metrics["Histograms"].ToObject();
+	json::Object histogram = histograms[HISTOGRAMNAME].ToObject();
+	ASSERT_DOUBLE_EQ(1.0, histogram["Count"].ToDouble())<< "count json";
+	ASSERT_DOUBLE_EQ(100.0, histogram["Max"].ToDouble())<< "max json";
+}
+
+// tests writing the metrics to a file
+TEST(MetricsRegistryTest, WriteFile) {
+	glass3::util::Logger::disable();
+
+	glass3::util::MetricsRegistry registry;
+	registry.getCounter(COUNTERNAME) += 5;
+
+	ASSERT_TRUE(registry.writeJSONFile(DUMPFILE))<< "written";
+
+	std::ifstream inFile(DUMPFILE);
+	std::stringstream contents;
+	contents << inFile.rdbuf();
+	inFile.close();
+
+	json::Object metrics = json::Deserialize(contents.str()).ToObject();
+	json::Object counters = metrics["Counters"].ToObject();
+	ASSERT_DOUBLE_EQ(5.0, counters[COUNTERNAME].ToDouble())<< "counter file";
+
+	std::remove(DUMPFILE);
+
+	// bad dumps
+	ASSERT_FALSE(registry.startDump("", 1))<< "no file";
+	ASSERT_FALSE(registry.startDump(DUMPFILE, 0))<< "bad interval";
+	ASSERT_FALSE(registry.writeJSONFile("./nonexistent/metrics.json"))
+	<< "bad directory";
+}
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <metricsserver.h>
+#include <metricsregistry.h>
+#include <logger.h>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <string>
+
+#define COUNTERNAME "metricsservertest.counter"
+
+#ifndef _WIN32
+// send a request to the server and return the response
+static std::string sendRequest(int port, const std::string &request) {
+	int socketFD = socket(AF_INET, SOCK_STREAM, 0);
+
+	struct sockaddr_in address;
+	std::memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = htons(port);
+	if (connect(socketFD, reinterpret_cast<struct sockaddr *>(&address),
+				sizeof(address)) != 0) {
+		close(socketFD);
+		return ("");
+	}
+
+	send(socketFD, request.data(), request.size(), 0);
+
+	std::string response = "";
+	char buffer[512];
+	ssize_t bytesRead = 0;
+	while ((bytesRead = recv(socketFD, buffer, sizeof(buffer), 0)) > 0) {
+		response.append(buffer, bytesRead);
+	}
+
+	close(socketFD);
+	return (response);
+}
+
+// tests serving the metrics
+TEST(MetricsServerTest, Serve) {
+	glass3::util::Logger::disable();
+
+	glass3::util::MetricsRegistry::getInstance().getCounter(COUNTERNAME)++;
+
+	glass3::util::MetricsServer server;
+	ASSERT_EQ(-1, server.getPort())<< "no port";
+	ASSERT_TRUE(server.openPort(0))<< "opened";
+	ASSERT_GT(server.getPort(), 0)<< "picked a port";
+	server.start();
+
+	std::string response = sendRequest(server.getPort(),
+										"GET /metrics HTTP/1.0\r\n\r\n");
+	ASSERT_EQ(0, response.find("HTTP/1.0 200 OK"))<< "ok";
+	ASSERT_NE(std::string::npos, response.find(COUNTERNAME))<< "metrics";
+
+	response = sendRequest(server.getPort(), "GET /other HTTP/1.0\r\n\r\n");
+	ASSERT_EQ(0, response.find("HTTP/1.0 404"))<< "not found";
+
+	server.stop();
+	server.closePort();
+	ASSERT_EQ(-1, server.getPort())<< "closed";
+}
+#endif
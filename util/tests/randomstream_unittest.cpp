@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <randomstream.h>
+
+#include <cmath>
+#include <thread>
+
+#define SEED 12345
+#define SEED2 54321
+#define NUMSAMPLES 200000
+#define NUMCHECKS 100
+#define MINVALUE -2.5
+#define MAXVALUE 7.5
+#define MEAN 3.0
+#define STDDEV 2.0
+
+// tests seeding the stream
+TEST(RandomStreamTest, Seed) {
+	glass3::util::RandomStream stream1(SEED);
+	glass3::util::RandomStream stream2(SEED);
+	glass3::util::RandomStream stream3(SEED2);
+
+	// the same seed gives the same sequence, a different seed does not
+	bool different = false;
+	for (int i = 0; i < NUMCHECKS; i++) {
+		uint64_t value = stream1.next();
+		ASSERT_EQ(value, stream2.next())<< "same sequence";
+		if (value != stream3.next()) {
+			different = true;
+		}
+	}
+	ASSERT_TRUE(different)<< "different sequence";
+
+	// reseeding restarts the sequence
+	stream1.seed(SEED);
+	stream2.seed(SEED);
+	for (int i = 0; i < NUMCHECKS; i++) {
+		ASSERT_DOUBLE_EQ(stream1.gauss(0.0, 1.0), stream2.gauss(0.0, 1.0))
+		<< "same gauss";
+	}
+
+	// combined seeds are reproducible and depend on the value
+	ASSERT_EQ(glass3::util::RandomStream::combineSeed(SEED, MEAN),
+				glass3::util::RandomStream::combineSeed(SEED, MEAN))
+	<< "same combined seed";
+	ASSERT_NE(glass3::util::RandomStream::combineSeed(SEED, MEAN),
+				glass3::util::RandomStream::combineSeed(SEED, STDDEV))
+	<< "different combined seed";
+}
+
+// tests the uniform samples
+TEST(RandomStreamTest, Uniform) {
+	glass3::util::RandomStream stream(SEED);
+
+	double sum = 0;
+	for (int i = 0; i < NUMSAMPLES; i++) {
+		double value = stream.uniform(MINVALUE, MAXVALUE);
+		ASSERT_GE(value, MINVALUE)<< "above minimum";
+		ASSERT_LT(value, MAXVALUE)<< "below maximum";
+		sum += value;
+	}
+
+	ASSERT_NEAR((MINVALUE + MAXVALUE) / 2.0, sum / NUMSAMPLES, 0.05)
+	<< "mean";
+}
+
+// tests the gaussian samples
+TEST(RandomStreamTest, Gauss) {
+	glass3::util::RandomStream stream(SEED);
+
+	double sum = 0;
+	double sumSquares = 0;
+	int numBeyondTwo = 0;
+	int numTail = 0;
+	for (int i = 0; i < NUMSAMPLES; i++) {
+		double value = stream.gauss(MEAN, STDDEV);
+		sum += value;
+		sumSquares += value * value;
+
+		double z = std::abs((value - MEAN) / STDDEV);
+		if (z > 2.0) {
+			numBeyondTwo++;
+		}
+		if (z > 3.442619855899) {
+			numTail++;
+		}
+	}
+
+	double mean = sum / NUMSAMPLES;
+	double stdDev = sqrt(sumSquares / NUMSAMPLES - mean * mean);
+	ASSERT_NEAR(MEAN, mean, 0.02)<< "mean";
+	ASSERT_NEAR(STDDEV, stdDev, 0.02)<< "standard deviation";
+
+	// 4.55% of a normal distribution lies beyond two standard deviations
+	ASSERT_NEAR(0.0455, static_cast<double>(numBeyondTwo) / NUMSAMPLES, 0.003)
+	<< "beyond two standard deviations";
+
+	// and 0.058% beyond the ziggurat edge
+	ASSERT_GT(numTail, 0)<< "tail sampled";
+	ASSERT_NEAR(0.00058, static_cast<double>(numTail) / NUMSAMPLES, 0.0003)
+	<< "tail";
+}
+
+// tests the per thread streams
+TEST(RandomStreamTest, ThreadStream) {
+	glass3::util::RandomStream * mainStream =
+			&glass3::util::RandomStream::getThreadStream();
+	ASSERT_EQ(mainStream, &glass3::util::RandomStream::getThreadStream())
+	<< "same stream on the same thread";
+
+	glass3::util::RandomStream * otherStream = NULL;
+	std::thread otherThread([&otherStream]() {
+		otherStream = &glass3::util::RandomStream::getThreadStream();
+		otherStream->next();
+	});
+	otherThread.join();
+
+	ASSERT_NE(mainStream, otherStream)<< "different stream on another thread";
+}
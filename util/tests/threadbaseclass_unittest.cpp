@@ -2,6 +2,7 @@
 #include <threadbaseclass.h>
 #include <logger.h>
 #include <string>
+#include <ctime>
 
 #define TESTTHREADNAME "threadbasestub"
 #define TESTSLEEPTIME 50
@@ -214,3 +215,44 @@ TEST(ThreadBaseClassTest, FailTests) {
 	ASSERT_FALSE(TestThreadBaseStub->healthCheck())<<
 	"TestThreadBaseStub healthCheck is false";
 }
+
+// tests the per thread heartbeats
+TEST(ThreadBaseClassTest, HeartbeatTest) {
+	std::string name = std::string(TESTTHREADNAME);
+
+	// create a threadbasestub
+	threadbasestub * TestThreadBaseStub = new threadbasestub(name,
+	TESTSLEEPTIME);
+
+	// no heartbeats before starting
+	size_t threadId = 0;
+	ASSERT_EQ(0, TestThreadBaseStub->getAllLastHealthy(&threadId))<<
+	"no heartbeats before start";
+
+	// start the thread
+	ASSERT_TRUE(TestThreadBaseStub->start())<< "start was successful";
+
+	// wait a little while
+	std::this_thread::sleep_for(std::chrono::seconds(WAITTIME / 2));
+
+	// the work thread has reported recently
+	std::time_t lastHealthy = TestThreadBaseStub->getAllLastHealthy(&threadId);
+	ASSERT_LE(std::time(nullptr) - lastHealthy, 1)<< "recent heartbeat";
+
+	// only the work threads can report their health
+	TestThreadBaseStub->setThreadHealth(false);
+	ASSERT_TRUE(TestThreadBaseStub->healthCheck())<<
+	"TestThreadBaseStub healthCheck is true";
+
+	// stop the thread
+	ASSERT_TRUE(TestThreadBaseStub->stop())<< "stop was successful";
+
+	// the heartbeats are gone with the threads
+	TestThreadBaseStub->testSetThreadState(glass3::util::ThreadState::Started);
+	ASSERT_EQ(0, TestThreadBaseStub->getAllLastHealthy(&threadId))<<
+	"no heartbeats after stop";
+	TestThreadBaseStub->testSetThreadState(glass3::util::ThreadState::Stopped);
+
+	// cleanup
+	delete (TestThreadBaseStub);
+}
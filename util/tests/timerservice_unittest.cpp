@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <timerservice.h>
+#include <clock.h>
+#include <logger.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#define INTERVALMS 100
+#define SIMTIME 1000000.0
+#define SIMINTERVALMS 10000
+
+// tests adding and removing timers
+TEST(TimerServiceTest, AddRemove) {
+	glass3::util::Logger::disable();
+
+	glass3::util::TimerService service;
+	ASSERT_EQ(0, service.getTimerCount())<< "no timers";
+
+	// bad timers
+	ASSERT_EQ(-1, service.addTimer("bad", 0, []() {}))<< "bad interval";
+	ASSERT_EQ(-1, service.addTimer("bad", INTERVALMS, nullptr))
+	<< "bad callback";
+
+	int64_t timerID = service.addTimer("good", INTERVALMS, []() {});
+	ASSERT_GE(timerID, 0)<< "good timer";
+	ASSERT_TRUE(service.hasTimer(timerID))<< "has timer";
+	ASSERT_EQ(1, service.getTimerCount())<< "one timer";
+
+	ASSERT_TRUE(service.removeTimer(timerID))<< "removed";
+	ASSERT_FALSE(service.hasTimer(timerID))<< "no timer";
+	ASSERT_FALSE(service.removeTimer(timerID))<< "not removed twice";
+	ASSERT_EQ(0, service.getTimerCount())<< "no timers";
+}
+
+// tests repeating and one shot timers on the timer thread
+TEST(TimerServiceTest, Run) {
+	glass3::util::Logger::disable();
+
+	std::atomic<int> repeatCount(0);
+	std::atomic<int> onceCount(0);
+
+	glass3::util::TimerService service;
+	int64_t repeatID = service.addTimer("repeat", INTERVALMS,
+										[&repeatCount]() { repeatCount++; });
+	int64_t onceID = service.addTimer("once", INTERVALMS,
+										[&onceCount]() { onceCount++; },
+										false, false);
+
+	service.start();
+	std::this_thread::sleep_for(std::chrono::milliseconds(INTERVALMS * 5 + 50));
+
+	// once removed, the callback is not called again
+	ASSERT_TRUE(service.removeTimer(repeatID))<< "removed";
+	int finalCount = repeatCount;
+	std::this_thread::sleep_for(std::chrono::milliseconds(INTERVALMS * 2));
+	service.stop();
+
+	ASSERT_GE(finalCount, 3)<< "repeated";
+	ASSERT_EQ(finalCount, repeatCount)<< "not called after removal";
+	ASSERT_EQ(1, onceCount)<< "called once";
+	ASSERT_FALSE(service.hasTimer(onceID))<< "one shot removed";
+}
+
+// tests timers on the simulated clock
+TEST(TimerServiceTest, SimulatedClock) {
+	glass3::util::Logger::disable();
+	glass3::util::Clock::setSimulatedTime(SIMTIME);
+
+	int count = 0;
+	glass3::util::TimerService service;
+	service.addTimer("clock", SIMINTERVALMS, [&count]() { count++; }, true);
+
+	// driven by the simulated time, not the wall clock
+	glass3::util::Clock::advanceSimulatedTime(SIMTIME + 5.0);
+	service.work();
+	ASSERT_EQ(0, count)<< "not due";
+
+	glass3::util::Clock::advanceSimulatedTime(SIMTIME + 10.0);
+	service.work();
+	ASSERT_EQ(1, count)<< "due";
+
+	glass3::util::Clock::advanceSimulatedTime(SIMTIME + 25.0);
+	service.work();
+	ASSERT_EQ(2, count)<< "due again, once";
+
+	// a big jump restarts the timer instead of catching up
+	glass3::util::Clock::advanceSimulatedTime(SIMTIME + 10.0 * 24 * 60 * 60);
+	service.work();
+	ASSERT_EQ(2, count)<< "restarted";
+
+	glass3::util::Clock::advanceSimulatedTime(
+			SIMTIME + 10.0 * 24 * 60 * 60 + 10.0);
+	service.work();
+	ASSERT_EQ(3, count)<< "due after restart";
+
+	glass3::util::Clock::useRealTime();
+}
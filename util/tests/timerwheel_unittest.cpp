@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <timerwheel.h>
+#include <string>
+#include <vector>
+
+#define TESTID1 "one"
+#define TESTID2 "two"
+#define TESTID3 "three"
+#define STARTTIME 1000000
+
+// tests to see if the timer wheel is functional
+TEST(TimerWheelTest, CombinedTest) {
+	glass3::util::TimerWheel * TestWheel = new glass3::util::TimerWheel();
+
+	// assert an empty wheel was created
+	ASSERT_EQ(TestWheel->size(), 0)<< "empty wheel constructed";
+
+	// schedule ids
+	TestWheel->schedule(TESTID1, STARTTIME + 10);
+	TestWheel->schedule(TESTID2, STARTTIME + 5);
+	TestWheel->schedule(TESTID3, STARTTIME + 20);
+
+	ASSERT_EQ(TestWheel->size(), 3)<< "3 ids scheduled";
+	ASSERT_TRUE(TestWheel->isScheduled(TESTID1))<< "id 1 scheduled";
+
+	// nothing due yet
+	std::vector<std::string> due = TestWheel->advance(STARTTIME + 4);
+	ASSERT_EQ(static_cast<int>(due.size()), 0)<< "nothing due";
+
+	// two due, in order
+	due = TestWheel->advance(STARTTIME + 10);
+	ASSERT_EQ(static_cast<int>(due.size()), 2)<< "two due";
+	ASSERT_STREQ(due[0].c_str(), TESTID2)<< "id 2 first";
+	ASSERT_STREQ(due[1].c_str(), TESTID1)<< "id 1 second";
+	ASSERT_FALSE(TestWheel->isScheduled(TESTID1))<< "id 1 not scheduled";
+	ASSERT_EQ(TestWheel->size(), 1)<< "1 id scheduled";
+
+	// reschedule and cancel
+	TestWheel->schedule(TESTID3, STARTTIME + 30);
+	TestWheel->schedule(TESTID1, STARTTIME + 25);
+	ASSERT_TRUE(TestWheel->cancel(TESTID1))<< "id 1 canceled";
+	ASSERT_FALSE(TestWheel->cancel(TESTID1))<< "id 1 not canceled twice";
+
+	due = TestWheel->advance(STARTTIME + 29);
+	ASSERT_EQ(static_cast<int>(due.size()), 0)<< "rescheduled not due";
+
+	due = TestWheel->advance(STARTTIME + 30);
+	ASSERT_EQ(static_cast<int>(due.size()), 1)<< "rescheduled due";
+	ASSERT_STREQ(due[0].c_str(), TESTID3)<< "id 3 due";
+
+	// ids scheduled in the past are due on the next advance
+	TestWheel->schedule(TESTID2, STARTTIME);
+	due = TestWheel->advance(STARTTIME + 31);
+	ASSERT_EQ(static_cast<int>(due.size()), 1)<< "past id due";
+	ASSERT_STREQ(due[0].c_str(), TESTID2)<< "id 2 due";
+
+	// clear
+	TestWheel->schedule(TESTID1, STARTTIME + 100);
+	TestWheel->clear();
+	ASSERT_EQ(TestWheel->size(), 0)<< "no ids scheduled";
+
+	delete (TestWheel);
+}
+
+// tests to see if ids are due at the right time across all wheel levels
+TEST(TimerWheelTest, LevelTest) {
+	glass3::util::TimerWheel TestWheel;
+
+	// delays reaching every level of the wheel and beyond it
+	std::vector<int64_t> delays = { 1, 63, 64, 65, 4095, 4096, 4097, 300000,
+		16777215, 16777216, 20000000 };
+
+	TestWheel.advance(STARTTIME);
+	for (int i = 0; i < delays.size(); i++) {
+		TestWheel.schedule(std::to_string(i), STARTTIME + delays[i]);
+	}
+
+	// each id must be due exactly at its time
+	for (int i = 0; i < delays.size(); i++) {
+		std::vector<std::string> due = TestWheel.advance(
+				STARTTIME + delays[i] - 1);
+		ASSERT_EQ(static_cast<int>(due.size()), 0)<< "not early "
+		<< delays[i];
+
+		due = TestWheel.advance(STARTTIME + delays[i]);
+		ASSERT_EQ(static_cast<int>(due.size()), 1)<< "due " << delays[i];
+		ASSERT_STREQ(due[0].c_str(), std::to_string(i).c_str())<< "right id";
+	}
+
+	ASSERT_EQ(TestWheel.size(), 0)<< "all ids due";
+}
+
+// tests to see if rescheduled and canceled ids leave nothing behind
+TEST(TimerWheelTest, RescheduleTest) {
+	glass3::util::TimerWheel TestWheel;
+
+	TestWheel.advance(STARTTIME);
+
+	// move an id around every level of the wheel, the due list, and back
+	std::vector<int64_t> delays = { 10, 5000, 300000, 20000000, -5, 70, 3 };
+	for (int i = 0; i < 1000; i++) {
+		TestWheel.schedule(TESTID1, STARTTIME + delays[i % delays.size()]);
+	}
+	TestWheel.schedule(TESTID2, STARTTIME + 3);
+	TestWheel.schedule(TESTID3, STARTTIME - 5);
+	ASSERT_EQ(TestWheel.size(), 3)<< "3 ids scheduled";
+
+	// canceling one id leaves the others alone
+	ASSERT_TRUE(TestWheel.cancel(TESTID3))<< "id 3 canceled";
+	ASSERT_EQ(TestWheel.size(), 2)<< "2 ids scheduled";
+
+	// only the last schedule of each id is due, once, the last schedule of
+	// id 1 is 70 seconds out
+	std::vector<std::string> due = TestWheel.advance(STARTTIME + 69);
+	ASSERT_EQ(static_cast<int>(due.size()), 1)<< "one due";
+	ASSERT_STREQ(due[0].c_str(), TESTID2)<< "id 2 due";
+	due = TestWheel.advance(STARTTIME + 20000000);
+	ASSERT_EQ(static_cast<int>(due.size()), 1)<< "one more due";
+	ASSERT_STREQ(due[0].c_str(), TESTID1)<< "id 1 due";
+	ASSERT_EQ(TestWheel.size(), 0)<< "nothing scheduled";
+
+	// a canceled id in the due list is not returned
+	TestWheel.schedule(TESTID1, STARTTIME);
+	ASSERT_TRUE(TestWheel.cancel(TESTID1))<< "id 1 canceled";
+	due = TestWheel.advance(STARTTIME + 20000001);
+	ASSERT_EQ(static_cast<int>(due.size()), 0)<< "canceled not due";
+}